@@ -66,6 +66,18 @@ tests = [
     ("Ice/defaultServant", ["core"]),
     ("Ice/defaultValue", ["core"]),
     ("Ice/invoke", ["core", "novc6"]),
+    ("Ice/requestTable", ["once"]),
+    ("Ice/bufferPool", ["once"]),
+    ("Ice/codec", ["once", "noipv6"]),
+    ("Ice/chunkedTransfer", ["once", "noipv6"]),
+    ("Ice/servantManager", ["once"]),
+    ("Ice/collocatedAsync", ["core", "novc6"]),
+    ("Ice/connectionPool", ["core", "novc6"]),
+    ("Ice/unixSocket", ["core", "nowin32"]),
+    ("Ice/shm", ["core", "nowin32"]),
+    ("Ice/metrics", ["core", "noipv6"]),
+    ("Ice/dispatchPriority", ["core", "novc6"]),
+    ("Ice/classGraph", ["once"]),
     ("IceSSL/configuration", ["once", "novalgrind"]), # valgrind doesn't work well with openssl
     ("IceBox/configuration", ["core", "noipv6", "nobcc", "novc6"]),
     ("Freeze/dbmap", ["once", "novc6"]),
@@ -52,6 +52,11 @@ public:
         {
             clear(); // Not inlined.
         }
+
+        if(_readTables || _writeTables)
+        {
+            deleteTables(); // Not inlined.
+        }
     }
 
     void clear();
@@ -80,6 +85,41 @@ public:
         b.resize(sz);
     }
 
+    //
+    // Makes room for writing n more bytes. The generated code calls
+    // this with the encoded size of the parameters before marshaling
+    // them, so that large requests and replies are written without
+    // reallocating the buffer. The buffer isn't expanded beyond the
+    // memory limit, writing past it throws MemoryLimitException as
+    // usual.
+    //
+    void expand(Container::size_type n)
+    {
+        if(_unlimited || b.size() + n <= _messageSizeMax)
+        {
+            b.expand(n);
+        }
+    }
+
+    //
+    // The encoded size of a sequence of n elements of the given fixed
+    // size, and of a string. The size of a string is its size before
+    // conversion to UTF-8: it's exact for narrow strings if no string
+    // converter is installed, and a lower bound otherwise.
+    //
+    static Container::size_type encodedSize(Container::size_type n, Container::size_type elementSize)
+    {
+        return (n > 254 ? 5 : 1) + n * elementSize;
+    }
+    static Container::size_type encodedSize(const std::string& v)
+    {
+        return encodedSize(v.size(), 1);
+    }
+    static Container::size_type encodedSize(const std::wstring& v)
+    {
+        return encodedSize(v.size(), 1);
+    }
+
     void startWriteEncaps()
     {
         WriteEncaps* oldEncaps = _currentWriteEncaps;
@@ -121,6 +161,10 @@ public:
 
         WriteEncaps* oldEncaps = _currentWriteEncaps;
         _currentWriteEncaps = _currentWriteEncaps->previous;
+        if(oldEncaps->tables)
+        {
+            releaseTables(oldEncaps); // Not inlined.
+        }
         if(oldEncaps == &_preAllocatedWriteEncaps)
         {
             oldEncaps->reset();
@@ -200,6 +244,10 @@ public:
 
         ReadEncaps* oldEncaps = _currentReadEncaps;
         _currentReadEncaps = _currentReadEncaps->previous;
+        if(oldEncaps->tables)
+        {
+            releaseTables(oldEncaps); // Not inlined.
+        }
         if(oldEncaps == &_preAllocatedReadEncaps)
         {
             oldEncaps->reset();
@@ -521,12 +569,6 @@ public:
     };
 
     typedef std::vector<PatchEntry> PatchList;
-    typedef std::map<Ice::Int, PatchList> PatchMap;
-    typedef std::map<Ice::Int, Ice::ObjectPtr> IndexToPtrMap;
-    typedef std::map<Ice::Int, std::string> TypeIdReadMap;
-
-    typedef std::map<Ice::ObjectPtr, Ice::Int> PtrToIndexMap;
-    typedef std::map<std::string, Ice::Int> TypeIdWriteMap;
 
     typedef std::vector<Ice::ObjectPtr> ObjectList;
 
@@ -553,32 +595,28 @@ private:
     //
     void* _closure;
 
+    //
+    // The tables of the class instances and type ids of an
+    // encapsulation, defined in BasicStream.cpp. They are allocated
+    // when the first instance is marshaled or unmarshaled and kept by
+    // the stream for the next encapsulation once cleared.
+    //
+    struct ReadTables;
+    struct WriteTables;
+
     class ICE_API ReadEncaps : private ::IceUtil::noncopyable
     {
     public:
 
-        ReadEncaps() : patchMap(0), unmarshaledMap(0), typeIdMap(0), typeIdIndex(0), previous(0)
+        ReadEncaps() : tables(0), previous(0)
         {
             // Inlined for performance reasons.
         }
-        ~ReadEncaps()
-        {
-            // Inlined for performance reasons.
-            delete patchMap;
-            delete unmarshaledMap;
-            delete typeIdMap;
-        }
+        ~ReadEncaps();
         void reset()
         {
             // Inlined for performance reasons.
-            delete patchMap;
-            delete unmarshaledMap;
-            delete typeIdMap;
-
-            patchMap = 0;
-            unmarshaledMap = 0;
-            typeIdMap = 0;
-            typeIdIndex = 0;
+            assert(!tables);
             previous = 0;
         }
         void swap(ReadEncaps&);
@@ -589,10 +627,7 @@ private:
         Ice::Byte encodingMajor;
         Ice::Byte encodingMinor;
 
-        PatchMap* patchMap;
-        IndexToPtrMap* unmarshaledMap;
-        TypeIdReadMap* typeIdMap;
-        Ice::Int typeIdIndex;
+        ReadTables* tables;
 
         ReadEncaps* previous;
     };
@@ -601,40 +636,22 @@ private:
     {
     public:
 
-        WriteEncaps() : writeIndex(0), toBeMarshaledMap(0), marshaledMap(0), typeIdMap(0), typeIdIndex(0), previous(0)
-        {
-            // Inlined for performance reasons.
-        }
-        ~WriteEncaps()
+        WriteEncaps() : tables(0), previous(0)
         {
             // Inlined for performance reasons.
-            delete toBeMarshaledMap;
-            delete marshaledMap;
-            delete typeIdMap;
         }
+        ~WriteEncaps();
         void reset()
         {
             // Inlined for performance reasons.
-            delete toBeMarshaledMap;
-            delete marshaledMap;
-            delete typeIdMap;
-
-            writeIndex = 0;
-            toBeMarshaledMap = 0;
-            marshaledMap = 0;
-            typeIdMap = 0;
-            typeIdIndex = 0;
+            assert(!tables);
             previous = 0;
         }
         void swap(WriteEncaps&);
 
         Container::size_type start;
 
-        Ice::Int writeIndex;
-        PtrToIndexMap* toBeMarshaledMap;
-        PtrToIndexMap* marshaledMap;
-        TypeIdWriteMap* typeIdMap;
-        Ice::Int typeIdIndex;
+        WriteTables* tables;
 
         WriteEncaps* previous;
     };
@@ -649,7 +666,15 @@ private:
     Container::size_type _writeSlice;
 
     void writeInstance(const Ice::ObjectPtr&, Ice::Int);
-    void patchPointers(Ice::Int, IndexToPtrMap::const_iterator, PatchMap::iterator);
+
+    ReadTables* readTables();
+    WriteTables* writeTables();
+    void releaseTables(ReadEncaps*);
+    void releaseTables(WriteEncaps*);
+    void deleteTables();
+
+    ReadTables* _readTables;
+    WriteTables* _writeTables;
 
     int _traceSlicing;
     const char* _slicingCat;
@@ -11,15 +11,23 @@
 #define ICEE_BUFFER_H
 
 #include <Ice/Config.h>
+#include <Ice/Handle.h>
+#include <IceUtil/Shared.h>
 
 namespace IceInternal
 {
 
+class BufferPool;
+
+class SharedBuffer;
+ICE_API IceUtil::Shared* upCast(SharedBuffer*);
+typedef IceInternal::Handle<SharedBuffer> SharedBufferPtr;
+
 class ICE_API Buffer : private IceUtil::noncopyable
 {
 public:
 
-    Buffer(size_t maxCapacity) : b(maxCapacity), i(b.begin()) { }
+    Buffer(size_t maxCapacity, BufferPool* pool = 0) : b(maxCapacity, pool), i(b.begin()) { }
     virtual ~Buffer() { }
 
     void swapBuffer(Buffer&);
@@ -41,7 +49,7 @@ public:
         typedef ptrdiff_t difference_type;
         typedef size_t size_type;
 
-        Container(size_type maxCapacity);
+        Container(size_type maxCapacity, BufferPool* = 0);
 
         ~Container();
 
@@ -79,6 +87,16 @@ public:
         
         void clear();
 
+        //
+        // Returns a reference-counted handle on the memory of this
+        // container. The memory is released once the container and
+        // all the handles are gone, which allows the bytes to be
+        // referenced after the container is destroyed. The container
+        // must not be modified in place afterwards: resizing it copies
+        // its content into new memory first.
+        //
+        SharedBufferPtr share();
+
         void resize(size_type n) // Inlined for performance reasons.
         {
             if(n == 0)
@@ -92,6 +110,18 @@ public:
             _size = n;
         }
 
+        //
+        // Makes room for n more bytes, so that resizing the container
+        // by up to n bytes doesn't reallocate its memory.
+        //
+        void expand(size_type n) // Inlined for performance reasons.
+        {
+            if(_size + n > _capacity)
+            {
+                reserve(_size + n);
+            }
+        }
+
         void reset()
         {
             if(_size > 0 && _size * 2 < _capacity)
@@ -144,6 +174,8 @@ public:
         size_type _capacity;
         size_type _maxCapacity;
         int _shrinkCounter;
+        BufferPool* _pool;
+        SharedBuffer* _shared;
     };
 
     Container b;
@@ -0,0 +1,128 @@
+// **********************************************************************
+//
+// Copyright (c) 2003-2011 ZeroC, Inc. All rights reserved.
+//
+// This copy of Ice is licensed to you under the terms described in the
+// ICE_LICENSE file included in this distribution.
+//
+// **********************************************************************
+
+#ifndef ICE_CHUNKED_TRANSFER_H
+#define ICE_CHUNKED_TRANSFER_H
+
+#include <IceUtil/Shared.h>
+#include <IceUtil/Handle.h>
+#include <IceUtil/Mutex.h>
+#include <IceUtil/Time.h>
+#include <Ice/Object.h>
+#include <Ice/ProxyF.h>
+#include <Ice/Current.h>
+
+namespace Ice
+{
+
+//
+// Chunked transfers move a stream of bytes of any size from a
+// ChunkProducer to a ChunkConsumer as a sequence of requests, each
+// carrying one chunk. The sender pipelines the requests but limits
+// the number of chunks not yet consumed by the receiver, so the
+// memory used by a transfer is bounded on both sides and no message
+// exceeds Ice.MessageSizeMax.
+//
+// This is a helper API built on the dynamic invocation and dispatch
+// API, not a Slice parameter type: the chunks are "chunk" requests
+// sent with ice_invoke to a ChunkReceiver servant. The parameters of
+// each request start with a header encoded like the Slice struct
+//
+//   struct ChunkHeader { string transfer; long seq; int window; bool last; };
+//
+// followed by the chunk data. The request context isn't used by the
+// transfer, the context of the proxy is passed unchanged to the
+// consumer.
+//
+
+class ICE_API ChunkProducer : public IceUtil::Shared
+{
+public:
+
+    //
+    // Fill the buffer with the next chunk of the transfer, of at most
+    // the given number of bytes. Returns false once all the data has
+    // been produced. The data placed in the buffer by the call which
+    // returns false, if any, is sent as the last chunk.
+    //
+    virtual bool produce(std::vector<Byte>&, size_t) = 0;
+};
+typedef IceUtil::Handle<ChunkProducer> ChunkProducerPtr;
+
+class ICE_API ChunkConsumer : public IceUtil::Shared
+{
+public:
+
+    //
+    // Called with each chunk of the transfer, in order. An exception
+    // raised by consume() aborts the transfer.
+    //
+    virtual void consume(const std::pair<const Byte*, const Byte*>&, const Current&) = 0;
+
+    //
+    // Called once all the chunks have been consumed.
+    //
+    virtual void finished(const Current&) = 0;
+
+    //
+    // Called if the sender or the consumer aborted the transfer, or if
+    // the transfer expired. The current is that of the request which
+    // detected it.
+    //
+    virtual void aborted(const Current&) = 0;
+};
+typedef IceUtil::Handle<ChunkConsumer> ChunkConsumerPtr;
+
+//
+// The servant receiving chunked transfers. Subclasses create a
+// consumer for each transfer. Chunks dispatched out of order by a
+// multi-threaded thread pool are held until they can be consumed in
+// order, and chunks beyond the window of the sender are rejected.
+//
+// A transfer which receives no chunk for longer than the idle timeout,
+// for example because its sender died, is aborted by a later request
+// to the receiver.
+//
+class ICE_API ChunkReceiver : public BlobjectArray
+{
+public:
+
+    ChunkReceiver(const IceUtil::Time& = IceUtil::Time::seconds(60));
+    virtual ~ChunkReceiver();
+
+    virtual ChunkConsumerPtr createConsumer(const Current&) = 0;
+
+    virtual bool ice_invoke(const std::pair<const Byte*, const Byte*>&, std::vector<Byte>&, const Current&);
+
+private:
+
+    class Transfer;
+    typedef IceUtil::Handle<Transfer> TransferPtr;
+
+    const IceUtil::Time _idleTimeout;
+
+    IceUtil::Mutex _mutex;
+    std::map<std::string, TransferPtr> _transfers;
+    IceUtil::Time _nextSweep;
+};
+typedef IceUtil::Handle<ChunkReceiver> ChunkReceiverPtr;
+
+//
+// Send the data of the producer to the ChunkReceiver servant
+// designated by the proxy, in chunks of at most chunkSize bytes and
+// with at most window chunks not yet consumed. The call blocks
+// until the transfer completes and returns the number of bytes sent.
+// If a chunk can't be delivered, the transfer is aborted and the
+// exception of the failed request is raised.
+//
+ICE_API Long sendChunked(const ObjectPrx&, const ChunkProducerPtr&, size_t = 256 * 1024, int = 8);
+
+}
+
+#endif
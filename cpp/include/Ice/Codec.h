@@ -0,0 +1,73 @@
+// **********************************************************************
+//
+// Copyright (c) 2003-2011 ZeroC, Inc. All rights reserved.
+//
+// This copy of Ice is licensed to you under the terms described in the
+// ICE_LICENSE file included in this distribution.
+//
+// **********************************************************************
+
+#ifndef ICE_CODEC_H
+#define ICE_CODEC_H
+
+#include <IceUtil/Shared.h>
+#include <Ice/CodecF.h>
+#include <Ice/Config.h>
+
+namespace IceInternal
+{
+
+//
+// The compression status byte of a message header identifies the
+// codec used for the message body. Status 2 is bzip2, the codec
+// supported by all Ice versions. Other codecs use ids 3 to 127. A
+// status with the high bit set denotes an uncompressed message for
+// which the response, if any, should be compressed with the codec
+// identified by the low bits.
+//
+const ::Ice::Byte bzip2CodecId = 2;
+const ::Ice::Byte codecIdMask = 0x7f;
+const ::Ice::Byte compressResponseFlag = 0x80;
+
+class ICE_API Codec : public ::IceUtil::Shared
+{
+public:
+
+    virtual ~Codec();
+
+    //
+    // The compression status byte for messages compressed with this
+    // codec, and the name used by Ice.Compression.Codec.
+    //
+    virtual ::Ice::Byte id() const = 0;
+    virtual ::std::string name() const = 0;
+
+    //
+    // The maximum size of the compressed form of the given number of
+    // bytes.
+    //
+    virtual size_t compressBound(size_t) const = 0;
+
+    //
+    // Compress the source buffer into the destination buffer, which
+    // must be at least compressBound() bytes, and return the
+    // compressed size. The last argument is the compression level (1
+    // to 9), which a codec may ignore.
+    //
+    virtual size_t compress(const ::Ice::Byte*, size_t, ::Ice::Byte*, size_t, int) const = 0;
+
+    //
+    // Uncompress the source buffer into the destination buffer. The
+    // uncompressed data must fill the destination buffer exactly,
+    // otherwise CompressionException is raised.
+    //
+    virtual void uncompress(const ::Ice::Byte*, size_t, ::Ice::Byte*, size_t) const = 0;
+
+protected:
+
+    Codec();
+};
+
+}
+
+#endif
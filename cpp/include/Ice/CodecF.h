@@ -0,0 +1,26 @@
+// **********************************************************************
+//
+// Copyright (c) 2003-2011 ZeroC, Inc. All rights reserved.
+//
+// This copy of Ice is licensed to you under the terms described in the
+// ICE_LICENSE file included in this distribution.
+//
+// **********************************************************************
+
+#ifndef ICE_CODEC_F_H
+#define ICE_CODEC_F_H
+
+#include <IceUtil/Shared.h>
+
+#include <Ice/Handle.h>
+
+namespace IceInternal
+{
+
+class Codec;
+ICE_API IceUtil::Shared* upCast(Codec*);
+typedef Handle<Codec> CodecPtr;
+
+}
+
+#endif
@@ -64,6 +64,17 @@ typedef double Double;
 
 }
 
+//
+// ICE_NATIVE_WIRE_LAYOUT is defined if the byte order and the
+// floating point format of the platform are those of the Ice
+// encoding. The generated code then marshals sequences of fixed-size
+// structs without padding with a single copy, see BasicStream for the
+// ARM floating point format.
+//
+#if defined(ICE_LITTLE_ENDIAN) && !(defined(__arm__) && defined(__linux))
+#   define ICE_NATIVE_WIRE_LAYOUT
+#endif
+
 namespace IceInternal
 {
 
@@ -23,6 +23,17 @@ class ICE_API GCShared : public virtual IceUtil::Shared
 {
 public:
 
+    GCShared() :
+        _gcCandidate(false)
+    {
+    }
+
+    GCShared(const GCShared&) :
+        IceUtil::Shared(),
+        _gcCandidate(false)
+    {
+    }
+
     virtual ~GCShared() {}
 
     GCShared& operator=(const GCShared&)
@@ -46,6 +57,13 @@ public:
 protected:
 
     friend class IceInternal::GC; // Allows IceInternal::GC to read value of _ref.
+
+    //
+    // True if the reference count of this instance was decremented
+    // since the collector last examined it, that is, if it might be
+    // the root of a garbage cycle.
+    //
+    bool _gcCandidate;
 };
 
 }
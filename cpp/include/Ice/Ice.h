@@ -26,6 +26,7 @@
 #include <Ice/OutgoingAsync.h>
 #include <Ice/IncomingAsync.h>
 #include <Ice/Process.h>
+#include <Ice/Metrics.h>
 #include <Ice/Application.h>
 #include <Ice/Connection.h>
 #include <Ice/ConnectionAsync.h>
@@ -36,6 +37,7 @@
 #include <Ice/Router.h>
 #include <Ice/DispatchInterceptor.h>
 #include <Ice/Plugin.h>
+#include <Ice/ChunkedTransfer.h>
 
 #ifndef _WIN32
 #include <Ice/IconvStringConverter.h>
@@ -12,6 +12,7 @@
 
 #include <Ice/InstanceF.h>
 #include <Ice/ConnectionIF.h>
+#include <Ice/ResponseHandlerF.h>
 #include <Ice/ServantLocatorF.h>
 #include <Ice/ServantManagerF.h>
 #include <Ice/BasicStream.h>
@@ -31,7 +32,8 @@ public:
 
 protected:
 
-    IncomingBase(Instance*, Ice::ConnectionI*, const Ice::ObjectAdapterPtr&, bool, Ice::Byte, Ice::Int);
+    IncomingBase(Instance*, ResponseHandler*, Ice::ConnectionI*, const Ice::ObjectAdapterPtr&, bool, Ice::Byte,
+                 Ice::Int);
     IncomingBase(IncomingBase&); // Adopts the argument. It must not be used afterwards.
     
     void __warning(const Ice::Exception&) const;
@@ -42,6 +44,13 @@ protected:
     void __handleException(const std::exception&);
     void __handleException();
 
+    //
+    // Send the response, recording the dispatch metrics if metrics
+    // are enabled. The boolean is false if the dispatch failed.
+    //
+    void __sendResponse(bool);
+    void __sendNoResponse(bool);
+
     Ice::Current _current;
     Ice::ObjectPtr _servant;
     Ice::ServantLocatorPtr _locator;
@@ -53,11 +62,25 @@ protected:
     BasicStream _os;
 
     //
-    // Optimization. The connection may not be deleted while a
-    // stack-allocated Incoming still holds it.
+    // Optimization. The response handler and the connection may not
+    // be deleted while a stack-allocated Incoming still holds them.
+    // The response handler is reset once the response is sent. The
+    // connection is null for collocated requests.
     //
+    ResponseHandler* _responseHandler;
     Ice::ConnectionI* _connection;
 
+    //
+    // The start time of the dispatch in microseconds and the size of
+    // the request parameters, only set if metrics are enabled. The
+    // dispatch isn't recorded under its operation name if the target
+    // object, facet or operation doesn't exist, as the name could be
+    // any string read from the request.
+    //
+    IceUtil::Int64 _dispatchStart;
+    Ice::Int _bytesIn;
+    bool _notExist;
+
     std::deque<Ice::DispatchInterceptorAsyncCallbackPtr> _interceptorAsyncCallbackQueue;
 };
 
@@ -65,7 +88,7 @@ class ICE_API Incoming : public IncomingBase
 {
 public:
 
-    Incoming(Instance*, Ice::ConnectionI*, const Ice::ObjectAdapterPtr&, bool, Ice::Byte, Ice::Int);
+    Incoming(Instance*, ResponseHandler*, Ice::ConnectionI*, const Ice::ObjectAdapterPtr&, bool, Ice::Byte, Ice::Int);
 
     const Ice::Current& getCurrent()
     {
@@ -64,10 +64,18 @@ private:
     const InstancePtr _instanceCopy;
 
     //
-    // We need a separate ConnectionIPtr, because IncomingBase only
-    // holds a ConnectionI* for optimization.
+    // We need a separate ResponseHandlerPtr, because IncomingBase only
+    // holds a ResponseHandler* for optimization.
     //
-    const Ice::ConnectionIPtr _connectionCopy;
+    const ResponseHandlerPtr _responseHandlerCopy;
+
+    //
+    // Keeps the request received by the connection alive for as long
+    // as this callback, so that in-parameters which refer to the
+    // request (such as cpp:array and cpp:range parameters) remain
+    // valid after the dispatch returns.
+    //
+    const SharedBufferPtr _requestBuffer;
 
     const bool _retriable;
     bool _active;
@@ -77,6 +77,7 @@ class ICE_API Outgoing : public OutgoingMessageCallback
 public:
 
     Outgoing(RequestHandler*, const std::string&, Ice::OperationMode, const Ice::Context*);
+    ~Outgoing();
 
     bool invoke(); // Returns true if ok, false if user exception.
     void abort(const Ice::LocalException&);
@@ -114,6 +115,14 @@ private:
     BasicStream _os;
     bool _sent;
 
+    //
+    // The start time of the invocation in microseconds and the start
+    // of the parameter encapsulation, only set if metrics are enabled.
+    //
+    const std::string& _operation;
+    IceUtil::Int64 _invokeStart;
+    size_t _encapsStart;
+
     //
     // NOTE: we use an attribute for the monitor instead of inheriting
     // from the monitor template.  Otherwise, the template would be
@@ -122,6 +122,8 @@ protected:
     void __warning(const std::exception&) const;
     void __warning() const;
 
+    void __invoked(bool);
+
     virtual ~AsyncResult(); // Must be heap-allocated.
 
     const IceInternal::InstancePtr _instance;
@@ -141,6 +143,13 @@ protected:
     unsigned char _state;
     bool _sentSynchronously;
     std::auto_ptr<Exception> _exception;
+
+    //
+    // The start time of the invocation in microseconds and the start
+    // of the parameter encapsulation, only set if metrics are enabled.
+    //
+    IceUtil::Int64 _invokeStart;
+    size_t _encapsStart;
 };
 
 }
@@ -14,6 +14,7 @@
 #include <Ice/ProtocolPluginFacadeF.h>
 #include <Ice/CommunicatorF.h>
 #include <Ice/EndpointFactoryF.h>
+#include <Ice/CodecF.h>
 #include <Ice/InstanceF.h>
 #include <Ice/EndpointIF.h>
 #include <Ice/Protocol.h>
@@ -72,6 +73,16 @@ public:
     //
     EndpointFactoryPtr getEndpointFactory(Ice::Short) const;
 
+    //
+    // Register a compression Codec.
+    //
+    void addCodec(const CodecPtr&) const;
+
+    //
+    // Get a Codec by id.
+    //
+    CodecPtr getCodec(Ice::Byte) const;
+
 private:
 
     ProtocolPluginFacade(const Ice::CommunicatorPtr&);
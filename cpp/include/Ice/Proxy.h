@@ -162,6 +162,9 @@ class ICE_API Object : public ::IceUtil::Shared, private ::IceUtil::Mutex
 {
 public:
 
+    Object();
+    virtual ~Object();
+
     bool operator==(const Object&) const;
     bool operator!=(const Object&) const;
     bool operator<(const Object&) const;
@@ -677,8 +680,19 @@ private:
     void setup(const ::IceInternal::ReferencePtr&);
     friend class ::IceInternal::ProxyFactory;
 
+    struct Variants;
+    ::Ice::ObjectPrx changeMode(int) const;
+    bool isStale() const;
+
     ::IceInternal::ReferencePtr _reference;
     ::IceInternal::Handle< ::IceDelegate::Ice::Object> _delegate;
+    bool _delegateReset;
+
+    //
+    // The proxies returned by the mode methods, ice_secure(),
+    // ice_timeout() and ice_context(), allocated on first use.
+    //
+    mutable Variants* _variants;
 };
 
 } }
@@ -767,6 +781,7 @@ protected:
 
     ::IceInternal::ReferencePtr __reference;
     ::Ice::ObjectAdapterPtr __adapter;
+    ::IceInternal::RequestHandlerPtr __handler;
 
     void __initCurrent(::Ice::Current&, const ::std::string&, ::Ice::OperationMode, const ::Ice::Context*);
 
@@ -16,15 +16,20 @@
 
 #   include <IceUtil/Mutex.h>
 
-// Using the gcc builtins requires gcc 4.1 or better. For Linux, i386
-// doesn't work. Apple is supported for all architectures. Sun only
-// supports sparc (32 and 64 bit).
-
-#elif __GNUC__ >= 4 && __GNUC_MINOR__ >= 1 && \
+// Using the gcc builtins requires gcc 4.1 or better (clang also
+// provides them). On Linux, they are used on any architecture where
+// the compiler implements them without a library call, which gcc 4.3
+// and later report with __GCC_HAVE_SYNC_COMPARE_AND_SWAP_4; this
+// includes x86_64, aarch64 and ppc64le but not i386. Apple is
+// supported for all architectures. Sun only supports sparc (32 and
+// 64 bit).
+
+#elif (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 1)) && \
 	((defined(__sun) && (defined(__sparc) || defined(__sparcv9))) || \
 	 defined(__APPLE__) || \
 	(defined(__linux) && \
-		(defined(__i486) || defined(__i586) || \
+		(defined(__GCC_HAVE_SYNC_COMPARE_AND_SWAP_4) || \
+		 defined(__i486) || defined(__i586) || \
 		 defined(__i686) || defined(__x86_64))))
 
 #   define ICE_HAS_GCC_BUILTINS
@@ -43,6 +43,13 @@ typedef IceUtil::Handle<TimerTask> TimerTaskPtr;
 // repeated execution. Tasks are executed by the dedicated timer thread 
 // sequentially.
 //
+// By default, the tasks are kept ordered by execution time, which
+// makes scheduling and cancelling a task O(log n). A timer constructed
+// with a tick instead keeps them in a hierarchical timing wheel, where
+// both are O(1): tasks run at the first tick following their
+// execution time, and tasks due at the same tick run in no particular
+// order.
+//
 class ICE_UTIL_API Timer : public virtual IceUtil::Shared, private virtual IceUtil::Thread
 {
 public:
@@ -58,6 +65,20 @@ public:
     //
     Timer(int priority);
 
+    //
+    // Construct a timer using a timing wheel with the given tick and
+    // starts its execution thread.
+    //
+    Timer(const IceUtil::Time&);
+
+    //
+    // Construct a timer using a timing wheel with the given tick and
+    // starts its execution thread with the priority.
+    //
+    Timer(const IceUtil::Time&, int priority);
+
+    virtual ~Timer();
+
     //
     // Destroy the timer and detach its execution thread if the calling thread 
     // is the timer thread, join the timer execution thread otherwise.
@@ -95,7 +116,10 @@ private:
         inline bool operator<(const Token& r) const;
     };
 
+    class Wheel;
+
     virtual void run();
+    void runWheel();
 
     IceUtil::Monitor<IceUtil::Mutex> _monitor;
     bool _destroyed;
@@ -112,6 +136,7 @@ private:
     };
     std::map<TimerTaskPtr, IceUtil::Time, TimerTaskCompare> _tasks;
     IceUtil::Time _wakeUpTime;
+    Wheel* _wheel;
 };
 typedef IceUtil::Handle<Timer> TimerPtr;
 
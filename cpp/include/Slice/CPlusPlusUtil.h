@@ -64,6 +64,33 @@ SLICE_API std::string findMetaData(const SequencePtr&, const StringList&, bool&,
 SLICE_API std::string findMetaData(const StringList&, int = 0);
 SLICE_API bool inWstringModule(const SequencePtr&);
 
+//
+// Returns true if the encoding of the given type can match the C++
+// layout: the type is a fixed-size numeric builtin or a struct with
+// only such members. The size is the encoded size, the alignment the
+// size of the largest builtin member. The C++ layout matches if the
+// sizeof the generated type is equal to the encoded size.
+//
+SLICE_API bool hasWireLayout(const TypePtr&, size_t&, size_t&);
+
+//
+// Computes the encoded size of the value of the given type and
+// parameter name: fixed sizes are added to the size argument, and
+// expressions that compute variable sizes are appended to the terms.
+// Returns false if the size can't be computed in advance because the
+// type contains classes or proxies.
+//
+SLICE_API bool getEncodedSize(const TypePtr&, const std::string&, const StringList&, int, size_t&, StringList&);
+SLICE_API std::string encodedSizeToString(size_t, const StringList&);
+
+//
+// Writes the code that expands the stream for the parameters about to
+// be marshaled, so that it's not reallocated while they are written.
+// The parameters whose size can't be computed in advance are ignored.
+//
+SLICE_API void writeExpandCode(::IceUtilInternal::Output&, const ParamDeclList&, const TypePtr&,
+                               const StringList&, int = 0);
+
 }
 
 #endif
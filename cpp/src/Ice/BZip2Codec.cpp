@@ -0,0 +1,137 @@
+// **********************************************************************
+//
+// Copyright (c) 2003-2011 ZeroC, Inc. All rights reserved.
+//
+// This copy of Ice is licensed to you under the terms described in the
+// ICE_LICENSE file included in this distribution.
+//
+// **********************************************************************
+
+#include <Ice/BZip2Codec.h>
+#include <Ice/LocalException.h>
+#include <bzlib.h>
+
+using namespace std;
+using namespace Ice;
+using namespace IceInternal;
+
+namespace
+{
+
+string
+getBZ2Error(int bzError)
+{
+    if(bzError == BZ_RUN_OK)
+    {
+        return ": BZ_RUN_OK";
+    }
+    else if(bzError == BZ_FLUSH_OK)
+    {
+        return ": BZ_FLUSH_OK";
+    }
+    else if(bzError == BZ_FINISH_OK)
+    {
+        return ": BZ_FINISH_OK";
+    }
+    else if(bzError == BZ_STREAM_END)
+    {
+        return ": BZ_STREAM_END";
+    }
+    else if(bzError == BZ_CONFIG_ERROR)
+    {
+        return ": BZ_CONFIG_ERROR";
+    }
+    else if(bzError == BZ_SEQUENCE_ERROR)
+    {
+        return ": BZ_SEQUENCE_ERROR";
+    }
+    else if(bzError == BZ_PARAM_ERROR)
+    {
+        return ": BZ_PARAM_ERROR";
+    }
+    else if(bzError == BZ_MEM_ERROR)
+    {
+        return ": BZ_MEM_ERROR";
+    }
+    else if(bzError == BZ_DATA_ERROR)
+    {
+        return ": BZ_DATA_ERROR";
+    }
+    else if(bzError == BZ_DATA_ERROR_MAGIC)
+    {
+        return ": BZ_DATA_ERROR_MAGIC";
+    }
+    else if(bzError == BZ_IO_ERROR)
+    {
+        return ": BZ_IO_ERROR";
+    }
+    else if(bzError == BZ_UNEXPECTED_EOF)
+    {
+        return ": BZ_UNEXPECTED_EOF";
+    }
+    else if(bzError == BZ_OUTBUFF_FULL)
+    {
+        return ": BZ_OUTBUFF_FULL";
+    }
+    else
+    {
+        return "";
+    }
+}
+
+}
+
+Byte
+IceInternal::BZip2Codec::id() const
+{
+    return bzip2CodecId;
+}
+
+string
+IceInternal::BZip2Codec::name() const
+{
+    return "bzip2";
+}
+
+size_t
+IceInternal::BZip2Codec::compressBound(size_t len) const
+{
+    return static_cast<size_t>(len * 1.01 + 600);
+}
+
+size_t
+IceInternal::BZip2Codec::compress(const Byte* src, size_t srcLen, Byte* dst, size_t dstLen, int level) const
+{
+    unsigned int compressedLen = static_cast<unsigned int>(dstLen);
+    int bzError = BZ2_bzBuffToBuffCompress(reinterpret_cast<char*>(dst), &compressedLen,
+                                           reinterpret_cast<char*>(const_cast<Byte*>(src)),
+                                           static_cast<unsigned int>(srcLen), level, 0, 0);
+    if(bzError != BZ_OK)
+    {
+        CompressionException ex(__FILE__, __LINE__);
+        ex.reason = "BZ2_bzBuffToBuffCompress failed" + getBZ2Error(bzError);
+        throw ex;
+    }
+    return compressedLen;
+}
+
+void
+IceInternal::BZip2Codec::uncompress(const Byte* src, size_t srcLen, Byte* dst, size_t dstLen) const
+{
+    unsigned int uncompressedLen = static_cast<unsigned int>(dstLen);
+    int bzError = BZ2_bzBuffToBuffDecompress(reinterpret_cast<char*>(dst), &uncompressedLen,
+                                             reinterpret_cast<char*>(const_cast<Byte*>(src)),
+                                             static_cast<unsigned int>(srcLen), 0, 0);
+    if(bzError != BZ_OK)
+    {
+        CompressionException ex(__FILE__, __LINE__);
+        ex.reason = "BZ2_bzBuffToBuffDecompress failed" + getBZ2Error(bzError);
+        throw ex;
+    }
+    if(uncompressedLen != dstLen)
+    {
+        CompressionException ex(__FILE__, __LINE__);
+        ex.reason = "BZ2_bzBuffToBuffDecompress failed: uncompressed data is shorter than expected";
+        throw ex;
+    }
+}
@@ -0,0 +1,31 @@
+// **********************************************************************
+//
+// Copyright (c) 2003-2011 ZeroC, Inc. All rights reserved.
+//
+// This copy of Ice is licensed to you under the terms described in the
+// ICE_LICENSE file included in this distribution.
+//
+// **********************************************************************
+
+#ifndef ICE_BZIP2_CODEC_H
+#define ICE_BZIP2_CODEC_H
+
+#include <Ice/Codec.h>
+
+namespace IceInternal
+{
+
+class BZip2Codec : public Codec
+{
+public:
+
+    virtual ::Ice::Byte id() const;
+    virtual ::std::string name() const;
+    virtual size_t compressBound(size_t) const;
+    virtual size_t compress(const ::Ice::Byte*, size_t, ::Ice::Byte*, size_t, int) const;
+    virtual void uncompress(const ::Ice::Byte*, size_t, ::Ice::Byte*, size_t) const;
+};
+
+}
+
+#endif
@@ -23,6 +23,7 @@
 #include <Ice/TraceLevels.h>
 #include <Ice/LoggerUtil.h>
 #include <Ice/StringConverter.h>
+#include <Ice/HashTable.h>
 #include <IceUtil/Unicode.h>
 #include <iterator>
 
@@ -30,6 +31,51 @@ using namespace std;
 using namespace Ice;
 using namespace IceInternal;
 
+struct IceInternal::BasicStream::ReadTables
+{
+    void clear()
+    {
+        unmarshaledMap.clear();
+        patchMap.clear();
+        typeIds.clear();
+    }
+
+    HashTable<Int, ObjectPtr, IntHash> unmarshaledMap;
+    HashTable<Int, PatchList, IntHash> patchMap;
+
+    //
+    // Type ids are assigned sequential indexes starting at 1, the id
+    // with index i is typeIds[i - 1].
+    //
+    vector<string> typeIds;
+};
+
+struct IceInternal::BasicStream::WriteTables
+{
+    WriteTables() : marshaled(0)
+    {
+    }
+
+    void clear()
+    {
+        indexMap.clear();
+        instances.clear();
+        marshaled = 0;
+        typeIdMap.clear();
+    }
+
+    //
+    // The index of an instance is its position in instances plus 1.
+    // The instances before marshaled are marshaled, the others are
+    // marshaled by the next call to writePendingObjects().
+    //
+    HashTable<const Object*, Int, PointerHash> indexMap;
+    vector<ObjectPtr> instances;
+    size_t marshaled;
+
+    HashTable<string, Int, StringHash> typeIdMap;
+};
+
 namespace
 {
 
@@ -77,11 +123,13 @@ private:
 }
 
 IceInternal::BasicStream::BasicStream(Instance* instance, bool unlimited) :
-    IceInternal::Buffer(instance->messageSizeMax()),
+    IceInternal::Buffer(instance->messageSizeMax(), instance->bufferPool()),
     _instance(instance),
     _closure(0),
     _currentReadEncaps(0),
     _currentWriteEncaps(0),
+    _readTables(0),
+    _writeTables(0),
     _traceSlicing(-1),
     _sliceObjects(true),
     _messageSizeMax(_instance->messageSizeMax()), // Cached for efficiency.
@@ -102,6 +150,10 @@ IceInternal::BasicStream::clear()
         _currentReadEncaps = _currentReadEncaps->previous;
         delete oldEncaps;
     }
+    if(_preAllocatedReadEncaps.tables)
+    {
+        releaseTables(&_preAllocatedReadEncaps);
+    }
 
     while(_currentWriteEncaps && _currentWriteEncaps != &_preAllocatedWriteEncaps)
     {
@@ -109,6 +161,10 @@ IceInternal::BasicStream::clear()
         _currentWriteEncaps = _currentWriteEncaps->previous;
         delete oldEncaps;
     }
+    if(_preAllocatedWriteEncaps.tables)
+    {
+        releaseTables(&_preAllocatedWriteEncaps);
+    }
 
     _startSeq = -1;
 
@@ -187,20 +243,26 @@ IceInternal::BasicStream::swap(BasicStream& other)
     std::swap(_unlimited, other._unlimited);
 }
 
+IceInternal::BasicStream::WriteEncaps::~WriteEncaps()
+{
+    delete tables;
+}
+
 void
 IceInternal::BasicStream::WriteEncaps::swap(WriteEncaps& other)
 {
     std::swap(start, other.start);
 
-    std::swap(writeIndex, other.writeIndex);
-    std::swap(toBeMarshaledMap, other.toBeMarshaledMap);
-    std::swap(marshaledMap, other.marshaledMap);
-    std::swap(typeIdMap, other.typeIdMap);
-    std::swap(typeIdIndex, other.typeIdIndex);
+    std::swap(tables, other.tables);
 
     std::swap(previous, other.previous);
 }
 
+IceInternal::BasicStream::ReadEncaps::~ReadEncaps()
+{
+    delete tables;
+}
+
 void
 IceInternal::BasicStream::ReadEncaps::swap(ReadEncaps& other)
 {
@@ -210,10 +272,7 @@ IceInternal::BasicStream::ReadEncaps::swap(ReadEncaps& other)
     std::swap(encodingMajor, other.encodingMajor);
     std::swap(encodingMinor, other.encodingMinor);
 
-    std::swap(patchMap, other.patchMap);
-    std::swap(unmarshaledMap, other.unmarshaledMap);
-    std::swap(typeIdMap, other.typeIdMap);
-    std::swap(typeIdIndex, other.typeIdIndex);
+    std::swap(tables, other.tables);
 
     std::swap(previous, other.previous);
 }
@@ -372,7 +431,7 @@ IceInternal::BasicStream::readAndCheckSeqSize(int minSize, Ice::Int& sz)
 void
 IceInternal::BasicStream::writeTypeId(const string& id)
 {
-    if(!_currentWriteEncaps || !_currentWriteEncaps->typeIdMap)
+    if(!_currentWriteEncaps || !_currentWriteEncaps->tables)
     {
         //
         // write(ObjectPtr) must be called first.
@@ -380,15 +439,16 @@ IceInternal::BasicStream::writeTypeId(const string& id)
         throw MarshalException(__FILE__, __LINE__, "type ids require an encapsulation");
     }
 
-    TypeIdWriteMap::const_iterator k = _currentWriteEncaps->typeIdMap->find(id);
-    if(k != _currentWriteEncaps->typeIdMap->end())
+    HashTable<string, Int, StringHash>& typeIdMap = _currentWriteEncaps->tables->typeIdMap;
+    HashTable<string, Int, StringHash>::iterator p = typeIdMap.find(id);
+    if(p != typeIdMap.end())
     {
         write(true);
-        writeSize(k->second);
+        writeSize(p->second);
     }
     else
     {
-        _currentWriteEncaps->typeIdMap->insert(make_pair(id, ++_currentWriteEncaps->typeIdIndex));
+        typeIdMap.insert(id, static_cast<Int>(typeIdMap.size()) + 1);
         write(false);
         write(id, false);
     }
@@ -397,7 +457,7 @@ IceInternal::BasicStream::writeTypeId(const string& id)
 void
 IceInternal::BasicStream::readTypeId(string& id)
 {
-    if(!_currentReadEncaps || !_currentReadEncaps->typeIdMap)
+    if(!_currentReadEncaps || !_currentReadEncaps->tables)
     {
         //
         // read(PatchFunc, void*) must be called first.
@@ -405,23 +465,23 @@ IceInternal::BasicStream::readTypeId(string& id)
         throw MarshalException(__FILE__, __LINE__, "type ids require an encapsulation");
     }
 
+    vector<string>& typeIds = _currentReadEncaps->tables->typeIds;
     bool isIndex;
     read(isIndex);
     if(isIndex)
     {
         Ice::Int index;
         readSize(index);
-        TypeIdReadMap::const_iterator k = _currentReadEncaps->typeIdMap->find(index);
-        if(k == _currentReadEncaps->typeIdMap->end())
+        if(index < 1 || index > static_cast<Int>(typeIds.size()))
         {
             throw UnmarshalOutOfBoundsException(__FILE__, __LINE__);
         }
-        id = k->second;
+        id = typeIds[index - 1];
     }
     else
     {
         read(id, false);
-        _currentReadEncaps->typeIdMap->insert(make_pair(++_currentReadEncaps->typeIdIndex, id));
+        typeIds.push_back(id);
     }
 }
 
@@ -1697,42 +1757,34 @@ IceInternal::BasicStream::write(const ObjectPtr& v)
         _currentWriteEncaps->start = b.size();
     }
 
-    if(!_currentWriteEncaps->toBeMarshaledMap) // Lazy initialization.
+    if(!_currentWriteEncaps->tables) // Lazy initialization.
     {
-        _currentWriteEncaps->toBeMarshaledMap = new PtrToIndexMap;
-        _currentWriteEncaps->marshaledMap = new PtrToIndexMap;
-        _currentWriteEncaps->typeIdMap = new TypeIdWriteMap;
+        _currentWriteEncaps->tables = writeTables();
     }
 
     if(v)
     {
-        //
-        // Look for this instance in the to-be-marshaled map.
-        //
-        PtrToIndexMap::iterator p = _currentWriteEncaps->toBeMarshaledMap->find(v);
-        if(p == _currentWriteEncaps->toBeMarshaledMap->end())
+        WriteTables* tables = _currentWriteEncaps->tables;
+        HashTable<const Object*, Int, PointerHash>::iterator p = tables->indexMap.find(v.get());
+        Int index;
+        if(p != tables->indexMap.end())
+        {
+            index = p->second;
+        }
+        else
         {
             //
-            // Didn't find it, try the marshaled map next.
+            // We haven't seen this instance previously, create a new
+            // index. The instance is marshaled by the next call to
+            // writePendingObjects().
             //
-            PtrToIndexMap::iterator q = _currentWriteEncaps->marshaledMap->find(v);
-            if(q == _currentWriteEncaps->marshaledMap->end())
-            {
-                //
-                // We haven't seen this instance previously, create a
-                // new index, and insert it into the to-be-marshaled
-                // map.
-                //
-                q = _currentWriteEncaps->toBeMarshaledMap->insert(
-                    _currentWriteEncaps->toBeMarshaledMap->end(),
-                    pair<const ObjectPtr, Int>(v, ++_currentWriteEncaps->writeIndex));
-            }
-            p = q;
+            tables->instances.push_back(v);
+            index = tables->indexMap.insert(v.get(), static_cast<Int>(tables->instances.size()));
         }
         //
         // Write the index for the instance.
         //
-        write(-(p->second));
+        write(-index);
     }
     else
     {
@@ -1748,11 +1800,9 @@ IceInternal::BasicStream::read(PatchFunc patchFunc, void* patchAddr)
         _currentReadEncaps = &_preAllocatedReadEncaps;
     }
 
-    if(!_currentReadEncaps->patchMap) // Lazy initialization.
+    if(!_currentReadEncaps->tables) // Lazy initialization.
     {
-        _currentReadEncaps->patchMap = new PatchMap;
-        _currentReadEncaps->unmarshaledMap = new IndexToPtrMap;
-        _currentReadEncaps->typeIdMap = new TypeIdReadMap;
+        _currentReadEncaps->tables = readTables();
     }
 
     ObjectPtr v;
@@ -1772,14 +1822,33 @@ IceInternal::BasicStream::read(PatchFunc patchFunc, void* patchAddr)
 
         if(index < 0)
         {
-            PatchMap::iterator p = _currentReadEncaps->patchMap->find(-index);
-            if(p == _currentReadEncaps->patchMap->end())
+            ReadTables* tables = _currentReadEncaps->tables;
+
+            //
+            // Patch the pointer right away if we have already
+            // unmarshaled the instance for that index.
+            //
+            HashTable<Int, ObjectPtr, IntHash>::iterator p = tables->unmarshaledMap.find(-index);
+            if(p != tables->unmarshaledMap.end())
+            {
+                v = p->second;
+                patchFunc(patchAddr, v);
+                return;
+            }
+
+            HashTable<Int, PatchList, IntHash>::iterator q = tables->patchMap.find(-index);
+            PatchList* l;
+            if(q != tables->patchMap.end())
+            {
+                l = &q->second;
+            }
+            else
             {
                 //
                 // We have no outstanding instances to be patched for this
                 // index, so make a new entry in the patch map.
                 //
-                p = _currentReadEncaps->patchMap->insert(make_pair(-index, PatchList())).first;
+                l = &tables->patchMap.insert(-index, PatchList());
             }
             //
             // Append a patch entry for this instance.
@@ -1787,8 +1856,7 @@ IceInternal::BasicStream::read(PatchFunc patchFunc, void* patchAddr)
             PatchEntry e;
             e.patchFunc = patchFunc;
             e.patchAddr = patchAddr;
-            p->second.push_back(e);
-            patchPointers(-index, _currentReadEncaps->unmarshaledMap->end(), p);
+            l->push_back(e);
             return;
         }
     }
@@ -1875,8 +1943,16 @@ IceInternal::BasicStream::read(PatchFunc patchFunc, void* patchAddr)
             }
         }
 
-        IndexToPtrMap::const_iterator unmarshaledPos =
-                            _currentReadEncaps->unmarshaledMap->insert(make_pair(index, v)).first;
+        ReadTables* tables = _currentReadEncaps->tables;
+        HashTable<Int, ObjectPtr, IntHash>::iterator p = tables->unmarshaledMap.find(index);
+        if(p != tables->unmarshaledMap.end())
+        {
+            p->second = v;
+        }
+        else
+        {
+            tables->unmarshaledMap.insert(index, v);
+        }
 
         //
         // Record each object instance so that readPendingObjects can
@@ -1890,7 +1966,30 @@ IceInternal::BasicStream::read(PatchFunc patchFunc, void* patchAddr)
         _objectList->push_back(v);
 
         v->__read(this, false);
-        patchPointers(index, unmarshaledPos, _currentReadEncaps->patchMap->end());
+
+        //
+        // Patch the pointers that refer to the instance just
+        // unmarshaled. The table may have been modified while the
+        // instance was unmarshaled, so the patch list is looked up
+        // again.
+        //
+        HashTable<Int, PatchList, IntHash>& patchMap = _currentReadEncaps->tables->patchMap;
+        HashTable<Int, PatchList, IntHash>::iterator q = patchMap.find(index);
+        if(q != patchMap.end())
+        {
+            PatchList* l = &q->second;
+            assert(l->size() > 0);
+            for(PatchList::iterator k = l->begin(); k != l->end(); ++k)
+            {
+                (*k->patchFunc)(k->patchAddr, v);
+            }
+
+            //
+            // Clear out the patch map for that index -- there is
+            // nothing left to patch for that index for the time being.
+            //
+            patchMap.erase(index);
+        }
         return;
     }
 
@@ -1996,36 +2095,25 @@ IceInternal::BasicStream::throwException()
 void
 IceInternal::BasicStream::writePendingObjects()
 {
-    if(_currentWriteEncaps && _currentWriteEncaps->toBeMarshaledMap)
+    if(_currentWriteEncaps && _currentWriteEncaps->tables)
     {
-        while(_currentWriteEncaps->toBeMarshaledMap->size())
+        WriteTables* tables = _currentWriteEncaps->tables;
+        while(tables->marshaled < tables->instances.size())
         {
-            PtrToIndexMap savedMap = *_currentWriteEncaps->toBeMarshaledMap;
-            writeSize(static_cast<Int>(savedMap.size()));
-            for(PtrToIndexMap::iterator p = savedMap.begin(); p != savedMap.end(); ++p)
-            {
-                //
-                // Add an instance from the old to-be-marshaled map to
-                // the marshaled map and then ask the instance to
-                // marshal itself. Any new class instances that are
-                // triggered by the classes marshaled are added to
-                // toBeMarshaledMap.
-                //
-                _currentWriteEncaps->marshaledMap->insert(*p);
-                writeInstance(p->first, p->second);
-            }
-
             //
-            // We have marshaled all the instances for this pass,
-            // substract what we have marshaled from the
-            // toBeMarshaledMap.
+            // Marshal the instances which are not marshaled yet. Any
+            // new class instances that are triggered by the classes
+            // marshaled are appended to the instances and marshaled
+            // by the next pass.
             //
-            PtrToIndexMap newMap;
-            set_difference(_currentWriteEncaps->toBeMarshaledMap->begin(),
-                           _currentWriteEncaps->toBeMarshaledMap->end(),
-                           savedMap.begin(), savedMap.end(),
-                           insert_iterator<PtrToIndexMap>(newMap, newMap.begin()));
-            *_currentWriteEncaps->toBeMarshaledMap = newMap;
+            size_t end = tables->instances.size();
+            writeSize(static_cast<Int>(end - tables->marshaled));
+            while(tables->marshaled < end)
+            {
+                ObjectPtr v = tables->instances[tables->marshaled];
+                ++tables->marshaled;
+                writeInstance(v, static_cast<Int>(tables->marshaled));
+            }
         }
     }
     writeSize(0); // Zero marker indicates end of sequence of sequences of instances.
@@ -2045,7 +2133,7 @@ IceInternal::BasicStream::readPendingObjects()
     }
     while(num);
 
-    if(_currentReadEncaps && _currentReadEncaps->patchMap && _currentReadEncaps->patchMap->size() != 0)
+    if(_currentReadEncaps && _currentReadEncaps->tables && !_currentReadEncaps->tables->patchMap.empty())
     {
         //
         // If any entries remain in the patch map, the sender has sent an index for an object, but failed
@@ -2132,65 +2220,77 @@ IceInternal::BasicStream::writeInstance(const ObjectPtr& v, Int index)
     v->__write(this);
 }
 
-void
-IceInternal::BasicStream::patchPointers(Int index, IndexToPtrMap::const_iterator unmarshaledPos,
-                                        PatchMap::iterator patchPos)
+BasicStream::ReadTables*
+IceInternal::BasicStream::readTables()
 {
-    //
-    // Called whenever we have unmarshaled a new instance. The index
-    // is the index of the instance.  UnmarshaledPos denotes the
-    // instance just unmarshaled and patchPos denotes the patch map
-    // entry for the index just unmarshaled. (Exactly one of these two
-    // iterators must be end().)  Patch any pointers in the patch map
-    // with the new address.
-    //
-    assert(   (unmarshaledPos != _currentReadEncaps->unmarshaledMap->end()
-               && patchPos == _currentReadEncaps->patchMap->end())
-           || (unmarshaledPos == _currentReadEncaps->unmarshaledMap->end()
-               && patchPos != _currentReadEncaps->patchMap->end())
-          );
-
-    if(unmarshaledPos != _currentReadEncaps->unmarshaledMap->end())
+    ReadTables* tables = _readTables;
+    if(tables)
     {
-        //
-        // We have just unmarshaled an instance -- check if something
-        // needs patching for that instance.
-        //
-        patchPos = _currentReadEncaps->patchMap->find(index);
-        if(patchPos == _currentReadEncaps->patchMap->end())
-        {
-            return; // We don't have anything to patch for the instance just unmarshaled.
-        }
+        _readTables = 0;
     }
     else
     {
-        //
-        // We have just unmarshaled an index -- check if we have
-        // unmarshaled the instance for that index yet.
-        //
-        unmarshaledPos = _currentReadEncaps->unmarshaledMap->find(index);
-        if(unmarshaledPos == _currentReadEncaps->unmarshaledMap->end())
-        {
-            return; // We haven't unmarshaled the instance yet.
-        }
+        tables = new ReadTables;
     }
-    assert(patchPos->second.size() > 0);
+    return tables;
+}
 
-    ObjectPtr v = unmarshaledPos->second;
-    assert(v);
+BasicStream::WriteTables*
+IceInternal::BasicStream::writeTables()
+{
+    WriteTables* tables = _writeTables;
+    if(tables)
+    {
+        _writeTables = 0;
+    }
+    else
+    {
+        tables = new WriteTables;
+    }
+    return tables;
+}
 
+void
+IceInternal::BasicStream::releaseTables(ReadEncaps* encaps)
+{
     //
-    // Patch all pointers that refer to the instance.
+    // Keep the tables of the encapsulation for the next
+    // encapsulation, unless the stream already keeps tables from a
+    // nested encapsulation.
     //
-    for(PatchList::iterator k = patchPos->second.begin(); k != patchPos->second.end(); ++k)
+    if(_readTables)
     {
-        (*k->patchFunc)(k->patchAddr, v);
+        delete encaps->tables;
     }
+    else
+    {
+        encaps->tables->clear();
+        _readTables = encaps->tables;
+    }
+    encaps->tables = 0;
+}
 
-    //
-    // Clear out the patch map for that index -- there is nothing left
-    // to patch for that index for the time being.
-    //
-    _currentReadEncaps->patchMap->erase(patchPos);
+void
+IceInternal::BasicStream::releaseTables(WriteEncaps* encaps)
+{
+    if(_writeTables)
+    {
+        delete encaps->tables;
+    }
+    else
+    {
+        encaps->tables->clear();
+        _writeTables = encaps->tables;
+    }
+    encaps->tables = 0;
+}
+
+void
+IceInternal::BasicStream::deleteTables()
+{
+    delete _readTables;
+    _readTables = 0;
+    delete _writeTables;
+    _writeTables = 0;
 }
 
@@ -8,12 +8,58 @@
 // **********************************************************************
 
 #include <Ice/Buffer.h>
+#include <Ice/BufferPool.h>
 #include <Ice/LocalException.h>
 
 using namespace std;
 using namespace Ice;
 using namespace IceInternal;
 
+namespace IceInternal
+{
+
+//
+// Memory adopted from a container by Buffer::Container::share().
+//
+class SharedBuffer : public IceUtil::Shared
+{
+public:
+
+    SharedBuffer(Byte* buf, size_t capacity, BufferPool* pool) :
+        _buf(buf),
+        _capacity(capacity),
+        _pool(pool)
+    {
+    }
+
+    virtual ~SharedBuffer()
+    {
+        if(_pool)
+        {
+            _pool->release(_buf, _capacity);
+        }
+        else
+        {
+            ::free(_buf);
+        }
+    }
+
+private:
+
+    Byte* const _buf;
+    const size_t _capacity;
+
+    //
+    // The pool must outlive the memory allocated from it, which may
+    // be referenced after the communicator is destroyed.
+    //
+    const BufferPoolPtr _pool;
+};
+
+}
+
+IceUtil::Shared* IceInternal::upCast(SharedBuffer* p) { return p; }
+
 void
 IceInternal::Buffer::swapBuffer(Buffer& other)
 {
@@ -21,17 +67,31 @@ IceInternal::Buffer::swapBuffer(Buffer& other)
     std::swap(i, other.i); 
 }
 
-IceInternal::Buffer::Container::Container(size_type maxCapacity) :
+IceInternal::Buffer::Container::Container(size_type maxCapacity, BufferPool* pool) :
     _buf(0),
     _size(0),
     _capacity(0),
-    _maxCapacity(maxCapacity)
+    _maxCapacity(maxCapacity),
+    _shrinkCounter(0),
+    _pool(pool),
+    _shared(0)
 {
 }
 
 IceInternal::Buffer::Container::~Container()
 {
-    ::free(_buf);
+    if(_shared)
+    {
+        _shared->__decRef();
+    }
+    else if(_pool)
+    {
+        _pool->release(_buf, _capacity);
+    }
+    else
+    {
+        ::free(_buf);
+    }
 }
 
 void
@@ -42,17 +102,52 @@ IceInternal::Buffer::Container::swap(Container& other)
     std::swap(_size, other._size);
     std::swap(_capacity, other._capacity);
     std::swap(_shrinkCounter, other._shrinkCounter);
+
+    //
+    // The memory must be returned to the pool it was allocated from.
+    //
+    std::swap(_pool, other._pool);
+    std::swap(_shared, other._shared);
 }
 
 void
 IceInternal::Buffer::Container::clear()
 {
-    free(_buf);
+    if(_shared)
+    {
+        _shared->__decRef();
+        _shared = 0;
+    }
+    else if(_pool)
+    {
+        _pool->release(_buf, _capacity);
+    }
+    else
+    {
+        free(_buf);
+    }
     _buf = 0;
     _size = 0;
     _capacity = 0;
 }
 
+SharedBufferPtr
+IceInternal::Buffer::Container::share()
+{
+    if(!_shared && _buf)
+    {
+        _shared = new SharedBuffer(_buf, _capacity, _pool);
+        _shared->__incRef();
+
+        //
+        // With a null capacity, any resize goes through reserve(),
+        // which copies the content before it's modified.
+        //
+        _capacity = 0;
+    }
+    return _shared;
+}
+
 void
 IceInternal::Buffer::Container::reserve(size_type n)
 {
@@ -71,7 +166,40 @@ IceInternal::Buffer::Container::reserve(size_type n)
         return;
     }
     
-    pointer p = reinterpret_cast<pointer>(::realloc(_buf, _capacity));
+    pointer p;
+    if(_shared)
+    {
+        //
+        // The memory is shared, copy the content into memory owned
+        // by this container.
+        //
+        size_type capacity = _capacity;
+        p = _pool ? _pool->allocate(_capacity, capacity) : reinterpret_cast<pointer>(::malloc(_capacity));
+        if(p)
+        {
+            _capacity = capacity;
+            memcpy(p, _buf, std::min(_size, n));
+            _shared->__decRef();
+            _shared = 0;
+        }
+    }
+    else if(_pool)
+    {
+        //
+        // The pool rounds the capacity up to its buffer size class.
+        //
+        size_type capacity;
+        p = _pool->reallocate(_buf, c, _size, _capacity, capacity);
+        if(p)
+        {
+            _capacity = capacity;
+        }
+    }
+    else
+    {
+        p = reinterpret_cast<pointer>(::realloc(_buf, _capacity));
+    }
+
     if(!p)
     {
         _capacity = c; // Restore the previous capacity.
@@ -0,0 +1,268 @@
+// **********************************************************************
+//
+// Copyright (c) 2003-2011 ZeroC, Inc. All rights reserved.
+//
+// This copy of Ice is licensed to you under the terms described in the
+// ICE_LICENSE file included in this distribution.
+//
+// **********************************************************************
+
+#include <Ice/BufferPool.h>
+#include <Ice/Properties.h>
+
+#ifndef _WIN32
+#   include <pthread.h>
+#endif
+
+using namespace std;
+using namespace Ice;
+using namespace IceInternal;
+
+IceUtil::Shared* IceInternal::upCast(BufferPool* p) { return p; }
+
+namespace
+{
+
+//
+// Free buffers are chained through their first bytes.
+//
+inline Byte*&
+next(Byte* p)
+{
+    return *reinterpret_cast<Byte**>(p);
+}
+
+}
+
+IceInternal::BufferPool::Shard::Shard() :
+    cachedBytes(0),
+    allocations(0),
+    hits(0),
+    releases(0),
+    discarded(0),
+    unpooled(0)
+{
+}
+
+IceInternal::BufferPool::BufferPool(const PropertiesPtr& properties) :
+    _maxClassSize(0),
+    _numClasses(0),
+    _highWater(0)
+{
+    //
+    // Both properties are in kilobytes.
+    //
+    Int maxSize = properties->getPropertyAsIntWithDefault("Ice.BufferPool.MaxSize", 64);
+    if(maxSize < 1)
+    {
+        maxSize = 1;
+    }
+    else if(maxSize > 64 * 1024)
+    {
+        maxSize = 64 * 1024;
+    }
+
+    _maxClassSize = static_cast<size_t>(1) << minClassShift;
+    _numClasses = 1;
+    while(_maxClassSize < static_cast<size_t>(maxSize) * 1024)
+    {
+        _maxClassSize <<= 1;
+        ++_numClasses;
+    }
+
+    Int highWater = properties->getPropertyAsIntWithDefault("Ice.BufferPool.HighWater", 4096);
+    if(highWater < 0)
+    {
+        highWater = 0;
+    }
+    _highWater = static_cast<size_t>(highWater) * 1024 / numShards;
+
+    for(int i = 0; i < numShards; ++i)
+    {
+        _shards[i].freeLists.resize(_numClasses, 0);
+    }
+}
+
+IceInternal::BufferPool::~BufferPool()
+{
+    for(int i = 0; i < numShards; ++i)
+    {
+        for(vector<Byte*>::iterator p = _shards[i].freeLists.begin(); p != _shards[i].freeLists.end(); ++p)
+        {
+            while(*p)
+            {
+                Byte* buf = *p;
+                *p = next(buf);
+                ::free(buf);
+            }
+        }
+    }
+}
+
+Byte*
+IceInternal::BufferPool::allocate(size_t sz, size_t& capacity)
+{
+    size_t classSize;
+    size_t cls = sizeClass(sz, classSize);
+    Shard& s = shard();
+    if(cls == _numClasses)
+    {
+        {
+            IceUtil::Mutex::Lock sync(s);
+            ++s.unpooled;
+        }
+        Byte* buf = reinterpret_cast<Byte*>(::malloc(sz));
+        if(buf)
+        {
+            capacity = sz;
+        }
+        return buf;
+    }
+
+    {
+        IceUtil::Mutex::Lock sync(s);
+        ++s.allocations;
+        Byte* buf = s.freeLists[cls];
+        if(buf)
+        {
+            s.freeLists[cls] = next(buf);
+            s.cachedBytes -= classSize;
+            ++s.hits;
+            capacity = classSize;
+            return buf;
+        }
+    }
+
+    Byte* buf = reinterpret_cast<Byte*>(::malloc(classSize));
+    if(buf)
+    {
+        capacity = classSize;
+    }
+    return buf;
+}
+
+Byte*
+IceInternal::BufferPool::reallocate(Byte* buf, size_t capacity, size_t used, size_t sz, size_t& newCapacity)
+{
+    if(!buf)
+    {
+        return allocate(sz, newCapacity);
+    }
+
+    size_t classSize;
+    size_t cls = sizeClass(sz, classSize);
+    if(cls == _numClasses && capacity > _maxClassSize)
+    {
+        //
+        // Neither the old nor the new buffer are pooled.
+        //
+        Byte* p = reinterpret_cast<Byte*>(::realloc(buf, sz));
+        if(p)
+        {
+            newCapacity = sz;
+        }
+        return p;
+    }
+
+    if(cls < _numClasses && classSize == capacity)
+    {
+        newCapacity = capacity; // Same size class, nothing to do.
+        return buf;
+    }
+
+    Byte* p = allocate(sz, newCapacity);
+    if(p)
+    {
+        memcpy(p, buf, min(used, newCapacity));
+        release(buf, capacity);
+    }
+    return p;
+}
+
+void
+IceInternal::BufferPool::release(Byte* buf, size_t capacity)
+{
+    if(!buf)
+    {
+        return;
+    }
+
+    size_t classSize;
+    size_t cls = sizeClass(capacity, classSize);
+    if(cls < _numClasses && classSize == capacity)
+    {
+        Shard& s = shard();
+        IceUtil::Mutex::Lock sync(s);
+        ++s.releases;
+        if(s.cachedBytes + classSize <= _highWater)
+        {
+            next(buf) = s.freeLists[cls];
+            s.freeLists[cls] = buf;
+            s.cachedBytes += classSize;
+            return;
+        }
+        ++s.discarded;
+    }
+    ::free(buf);
+}
+
+BufferPool::Stats
+IceInternal::BufferPool::stats() const
+{
+    Stats stats;
+    stats.allocations = 0;
+    stats.hits = 0;
+    stats.releases = 0;
+    stats.discarded = 0;
+    stats.unpooled = 0;
+    stats.cachedBytes = 0;
+    for(int i = 0; i < numShards; ++i)
+    {
+        const Shard& s = _shards[i];
+        IceUtil::Mutex::Lock sync(s);
+        stats.allocations += s.allocations;
+        stats.hits += s.hits;
+        stats.releases += s.releases;
+        stats.discarded += s.discarded;
+        stats.unpooled += s.unpooled;
+        stats.cachedBytes += static_cast<Long>(s.cachedBytes);
+    }
+    return stats;
+}
+
+BufferPool::Shard&
+IceInternal::BufferPool::shard()
+{
+    //
+    // Select the shard from the identity of the calling thread. Thread
+    // ids are often aligned addresses, so mix in the upper bits.
+    //
+#ifdef _WIN32
+    size_t id = static_cast<size_t>(GetCurrentThreadId());
+#else
+    pthread_t self = pthread_self();
+    size_t id = 0;
+    memcpy(&id, &self, min(sizeof(id), sizeof(self)));
+#endif
+    id ^= (id >> 4) ^ (id >> 12) ^ (id >> 20);
+    return _shards[id % numShards];
+}
+
+size_t
+IceInternal::BufferPool::sizeClass(size_t sz, size_t& classSize) const
+{
+    if(sz > _maxClassSize)
+    {
+        classSize = sz;
+        return _numClasses;
+    }
+
+    size_t cls = 0;
+    classSize = static_cast<size_t>(1) << minClassShift;
+    while(classSize < sz)
+    {
+        classSize <<= 1;
+        ++cls;
+    }
+    return cls;
+}
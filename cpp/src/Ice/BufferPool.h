@@ -0,0 +1,98 @@
+// **********************************************************************
+//
+// Copyright (c) 2003-2011 ZeroC, Inc. All rights reserved.
+//
+// This copy of Ice is licensed to you under the terms described in the
+// ICE_LICENSE file included in this distribution.
+//
+// **********************************************************************
+
+#ifndef ICE_BUFFER_POOL_H
+#define ICE_BUFFER_POOL_H
+
+#include <IceUtil/Shared.h>
+#include <IceUtil/Mutex.h>
+#include <Ice/Config.h>
+#include <Ice/BufferPoolF.h>
+#include <Ice/PropertiesF.h>
+#include <vector>
+
+namespace IceInternal
+{
+
+//
+// The buffer pool keeps the memory of the message buffers used by
+// the BasicStreams of a communicator. Buffers are allocated in
+// power-of-two size classes and returned to per-class free lists
+// when released, so that sending and receiving messages doesn't
+// allocate and free memory for each message. The free lists are
+// split in shards selected by the calling thread to avoid
+// contention between threads.
+//
+// Buffers larger than the largest size class are not pooled. Once
+// the memory held by a shard reaches the high-water mark, released
+// buffers are freed instead of being cached.
+//
+class ICE_API BufferPool : public IceUtil::Shared
+{
+public:
+
+    struct Stats
+    {
+        Ice::Long allocations; // Buffers allocated through the pool.
+        Ice::Long hits; // Allocations served from a free list.
+        Ice::Long releases; // Buffers released to the pool.
+        Ice::Long discarded; // Released buffers freed because of the high-water mark.
+        Ice::Long unpooled; // Allocations larger than the largest size class.
+        Ice::Long cachedBytes; // Memory currently held in the free lists.
+    };
+
+    BufferPool(const Ice::PropertiesPtr&);
+    virtual ~BufferPool();
+
+    //
+    // Allocate a buffer of at least sz bytes. The actual size of the
+    // buffer is returned in capacity.
+    //
+    Ice::Byte* allocate(size_t sz, size_t& capacity);
+
+    //
+    // Resize a buffer, preserving the first used bytes. Returns 0 if
+    // the memory couldn't be allocated, in which case the buffer is
+    // left untouched.
+    //
+    Ice::Byte* reallocate(Ice::Byte*, size_t capacity, size_t used, size_t sz, size_t& newCapacity);
+
+    void release(Ice::Byte*, size_t capacity);
+
+    Stats stats() const;
+
+private:
+
+    enum { minClassShift = 8, numShards = 16 };
+
+    struct Shard : public IceUtil::Mutex
+    {
+        Shard();
+
+        std::vector<Ice::Byte*> freeLists;
+        size_t cachedBytes;
+        Ice::Long allocations;
+        Ice::Long hits;
+        Ice::Long releases;
+        Ice::Long discarded;
+        Ice::Long unpooled;
+    };
+
+    Shard& shard();
+    size_t sizeClass(size_t, size_t&) const;
+
+    size_t _maxClassSize;
+    size_t _numClasses;
+    size_t _highWater; // Per shard.
+    Shard _shards[numShards];
+};
+
+}
+
+#endif
@@ -0,0 +1,569 @@
+// **********************************************************************
+//
+// Copyright (c) 2003-2011 ZeroC, Inc. All rights reserved.
+//
+// This copy of Ice is licensed to you under the terms described in the
+// ICE_LICENSE file included in this distribution.
+//
+// **********************************************************************
+
+#include <IceUtil/Monitor.h>
+#include <IceUtil/UUID.h>
+#include <Ice/ChunkedTransfer.h>
+#include <Ice/Proxy.h>
+#include <Ice/OutgoingAsync.h>
+#include <Ice/LocalException.h>
+#include <memory>
+
+using namespace std;
+using namespace Ice;
+
+namespace
+{
+
+//
+// The chunks are sent as "chunk" requests. The parameters of a request
+// start with a header encoded like the Slice struct
+//
+//   struct ChunkHeader { string transfer; long seq; int window; bool last; };
+//
+// which identifies the transfer, the position of the chunk, the window
+// of the sender and whether the chunk is the last one. The chunk data
+// is the rest of the parameters. The request context is left to the
+// application. The reply carries the number of chunks consumed so far,
+// as a little-endian 64-bit integer.
+//
+const string chunkOperation = "chunk";
+
+struct ChunkHeader
+{
+    string transfer;
+    Long seq;
+    Int window;
+    bool last;
+};
+
+//
+// The sequence number of the request sent to abort a transfer.
+//
+const Long abortSequence = -1;
+
+inline pair<const Byte*, const Byte*>
+toPair(const vector<Byte>& v)
+{
+    if(v.empty())
+    {
+        return pair<const Byte*, const Byte*>(static_cast<const Byte*>(0), static_cast<const Byte*>(0));
+    }
+    return pair<const Byte*, const Byte*>(&v[0], &v[0] + v.size());
+}
+
+void
+writeLittleEndian(vector<Byte>& v, Long value, size_t sz)
+{
+    for(size_t i = 0; i < sz; ++i)
+    {
+        v.push_back(static_cast<Byte>(value >> (8 * i)));
+    }
+}
+
+Long
+readLittleEndian(const Byte*& p, const Byte* end, size_t sz)
+{
+    if(static_cast<size_t>(end - p) < sz)
+    {
+        throw MarshalException(__FILE__, __LINE__, "invalid chunk header");
+    }
+    unsigned long long value = 0;
+    for(size_t i = 0; i < sz; ++i)
+    {
+        value |= static_cast<unsigned long long>(*p++) << (8 * i);
+    }
+    return static_cast<Long>(value);
+}
+
+void
+writeHeader(vector<Byte>& v, const ChunkHeader& header)
+{
+    if(header.transfer.size() < 255)
+    {
+        v.push_back(static_cast<Byte>(header.transfer.size()));
+    }
+    else
+    {
+        v.push_back(255);
+        writeLittleEndian(v, static_cast<Long>(header.transfer.size()), sizeof(Int));
+    }
+    v.insert(v.end(), header.transfer.begin(), header.transfer.end());
+    writeLittleEndian(v, header.seq, sizeof(Long));
+    writeLittleEndian(v, header.window, sizeof(Int));
+    v.push_back(header.last ? 1 : 0);
+}
+
+//
+// Returns the start of the chunk data.
+//
+const Byte*
+readHeader(const pair<const Byte*, const Byte*>& params, ChunkHeader& header)
+{
+    const Byte* p = params.first;
+    Long sz = readLittleEndian(p, params.second, 1);
+    if(sz == 255)
+    {
+        sz = static_cast<Int>(readLittleEndian(p, params.second, sizeof(Int)));
+    }
+    if(sz < 0 || sz > params.second - p)
+    {
+        throw MarshalException(__FILE__, __LINE__, "invalid chunk header");
+    }
+    header.transfer.assign(reinterpret_cast<const char*>(p), static_cast<size_t>(sz));
+    p += sz;
+    header.seq = readLittleEndian(p, params.second, sizeof(Long));
+    header.window = static_cast<Int>(readLittleEndian(p, params.second, sizeof(Int)));
+    header.last = readLittleEndian(p, params.second, 1) != 0;
+    return p;
+}
+
+void
+writeConsumed(vector<Byte>& v, Long consumed)
+{
+    v.clear();
+    writeLittleEndian(v, consumed, sizeof(Long));
+}
+
+Long
+readConsumed(const vector<Byte>& v)
+{
+    if(v.size() != sizeof(Long))
+    {
+        throw MarshalException(__FILE__, __LINE__, "invalid chunk reply");
+    }
+    const Byte* p = &v[0];
+    return readLittleEndian(p, p + v.size(), sizeof(Long));
+}
+
+class ChunkSender : public IceUtil::Shared, public IceUtil::Monitor<IceUtil::Mutex>
+{
+public:
+
+    ChunkSender(const ObjectPrx& proxy, int window) :
+        _proxy(proxy),
+        _transfer(IceUtil::generateUUID()),
+        _window(window),
+        _outstanding(0),
+        _consumed(0)
+    {
+    }
+
+    //
+    // Send a chunk once fewer than window chunks are outstanding and
+    // the chunk is within window chunks of the first chunk not yet
+    // consumed. Chunks received ahead of their turn are acknowledged
+    // before being consumed, so the outstanding chunks alone don't
+    // bound the chunks held by the receiver. Returns false if a
+    // previous chunk failed.
+    //
+    bool
+    send(const vector<Byte>& chunk, Long seq, bool last)
+    {
+        {
+            Lock sync(*this);
+            while((_outstanding >= _window || seq >= _consumed + _window) && !_exception.get())
+            {
+                wait();
+            }
+            if(_exception.get())
+            {
+                return false;
+            }
+            ++_outstanding;
+        }
+
+        try
+        {
+            _proxy->begin_ice_invoke(chunkOperation, Normal, toPair(params(seq, last, chunk)),
+                                     newCallback(this, &ChunkSender::completed));
+        }
+        catch(const Exception& ex)
+        {
+            Lock sync(*this);
+            --_outstanding;
+            if(!_exception.get())
+            {
+                _exception.reset(ex.ice_clone());
+            }
+            return false;
+        }
+        return true;
+    }
+
+    void
+    completed(const AsyncResultPtr& result)
+    {
+        auto_ptr<Exception> exception;
+        Long consumed = 0;
+        try
+        {
+            vector<Byte> outParams;
+            if(!result->getProxy()->end_ice_invoke(outParams, result))
+            {
+                throw UnknownUserException(__FILE__, __LINE__, "unexpected user exception from chunk receiver");
+            }
+            consumed = readConsumed(outParams);
+        }
+        catch(const Exception& ex)
+        {
+            exception.reset(ex.ice_clone());
+        }
+
+        Lock sync(*this);
+        --_outstanding;
+        if(consumed > _consumed)
+        {
+            _consumed = consumed;
+        }
+        if(exception.get() && !_exception.get())
+        {
+            _exception = exception;
+        }
+        notifyAll();
+    }
+
+    //
+    // Wait for the outstanding chunks. If a chunk failed, abort the
+    // transfer and raise the exception of the chunk.
+    //
+    void
+    finish()
+    {
+        {
+            Lock sync(*this);
+            while(_outstanding > 0)
+            {
+                wait();
+            }
+            if(!_exception.get())
+            {
+                return;
+            }
+        }
+        abort();
+        _exception->ice_throw();
+    }
+
+    //
+    // Tell the receiver to discard the transfer. This is best effort:
+    // the receiver may not be reachable anymore.
+    //
+    void
+    abort()
+    {
+        {
+            Lock sync(*this);
+            while(_outstanding > 0)
+            {
+                wait();
+            }
+        }
+
+        try
+        {
+            vector<Byte> outParams;
+            _proxy->ice_invoke(chunkOperation, Normal, params(abortSequence, false, vector<Byte>()), outParams);
+        }
+        catch(const Exception&)
+        {
+        }
+    }
+
+private:
+
+    vector<Byte>
+    params(Long seq, bool last, const vector<Byte>& chunk) const
+    {
+        ChunkHeader header;
+        header.transfer = _transfer;
+        header.seq = seq;
+        header.window = _window;
+        header.last = last;
+
+        vector<Byte> v;
+        v.reserve(_transfer.size() + 32 + chunk.size());
+        writeHeader(v, header);
+        v.insert(v.end(), chunk.begin(), chunk.end());
+        return v;
+    }
+
+    const ObjectPrx _proxy;
+    const string _transfer;
+    const int _window;
+    int _outstanding;
+    Long _consumed;
+    auto_ptr<Exception> _exception;
+};
+typedef IceUtil::Handle<ChunkSender> ChunkSenderPtr;
+
+}
+
+class Ice::ChunkReceiver::Transfer : public IceUtil::Shared, public IceUtil::Mutex
+{
+public:
+
+    Transfer(const ChunkConsumerPtr& c, Long w) :
+        consumer(c),
+        window(w),
+        next(0),
+        last(-1),
+        failed(false)
+    {
+    }
+
+    const ChunkConsumerPtr consumer;
+    const Long window;
+    Long next;
+    Long last;
+    bool failed;
+
+    //
+    // The time of the last chunk received, protected by the mutex of
+    // the receiver.
+    //
+    IceUtil::Time lastUsed;
+
+    //
+    // Chunks received ahead of the next chunk to consume.
+    //
+    map<Long, vector<Byte> > pending;
+};
+
+Ice::ChunkReceiver::ChunkReceiver(const IceUtil::Time& idleTimeout) :
+    _idleTimeout(idleTimeout)
+{
+}
+
+Ice::ChunkReceiver::~ChunkReceiver()
+{
+}
+
+bool
+Ice::ChunkReceiver::ice_invoke(const pair<const Byte*, const Byte*>& inParams, vector<Byte>& outParams,
+                               const Current& current)
+{
+    if(current.operation == "ice_ping")
+    {
+        return true;
+    }
+
+    if(current.operation != chunkOperation)
+    {
+        throw OperationNotExistException(__FILE__, __LINE__, current.id, current.facet, current.operation);
+    }
+    ChunkHeader header;
+    const pair<const Byte*, const Byte*> chunk(readHeader(inParams, header), inParams.second);
+    const string& id = header.transfer;
+    const Long seq = header.seq;
+    const Long window = header.window;
+    if(seq < abortSequence)
+    {
+        throw MarshalException(__FILE__, __LINE__, "invalid chunk sequence number");
+    }
+    if(window <= 0)
+    {
+        throw MarshalException(__FILE__, __LINE__, "invalid chunk window");
+    }
+
+    //
+    // Abort the transfers which didn't receive any chunk for longer
+    // than the idle timeout. The receiver is swept at most once per
+    // idle timeout, so a transfer expires after one to two idle
+    // timeouts.
+    //
+    IceUtil::Time now = IceUtil::Time::now(IceUtil::Time::Monotonic);
+    vector<TransferPtr> expired;
+    {
+        IceUtil::Mutex::Lock sync(_mutex);
+        if(now >= _nextSweep)
+        {
+            map<string, TransferPtr>::iterator r = _transfers.begin();
+            while(r != _transfers.end())
+            {
+                if(now - r->second->lastUsed > _idleTimeout)
+                {
+                    expired.push_back(r->second);
+                    _transfers.erase(r++);
+                }
+                else
+                {
+                    ++r;
+                }
+            }
+            _nextSweep = now + _idleTimeout;
+        }
+    }
+    for(vector<TransferPtr>::const_iterator r = expired.begin(); r != expired.end(); ++r)
+    {
+        IceUtil::Mutex::Lock sync(**r);
+        if(!(*r)->failed)
+        {
+            (*r)->failed = true;
+            (*r)->pending.clear();
+            (*r)->consumer->aborted(current);
+        }
+    }
+
+    TransferPtr transfer;
+    {
+        IceUtil::Mutex::Lock sync(_mutex);
+        map<string, TransferPtr>::iterator r = _transfers.find(id);
+        if(seq == abortSequence)
+        {
+            if(r == _transfers.end())
+            {
+                return true;
+            }
+            transfer = r->second;
+            _transfers.erase(r);
+        }
+        else if(r == _transfers.end())
+        {
+            //
+            // The first chunk to consume of a new transfer is chunk 0.
+            //
+            if(seq >= window)
+            {
+                throw MarshalException(__FILE__, __LINE__, "chunk is outside of the window");
+            }
+            transfer = new Transfer(createConsumer(current), window);
+            _transfers.insert(make_pair(id, transfer));
+        }
+        else
+        {
+            transfer = r->second;
+        }
+        transfer->lastUsed = now;
+    }
+
+    IceUtil::Mutex::Lock sync(*transfer);
+    if(seq == abortSequence)
+    {
+        transfer->failed = true;
+        transfer->pending.clear();
+        transfer->consumer->aborted(current);
+        return true;
+    }
+
+    if(transfer->failed || seq < transfer->next)
+    {
+        //
+        // The consumer failed and the sender will abort the transfer,
+        // or this is a duplicate.
+        //
+        writeConsumed(outParams, transfer->next);
+        return true;
+    }
+
+    if(seq >= transfer->next + transfer->window)
+    {
+        transfer->failed = true;
+        transfer->pending.clear();
+        throw MarshalException(__FILE__, __LINE__, "chunk is outside of the window");
+    }
+
+    if(header.last)
+    {
+        transfer->last = seq;
+    }
+
+    if(seq > transfer->next)
+    {
+        transfer->pending[seq].assign(chunk.first, chunk.second);
+        writeConsumed(outParams, transfer->next);
+        return true;
+    }
+
+    try
+    {
+        transfer->consumer->consume(chunk, current);
+        ++transfer->next;
+
+        map<Long, vector<Byte> >::iterator r;
+        while((r = transfer->pending.find(transfer->next)) != transfer->pending.end())
+        {
+            transfer->consumer->consume(toPair(r->second), current);
+            transfer->pending.erase(r);
+            ++transfer->next;
+        }
+    }
+    catch(...)
+    {
+        transfer->failed = true;
+        transfer->pending.clear();
+        throw;
+    }
+
+    if(transfer->last >= 0 && transfer->next > transfer->last)
+    {
+        {
+            IceUtil::Mutex::Lock sync(_mutex);
+            _transfers.erase(id);
+        }
+        transfer->consumer->finished(current);
+    }
+    writeConsumed(outParams, transfer->next);
+    return true;
+}
+
+Long
+Ice::sendChunked(const ObjectPrx& proxy, const ChunkProducerPtr& producer, size_t chunkSize, int window)
+{
+    if(chunkSize == 0 || window <= 0)
+    {
+        throw IceUtil::IllegalArgumentException(__FILE__, __LINE__, "invalid chunk size or window");
+    }
+
+    ChunkSenderPtr sender = new ChunkSender(proxy, window);
+    Long total = 0;
+    try
+    {
+        //
+        // The producer runs one chunk ahead so that the last chunk can
+        // be marked as such. The data of the call returning false is
+        // the last chunk, unless that call produced no data.
+        //
+        vector<Byte> chunk;
+        vector<Byte> next;
+        bool more = producer->produce(chunk, chunkSize);
+        for(Long seq = 0;; ++seq)
+        {
+            bool last = !more;
+            if(more)
+            {
+                next.clear();
+                more = producer->produce(next, chunkSize);
+                last = !more && next.empty();
+            }
+            if(chunk.size() > chunkSize)
+            {
+                throw IceUtil::IllegalArgumentException(__FILE__, __LINE__, "chunk larger than the chunk size");
+            }
+            if(!sender->send(chunk, seq, last))
+            {
+                break;
+            }
+            total += static_cast<Long>(chunk.size());
+            if(last)
+            {
+                break;
+            }
+            chunk.swap(next);
+        }
+    }
+    catch(...)
+    {
+        sender->abort();
+        throw;
+    }
+
+    sender->finish();
+    return total;
+}
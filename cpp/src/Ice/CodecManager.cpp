@@ -0,0 +1,90 @@
+// **********************************************************************
+//
+// Copyright (c) 2003-2011 ZeroC, Inc. All rights reserved.
+//
+// This copy of Ice is licensed to you under the terms described in the
+// ICE_LICENSE file included in this distribution.
+//
+// **********************************************************************
+
+#include <Ice/CodecManager.h>
+#include <Ice/Codec.h>
+#include <Ice/BZip2Codec.h>
+#include <Ice/LZ4Codec.h>
+#include <Ice/LocalException.h>
+
+using namespace std;
+using namespace Ice;
+using namespace IceInternal;
+
+IceUtil::Shared* IceInternal::upCast(CodecManager* p) { return p; }
+
+IceInternal::CodecManager::CodecManager() :
+    _codecs(codecIdMask + 1)
+{
+    add(new BZip2Codec);
+    add(new LZ4Codec);
+    _preferred = _codecs[bzip2CodecId];
+}
+
+void
+IceInternal::CodecManager::add(const CodecPtr& codec)
+{
+    IceUtil::Mutex::Lock sync(*this);
+
+    Byte id = codec->id();
+    if(id < bzip2CodecId || id > codecIdMask)
+    {
+        throw IceUtil::IllegalArgumentException(__FILE__, __LINE__, "invalid id for codec `" + codec->name() + "'");
+    }
+    if(_codecs[id])
+    {
+        throw IceUtil::IllegalArgumentException(__FILE__, __LINE__, "codec `" + codec->name() + 
+                                                "' uses the same id as codec `" + _codecs[id]->name() + "'");
+    }
+    _codecs[id] = codec;
+}
+
+CodecPtr
+IceInternal::CodecManager::get(Byte id) const
+{
+    IceUtil::Mutex::Lock sync(*this);
+
+    if(id >= _codecs.size())
+    {
+        return 0;
+    }
+    return _codecs[id];
+}
+
+CodecPtr
+IceInternal::CodecManager::preferred() const
+{
+    IceUtil::Mutex::Lock sync(*this);
+    return _preferred;
+}
+
+void
+IceInternal::CodecManager::setPreferred(const string& name)
+{
+    IceUtil::Mutex::Lock sync(*this);
+
+    for(vector<CodecPtr>::const_iterator p = _codecs.begin(); p != _codecs.end(); ++p)
+    {
+        if(*p && (*p)->name() == name)
+        {
+            _preferred = *p;
+            return;
+        }
+    }
+    throw InitializationException(__FILE__, __LINE__, "unknown compression codec `" + name + "'");
+}
+
+void
+IceInternal::CodecManager::destroy()
+{
+    IceUtil::Mutex::Lock sync(*this);
+
+    _codecs.clear();
+    _preferred = 0;
+}
@@ -0,0 +1,48 @@
+// **********************************************************************
+//
+// Copyright (c) 2003-2011 ZeroC, Inc. All rights reserved.
+//
+// This copy of Ice is licensed to you under the terms described in the
+// ICE_LICENSE file included in this distribution.
+//
+// **********************************************************************
+
+#ifndef ICE_CODEC_MANAGER_H
+#define ICE_CODEC_MANAGER_H
+
+#include <IceUtil/Shared.h>
+#include <IceUtil/Mutex.h>
+#include <Ice/InstanceF.h>
+#include <Ice/CodecF.h>
+#include <Ice/CodecManagerF.h>
+
+namespace IceInternal
+{
+
+class CodecManager : public ::IceUtil::Shared, public ::IceUtil::Mutex
+{
+public:
+
+    void add(const CodecPtr&);
+    CodecPtr get(::Ice::Byte) const;
+
+    //
+    // The codec selected with Ice.Compression.Codec, which a server
+    // advertises to its clients during connection validation.
+    //
+    CodecPtr preferred() const;
+
+private:
+
+    CodecManager();
+    void setPreferred(const std::string&);
+    void destroy();
+    friend class Instance;
+
+    std::vector<CodecPtr> _codecs;
+    CodecPtr _preferred;
+};
+
+}
+
+#endif
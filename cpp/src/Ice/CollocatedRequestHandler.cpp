@@ -0,0 +1,257 @@
+// **********************************************************************
+//
+// Copyright (c) 2003-2011 ZeroC, Inc. All rights reserved.
+//
+// This copy of Ice is licensed to you under the terms described in the
+// ICE_LICENSE file included in this distribution.
+//
+// **********************************************************************
+
+#include <Ice/CollocatedRequestHandler.h>
+#include <Ice/Reference.h>
+#include <Ice/Instance.h>
+#include <Ice/Incoming.h>
+#include <Ice/OutgoingAsync.h>
+#include <Ice/Protocol.h>
+#include <Ice/ThreadPool.h>
+#include <Ice/LocalException.h>
+
+using namespace std;
+using namespace Ice;
+using namespace IceInternal;
+
+namespace
+{
+
+class InvokeRequest : public DispatchWorkItem
+{
+public:
+
+    InvokeRequest(const InstancePtr& instance, const CollocatedRequestHandlerPtr& handler, BasicStream* os,
+                  Int requestId) :
+        DispatchWorkItem(instance),
+        _handler(handler),
+        _is(instance.get()),
+        _requestId(requestId)
+    {
+        //
+        // The outgoing async object keeps its stream to retry the
+        // request, so we dispatch a copy of the request.
+        //
+        _is.writeBlob(os->b.begin(), os->b.size());
+        _is.i = _is.b.begin() + headerSize + sizeof(Int);
+    }
+
+    virtual void
+    run()
+    {
+        _handler->invoke(_is, _requestId);
+    }
+
+private:
+
+    const CollocatedRequestHandlerPtr _handler;
+    BasicStream _is;
+    const Int _requestId;
+};
+
+}
+
+IceInternal::CollocatedRequestHandler::CollocatedRequestHandler(const ReferencePtr& reference,
+                                                                const ObjectAdapterPtr& adapter) :
+    RequestHandler(reference),
+    _adapter(ObjectAdapterIPtr::dynamicCast(adapter)),
+    _nextRequestId(1)
+{
+    assert(_adapter);
+}
+
+void
+IceInternal::CollocatedRequestHandler::prepareBatchRequest(BasicStream*)
+{
+    throw CollocationOptimizationException(__FILE__, __LINE__);
+}
+
+void
+IceInternal::CollocatedRequestHandler::finishBatchRequest(BasicStream*)
+{
+    throw CollocationOptimizationException(__FILE__, __LINE__);
+}
+
+void
+IceInternal::CollocatedRequestHandler::abortBatchRequest()
+{
+    throw CollocationOptimizationException(__FILE__, __LINE__);
+}
+
+ConnectionI*
+IceInternal::CollocatedRequestHandler::sendRequest(Outgoing*)
+{
+    throw CollocationOptimizationException(__FILE__, __LINE__);
+    return 0; // Keep the compiler happy.
+}
+
+AsyncStatus
+IceInternal::CollocatedRequestHandler::sendAsyncRequest(const OutgoingAsyncPtr& outAsync)
+{
+    //
+    // Must call incDirectCount() first, because it checks for adapter
+    // deactivation, and prevents deactivation completion until
+    // decDirectCount() is called once the response is sent.
+    //
+    _adapter->incDirectCount();
+
+    BasicStream* os = outAsync->__getOs();
+    Int requestId = 0;
+    if(_response)
+    {
+        {
+            IceUtil::Mutex::Lock sync(*this);
+            requestId = _nextRequestId++;
+            if(requestId <= 0)
+            {
+                _nextRequestId = 1;
+                requestId = _nextRequestId++;
+            }
+            _asyncRequests.insert(requestId, outAsync);
+        }
+
+        //
+        // Fill in the request ID.
+        //
+        const Byte* p = reinterpret_cast<const Byte*>(&requestId);
+#ifdef ICE_BIG_ENDIAN
+        reverse_copy(p, p + sizeof(Int), os->b.begin() + headerSize);
+#else
+        copy(p, p + sizeof(Int), os->b.begin() + headerSize);
+#endif
+    }
+
+    try
+    {
+        _adapter->getThreadPool()->execute(new InvokeRequest(_reference->getInstance(), this, os, requestId));
+    }
+    catch(...)
+    {
+        if(_response)
+        {
+            takeRequest(requestId);
+        }
+        _adapter->decDirectCount();
+        throw;
+    }
+
+    //
+    // The request is sent as soon as it's queued for dispatch.
+    //
+    AsyncStatus status = AsyncStatusSent;
+    if(outAsync->__sent(0))
+    {
+        status = static_cast<AsyncStatus>(status | AsyncStatusInvokeSentCallback);
+    }
+    return status;
+}
+
+bool
+IceInternal::CollocatedRequestHandler::flushBatchRequests(BatchOutgoing*)
+{
+    throw CollocationOptimizationException(__FILE__, __LINE__);
+    return false; // Keep the compiler happy.
+}
+
+AsyncStatus
+IceInternal::CollocatedRequestHandler::flushAsyncBatchRequests(const BatchOutgoingAsyncPtr&)
+{
+    throw CollocationOptimizationException(__FILE__, __LINE__);
+    return AsyncStatusQueued; // Keep the compiler happy.
+}
+
+ConnectionIPtr
+IceInternal::CollocatedRequestHandler::getConnection(bool)
+{
+    throw CollocationOptimizationException(__FILE__, __LINE__);
+    return 0; // Keep the compiler happy.
+}
+
+void
+IceInternal::CollocatedRequestHandler::sendResponse(BasicStream* os, Byte)
+{
+    //
+    // The reply is handed to the outgoing async object positioned
+    // after the request ID, as if it had been read from a connection.
+    //
+    BasicStream is(os->instance());
+    is.swap(*os);
+    is.i = is.b.begin() + headerSize;
+    Int requestId;
+    is.read(requestId);
+
+    OutgoingAsyncPtr outAsync = takeRequest(requestId);
+    _adapter->decDirectCount();
+    if(outAsync)
+    {
+        outAsync->__finished(is);
+    }
+}
+
+void
+IceInternal::CollocatedRequestHandler::sendNoResponse()
+{
+    _adapter->decDirectCount();
+}
+
+void
+IceInternal::CollocatedRequestHandler::invokeException(Int requestId, const LocalException& ex, int)
+{
+    OutgoingAsyncPtr outAsync;
+    if(requestId > 0)
+    {
+        outAsync = takeRequest(requestId);
+    }
+    _adapter->decDirectCount();
+    if(outAsync)
+    {
+        outAsync->__finished(ex, true);
+    }
+}
+
+void
+IceInternal::CollocatedRequestHandler::invoke(BasicStream& stream, Int requestId)
+{
+    //
+    // Note: the adapter can't complete its deactivation until the
+    // response is sent, so the servant manager remains valid for the
+    // duration of the dispatch.
+    //
+    try
+    {
+        bool response = requestId != 0;
+        Incoming in(_reference->getInstance().get(), this, 0, _adapter, response, 0, requestId);
+        in.is()->swap(stream);
+        if(response)
+        {
+            BasicStream* os = in.os();
+            os->writeBlob(replyHdr, sizeof(replyHdr));
+            os->write(requestId);
+        }
+        in.invoke(_adapter->getServantManager());
+    }
+    catch(const LocalException& ex)
+    {
+        invokeException(requestId, ex, 1); // Fatal invocation exception
+    }
+}
+
+OutgoingAsyncPtr
+IceInternal::CollocatedRequestHandler::takeRequest(Int requestId)
+{
+    IceUtil::Mutex::Lock sync(*this);
+    RequestTable<OutgoingAsyncPtr>::iterator p = _asyncRequests.find(requestId);
+    if(p == _asyncRequests.end())
+    {
+        return 0;
+    }
+    OutgoingAsyncPtr outAsync = p->second;
+    _asyncRequests.erase(p);
+    return outAsync;
+}
@@ -0,0 +1,67 @@
+// **********************************************************************
+//
+// Copyright (c) 2003-2011 ZeroC, Inc. All rights reserved.
+//
+// This copy of Ice is licensed to you under the terms described in the
+// ICE_LICENSE file included in this distribution.
+//
+// **********************************************************************
+
+#ifndef ICE_COLLOCATED_REQUEST_HANDLER_H
+#define ICE_COLLOCATED_REQUEST_HANDLER_H
+
+#include <IceUtil/Mutex.h>
+
+#include <Ice/RequestHandler.h>
+#include <Ice/ResponseHandler.h>
+#include <Ice/ObjectAdapterI.h>
+#include <Ice/RequestTable.h>
+
+namespace IceInternal
+{
+
+//
+// The request handler of collocation optimized proxies. Asynchronous
+// requests are dispatched by the thread pool of the object adapter,
+// without going through a connection: the marshaled request is handed
+// to the dispatch and the reply is handed back to the outgoing async
+// object by the dispatch thread. Synchronous requests are dispatched
+// directly by the delegate (see Direct) and don't use this handler.
+//
+class CollocatedRequestHandler : public RequestHandler, public ResponseHandler, private IceUtil::Mutex
+{
+public:
+
+    CollocatedRequestHandler(const ReferencePtr&, const Ice::ObjectAdapterPtr&);
+
+    virtual void prepareBatchRequest(BasicStream*);
+    virtual void finishBatchRequest(BasicStream*);
+    virtual void abortBatchRequest();
+
+    virtual Ice::ConnectionI* sendRequest(Outgoing*);
+    virtual AsyncStatus sendAsyncRequest(const OutgoingAsyncPtr&);
+
+    virtual bool flushBatchRequests(BatchOutgoing*);
+    virtual AsyncStatus flushAsyncBatchRequests(const BatchOutgoingAsyncPtr&);
+
+    virtual Ice::ConnectionIPtr getConnection(bool);
+
+    virtual void sendResponse(BasicStream*, Ice::Byte);
+    virtual void sendNoResponse();
+    virtual void invokeException(Ice::Int, const Ice::LocalException&, int);
+
+    void invoke(BasicStream&, Ice::Int);
+
+private:
+
+    OutgoingAsyncPtr takeRequest(Ice::Int);
+
+    const Ice::ObjectAdapterIPtr _adapter;
+    Ice::Int _nextRequestId;
+    RequestTable<OutgoingAsyncPtr> _asyncRequests;
+};
+typedef IceUtil::Handle<CollocatedRequestHandler> CollocatedRequestHandlerPtr;
+
+}
+
+#endif
@@ -43,13 +43,15 @@ namespace
 struct GarbageCollectorStats
 {
     GarbageCollectorStats() :
-        runs(0), examined(0), collected(0)
+        runs(0), examined(0), collected(0), pauses(0)
     {
     }
     int runs;
     int examined;
     int collected;
+    int pauses;
     IceUtil::Time time;
+    IceUtil::Time maxPause;
 };
 
 int communicatorCount = 0;
@@ -58,6 +60,7 @@ GarbageCollectorStats gcStats;
 int gcTraceLevel;
 string gcTraceCat;
 int gcInterval;
+int gcMaxPause;
 bool gcHasPriority;
 int gcThreadPriority;
 
@@ -87,12 +90,23 @@ printGCStats(const IceInternal::GCStats& stats)
         if(gcTraceLevel > 1)
         {
             Trace out(getProcessLogger(), gcTraceCat);
-            out << stats.collected << "/" << stats.examined << ", " << stats.time * 1000 << "ms";
+            out << stats.collected << "/" << stats.examined << ", " << stats.time * 1000 << "ms" << ", "
+                << stats.pauses << " pause";
+            if(stats.pauses != 1)
+            {
+                out << "s";
+            }
+            out << ", max pause " << stats.maxPause * 1000 << "ms";
         }
         ++gcStats.runs;
         gcStats.examined += stats.examined;
         gcStats.collected += stats.collected;
+        gcStats.pauses += stats.pauses;
         gcStats.time += stats.time;
+        if(stats.maxPause > gcStats.maxPause)
+        {
+            gcStats.maxPause = stats.maxPause;
+        }
     }
 }
 
@@ -131,6 +145,12 @@ Ice::CommunicatorI::destroy()
                 {
                     out << "s";
                 }
+                out << ", " << gcStats.pauses << " pause";
+                if(gcStats.pauses != 1)
+                {
+                    out << "s";
+                }
+                out << ", max pause " << gcStats.maxPause * 1000 << "ms";
             }
             theCollector = 0; // Force destruction of the collector.
         }
@@ -401,13 +421,15 @@ Ice::CommunicatorI::CommunicatorI(const InitializationData& initData)
             gcTraceLevel = _instance->traceLevels()->gc;
             gcTraceCat = _instance->traceLevels()->gcCat;
             gcInterval = _instance->initializationData().properties->getPropertyAsInt("Ice.GC.Interval");
+            gcMaxPause =
+                _instance->initializationData().properties->getPropertyAsIntWithDefault("Ice.GC.MaxPause", 10);
             gcHasPriority = _instance->initializationData().properties->getProperty("Ice.ThreadPriority") != "";
             gcThreadPriority = _instance->initializationData().properties->getPropertyAsInt("Ice.ThreadPriority");
             gcOnce = false;
         }
         if(++communicatorCount == 1)
         {
-            IceUtil::Handle<IceInternal::GC> collector  = new IceInternal::GC(gcInterval, printGCStats);
+            IceUtil::Handle<IceInternal::GC> collector  = new IceInternal::GC(gcInterval, gcMaxPause, printGCStats);
             if(gcInterval > 0)
             {
                 if(gcHasPriority)
@@ -67,27 +67,52 @@ remove(multimap<K, V>& m, K k, V v)
     assert(false); // Nothing was removed which is an error.
 }
 
-template <typename K, typename V> ::IceInternal::Handle<V>
-find(const multimap<K,::IceInternal::Handle<V> >& m, 
-     K k, 
-     const ::IceUtilInternal::ConstMemFun<bool, V, ::IceInternal::Handle<V> >& predicate)
+//
+// Returns the active or holding connection of the pool for k with the
+// fewest outstanding requests. Returns null if there is no such
+// connection, or if all the connections of the pool are busy and the
+// pool can grow to a new connection.
+//
+template <typename K> ConnectionIPtr
+findPooled(const multimap<K, ConnectionIPtr>& m, K k, size_t poolSize, bool canGrow)
 {
+    ConnectionIPtr connection;
+    size_t active = 0;
+    size_t outstanding = 0;
 #if defined(_MSC_VER) && (_MSC_VER < 1300)
-    pair<multimap<K, ::IceInternal::Handle<V> >::const_iterator, 
-         multimap<K, ::IceInternal::Handle<V> >::const_iterator> pr = m.equal_range(k);
-    for(multimap<K, ::IceInternal::Handle<V> >::const_iterator q = pr.first; q != pr.second; ++q)
+    pair<multimap<K, ConnectionIPtr>::const_iterator, multimap<K, ConnectionIPtr>::const_iterator> pr =
+        m.equal_range(k);
+    for(multimap<K, ConnectionIPtr>::const_iterator q = pr.first; q != pr.second; ++q)
 #else
-    pair<typename multimap<K, ::IceInternal::Handle<V> >::const_iterator, 
-         typename multimap<K, ::IceInternal::Handle<V> >::const_iterator> pr = m.equal_range(k);
-    for(typename multimap<K, ::IceInternal::Handle<V> >::const_iterator q = pr.first; q != pr.second; ++q)
+    pair<typename multimap<K, ConnectionIPtr>::const_iterator, typename multimap<K, ConnectionIPtr>::const_iterator> pr =
+        m.equal_range(k);
+    for(typename multimap<K, ConnectionIPtr>::const_iterator q = pr.first; q != pr.second; ++q)
 #endif
     {
-        if(predicate(q->second))
+        if(!q->second->isActiveOrHolding())
+        {
+            continue;
+        }
+
+        if(poolSize == 1)
         {
             return q->second;
         }
+
+        ++active;
+        size_t n = q->second->outstandingRequests();
+        if(!connection || n < outstanding)
+        {
+            connection = q->second;
+            outstanding = n;
+        }
+    }
+
+    if(connection && outstanding > 0 && canGrow && active < poolSize)
+    {
+        return 0;
     }
-    return IceInternal::Handle<V>();
+    return connection;
 }
 
 }
@@ -441,7 +466,9 @@ IceInternal::OutgoingConnectionFactory::OutgoingConnectionFactory(const Instance
     _instance(instance),
     _reaper(new ConnectionReaper()),
     _destroyed(false),
-    _pendingConnectCount(0)
+    _pendingConnectCount(0),
+    _poolSize(static_cast<size_t>(max(1, instance->initializationData().properties->getPropertyAsIntWithDefault(
+                                             "Ice.ConnectionPool.Size", 1))))
 {
 }
 
@@ -485,7 +512,7 @@ IceInternal::OutgoingConnectionFactory::findConnection(const vector<EndpointIPtr
     assert(!endpoints.empty());
     for(vector<EndpointIPtr>::const_iterator p = endpoints.begin(); p != endpoints.end(); ++p)
     {
-        ConnectionIPtr connection = find(_connectionsByEndpoint, *p, Ice::constMemFun(&ConnectionI::isActiveOrHolding));
+        ConnectionIPtr connection = findPooled(_connectionsByEndpoint, *p, _poolSize, true);
         if(connection)
         {
             if(defaultsAndOverrides->overrideCompress)
@@ -510,12 +537,17 @@ IceInternal::OutgoingConnectionFactory::findConnection(const vector<ConnectorInf
     DefaultsAndOverridesPtr defaultsAndOverrides = _instance->defaultsAndOverrides();
     for(vector<ConnectorInfo>::const_iterator p = connectors.begin(); p != connectors.end(); ++p)
     {
-        if(_pending.find(p->connector) != _pending.end())
+        //
+        // While a connection to the connector is being established, we
+        // can only use the other connections of its pool, if any.
+        //
+        bool pending = _pending.find(p->connector) != _pending.end();
+        if(pending && _poolSize == 1)
         {
             continue;
         }
 
-        ConnectionIPtr connection = find(_connections, p->connector, Ice::constMemFun(&ConnectionI::isActiveOrHolding));
+        ConnectionIPtr connection = findPooled(_connections, p->connector, _poolSize, !pending);
         if(connection)
         {
             if(defaultsAndOverrides->overrideCompress)
@@ -149,6 +149,7 @@ private:
 
     std::multimap<EndpointIPtr, Ice::ConnectionIPtr> _connectionsByEndpoint;
     int _pendingConnectCount;
+    const size_t _poolSize;
 };
 
 class IncomingConnectionFactory : public EventHandler, 
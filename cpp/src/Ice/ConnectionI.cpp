@@ -16,6 +16,7 @@
 #include <Ice/DefaultsAndOverrides.h>
 #include <Ice/Transceiver.h>
 #include <Ice/ThreadPool.h>
+#include <Ice/DispatchQueue.h>
 #include <Ice/ConnectionMonitor.h>
 #include <Ice/ObjectAdapterI.h> // For getThreadPool() and getServantManager().
 #include <Ice/EndpointI.h>
@@ -25,7 +26,9 @@
 #include <Ice/LocalException.h>
 #include <Ice/ReferenceFactory.h> // For createProxy().
 #include <Ice/ProxyFactory.h> // For createProxy().
-#include <bzlib.h>
+#include <Ice/Codec.h>
+#include <Ice/CodecManager.h>
+#include <Ice/MetricsManager.h>
 
 using namespace std;
 using namespace Ice;
@@ -36,6 +39,12 @@ Ice::LocalObject* IceInternal::upCast(ConnectionI* p) { return p; }
 namespace
 {
 
+//
+// The maximum number of queued messages handed to the transceiver
+// in a single gather write.
+//
+const size_t maxGatherMessages = 64;
+
 class TimeoutCallback : public IceUtil::TimerTask
 {
 public:
@@ -84,6 +93,12 @@ public:
                               _outAsync, _stream);
     }
 
+    BasicStream&
+    stream()
+    {
+        return _stream;
+    }
+
 private:
 
     ConnectionIPtr _connection;
@@ -389,6 +404,18 @@ Ice::ConnectionI::isFinished() const
     return true;
 }
 
+size_t
+Ice::ConnectionI::outstandingRequests() const
+{
+    IceUtil::Monitor<IceUtil::Mutex>::Lock sync(*this);
+
+    //
+    // The twoway requests waiting for a reply, and the messages
+    // queued for sending (including oneway requests).
+    //
+    return _requests.size() + _asyncRequests.size() + _sendStreams.size();
+}
+
 void
 Ice::ConnectionI::throwException() const
 {
@@ -537,7 +564,7 @@ Ice::ConnectionI::sendRequest(Outgoing* out, bool compress, bool response)
         //
         // Add to the requests map.
         //
-        _requestsHint = _requests.insert(_requests.end(), pair<const Int, Outgoing*>(requestId, out));
+        _requests.insert(requestId, out);
     }
 
     return sent;
@@ -610,8 +637,7 @@ Ice::ConnectionI::sendAsyncRequest(const OutgoingAsyncPtr& out, bool compress, b
         //
         // Add to the async requests map.
         //
-        _asyncRequestsHint = _asyncRequests.insert(_asyncRequests.end(),
-                                                   pair<const Int, OutgoingAsyncPtr>(requestId, out));
+        _asyncRequests.insert(requestId, out);
     }
     return status;
 }
@@ -1011,6 +1037,13 @@ Ice::ConnectionI::sendResponse(BasicStream* os, Byte compressFlag)
         }
         
         OutgoingMessage message(os, compressFlag > 0);
+        if(compressFlag > bzip2CodecId)
+        {
+            //
+            // Compress the response with the codec of the request.
+            //
+            message.codec = _codecManager->get(compressFlag & codecIdMask);
+        }
         sendMessage(message);
         
         if(_state == StateClosing && _dispatchCount == 0)
@@ -1086,15 +1119,19 @@ Ice::ConnectionI::setAdapter(const ObjectAdapterPtr& adapter)
 
     if(_adapter)
     {
-        _servantManager = dynamic_cast<ObjectAdapterI*>(_adapter.get())->getServantManager();
+        ObjectAdapterI* adapterImpl = dynamic_cast<ObjectAdapterI*>(_adapter.get());
+        _servantManager = adapterImpl->getServantManager();
+        _dispatchQueue = adapterImpl->getDispatchQueue();
         if(!_servantManager)
         {
             _adapter = 0;
+            _dispatchQueue = 0;
         }
     }
     else
     {
         _servantManager = 0;
+        _dispatchQueue = 0;
     }
 
     //
@@ -1192,6 +1229,8 @@ Ice::ConnectionI::message(ThreadPoolCurrent& current)
     ServantManagerPtr servantManager;
     ObjectAdapterPtr adapter;
     OutgoingAsyncPtr outAsync;
+    vector<DispatcherCallPtr> datagrams;
+    DispatchQueuePtr dispatchQueue;
 
     ThreadPoolMessage<ConnectionI> msg(current, *this);
 
@@ -1231,73 +1270,7 @@ Ice::ConnectionI::message(ThreadPoolCurrent& current)
                         return;
                     }   
                     assert(_readStream.i == _readStream.b.end());
-                    _readHeader = false;
-                
-                    ptrdiff_t pos = _readStream.i - _readStream.b.begin();
-                    if(pos < headerSize)
-                    {
-                        //
-                        // This situation is possible for small UDP packets.
-                        //
-                        throw IllegalMessageSizeException(__FILE__, __LINE__);
-                    }
-                
-                    _readStream.i = _readStream.b.begin();
-                    const Byte* m;
-                    _readStream.readBlob(m, static_cast<Int>(sizeof(magic)));
-                    if(m[0] != magic[0] || m[1] != magic[1] || m[2] != magic[2] || m[3] != magic[3])
-                    {
-                        BadMagicException ex(__FILE__, __LINE__);
-                        ex.badMagic = Ice::ByteSeq(&m[0], &m[0] + sizeof(magic));
-                        throw ex;
-                    }
-                    Byte pMajor;
-                    Byte pMinor;
-                    _readStream.read(pMajor);
-                    _readStream.read(pMinor);
-                    if(pMajor != protocolMajor
-                       || static_cast<unsigned char>(pMinor) > static_cast<unsigned char>(protocolMinor))
-                    {
-                        UnsupportedProtocolException ex(__FILE__, __LINE__);
-                        ex.badMajor = static_cast<unsigned char>(pMajor);
-                        ex.badMinor = static_cast<unsigned char>(pMinor);
-                        ex.major = static_cast<unsigned char>(protocolMajor);
-                        ex.minor = static_cast<unsigned char>(protocolMinor);
-                        throw ex;
-                    }
-                    Byte eMajor;
-                    Byte eMinor;
-                    _readStream.read(eMajor);
-                    _readStream.read(eMinor);
-                    if(eMajor != encodingMajor
-                       || static_cast<unsigned char>(eMinor) > static_cast<unsigned char>(encodingMinor))
-                    {
-                        UnsupportedEncodingException ex(__FILE__, __LINE__);
-                        ex.badMajor = static_cast<unsigned char>(eMajor);
-                        ex.badMinor = static_cast<unsigned char>(eMinor);
-                        ex.major = static_cast<unsigned char>(encodingMajor);
-                        ex.minor = static_cast<unsigned char>(encodingMinor);
-                        throw ex;
-                    }
-                    Byte messageType;
-                    _readStream.read(messageType);
-                    Byte compress;
-                    _readStream.read(compress);
-                    Int size;
-                    _readStream.read(size);
-                    if(size < headerSize)
-                    {
-                        throw IllegalMessageSizeException(__FILE__, __LINE__);
-                    }
-                    if(size > static_cast<Int>(_instance->messageSizeMax()))
-                    {
-                        throw MemoryLimitException(__FILE__, __LINE__);
-                    }
-                    if(size > static_cast<Int>(_readStream.b.size()))
-                    {
-                        _readStream.b.resize(size);
-                    }
-                    _readStream.i = _readStream.b.begin() + pos;
+                    readHeader();
                 }
 
                 if(_readStream.i != _readStream.b.end())
@@ -1351,6 +1324,10 @@ Ice::ConnectionI::message(ThreadPoolCurrent& current)
                 if(current.operation & SocketOperationRead)
                 {
                     parseMessage(current.stream, invokeNum, requestId, compress, servantManager, adapter, outAsync);
+                    if(_endpoint->datagram())
+                    {
+                        parseDatagrams(datagrams);
+                    }
                 }
                 
                 //
@@ -1373,7 +1350,16 @@ Ice::ConnectionI::message(ThreadPoolCurrent& current)
             _readStream.resize(headerSize);
             _readStream.i = _readStream.b.begin();
             _readHeader = true;
-            return;
+
+            //
+            // The datagrams received along with this one are still
+            // dispatched.
+            //
+            parseDatagrams(datagrams);
+            if(datagrams.empty())
+            {
+                return;
+            }
         }
         catch(const SocketException& ex)
         {
@@ -1392,12 +1378,18 @@ Ice::ConnectionI::message(ThreadPoolCurrent& current)
                 _readStream.resize(headerSize);
                 _readStream.i = _readStream.b.begin();
                 _readHeader = true;
+
+                parseDatagrams(datagrams);
+                if(datagrams.empty())
+                {
+                    return;
+                }
             }
             else
             {
                 setState(StateClosed, ex);
+                return;
             }
-            return;
         }
 
         if(_acmTimeout > 0)
@@ -1405,36 +1397,71 @@ Ice::ConnectionI::message(ThreadPoolCurrent& current)
             _acmAbsoluteTimeout = IceUtil::Time::now(IceUtil::Time::Monotonic) + IceUtil::Time::seconds(_acmTimeout);
         }
 
+        if(invokeNum || !datagrams.empty())
+        {
+            dispatchQueue = _dispatchQueue;
+        }
+
         io.completed();
     }
 
     if(_dispatcher)
     {
-        try
-        {
-            _dispatcher->dispatch(new DispatchDispatcherCall(this, startCB, sentCBs, compress, requestId, invokeNum,
-                                                             servantManager, adapter, outAsync, current.stream), this);
-        }
-        catch(const std::exception& ex)
+        datagrams.insert(datagrams.begin(), new DispatchDispatcherCall(this, startCB, sentCBs, compress, requestId,
+                                                                       invokeNum, servantManager, adapter, outAsync,
+                                                                       current.stream));
+        for(vector<DispatcherCallPtr>::const_iterator p = datagrams.begin(); p != datagrams.end(); ++p)
         {
-            if(_instance->initializationData().properties->getPropertyAsIntWithDefault("Ice.Warn.Dispatch", 1) > 1)
+            try
             {
-                Warning out(_instance->initializationData().logger);
-                out << "dispatch exception:\n" << ex << '\n' << _desc;
+                _dispatcher->dispatch(*p, this);
             }
-        }
-        catch(...)
-        {
-            if(_instance->initializationData().properties->getPropertyAsIntWithDefault("Ice.Warn.Dispatch", 1) > 1)
+            catch(const std::exception& ex)
             {
-                Warning out(_instance->initializationData().logger);
-                out << "dispatch exception:\nunknown c++ exception" << '\n' << _desc;
+                if(_instance->initializationData().properties->getPropertyAsIntWithDefault("Ice.Warn.Dispatch", 1) > 1)
+                {
+                    Warning out(_instance->initializationData().logger);
+                    out << "dispatch exception:\n" << ex << '\n' << _desc;
+                }
             }
+            catch(...)
+            {
+                if(_instance->initializationData().properties->getPropertyAsIntWithDefault("Ice.Warn.Dispatch", 1) > 1)
+                {
+                    Warning out(_instance->initializationData().logger);
+                    out << "dispatch exception:\nunknown c++ exception" << '\n' << _desc;
+                }
+            }
+        }
+    }
+    else if(dispatchQueue)
+    {
+        //
+        // The requests are queued with their priority and dispatched
+        // by the thread pool, see DispatchQueue.
+        //
+        if(invokeNum)
+        {
+            datagrams.insert(datagrams.begin(), new DispatchDispatcherCall(this, 0,
+                                                                           vector<OutgoingAsyncMessageCallbackPtr>(),
+                                                                           compress, requestId, invokeNum,
+                                                                           servantManager, adapter, 0, current.stream));
+        }
+        dispatch(startCB, sentCBs, 0, 0, 0, 0, 0, outAsync, current.stream);
+        for(vector<DispatcherCallPtr>::const_iterator p = datagrams.begin(); p != datagrams.end(); ++p)
+        {
+            DispatchDispatcherCall* call = static_cast<DispatchDispatcherCall*>(p->get());
+            dispatchQueue->queue(*p, dispatchQueue->priority(call->stream()), this);
+            _threadPool->execute(dispatchQueue);
         }
     }
     else
     {
         dispatch(startCB, sentCBs, compress, requestId, invokeNum, servantManager, adapter, outAsync, current.stream);
+        for(vector<DispatcherCallPtr>::const_iterator p = datagrams.begin(); p != datagrams.end(); ++p)
+        {
+            (*p)->run();
+        }
     }
 }
 
@@ -1593,6 +1620,10 @@ Ice::ConnectionI::finish()
                 message->outAsync->__sent();
             }
             _sendStreams.pop_front();
+            if(_metrics)
+            {
+                _metrics->messagesQueued(-1, 0);
+            }
         }
 #endif
 
@@ -1611,16 +1642,20 @@ Ice::ConnectionI::finish()
                 }
             }
         }
+        if(_metrics)
+        {
+            _metrics->messagesQueued(-static_cast<int>(_sendStreams.size()), 0);
+        }
         _sendStreams.clear(); // Must be cleared before _requests because of Outgoing* references in OutgoingMessage
     }
 
-    for(map<Int, Outgoing*>::const_iterator p = _requests.begin(); p != _requests.end(); ++p)
+    for(RequestTable<Outgoing*>::iterator p = _requests.begin(); p != _requests.end(); ++p)
     {
         p->second->finished(*_exception.get(), true);
     }
     _requests.clear();
 
-    for(map<Int, OutgoingAsyncPtr>::const_iterator q = _asyncRequests.begin(); q != _asyncRequests.end(); ++q)
+    for(RequestTable<OutgoingAsyncPtr>::iterator q = _asyncRequests.begin(); q != _asyncRequests.end(); ++q)
     {
         q->second->__finished(*_exception.get(), true);
     }
@@ -1640,6 +1675,30 @@ Ice::ConnectionI::finish()
     }
 }
 
+void
+Ice::ConnectionI::suspendRead()
+{
+    IceUtil::Monitor<IceUtil::Mutex>::Lock sync(*this);
+    assert(!_readSuspended);
+    _readSuspended = true;
+    if(_state == StateActive || _state == StateClosing)
+    {
+        _threadPool->unregister(this, SocketOperationRead);
+    }
+}
+
+void
+Ice::ConnectionI::resumeRead()
+{
+    IceUtil::Monitor<IceUtil::Mutex>::Lock sync(*this);
+    assert(_readSuspended);
+    _readSuspended = false;
+    if(_state == StateActive || _state == StateClosing)
+    {
+        _threadPool->_register(this, SocketOperationRead);
+    }
+}
+
 string
 Ice::ConnectionI::toString() const
 {
@@ -1704,6 +1763,12 @@ Ice::ConnectionI::exception(const LocalException& ex)
     setState(StateClosed, ex);
 }
 
+void
+Ice::ConnectionI::invokeException(Int, const LocalException& ex, int invokeNum)
+{
+    invokeException(ex, invokeNum);
+}
+
 void
 Ice::ConnectionI::invokeException(const LocalException& ex, int invokeNum)
 {
@@ -1748,6 +1813,7 @@ Ice::ConnectionI::ConnectionI(const InstancePtr& instance,
     _dispatcher(_instance->initializationData().dispatcher), // Cached for better performance.
     _logger(_instance->initializationData().logger), // Cached for better performance.
     _traceLevels(_instance->traceLevels()), // Cached for better performance.
+    _metrics(_instance->metrics()), // Cached for better performance.
     _timer(_instance->timer()), // Cached for better performance.
     _writeTimeout(new TimeoutCallback(this)),
     _writeTimeoutScheduled(false),
@@ -1757,9 +1823,10 @@ Ice::ConnectionI::ConnectionI(const InstancePtr& instance,
     _warnUdp(_instance->initializationData().properties->getPropertyAsInt("Ice.Warn.Datagrams") > 0),
     _acmTimeout(0),
     _compressionLevel(1),
+    _compressionMinSize(100),
+    _codecManager(_instance->codecManager()),
+    _codec(_codecManager->get(bzip2CodecId)),
     _nextRequestId(1),
-    _requestsHint(_requests.end()),
-    _asyncRequestsHint(_asyncRequests.end()),
     _batchAutoFlush(
         _instance->initializationData().properties->getPropertyAsIntWithDefault("Ice.BatchAutoFlush", 1) > 0),
     _batchStream(_instance.get(), _batchAutoFlush),
@@ -1769,6 +1836,7 @@ Ice::ConnectionI::ConnectionI(const InstancePtr& instance,
     _batchMarker(0),
     _readStream(_instance.get()),
     _readHeader(false),
+    _readSuspended(false),
     _writeStream(_instance.get()),
     _dispatchCount(0),
     _state(StateNotInitialized)
@@ -1786,10 +1854,16 @@ Ice::ConnectionI::ConnectionI(const InstancePtr& instance,
         compressionLevel = 9;
     }
 
+    size_t& compressionMinSize = const_cast<size_t&>(_compressionMinSize);
+    Int minSize = _instance->initializationData().properties->getPropertyAsIntWithDefault(
+        "Ice.Compression.MinSize", 100);
+    compressionMinSize = minSize > 0 ? static_cast<size_t>(minSize) : 0;
+
     ObjectAdapterI* adapterImpl = _adapter ? dynamic_cast<ObjectAdapterI*>(_adapter.get()) : 0;
     if(adapterImpl)
     {
         _servantManager = adapterImpl->getServantManager();
+        _dispatchQueue = adapterImpl->getDispatchQueue();
     }
 
     Int& acmTimeout = const_cast<Int&>(_acmTimeout);
@@ -1807,6 +1881,18 @@ Ice::ConnectionI::ConnectionI(const InstancePtr& instance,
         {
             acmTimeout = _instance->clientACM();
         }
+
+#ifndef ICE_USE_IOCP
+        //
+        // A TCP connection either completes the IO of a message or
+        // returns from message() because its socket would block, so
+        // it can be registered with an edge-triggered selector. This
+        // isn't the case for other transports: an SSL transceiver
+        // might need to read to write, and plug-in transceivers might
+        // not be ready while their socket is.
+        //
+        _edgeTriggered = _endpoint->type() == TCPEndpointType;
+#endif
     }
 
     __setNoDelete(true);
@@ -1828,6 +1914,11 @@ Ice::ConnectionI::ConnectionI(const InstancePtr& instance,
         throw;
     }
     __setNoDelete(false);
+
+    if(_metrics)
+    {
+        _metrics->connectionOpened();
+    }
 }
 
 Ice::ConnectionI::~ConnectionI()
@@ -1950,7 +2041,10 @@ Ice::ConnectionI::setState(State state)
             {
                 return;
             }
-            _threadPool->_register(this, SocketOperationRead);
+            if(!_readSuspended)
+            {
+                _threadPool->_register(this, SocketOperationRead);
+            }
             break;
         }
 
@@ -1964,7 +2058,7 @@ Ice::ConnectionI::setState(State state)
             {
                 return;
             }
-            if(_state == StateActive)
+            if(_state == StateActive && !_readSuspended)
             {
                 _threadPool->unregister(this, SocketOperationRead);
             }
@@ -1980,7 +2074,7 @@ Ice::ConnectionI::setState(State state)
             {
                 return;
             }
-            if(_state == StateHolding)
+            if(_state == StateHolding && !_readSuspended)
             {
                 _threadPool->_register(this, SocketOperationRead); // We need to continue to read in closing state.
             }
@@ -2034,6 +2128,11 @@ Ice::ConnectionI::setState(State state)
         }
     }
 
+    if(_metrics && state == StateClosed)
+    {
+        _metrics->connectionClosed();
+    }
+
     _state = state;
 
     notifyAll();
@@ -2135,7 +2234,13 @@ Ice::ConnectionI::validate(SocketOperation operation)
                 _writeStream.write(encodingMajor);
                 _writeStream.write(encodingMinor);
                 _writeStream.write(validateConnectionMsg);
-                _writeStream.write(static_cast<Byte>(0)); // Compression status (always zero for validate connection).
+                //
+                // The compression status advertises the codec preferred
+                // by the server if it isn't bzip2. Clients which don't
+                // support it keep using bzip2.
+                //
+                Byte codecId = _codecManager->preferred()->id();
+                _writeStream.write(static_cast<Byte>(codecId == bzip2CodecId ? 0 : codecId));
                 _writeStream.write(headerSize); // Message size.
                 _writeStream.i = _writeStream.b.begin();
                 traceSend(_writeStream, _logger, _traceLevels);
@@ -2209,7 +2314,15 @@ Ice::ConnectionI::validate(SocketOperation operation)
                 throw ConnectionNotValidatedException(__FILE__, __LINE__);
             }
             Byte compress;
-            _readStream.read(compress); // Ignore compression status for validate connection.
+            _readStream.read(compress); // Codec preferred by the server, if not zero.
+            if(compress > bzip2CodecId)
+            {
+                CodecPtr codec = _codecManager->get(compress);
+                if(codec)
+                {
+                    _codec = codec;
+                }
+            }
             Int size;
             _readStream.read(size);
             if(size != headerSize)
@@ -2237,6 +2350,7 @@ Ice::ConnectionI::sendNextMessage(vector<OutgoingAsyncMessageCallbackPtr>& callb
     assert(!_writeStream.b.empty() && _writeStream.i == _writeStream.b.end());
     try
     {
+        bool blocked = false;
         while(true)
         {    
             //
@@ -2250,6 +2364,10 @@ Ice::ConnectionI::sendNextMessage(vector<OutgoingAsyncMessageCallbackPtr>& callb
                 callbacks.push_back(message->outAsync);
             }
             _sendStreams.pop_front();
+            if(_metrics)
+            {
+                _metrics->messagesQueued(-1, 0);
+            }
 
             //
             // If there's nothing left to send, we're done.
@@ -2260,74 +2378,74 @@ Ice::ConnectionI::sendNextMessage(vector<OutgoingAsyncMessageCallbackPtr>& callb
             }
 
             //
-            // Otherwise, prepare the next message stream for writing.
+            // Otherwise, prepare the next message stream for writing,
+            // unless it was already prepared and (partially) written
+            // by a previous gather write.
             //
             message = &_sendStreams.front();
-            assert(!message->stream->i);
-            if(message->compress && message->stream->b.size() >= 100) // Only compress messages > 100 bytes.
+            if(!message->stream->i)
             {
-                //
-                // Message compressed. Request compressed response, if any.
-                //
-                message->stream->b[9] = 2;
-
-                //
-                // Do compression.
-                //
-                BasicStream stream(_instance.get());
-                doCompress(*message->stream, stream);
-
-                if(message->outAsync)
-                {
-                    trace("sending asynchronous request", *message->stream, _logger, _traceLevels);
-                }
-                else
-                {
-                    traceSend(*message->stream, _logger, _traceLevels);
-                }
-
-                message->adopt(&stream); // Adopt the compressed stream.
-                message->stream->i = message->stream->b.begin();
+                prepareMessage(*message);
             }
-            else
+            _writeStream.swap(*message->stream);
+
+            if(_writeStream.i == _writeStream.b.end())
             {
-                if(message->compress)
-                {
-                    //
-                    // Message not compressed. Request compressed response, if any.
-                    //
-                    message->stream->b[9] = 1;
-                }
+                continue; // Already sent with the previous message.
+            }
 
-                //
-                // No compression, just fill in the message size.
-                //
-                Int sz = static_cast<Int>(message->stream->b.size());
-                const Byte* p = reinterpret_cast<const Byte*>(&sz);
-#ifdef ICE_BIG_ENDIAN
-                reverse_copy(p, p + sizeof(Int), message->stream->b.begin() + 10);
-#else
-                copy(p, p + sizeof(Int), message->stream->b.begin() + 10);
-#endif
-                message->stream->i = message->stream->b.begin();
-                if(message->outAsync)
+            //
+            // Send the message. If there are other messages queued,
+            // send them along with this one.
+            //
+            assert(_writeStream.i);
+            if(!blocked)
+            {
+#ifndef ICE_USE_IOCP
+                if(_sendStreams.size() > 1)
                 {
-                    trace("sending asynchronous request", *message->stream, _logger, _traceLevels);
+                    vector<Buffer*> bufs;
+                    bufs.reserve(min(_sendStreams.size(), maxGatherMessages));
+                    bufs.push_back(&_writeStream);
+                    for(deque<OutgoingMessage>::iterator p = _sendStreams.begin() + 1;
+                        p != _sendStreams.end() && bufs.size() < maxGatherMessages; ++p)
+                    {
+                        if(!p->stream->i)
+                        {
+                            prepareMessage(*p);
+                        }
+                        bufs.push_back(p->stream);
+                    }
+                    try
+                    {
+                        blocked = !_transceiver->gatherWrite(bufs);
+                    }
+                    catch(const Ice::LocalException&)
+                    {
+                        //
+                        // Messages fully written before the failure are
+                        // considered sent, for at-most-once semantics.
+                        //
+                        for(vector<Buffer*>::size_type i = 0; i < bufs.size(); ++i)
+                        {
+                            if(bufs[i]->i == bufs[i]->b.end())
+                            {
+                                _sendStreams[i].isSent = true;
+                            }
+                        }
+                        throw;
+                    }
                 }
                 else
+#endif
                 {
-                    traceSend(*message->stream, _logger, _traceLevels);
+                    blocked = !_transceiver->write(_writeStream);
                 }
             }
-            _writeStream.swap(*message->stream);
 
-            //
-            // Send the message.
-            //
-            assert(_writeStream.i);
-            if(_writeStream.i != _writeStream.b.end() && !_transceiver->write(_writeStream))
+            if(_writeStream.i != _writeStream.b.end())
             {
-                assert(!_writeStream.b.empty());
+                assert(blocked);
                 scheduleTimeout(SocketOperationWrite, _endpoint->timeout());
                 return;
             }
@@ -2352,6 +2470,68 @@ Ice::ConnectionI::sendNextMessage(vector<OutgoingAsyncMessageCallbackPtr>& callb
     }
 }
 
+void
+Ice::ConnectionI::prepareMessage(OutgoingMessage& message)
+{
+    assert(!message.stream->i);
+    const CodecPtr& codec = message.codec ? message.codec : _codec;
+    if(message.compress && message.stream->b.size() >= _compressionMinSize)
+    {
+        //
+        // Message compressed. Request compressed response, if any.
+        //
+        message.stream->b[9] = codec->id();
+
+        //
+        // Do compression.
+        //
+        BasicStream stream(_instance.get());
+        doCompress(codec, *message.stream, stream);
+
+        if(message.outAsync)
+        {
+            trace("sending asynchronous request", *message.stream, _logger, _traceLevels);
+        }
+        else
+        {
+            traceSend(*message.stream, _logger, _traceLevels);
+        }
+
+        message.adopt(&stream); // Adopt the compressed stream.
+        message.stream->i = message.stream->b.begin();
+    }
+    else
+    {
+        if(message.compress)
+        {
+            //
+            // Message not compressed. Request compressed response, if any.
+            //
+            message.stream->b[9] = codec->id() == bzip2CodecId ? 1 : compressResponseFlag | codec->id();
+        }
+
+        //
+        // No compression, just fill in the message size.
+        //
+        Int sz = static_cast<Int>(message.stream->b.size());
+        const Byte* p = reinterpret_cast<const Byte*>(&sz);
+#ifdef ICE_BIG_ENDIAN
+        reverse_copy(p, p + sizeof(Int), message.stream->b.begin() + 10);
+#else
+        copy(p, p + sizeof(Int), message.stream->b.begin() + 10);
+#endif
+        message.stream->i = message.stream->b.begin();
+        if(message.outAsync)
+        {
+            trace("sending asynchronous request", *message.stream, _logger, _traceLevels);
+        }
+        else
+        {
+            traceSend(*message.stream, _logger, _traceLevels);
+        }
+    }
+}
+
 AsyncStatus
 Ice::ConnectionI::sendMessage(OutgoingMessage& message)
 {
@@ -2359,10 +2539,19 @@ Ice::ConnectionI::sendMessage(OutgoingMessage& message)
 
     message.stream->i = 0; // Reset the message stream iterator before starting sending the message.
 
+    if(_metrics)
+    {
+        _metrics->messageSent(message.stream->b.size());
+    }
+
     if(!_sendStreams.empty())
     {
         _sendStreams.push_back(message);
         _sendStreams.back().adopt(0);
+        if(_metrics)
+        {
+            _metrics->messagesQueued(1, _sendStreams.size());
+        }
         return AsyncStatusQueued;
     }
 
@@ -2373,18 +2562,19 @@ Ice::ConnectionI::sendMessage(OutgoingMessage& message)
 
     message.stream->i = message.stream->b.begin();
 
-    if(message.compress && message.stream->b.size() >= 100) // Only compress messages larger than 100 bytes.
+    const CodecPtr& codec = message.codec ? message.codec : _codec;
+    if(message.compress && message.stream->b.size() >= _compressionMinSize)
     {
         //
         // Message compressed. Request compressed response, if any.
         //
-        message.stream->b[9] = 2;
+        message.stream->b[9] = codec->id();
 
         //
         // Do compression.
         //
         BasicStream stream(_instance.get());
-        doCompress(*message.stream, stream);
+        doCompress(codec, *message.stream, stream);
         stream.i = stream.b.begin();
 
         if(message.outAsync)
@@ -2424,7 +2614,7 @@ Ice::ConnectionI::sendMessage(OutgoingMessage& message)
             //
             // Message not compressed. Request compressed response, if any.
             //
-            message.stream->b[9] = 1;
+            message.stream->b[9] = codec->id() == bzip2CodecId ? 1 : compressResponseFlag | codec->id();
         }
 
         //
@@ -2470,95 +2660,30 @@ Ice::ConnectionI::sendMessage(OutgoingMessage& message)
         _sendStreams.back().adopt(0); // Adopt the stream.
     }
 
+    if(_metrics)
+    {
+        _metrics->messagesQueued(1, _sendStreams.size());
+    }
+
     _writeStream.swap(*_sendStreams.back().stream);
     scheduleTimeout(SocketOperationWrite, _endpoint->timeout());
     _threadPool->_register(this, SocketOperationWrite);
     return AsyncStatusQueued;
 }
 
-static string
-getBZ2Error(int bzError)
-{
-    if(bzError == BZ_RUN_OK)
-    {
-        return ": BZ_RUN_OK";
-    }
-    else if(bzError == BZ_FLUSH_OK)
-    {
-        return ": BZ_FLUSH_OK";
-    }
-    else if(bzError == BZ_FINISH_OK)
-    {
-        return ": BZ_FINISH_OK";
-    }
-    else if(bzError == BZ_STREAM_END)
-    {
-        return ": BZ_STREAM_END";
-    }
-    else if(bzError == BZ_CONFIG_ERROR)
-    {
-        return ": BZ_CONFIG_ERROR";
-    }
-    else if(bzError == BZ_SEQUENCE_ERROR)
-    {
-        return ": BZ_SEQUENCE_ERROR";
-    }
-    else if(bzError == BZ_PARAM_ERROR)
-    {
-        return ": BZ_PARAM_ERROR";
-    }
-    else if(bzError == BZ_MEM_ERROR)
-    {
-        return ": BZ_MEM_ERROR";
-    }
-    else if(bzError == BZ_DATA_ERROR)
-    {
-        return ": BZ_DATA_ERROR";
-    }
-    else if(bzError == BZ_DATA_ERROR_MAGIC)
-    {
-        return ": BZ_DATA_ERROR_MAGIC";
-    }
-    else if(bzError == BZ_IO_ERROR)
-    {
-        return ": BZ_IO_ERROR";
-    }
-    else if(bzError == BZ_UNEXPECTED_EOF)
-    {
-        return ": BZ_UNEXPECTED_EOF";
-    }
-    else if(bzError == BZ_OUTBUFF_FULL)
-    {
-        return ": BZ_OUTBUFF_FULL";
-    }
-    else
-    {
-        return "";
-    }
-}
-
 void
-Ice::ConnectionI::doCompress(BasicStream& uncompressed, BasicStream& compressed)
+Ice::ConnectionI::doCompress(const CodecPtr& codec, BasicStream& uncompressed, BasicStream& compressed)
 {
     const Byte* p;
 
     //
     // Compress the message body, but not the header.
     //
-    unsigned int uncompressedLen = static_cast<unsigned int>(uncompressed.b.size() - headerSize);
-    unsigned int compressedLen = static_cast<unsigned int>(uncompressedLen * 1.01 + 600);
+    size_t uncompressedLen = uncompressed.b.size() - headerSize;
+    size_t compressedLen = codec->compressBound(uncompressedLen);
     compressed.b.resize(headerSize + sizeof(Int) + compressedLen);
-    int bzError = BZ2_bzBuffToBuffCompress(reinterpret_cast<char*>(&compressed.b[0]) + headerSize + sizeof(Int),
-                                           &compressedLen,
-                                           reinterpret_cast<char*>(&uncompressed.b[0]) + headerSize,
-                                           uncompressedLen,
-                                           _compressionLevel, 0, 0);
-    if(bzError != BZ_OK)
-    {
-        CompressionException ex(__FILE__, __LINE__);
-        ex.reason = "BZ2_bzBuffToBuffCompress failed" + getBZ2Error(bzError);
-        throw ex;
-    }
+    compressedLen = codec->compress(&uncompressed.b[0] + headerSize, uncompressedLen,
+                                    &compressed.b[0] + headerSize + sizeof(Int), compressedLen, _compressionLevel);
     compressed.b.resize(headerSize + sizeof(Int) + compressedLen);
 
     //
@@ -2593,7 +2718,7 @@ Ice::ConnectionI::doCompress(BasicStream& uncompressed, BasicStream& compressed)
 }
 
 void
-Ice::ConnectionI::doUncompress(BasicStream& compressed, BasicStream& uncompressed)
+Ice::ConnectionI::doUncompress(const CodecPtr& codec, BasicStream& compressed, BasicStream& uncompressed)
 {
     Int uncompressedSize;
     compressed.i = compressed.b.begin() + headerSize;
@@ -2604,23 +2729,84 @@ Ice::ConnectionI::doUncompress(BasicStream& compressed, BasicStream& uncompresse
     }
 
     uncompressed.resize(uncompressedSize);
-    unsigned int uncompressedLen = uncompressedSize - headerSize;
-    unsigned int compressedLen = static_cast<unsigned int>(compressed.b.size() - headerSize - sizeof(Int));
-    int bzError = BZ2_bzBuffToBuffDecompress(reinterpret_cast<char*>(&uncompressed.b[0]) + headerSize,
-                                             &uncompressedLen,
-                                             reinterpret_cast<char*>(&compressed.b[0]) + headerSize + sizeof(Int),
-                                             compressedLen,
-                                             0, 0);
-    if(bzError != BZ_OK)
-    {
-        CompressionException ex(__FILE__, __LINE__);
-        ex.reason = "BZ2_bzBuffToBuffCompress failed" + getBZ2Error(bzError);
-        throw ex;
-    }
+    codec->uncompress(&compressed.b[0] + headerSize + sizeof(Int), compressed.b.size() - headerSize - sizeof(Int),
+                      &uncompressed.b[0] + headerSize, uncompressedSize - headerSize);
 
     copy(compressed.b.begin(), compressed.b.begin() + headerSize, uncompressed.b.begin());
 }
 
+void
+Ice::ConnectionI::readHeader()
+{
+    _readHeader = false;
+
+    ptrdiff_t pos = _readStream.i - _readStream.b.begin();
+    if(pos < headerSize)
+    {
+        //
+        // This situation is possible for small UDP packets.
+        //
+        throw IllegalMessageSizeException(__FILE__, __LINE__);
+    }
+
+    _readStream.i = _readStream.b.begin();
+    const Byte* m;
+    _readStream.readBlob(m, static_cast<Int>(sizeof(magic)));
+    if(m[0] != magic[0] || m[1] != magic[1] || m[2] != magic[2] || m[3] != magic[3])
+    {
+        BadMagicException ex(__FILE__, __LINE__);
+        ex.badMagic = Ice::ByteSeq(&m[0], &m[0] + sizeof(magic));
+        throw ex;
+    }
+    Byte pMajor;
+    Byte pMinor;
+    _readStream.read(pMajor);
+    _readStream.read(pMinor);
+    if(pMajor != protocolMajor
+       || static_cast<unsigned char>(pMinor) > static_cast<unsigned char>(protocolMinor))
+    {
+        UnsupportedProtocolException ex(__FILE__, __LINE__);
+        ex.badMajor = static_cast<unsigned char>(pMajor);
+        ex.badMinor = static_cast<unsigned char>(pMinor);
+        ex.major = static_cast<unsigned char>(protocolMajor);
+        ex.minor = static_cast<unsigned char>(protocolMinor);
+        throw ex;
+    }
+    Byte eMajor;
+    Byte eMinor;
+    _readStream.read(eMajor);
+    _readStream.read(eMinor);
+    if(eMajor != encodingMajor
+       || static_cast<unsigned char>(eMinor) > static_cast<unsigned char>(encodingMinor))
+    {
+        UnsupportedEncodingException ex(__FILE__, __LINE__);
+        ex.badMajor = static_cast<unsigned char>(eMajor);
+        ex.badMinor = static_cast<unsigned char>(eMinor);
+        ex.major = static_cast<unsigned char>(encodingMajor);
+        ex.minor = static_cast<unsigned char>(encodingMinor);
+        throw ex;
+    }
+    Byte messageType;
+    _readStream.read(messageType);
+    Byte compress;
+    _readStream.read(compress);
+    Int size;
+    _readStream.read(size);
+    if(size < headerSize)
+    {
+        throw IllegalMessageSizeException(__FILE__, __LINE__);
+    }
+    if(size > static_cast<Int>(_instance->messageSizeMax()))
+    {
+        throw MemoryLimitException(__FILE__, __LINE__);
+    }
+    if(size > static_cast<Int>(_readStream.b.size()))
+    {
+        _readStream.b.resize(size);
+    }
+    _readStream.i = _readStream.b.begin() + pos;
+}
+
 void
 Ice::ConnectionI::parseMessage(BasicStream& stream, Int& invokeNum, Int& requestId, Byte& compress,
                                ServantManagerPtr& servantManager, ObjectAdapterPtr& adapter,
@@ -2628,6 +2814,11 @@ Ice::ConnectionI::parseMessage(BasicStream& stream, Int& invokeNum, Int& request
 {
     assert(_state > StateNotValidated && _state < StateClosed);
 
+    if(_metrics)
+    {
+        _metrics->messageReceived(_readStream.b.size());
+    }
+
     _readStream.swap(stream);
     _readStream.resize(headerSize);
     _readStream.i = _readStream.b.begin();
@@ -2647,10 +2838,17 @@ Ice::ConnectionI::parseMessage(BasicStream& stream, Int& invokeNum, Int& request
         Byte messageType;
         stream.read(messageType);
         stream.read(compress);
-        if(compress == 2)
+        if(compress >= bzip2CodecId && compress <= codecIdMask)
         {
+            CodecPtr codec = _codecManager->get(compress);
+            if(!codec)
+            {
+                CompressionException ex(__FILE__, __LINE__);
+                ex.reason = "unknown compression codec";
+                throw ex;
+            }
             BasicStream ustream(_instance.get());
-            doUncompress(stream, ustream);
+            doUncompress(codec, stream, ustream);
             stream.b.swap(ustream.b);
         }
         stream.i = stream.b.begin() + headerSize;
@@ -2723,72 +2921,21 @@ Ice::ConnectionI::parseMessage(BasicStream& stream, Int& invokeNum, Int& request
 
                 stream.read(requestId);
 
-                map<Int, Outgoing*>::iterator p = _requests.end();
-                map<Int, OutgoingAsyncPtr>::iterator q = _asyncRequests.end();
-
-                if(_requestsHint != _requests.end())
-                {
-                    if(_requestsHint->first == requestId)
-                    {
-                        p = _requestsHint;
-                    }
-                }
-
-                if(p == _requests.end())
-                {
-                    if(_asyncRequestsHint != _asyncRequests.end())
-                    {
-                        if(_asyncRequestsHint->first == requestId)
-                        {
-                            q = _asyncRequestsHint;
-                        }
-                    }
-                }
-
-                if(p == _requests.end() && q == _asyncRequests.end())
-                {
-                    p = _requests.find(requestId);
-                }
-
-                if(p == _requests.end() && q == _asyncRequests.end())
-                {
-                    q = _asyncRequests.find(requestId);
-                }
-
-                if(p == _requests.end() && q == _asyncRequests.end())
-                {
-                    throw UnknownRequestIdException(__FILE__, __LINE__);
-                }
-
+                RequestTable<Outgoing*>::iterator p = _requests.find(requestId);
                 if(p != _requests.end())
                 {
                     p->second->finished(stream);
-
-                    if(p == _requestsHint)
-                    {
-                        _requests.erase(p++);
-                        _requestsHint = p;
-                    }
-                    else
-                    {
-                        _requests.erase(p);
-                    }
+                    _requests.erase(p);
                 }
                 else
                 {
-                    assert(q != _asyncRequests.end());
-
-                    outAsync = q->second;
-
-                    if(q == _asyncRequestsHint)
-                    {
-                        _asyncRequests.erase(q++);
-                        _asyncRequestsHint = q;
-                    }
-                    else
+                    RequestTable<OutgoingAsyncPtr>::iterator q = _asyncRequests.find(requestId);
+                    if(q == _asyncRequests.end())
                     {
-                        _asyncRequests.erase(q);
+                        throw UnknownRequestIdException(__FILE__, __LINE__);
                     }
+                    outAsync = q->second;
+                    _asyncRequests.erase(q);
                 }
                 notifyAll(); // Notify threads blocked in close(false)
                 break;
@@ -2830,6 +2977,72 @@ Ice::ConnectionI::parseMessage(BasicStream& stream, Int& invokeNum, Int& request
     }
 }
 
+void
+Ice::ConnectionI::parseDatagrams(vector<DispatcherCallPtr>& datagrams)
+{
+    //
+    // Parse the datagrams which the transceiver received along with
+    // the one just parsed, they are dispatched after it.
+    //
+    while(_state == StateActive && _transceiver->hasMoreData())
+    {
+        try
+        {
+#ifndef NDEBUG
+            bool received = _transceiver->read(_readStream);
+            assert(received);
+#else
+            _transceiver->read(_readStream);
+#endif
+            readHeader();
+            if(_readStream.i != _readStream.b.end())
+            {
+                throw DatagramLimitException(__FILE__, __LINE__); // The message was truncated.
+            }
+        }
+        catch(const DatagramLimitException&)
+        {
+            if(_warnUdp)
+            {
+                Warning out(_instance->initializationData().logger);
+                out << "maximum datagram size of " << _readStream.i - _readStream.b.begin() << " exceeded";
+            }
+            _readStream.resize(headerSize);
+            _readStream.i = _readStream.b.begin();
+            _readHeader = true;
+            continue;
+        }
+        catch(const LocalException& ex)
+        {
+            if(_warn)
+            {
+                Warning out(_instance->initializationData().logger);
+                out << "datagram connection exception:\n" << ex << '\n' << _desc;
+            }
+            _readStream.resize(headerSize);
+            _readStream.i = _readStream.b.begin();
+            _readHeader = true;
+            continue;
+        }
+
+        BasicStream stream(_instance.get());
+        Byte compress = 0;
+        Int requestId = 0;
+        Int invokeNum = 0;
+        ServantManagerPtr servantManager;
+        ObjectAdapterPtr adapter;
+        OutgoingAsyncPtr outAsync;
+        parseMessage(stream, invokeNum, requestId, compress, servantManager, adapter, outAsync);
+        assert(!outAsync); // There are no replies over datagram connections.
+        if(invokeNum > 0)
+        {
+            datagrams.push_back(new DispatchDispatcherCall(this, 0, vector<OutgoingAsyncMessageCallbackPtr>(),
+                                                           compress, requestId, invokeNum, servantManager, adapter,
+                                                           0, stream));
+        }
+    }
+}
+
 void
 Ice::ConnectionI::invokeAll(BasicStream& stream, Int invokeNum, Int requestId, Byte compress,
                             const ServantManagerPtr& servantManager, const ObjectAdapterPtr& adapter)
@@ -2847,7 +3060,7 @@ Ice::ConnectionI::invokeAll(BasicStream& stream, Int invokeNum, Int requestId, B
             // Prepare the invocation.
             //
             bool response = !_endpoint->datagram() && requestId != 0;
-            Incoming in(_instance.get(), this, adapter, response, compress, requestId);
+            Incoming in(_instance.get(), this, this, adapter, response, compress, requestId);
             BasicStream* is = in.is();
             stream.swap(*is);
             BasicStream* os = in.os();
@@ -22,13 +22,19 @@
 #include <Ice/TransceiverF.h>
 #include <Ice/ObjectAdapterF.h>
 #include <Ice/ServantManagerF.h>
+#include <Ice/DispatchQueueF.h>
 #include <Ice/EndpointIF.h>
 #include <Ice/ConnectorF.h>
 #include <Ice/LoggerF.h>
 #include <Ice/TraceLevelsF.h>
+#include <Ice/MetricsManagerF.h>
+#include <Ice/CodecF.h>
+#include <Ice/CodecManagerF.h>
 #include <Ice/OutgoingAsyncF.h>
 #include <Ice/EventHandler.h>
+#include <Ice/ResponseHandler.h>
 #include <Ice/Dispatcher.h>
+#include <Ice/RequestTable.h>
 
 #include <deque>
 #include <memory>
@@ -60,7 +66,8 @@ namespace Ice
 
 class LocalException;
 
-class ICE_API ConnectionI : public Connection, public IceInternal::EventHandler, public IceUtil::Monitor<IceUtil::Mutex>
+class ICE_API ConnectionI : public Connection, public IceInternal::EventHandler, public IceInternal::ResponseHandler,
+                            public IceUtil::Monitor<IceUtil::Mutex>
 {
 public:
 
@@ -87,6 +94,7 @@ public:
 
     bool isActiveOrHolding() const;
     bool isFinished() const;
+    size_t outstandingRequests() const; // Used by the outgoing connection factory to balance connection pools.
 
     void throwException() const; // Throws the connection exception if destroyed.
 
@@ -113,8 +121,8 @@ public:
     bool flushBatchRequests(IceInternal::BatchOutgoing*);
     IceInternal::AsyncStatus flushAsyncBatchRequests(const IceInternal::BatchOutgoingAsyncPtr&);
 
-    void sendResponse(IceInternal::BasicStream*, Byte);
-    void sendNoResponse();
+    virtual void sendResponse(IceInternal::BasicStream*, Byte); // From ResponseHandler.
+    virtual void sendNoResponse(); // From ResponseHandler.
 
     IceInternal::EndpointIPtr endpoint() const;
     IceInternal::ConnectorPtr connector() const;
@@ -144,12 +152,20 @@ public:
 
     void exception(const LocalException&);
     void invokeException(const LocalException&, int);
+    virtual void invokeException(Int, const LocalException&, int); // From ResponseHandler.
 
     void dispatch(const StartCallbackPtr&, const std::vector<IceInternal::OutgoingAsyncMessageCallbackPtr>&,
                   Byte, Int, Int, const IceInternal::ServantManagerPtr&, const ObjectAdapterPtr&, 
                   const IceInternal::OutgoingAsyncPtr&, IceInternal::BasicStream&);
     void finish();
 
+    //
+    // Stop and resume reading from the connection while the dispatch
+    // queue of the adapter is full, see DispatchQueue.
+    //
+    void suspendRead();
+    void resumeRead();
+
 private:
 
     enum State
@@ -189,6 +205,7 @@ private:
         IceInternal::OutgoingMessageCallback* out;
         IceInternal::OutgoingAsyncMessageCallbackPtr outAsync;
         bool compress;
+        IceInternal::CodecPtr codec; // If null, the connection's codec is used.
         int requestId;
         bool adopted;
         bool isSent;
@@ -210,13 +227,16 @@ private:
     bool initialize(IceInternal::SocketOperation = IceInternal::SocketOperationNone);
     bool validate(IceInternal::SocketOperation = IceInternal::SocketOperationNone);
     void sendNextMessage(std::vector<IceInternal::OutgoingAsyncMessageCallbackPtr>&);
+    void prepareMessage(OutgoingMessage&);
     IceInternal::AsyncStatus sendMessage(OutgoingMessage&);
 
-    void doCompress(IceInternal::BasicStream&, IceInternal::BasicStream&);
-    void doUncompress(IceInternal::BasicStream&, IceInternal::BasicStream&);
+    void doCompress(const IceInternal::CodecPtr&, IceInternal::BasicStream&, IceInternal::BasicStream&);
+    void doUncompress(const IceInternal::CodecPtr&, IceInternal::BasicStream&, IceInternal::BasicStream&);
 
+    void readHeader();
     void parseMessage(IceInternal::BasicStream&, Int&, Int&, Byte&,
                       IceInternal::ServantManagerPtr&, ObjectAdapterPtr&, IceInternal::OutgoingAsyncPtr&);
+    void parseDatagrams(std::vector<DispatcherCallPtr>&);
     void invokeAll(IceInternal::BasicStream&, Int, Int, Byte,
                    const IceInternal::ServantManagerPtr&, const ObjectAdapterPtr&);
 
@@ -276,10 +296,12 @@ private:
 
     ObjectAdapterPtr _adapter;
     IceInternal::ServantManagerPtr _servantManager;
+    IceInternal::DispatchQueuePtr _dispatchQueue;
 
     const DispatcherPtr _dispatcher;
     const LoggerPtr _logger;
     const IceInternal::TraceLevelsPtr _traceLevels;
+    IceInternal::MetricsManager* const _metrics;
     const IceInternal::ThreadPoolPtr _threadPool;
 
     const IceUtil::TimerPtr _timer;
@@ -296,14 +318,15 @@ private:
     IceUtil::Time _acmAbsoluteTimeout;
 
     const int _compressionLevel;
+    const size_t _compressionMinSize;
+    const IceInternal::CodecManagerPtr _codecManager;
+    IceInternal::CodecPtr _codec;
 
     Int _nextRequestId;
 
-    std::map<Int, IceInternal::Outgoing*> _requests;
-    std::map<Int, IceInternal::Outgoing*>::iterator _requestsHint;
+    IceInternal::RequestTable<IceInternal::Outgoing*> _requests;
 
-    std::map<Int, IceInternal::OutgoingAsyncPtr> _asyncRequests;
-    std::map<Int, IceInternal::OutgoingAsyncPtr>::iterator _asyncRequestsHint;
+    IceInternal::RequestTable<IceInternal::OutgoingAsyncPtr> _asyncRequests;
 
     std::auto_ptr<LocalException> _exception;
 
@@ -318,6 +341,7 @@ private:
 
     IceInternal::BasicStream _readStream;
     bool _readHeader;
+    bool _readSuspended;
     IceInternal::BasicStream _writeStream;
 
     int _dispatchCount;
@@ -0,0 +1,286 @@
+// **********************************************************************
+//
+// Copyright (c) 2003-2011 ZeroC, Inc. All rights reserved.
+//
+// This copy of Ice is licensed to you under the terms described in the
+// ICE_LICENSE file included in this distribution.
+//
+// **********************************************************************
+
+#include <Ice/DispatchQueue.h>
+#include <Ice/Instance.h>
+#include <Ice/Properties.h>
+#include <Ice/LoggerUtil.h>
+#include <Ice/LocalException.h>
+#include <Ice/ConnectionI.h>
+
+#include <algorithm>
+
+using namespace std;
+using namespace Ice;
+using namespace IceInternal;
+
+IceUtil::Shared* IceInternal::upCast(DispatchQueue* p) { return p; }
+
+namespace
+{
+
+//
+// The pass of a level is increased by its stride, the inverse of its
+// weight, each time one of its requests is dispatched.
+//
+const Ice::Long strideScale = 1 << 20;
+
+}
+
+IceInternal::DispatchQueue::DispatchQueue(const InstancePtr& instance, const string& name,
+                                          const ThreadPoolPtr& threadPool) :
+    _virtualTime(0),
+    _inUseLow(0),
+    _maxInUseLow(0),
+    _queuedLow(0),
+    _maxQueuedLow(0),
+    _defaultPriority(0)
+{
+    PropertiesPtr properties = instance->initializationData().properties;
+    string prefix = name + ".DispatchPriority";
+
+    StringSeq weights = properties->getPropertyAsList(prefix + ".Weights");
+    assert(!weights.empty());
+    for(StringSeq::const_iterator p = weights.begin(); p != weights.end(); ++p)
+    {
+        istringstream is(*p);
+        int weight;
+        if(!(is >> weight) || !is.eof() || weight < 1)
+        {
+            Warning out(instance->initializationData().logger);
+            out << "invalid weight `" << *p << "' in " << prefix << ".Weights; weight adjusted to 1";
+            weight = 1;
+        }
+        Level level;
+        level.stride = strideScale / weight;
+        level.pass = 0;
+        _levels.push_back(level);
+    }
+    int levels = static_cast<int>(_levels.size());
+
+    _defaultPriority = properties->getPropertyAsInt(prefix + ".Default");
+    if(_defaultPriority < 0 || _defaultPriority >= levels)
+    {
+        Warning out(instance->initializationData().logger);
+        out << prefix << ".Default is not a valid priority level; Default adjusted to " << levels - 1;
+        _defaultPriority = levels - 1;
+    }
+
+    _context = properties->getPropertyWithDefault(prefix + ".Context", "priority");
+
+    PropertyDict operations = properties->getPropertiesForPrefix(prefix + ".Operation.");
+    for(PropertyDict::const_iterator p = operations.begin(); p != operations.end(); ++p)
+    {
+        istringstream is(p->second);
+        int priority;
+        if(!(is >> priority) || !is.eof() || priority < 0 || priority >= levels)
+        {
+            Warning out(instance->initializationData().logger);
+            out << p->first << " is not a valid priority level, the property is ignored";
+            continue;
+        }
+        _operations[p->first.substr(prefix.size() + sizeof(".Operation.") - 1)] = priority;
+    }
+
+    //
+    // The threads reserved for level 0 are not counted in the number
+    // of threads which can dispatch the other levels. At least one
+    // thread must remain for these levels.
+    //
+    int sizeMax = threadPool->sizeMax();
+    int reserved = properties->getPropertyAsInt(prefix + ".Reserved");
+    if(reserved < 0)
+    {
+        Warning out(instance->initializationData().logger);
+        out << prefix << ".Reserved < 0; Reserved adjusted to 0";
+        reserved = 0;
+    }
+    else if(reserved > 0 && reserved >= sizeMax)
+    {
+        Warning out(instance->initializationData().logger);
+        out << prefix << ".Reserved >= " << threadPool->prefix() << ".SizeMax; Reserved adjusted to "
+            << sizeMax - 1;
+        reserved = sizeMax - 1;
+    }
+    _maxInUseLow = reserved > 0 ? sizeMax - reserved : sizeMax;
+
+    _maxQueuedLow = properties->getPropertyAsInt(prefix + ".MaxQueued");
+    if(_maxQueuedLow < 0)
+    {
+        Warning out(instance->initializationData().logger);
+        out << prefix << ".MaxQueued < 0; MaxQueued adjusted to 0";
+        _maxQueuedLow = 0;
+    }
+}
+
+int
+IceInternal::DispatchQueue::priority(BasicStream& stream) const
+{
+    //
+    // The priority is read from the request header: the priority
+    // context entry takes precedence over the priority configured for
+    // the operation. The request isn't checked here, invalid requests
+    // get the default priority and are rejected when dispatched.
+    //
+    Buffer::Container::iterator start = stream.i;
+    int priority = _defaultPriority;
+    try
+    {
+        string name;
+        stream.read(name, false); // Identity name.
+        stream.read(name, false); // Identity category.
+        vector<string> facet;
+        stream.read(facet, false);
+        string operation;
+        stream.read(operation, false);
+
+        map<string, int>::const_iterator p = _operations.find(operation);
+        if(p != _operations.end())
+        {
+            priority = p->second;
+        }
+
+        if(!_context.empty())
+        {
+            Byte mode;
+            stream.read(mode);
+            Int sz;
+            stream.readSize(sz);
+            while(sz-- > 0)
+            {
+                string key;
+                string value;
+                stream.read(key, false);
+                stream.read(value, false);
+                if(key == _context)
+                {
+                    istringstream is(value);
+                    int level;
+                    if(is >> level && is.eof())
+                    {
+                        priority = max(0, min(level, static_cast<int>(_levels.size()) - 1));
+                    }
+                    break;
+                }
+            }
+        }
+    }
+    catch(const LocalException&)
+    {
+    }
+    stream.i = start;
+    return priority;
+}
+
+void
+IceInternal::DispatchQueue::queue(const DispatcherCallPtr& call, int priority, const ConnectionIPtr& connection)
+{
+    Lock sync(*this);
+    Level& level = _levels[priority];
+    if(level.calls.empty())
+    {
+        //
+        // A level which becomes active starts at the current virtual
+        // time, it doesn't get the dispatches it missed while idle.
+        //
+        level.pass = max(level.pass, _virtualTime);
+    }
+    level.calls.push_back(call);
+
+    if(priority > 0 && ++_queuedLow > _maxQueuedLow && _maxQueuedLow > 0 &&
+       find(_suspended.begin(), _suspended.end(), connection) == _suspended.end())
+    {
+        //
+        // The connection is suspended with the queue locked, so that
+        // it can't be resumed by next() before it's suspended.
+        //
+        connection->suspendRead();
+        _suspended.push_back(connection);
+    }
+}
+
+void
+IceInternal::DispatchQueue::execute(ThreadPoolCurrent& current)
+{
+    current.ioCompleted(); // Promote a follower.
+
+    //
+    // Dispatch the queued requests until none can be dispatched by
+    // this thread. The requests which are not dispatched because of
+    // the reserved threads are dispatched by the threads dispatching
+    // the other levels when they are done.
+    //
+    DispatcherCallPtr call;
+    int priority;
+    while(next(call, priority))
+    {
+        try
+        {
+            call->run();
+        }
+        catch(...)
+        {
+            Lock sync(*this);
+            if(priority > 0)
+            {
+                --_inUseLow;
+            }
+            throw;
+        }
+
+        Lock sync(*this);
+        if(priority > 0)
+        {
+            --_inUseLow;
+        }
+    }
+}
+
+bool
+IceInternal::DispatchQueue::next(DispatcherCallPtr& call, int& priority)
+{
+    Lock sync(*this);
+    int selected = -1;
+    for(int i = 0; i < static_cast<int>(_levels.size()); ++i)
+    {
+        if(_levels[i].calls.empty() || (i > 0 && _inUseLow >= _maxInUseLow))
+        {
+            continue;
+        }
+        if(selected < 0 || _levels[i].pass < _levels[selected].pass)
+        {
+            selected = i;
+        }
+    }
+    if(selected < 0)
+    {
+        return false;
+    }
+
+    Level& level = _levels[selected];
+    call = level.calls.front();
+    level.calls.pop_front();
+    _virtualTime = level.pass;
+    level.pass += level.stride;
+    if(selected > 0)
+    {
+        ++_inUseLow;
+        --_queuedLow;
+        if(!_suspended.empty() && _queuedLow <= _maxQueuedLow / 2)
+        {
+            for(vector<ConnectionIPtr>::const_iterator p = _suspended.begin(); p != _suspended.end(); ++p)
+            {
+                (*p)->resumeRead();
+            }
+            _suspended.clear();
+        }
+    }
+    priority = selected;
+    return true;
+}
@@ -0,0 +1,89 @@
+// **********************************************************************
+//
+// Copyright (c) 2003-2011 ZeroC, Inc. All rights reserved.
+//
+// This copy of Ice is licensed to you under the terms described in the
+// ICE_LICENSE file included in this distribution.
+//
+// **********************************************************************
+
+#ifndef ICE_DISPATCH_QUEUE_H
+#define ICE_DISPATCH_QUEUE_H
+
+#include <IceUtil/Mutex.h>
+#include <Ice/DispatchQueueF.h>
+#include <Ice/ThreadPool.h>
+#include <Ice/InstanceF.h>
+#include <Ice/Dispatcher.h>
+#include <Ice/ConnectionIF.h>
+
+#include <deque>
+#include <map>
+
+namespace IceInternal
+{
+
+//
+// The dispatch queue of an object adapter configured with
+// <adapter>.DispatchPriority.Weights. Requests received over the
+// connections of the adapter are queued with a priority level instead
+// of being dispatched by the thread which read them. The queue is a
+// work item of the adapter's thread pool, it's executed once for each
+// queued request and dispatches the next request selected by stride
+// scheduling: each level gets a share of the dispatches proportional
+// to its weight, and a level that was idle doesn't get credit for the
+// time it didn't use. Level 0 has the highest priority: the threads
+// reserved with <adapter>.DispatchPriority.Reserved only dispatch
+// requests of this level.
+//
+// With <adapter>.DispatchPriority.MaxQueued, a connection stops being
+// read when it queues a request of a level greater than 0 while that
+// many such requests are already queued. The connections are read
+// again once the queue has drained to half of the limit.
+//
+class DispatchQueue : public ThreadPoolWorkItem, public IceUtil::Mutex
+{
+public:
+
+    DispatchQueue(const InstancePtr&, const std::string&, const ThreadPoolPtr&);
+
+    //
+    // Returns the priority level of the request at the current
+    // position of the given stream. The position isn't changed.
+    //
+    int priority(BasicStream&) const;
+
+    //
+    // Queue a request received over the given connection.
+    //
+    void queue(const Ice::DispatcherCallPtr&, int, const Ice::ConnectionIPtr&);
+
+    virtual void execute(ThreadPoolCurrent&);
+
+private:
+
+    bool next(Ice::DispatcherCallPtr&, int&);
+
+    struct Level
+    {
+        Ice::Long stride;
+        Ice::Long pass;
+        std::deque<Ice::DispatcherCallPtr> calls;
+    };
+
+    std::vector<Level> _levels;
+    Ice::Long _virtualTime;
+    int _inUseLow; // Number of threads dispatching requests with a priority level greater than 0.
+    int _maxInUseLow;
+    int _queuedLow; // Number of queued requests with a priority level greater than 0.
+    int _maxQueuedLow;
+    std::vector<Ice::ConnectionIPtr> _suspended;
+
+    int _defaultPriority;
+    std::string _context;
+    std::map<std::string, int> _operations;
+};
+
+}
+
+#endif
@@ -0,0 +1,26 @@
+// **********************************************************************
+//
+// Copyright (c) 2003-2011 ZeroC, Inc. All rights reserved.
+//
+// This copy of Ice is licensed to you under the terms described in the
+// ICE_LICENSE file included in this distribution.
+//
+// **********************************************************************
+
+#ifndef ICE_DISPATCH_QUEUE_F_H
+#define ICE_DISPATCH_QUEUE_F_H
+
+#include <IceUtil/Shared.h>
+
+#include <Ice/Handle.h>
+
+namespace IceInternal
+{
+
+class DispatchQueue;
+IceUtil::Shared* upCast(DispatchQueue*);
+typedef Handle<DispatchQueue> DispatchQueuePtr;
+
+}
+
+#endif
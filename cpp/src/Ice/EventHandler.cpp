@@ -24,6 +24,10 @@ IceInternal::EventHandler::EventHandler() :
     _finish(false),
 #else
     _disabled(SocketOperationNone),
+    _ready(SocketOperationNone),
+    _readyQueued(false),
+    _edgeTriggered(false),
+    _reactor(-1),
 #endif
     _registered(SocketOperationNone)
 {
@@ -64,6 +64,10 @@ protected:
     bool _finish;
 #else
     SocketOperation _disabled;
+    SocketOperation _ready; // Operations reported by an edge-triggered selector and not yet completed.
+    bool _readyQueued; // True if the handler is queued with the edge-triggered selector ready handlers.
+    bool _edgeTriggered; // True if the handler supports edge-triggered selectors, see Selector::clearReady().
+    int _reactor; // The reactor of the handler if the thread pool uses the Reactor model.
 #endif
     SocketOperation _registered;
 
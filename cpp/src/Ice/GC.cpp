@@ -13,6 +13,7 @@
 #include <Ice/GC.h>
 #include <Ice/GCShared.h>
 #include <set>
+#include <vector>
 
 using namespace IceUtil;
 
@@ -22,7 +23,16 @@ namespace
 Mutex* numCollectorsMutex = 0;
 int numCollectors = 0;
 typedef std::set<IceInternal::GCShared*> GCObjectSet;
-GCObjectSet* gcObjects = 0; // Set of pointers to all existing classes with class data members.
+
+//
+// Candidate roots of garbage cycles, that is, the instances whose reference count was decremented
+// to a non-zero value since the collector last examined them. A cycle can only become garbage when
+// the last reference from outside the cycle is released, so every garbage cycle has at least one
+// member in these sets. A collection moves the candidates to pendingRoots when it starts; instances
+// that become candidates while it runs are left in candidateRoots for the next collection.
+//
+GCObjectSet* candidateRoots = 0;
+GCObjectSet* pendingRoots = 0;
 RecMutex* gcRecMutex = 0;
 
 class Init
@@ -32,7 +42,8 @@ public:
     Init()
     {
         numCollectorsMutex = new IceUtil::Mutex;
-        gcObjects = new GCObjectSet();
+        candidateRoots = new GCObjectSet();
+        pendingRoots = new GCObjectSet();
         gcRecMutex = new RecMutex();
     }
 
@@ -42,8 +53,10 @@ public:
         numCollectorsMutex = 0;
         delete gcRecMutex;
         gcRecMutex = 0;
-        delete gcObjects;
-        gcObjects = 0;
+        delete candidateRoots;
+        candidateRoots = 0;
+        delete pendingRoots;
+        pendingRoots = 0;
     }
 };
 
@@ -51,28 +64,6 @@ Init init;
 
 }
 
-
-namespace IceInternal
-{
-
-void
-recursivelyReachable(GCShared* p, GCObjectSet& o)
-{
-    if(o.find(p) == o.end())
-    {
-        assert(p);
-        o.insert(p);
-        GCCountMap tmp;
-        p->__gcReachable(tmp);
-        for(GCCountMap::const_iterator i = tmp.begin(); i != tmp.end(); ++i)
-        {
-            recursivelyReachable(i->first, o);
-        }
-    }
-}
-
-}
-
 using namespace IceInternal;
 
 //
@@ -83,15 +74,6 @@ IceInternal::GCShared::__incRef()
 {
     IceUtilInternal::MutexPtrLock<IceUtil::RecMutex> lock(gcRecMutex);
     assert(_ref >= 0);
-    if(_ref == 0 && gcObjects != 0)
-    {
-#ifdef NDEBUG // To avoid annoying warnings about variables that are not used...
-        gcObjects->insert(this);
-#else
-        std::pair<GCObjectSet::iterator, bool> rc = gcObjects->insert(this);
-        assert(rc.second);
-#endif
-    }
     ++_ref;
 }
 
@@ -101,16 +83,27 @@ IceInternal::GCShared::__decRef()
     IceUtilInternal::MutexPtrLock<IceUtil::RecMutex> lock(gcRecMutex);
     bool doDelete = false;
     assert(_ref > 0);
-    if(--_ref == 0 && gcObjects != 0)
+    if(--_ref == 0)
     {
-        doDelete = !_noDelete;
-        _noDelete = true;
-#ifdef NDEBUG // To avoid annoying warnings about variables that are not used...
-        gcObjects->erase(this);
-#else
-        GCObjectSet::size_type num = gcObjects->erase(this);
-        assert(num == 1);
-#endif
+        if(candidateRoots != 0)
+        {
+            doDelete = !_noDelete;
+            _noDelete = true;
+            if(_gcCandidate)
+            {
+                _gcCandidate = false;
+                candidateRoots->erase(this);
+                pendingRoots->erase(this);
+            }
+        }
+    }
+    else if(!_gcCandidate && candidateRoots != 0)
+    {
+        //
+        // The remaining references might all come from a garbage cycle.
+        //
+        _gcCandidate = true;
+        candidateRoots->insert(this);
     }
     lock.release();
     if(doDelete)
@@ -138,7 +131,7 @@ IceInternal::GCShared::__setNoDelete(bool b)
 //
 
 
-IceInternal::GC::GC(int interval, StatsCallback cb)
+IceInternal::GC::GC(int interval, int maxPause, StatsCallback cb)
 {
     IceUtilInternal::MutexPtrLock<IceUtil::Mutex> sync(numCollectorsMutex);
     if(numCollectors++ > 0)
@@ -149,6 +142,7 @@ IceInternal::GC::GC(int interval, StatsCallback cb)
     _state = NotStarted;
     _collecting = false;
     _interval = interval;
+    _maxPause = Time::milliSeconds(maxPause);
     _statsCallback = cb;
 }
 
@@ -244,132 +238,169 @@ IceInternal::GC::collectGarbage()
             return;
         }
         _collecting = true;
-        assert(gcObjects != 0);
+        assert(candidateRoots != 0);
     }
 
-    // Prevent any further class reference count activity.
-    IceUtilInternal::MutexPtrLock<IceUtil::RecMutex> lock(gcRecMutex);
-
-    Time t;
     GCStats stats;
+    stats.examined = 0;
+    stats.collected = 0;
+    stats.pauses = 0;
+
+    {
+        IceUtilInternal::MutexPtrLock<IceUtil::RecMutex> lock(gcRecMutex);
+        assert(pendingRoots->empty());
+        pendingRoots->swap(*candidateRoots);
+    }
+
+    //
+    // Examine the pending roots in slices. Each slice prevents any class reference count
+    // activity until it ends, which is once the maximum pause is exceeded or when there are
+    // no more pending roots. Threads using classes run between slices.
+    //
+    while(true)
+    {
+        IceUtilInternal::MutexPtrLock<IceUtil::RecMutex> lock(gcRecMutex);
+        if(pendingRoots->empty())
+        {
+            break;
+        }
+
+        Time start = Time::now(Time::Monotonic);
+        collectSlice(start, stats);
+        Time pause = Time::now(Time::Monotonic) - start;
+
+        ++stats.pauses;
+        stats.time += pause;
+        if(pause > stats.maxPause)
+        {
+            stats.maxPause = pause;
+        }
+
+        lock.release();
+        ThreadControl::yield();
+    }
 
     if(_statsCallback)
     {
-        t = Time::now(IceUtil::Time::Monotonic);
-        stats.examined = static_cast<int>(gcObjects->size());
+        _statsCallback(stats);
     }
 
-    GCCountMap counts;
+    {
+        Monitor<Mutex>::Lock sync(*this);
+
+        _collecting = false;
+    }
+}
 
+void
+IceInternal::GC::collectSlice(const Time& start, GCStats& stats)
+{
+    //
+    // Trial deletion. The counts map contains, for each instance reachable from the roots examined
+    // in this slice, the reference count of the instance minus the number of times the instance is
+    // pointed at by the other instances of the map.
+    //
+    GCCountMap counts;
+    std::vector<GCShared*> stack;
+    do
     {
         //
-        // gcObjects contains the set of class instances that have at least one member of class type,
-        // that is, gcObjects contains all those instances that can point at other instances.
-        //
-        // Create a map that, for each object in gcObjects, contains an <object, refcount> pair.
-        // In addition, for each object in gcObjects, add the objects that are immediately (not
-        // recursively) reachable from that object to a reachable map that counts how many times
-        // the object is pointed at.
+        // The pending roots are never in the counts map, as the examined instances are no
+        // longer candidates.
         //
-        GCCountMap reachable;
+        GCShared* root = *pendingRoots->begin();
+        counts.insert(GCCountMap::value_type(root, root->__getRefUnsafe()));
+        stack.push_back(root);
+        while(!stack.empty())
         {
-            for(GCObjectSet::const_iterator i = gcObjects->begin(); i != gcObjects->end(); ++i)
+            GCShared* p = stack.back();
+            stack.pop_back();
+
+            if(p->_gcCandidate)
             {
-                counts.insert(GCCountMap::value_type(*i, (*i)->__getRefUnsafe()));
-                (*i)->__gcReachable(reachable);
+                p->_gcCandidate = false;
+                candidateRoots->erase(p);
+                pendingRoots->erase(p);
             }
-        }
 
-        //
-        // Decrement the reference count for each object in the counts map by the count in the reachable
-        // map. This drops the reference count of each object in the counts map by the number of times that
-        // the object is pointed at by other objects in the counts map.
-        //
-        {
+            GCCountMap reachable;
+            p->__gcReachable(reachable);
             for(GCCountMap::const_iterator i = reachable.begin(); i != reachable.end(); ++i)
             {
-                GCCountMap::iterator pos = counts.find(i->first);
-                assert(pos != counts.end());
-                pos->second -= i->second;
+                std::pair<GCCountMap::iterator, bool> rc =
+                    counts.insert(GCCountMap::value_type(i->first, i->first->__getRefUnsafe()));
+                if(rc.second)
+                {
+                    stack.push_back(i->first);
+                }
+                rc.first->second -= i->second;
             }
         }
     }
+    while(!pendingRoots->empty() && (_maxPause == Time() || Time::now(Time::Monotonic) - start < _maxPause));
+
+    stats.examined += static_cast<int>(counts.size());
 
+    //
+    // Any instances in the counts map with a count > 0 are referenced from outside the map (for
+    // example, via a Ptr variable on the stack or by an instance that isn't reachable from the
+    // roots). The live instances are these instances, as well as all the instances that are
+    // (recursively) reachable from them. We mark the live instances by setting their count to 1.
+    //
+    for(GCCountMap::const_iterator i = counts.begin(); i != counts.end(); ++i)
     {
-        //
-        // Any instances in the counts map with a ref count > 0 are referenced from outside the objects in
-        // gcObjects (and are therefore reachable from the program, for example, via Ptr variable on the stack).
-        // The set of live objects therefore are all the objects with a reference count > 0, as well as all
-        // objects that are (recursively) reachable from these objects.
-        //
-        GCObjectSet liveObjects;
+        if(i->second > 0)
         {
-            for(GCCountMap::const_iterator i = counts.begin(); i != counts.end(); ++i)
-            {
-                if(i->second > 0)
-                {
-                    recursivelyReachable(i->first, liveObjects);
-                }
-            }
+            stack.push_back(i->first);
         }
+    }
+    while(!stack.empty())
+    {
+        GCShared* p = stack.back();
+        stack.pop_back();
 
-        //
-        // Remove all live objects from the counts map.
-        //
+        GCCountMap reachable;
+        p->__gcReachable(reachable);
+        for(GCCountMap::const_iterator i = reachable.begin(); i != reachable.end(); ++i)
         {
-            for(GCObjectSet::const_iterator i = liveObjects.begin(); i != liveObjects.end(); ++i)
+            GCCountMap::iterator pos = counts.find(i->first);
+            assert(pos != counts.end());
+            if(pos->second <= 0)
             {
-#ifndef NDEBUG
-                size_t erased =
-#endif
-                    counts.erase(*i);
-                assert(erased != 0);
+                pos->second = 1;
+                stack.push_back(i->first);
             }
         }
     }
 
     //
-    // What is left in the counts map can be garbage collected.
+    // What is left with a count <= 0 can be garbage collected.
     //
+    std::vector<GCShared*> garbage;
+    for(GCCountMap::const_iterator i = counts.begin(); i != counts.end(); ++i)
     {
-        GCCountMap::const_iterator i;
-        for(i = counts.begin(); i != counts.end(); ++i)
-        {
-            //
-            // For classes with members that point at potentially-cyclic instances, __gcClear()
-            // decrements the reference count of the pointed-at instances as many times as they are
-            // pointed at and clears the corresponding Ptr members in the pointing class.
-            // For classes that cannot be part of a cycle (because they do not contain class members)
-            // and are therefore true leaves, __gcClear() assigns 0 to the corresponding class member,
-            // which either decrements the ref count or, if it reaches zero, deletes the instance as usual.
-            //
-            i->first->__gcClear();
-        }
-        for(i = counts.begin(); i != counts.end(); ++i)
+        if(i->second <= 0)
         {
-            gcObjects->erase(i->first); // Remove this object from candidate set.
-            delete i->first; // Delete this object.
+            garbage.push_back(i->first);
         }
     }
 
-    if(_statsCallback)
+    std::vector<GCShared*>::const_iterator j;
+    for(j = garbage.begin(); j != garbage.end(); ++j)
     {
-        stats.time = Time::now(IceUtil::Time::Monotonic) - t;
-        stats.collected = static_cast<int>(counts.size());
-        _statsCallback(stats);
+        //
+        // For classes with members that point at potentially-cyclic instances, __gcClear()
+        // decrements the reference count of the pointed-at instances as many times as they are
+        // pointed at and clears the corresponding Ptr members in the pointing class.
+        // For classes that cannot be part of a cycle (because they do not contain class members)
+        // and are therefore true leaves, __gcClear() assigns 0 to the corresponding class member,
+        // which either decrements the ref count or, if it reaches zero, deletes the instance as usual.
+        //
+        (*j)->__gcClear();
     }
-
-    //
-    // We clear explicitly under protection of the lock, instead of waiting for the
-    // counts destructor. This avoids lots of lock contention later because, otherwise,
-    // the destructor of each object in the counts set would acquire and release
-    // gcRecMutex._m.
-    //
-    counts.clear();
-
+    for(j = garbage.begin(); j != garbage.end(); ++j)
     {
-        Monitor<Mutex>::Lock sync(*this);
-
-        _collecting = false;
+        delete *j;
     }
+    stats.collected += static_cast<int>(garbage.size());
 }
@@ -22,7 +22,9 @@ struct GCStats
 {
     int examined;
     int collected;
-    IceUtil::Time time;
+    int pauses; // Number of times the collector locked out the threads using classes.
+    IceUtil::Time time; // Total time of the pauses.
+    IceUtil::Time maxPause;
 };
 
 class GC : public ::IceUtil::Thread, public ::IceUtil::Monitor< ::IceUtil::Mutex>
@@ -31,7 +33,7 @@ public:
 
     typedef void (*StatsCallback)(const ::IceInternal::GCStats&);
 
-    GC(int, StatsCallback);
+    GC(int, int, StatsCallback);
     virtual ~GC();
     virtual void run();
     void stop();
@@ -39,10 +41,13 @@ public:
 
 private:
 
+    void collectSlice(const IceUtil::Time&, GCStats&);
+
     enum State { NotStarted, Started, Stopping, Stopped };
     State _state;
     bool _collecting;
     int _interval;
+    IceUtil::Time _maxPause;
     StatsCallback _statsCallback;
 };
 
@@ -0,0 +1,352 @@
+// **********************************************************************
+//
+// Copyright (c) 2003-2011 ZeroC, Inc. All rights reserved.
+//
+// This copy of Ice is licensed to you under the terms described in the
+// ICE_LICENSE file included in this distribution.
+//
+// **********************************************************************
+
+#ifndef ICE_HASH_TABLE_H
+#define ICE_HASH_TABLE_H
+
+#include <Ice/Config.h>
+#include <vector>
+
+namespace IceInternal
+{
+
+//
+// Hash functions for the keys of HashTable. The table scrambles the
+// hash values, they don't need to be well distributed.
+//
+struct IntHash
+{
+    size_t operator()(Ice::Int key) const
+    {
+        return static_cast<size_t>(key);
+    }
+};
+
+struct PointerHash
+{
+    size_t operator()(const void* key) const
+    {
+        return reinterpret_cast<size_t>(key) >> 3;
+    }
+};
+
+struct StringHash
+{
+    size_t operator()(const std::string& key) const
+    {
+        //
+        // FNV-1a.
+        //
+        unsigned int h = 2166136261U;
+        for(std::string::const_iterator p = key.begin(); p != key.end(); ++p)
+        {
+            h = (h ^ static_cast<unsigned char>(*p)) * 16777619U;
+        }
+        return h;
+    }
+};
+
+//
+// An open-addressed hash table with linear probing, used for the
+// tables of the class instances and type ids of an encapsulation and
+// for the outstanding requests of a connection (see RequestTable).
+// Unlike std::map, inserting an element doesn't allocate memory once
+// the table has grown, and clear() keeps the slots of the table so
+// that it can be reused for the next encapsulation. The slots are
+// released instead if the table is larger than maxKeptSize, or if
+// it's mostly empty so that clearing it would be needlessly costly.
+//
+// Erased slots are marked and reused by later inserts. Iterators
+// and references returned by find() and insert() are invalidated by
+// the next insert().
+//
+template<typename K, typename V, typename H>
+class HashTable : private IceUtil::noncopyable
+{
+    enum State { Empty, Used, Erased };
+
+public:
+
+    class iterator;
+
+    struct value_type
+    {
+        value_type() : first(), second(), state(Empty)
+        {
+        }
+
+        K first;
+        V second;
+
+    private:
+
+        friend class HashTable;
+        friend class iterator;
+
+        State state;
+    };
+
+    class iterator
+    {
+    public:
+
+        iterator() : _p(0), _end(0)
+        {
+        }
+
+        value_type& operator*() const
+        {
+            return *_p;
+        }
+
+        value_type* operator->() const
+        {
+            return _p;
+        }
+
+        iterator& operator++()
+        {
+            ++_p;
+            skip();
+            return *this;
+        }
+
+        bool operator==(const iterator& rhs) const
+        {
+            return _p == rhs._p;
+        }
+
+        bool operator!=(const iterator& rhs) const
+        {
+            return _p != rhs._p;
+        }
+
+    private:
+
+        friend class HashTable;
+
+        iterator(value_type* p, value_type* end) : _p(p), _end(end)
+        {
+        }
+
+        void skip()
+        {
+            while(_p != _end && _p->state != Used)
+            {
+                ++_p;
+            }
+        }
+
+        value_type* _p;
+        value_type* _end;
+    };
+
+    HashTable() :
+        _size(0),
+        _used(0)
+    {
+    }
+
+    bool empty() const
+    {
+        return _size == 0;
+    }
+
+    size_t size() const
+    {
+        return _size;
+    }
+
+    iterator begin()
+    {
+        if(_slots.empty())
+        {
+            return iterator();
+        }
+        iterator p(&_slots[0], &_slots[0] + _slots.size());
+        p.skip();
+        return p;
+    }
+
+    iterator end()
+    {
+        if(_slots.empty())
+        {
+            return iterator();
+        }
+        return iterator(&_slots[0] + _slots.size(), &_slots[0] + _slots.size());
+    }
+
+    iterator find(const K& key)
+    {
+        if(_size == 0)
+        {
+            return end();
+        }
+
+        size_t mask = _slots.size() - 1;
+        for(size_t i = slot(key);; i = (i + 1) & mask)
+        {
+            if(_slots[i].state == Used && _slots[i].first == key)
+            {
+                return iterator(&_slots[i], &_slots[0] + _slots.size());
+            }
+            else if(_slots[i].state == Empty)
+            {
+                return end();
+            }
+        }
+    }
+
+    //
+    // The key must not already be in the table.
+    //
+    V& insert(const K& key, const V& value)
+    {
+        //
+        // Keep the number of used and erased slots under 3/4 of the
+        // table to keep probe sequences short. The table is rehashed
+        // with the same size if it's mostly erased slots.
+        //
+        if((_used + 1) * 4 > _slots.size() * 3)
+        {
+            if(_slots.empty())
+            {
+                rehash(minSize);
+            }
+            else
+            {
+                rehash((_size + 1) * 2 > _slots.size() ? _slots.size() * 2 : _slots.size());
+            }
+        }
+
+        size_t mask = _slots.size() - 1;
+        size_t i = slot(key);
+        while(_slots[i].state == Used)
+        {
+            assert(!(_slots[i].first == key));
+            i = (i + 1) & mask;
+        }
+        if(_slots[i].state == Empty)
+        {
+            ++_used;
+        }
+        _slots[i].state = Used;
+        _slots[i].first = key;
+        _slots[i].second = value;
+        ++_size;
+        return _slots[i].second;
+    }
+
+    void erase(iterator p)
+    {
+        assert(p != end());
+
+        size_t mask = _slots.size() - 1;
+        size_t i = p._p - &_slots[0];
+        p->first = K();
+        p->second = V();
+        --_size;
+
+        //
+        // The slot must remain marked as erased if it's part of the
+        // probe sequence of other keys, that is if the next slot
+        // isn't empty.
+        //
+        if(_slots[(i + 1) & mask].state != Empty)
+        {
+            p._p->state = Erased;
+        }
+        else
+        {
+            p._p->state = Empty;
+            --_used;
+        }
+    }
+
+    bool erase(const K& key)
+    {
+        iterator p = find(key);
+        if(p == end())
+        {
+            return false;
+        }
+        erase(p);
+        return true;
+    }
+
+    void clear()
+    {
+        if(_used == 0)
+        {
+            return;
+        }
+
+        if(_slots.size() > maxKeptSize || (_slots.size() > minSize * 4 && _used * 8 < _slots.size()))
+        {
+            std::vector<value_type>().swap(_slots);
+        }
+        else
+        {
+            for(typename std::vector<value_type>::iterator p = _slots.begin(); p != _slots.end(); ++p)
+            {
+                if(p->state != Empty)
+                {
+                    p->state = Empty;
+                    p->first = K();
+                    p->second = V();
+                }
+            }
+        }
+        _size = 0;
+        _used = 0;
+    }
+
+private:
+
+    enum { minSize = 16, maxKeptSize = 1 << 16 };
+
+    size_t slot(const K& key) const
+    {
+        //
+        // Scramble the hash value so that keys with regular patterns,
+        // such as sequential indexes or aligned addresses, don't
+        // collide in the low bits.
+        //
+        unsigned int h = static_cast<unsigned int>(H()(key));
+        h ^= h >> 16;
+        h *= 0x45d9f3bU;
+        h ^= h >> 16;
+        return static_cast<size_t>(h) & (_slots.size() - 1);
+    }
+
+    void rehash(size_t n)
+    {
+        std::vector<value_type> slots(n);
+        _slots.swap(slots);
+        _size = 0;
+        _used = 0;
+        for(typename std::vector<value_type>::iterator p = slots.begin(); p != slots.end(); ++p)
+        {
+            if(p->state == Used)
+            {
+                V& value = insert(p->first, V());
+                std::swap(value, p->second);
+            }
+        }
+    }
+
+    std::vector<value_type> _slots;
+    size_t _size; // Number of keys.
+    size_t _used; // Number of keys and erased slots.
+};
+
+}
+
+#endif
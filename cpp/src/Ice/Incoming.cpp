@@ -15,12 +15,14 @@
 #include <Ice/ServantManager.h>
 #include <Ice/Object.h>
 #include <Ice/ConnectionI.h>
+#include <Ice/ResponseHandler.h>
 #include <Ice/LocalException.h>
 #include <Ice/Instance.h>
 #include <Ice/Properties.h>
 #include <Ice/LoggerUtil.h>
 #include <Ice/Protocol.h>
 #include <Ice/ReplyStatus.h>
+#include <Ice/MetricsManager.h>
 #include <IceUtil/StringUtil.h>
 
 using namespace std;
@@ -34,13 +36,17 @@ extern bool ICE_DECLSPEC_IMPORT printStackTraces;
 
 }
 
-IceInternal::IncomingBase::IncomingBase(Instance* instance, ConnectionI* connection,
-                                        const ObjectAdapterPtr& adapter,
+IceInternal::IncomingBase::IncomingBase(Instance* instance, ResponseHandler* responseHandler,
+                                        ConnectionI* connection, const ObjectAdapterPtr& adapter,
                                         bool response, Byte compress, Int requestId) :
     _response(response),
     _compress(compress),
     _os(instance),
-    _connection(connection)
+    _responseHandler(responseHandler),
+    _connection(connection),
+    _dispatchStart(0),
+    _bytesIn(0),
+    _notExist(false)
 {
     _current.adapter = adapter;
     _current.con = _connection;
@@ -75,8 +81,20 @@ IceInternal::IncomingBase::adopt(IncomingBase& other)
 
     _os.swap(other._os);
 
+    _responseHandler = other._responseHandler;
+    other._responseHandler = 0;
+
     _connection = other._connection;
     other._connection = 0;
+
+    _dispatchStart = other._dispatchStart;
+    other._dispatchStart = 0;
+
+    _bytesIn = other._bytesIn;
+    other._bytesIn = 0;
+
+    _notExist = other._notExist;
+    other._notExist = false;
 }
 
 void
@@ -132,7 +150,7 @@ IceInternal::IncomingBase::__servantLocatorFinished()
     }
     catch(const UserException& ex)
     {
-        assert(_connection);
+        assert(_responseHandler);
 
         //
         // The operation may have already marshaled a reply; we must overwrite that reply.
@@ -145,14 +163,14 @@ IceInternal::IncomingBase::__servantLocatorFinished()
             _os.startWriteEncaps();
             _os.write(ex);
             _os.endWriteEncaps();
-            _connection->sendResponse(&_os, _compress);
+            __sendResponse(false);
         }
         else
         {
-            _connection->sendNoResponse();
+            __sendNoResponse(false);
         }
 
-        _connection = 0;
+        _responseHandler = 0;
     }
     catch(const std::exception& ex)
     {
@@ -168,7 +186,7 @@ IceInternal::IncomingBase::__servantLocatorFinished()
 void
 IceInternal::IncomingBase::__handleException(const std::exception& exc)
 {
-    assert(_connection);
+    assert(_responseHandler);
 
     if(dynamic_cast<const RequestFailedException*>(&exc))
     {
@@ -190,6 +208,8 @@ IceInternal::IncomingBase::__handleException(const std::exception& exc)
             rfe->operation = _current.operation;
         }
 
+        _notExist = true;
+
         if(_os.instance()->initializationData().properties->getPropertyAsIntWithDefault("Ice.Warn.Dispatch", 1) > 1)
         {
             __warning(*rfe);
@@ -232,11 +252,11 @@ IceInternal::IncomingBase::__handleException(const std::exception& exc)
 
             _os.write(rfe->operation, false);
 
-            _connection->sendResponse(&_os, _compress);
+            __sendResponse(false);
         }
         else
         {
-            _connection->sendNoResponse();
+            __sendNoResponse(false);
         }
     }
     else if(const Exception* ex = dynamic_cast<const Exception*>(&exc))
@@ -299,11 +319,11 @@ IceInternal::IncomingBase::__handleException(const std::exception& exc)
                 str << *ex;
                 _os.write(str.str(), false);
             }
-            _connection->sendResponse(&_os, _compress);
+            __sendResponse(false);
         }
         else
         {
-            _connection->sendNoResponse();
+            __sendNoResponse(false);
         }
     }
     else
@@ -321,15 +341,15 @@ IceInternal::IncomingBase::__handleException(const std::exception& exc)
             ostringstream str;
             str << "std::exception: " << exc.what();
             _os.write(str.str(), false);
-            _connection->sendResponse(&_os, _compress);
+            __sendResponse(false);
         }
         else
         {
-            _connection->sendNoResponse();
+            __sendNoResponse(false);
         }
     }
 
-    _connection = 0;
+    _responseHandler = 0;
 }
 
 void
@@ -340,7 +360,7 @@ IceInternal::IncomingBase::__handleException()
         __warning("unknown c++ exception");
     }
 
-    assert(_connection);
+    assert(_responseHandler);
 
     if(_response)
     {
@@ -349,21 +369,49 @@ IceInternal::IncomingBase::__handleException()
         _os.write(replyUnknownException);
         string reason = "unknown c++ exception";
         _os.write(reason, false);
-        _connection->sendResponse(&_os, _compress);
+        __sendResponse(false);
     }
     else
     {
-        _connection->sendNoResponse();
+        __sendNoResponse(false);
     }
 
-    _connection = 0;
+    _responseHandler = 0;
+}
+
+void
+IceInternal::IncomingBase::__sendResponse(bool ok)
+{
+    if(_dispatchStart)
+    {
+        //
+        // The reply payload follows the reply status.
+        //
+        IceUtil::Int64 now = IceUtil::Time::now(IceUtil::Time::Monotonic).toMicroSeconds();
+        _os.instance()->metrics()->dispatched(_notExist ? string() : _current.operation, now - _dispatchStart, !ok,
+                                              _bytesIn, _os.b.size() - headerSize - 5);
+        _dispatchStart = 0;
+    }
+    _responseHandler->sendResponse(&_os, _compress);
 }
 
+void
+IceInternal::IncomingBase::__sendNoResponse(bool ok)
+{
+    if(_dispatchStart)
+    {
+        IceUtil::Int64 now = IceUtil::Time::now(IceUtil::Time::Monotonic).toMicroSeconds();
+        _os.instance()->metrics()->dispatched(_notExist ? string() : _current.operation, now - _dispatchStart, !ok,
+                                              _bytesIn, 0);
+        _dispatchStart = 0;
+    }
+    _responseHandler->sendNoResponse();
+}
 
-IceInternal::Incoming::Incoming(Instance* instance, ConnectionI* connection,
+IceInternal::Incoming::Incoming(Instance* instance, ResponseHandler* responseHandler, ConnectionI* connection,
                                 const ObjectAdapterPtr& adapter,
                                 bool response, Byte compress, Int requestId) :
-    IncomingBase(instance, connection, adapter, response, compress, requestId),
+    IncomingBase(instance, responseHandler, connection, adapter, response, compress, requestId),
     _is(instance),
     _inParamPos(0)
 {
@@ -437,6 +485,11 @@ IceInternal::Incoming::setActive(IncomingAsync& cb)
 void
 IceInternal::Incoming::invoke(const ServantManagerPtr& servantManager)
 {
+    if(_os.instance()->metrics())
+    {
+        _dispatchStart = IceUtil::Time::now(IceUtil::Time::Monotonic).toMicroSeconds();
+    }
+
     //
     // Read the current.
     //
@@ -476,6 +529,15 @@ IceInternal::Incoming::invoke(const ServantManagerPtr& servantManager)
         _current.ctx.insert(_current.ctx.end(), pr);
     }
 
+    if(_dispatchStart && _is.b.end() - _is.i >= static_cast<int>(sizeof(Int)))
+    {
+        //
+        // Peek at the size of the parameter encapsulation.
+        //
+        _is.read(_bytesIn);
+        _is.i -= sizeof(Int);
+    }
+
     if(_response)
     {
         assert(_os.b.size() == headerSize + 4); // Reply status position.
@@ -570,6 +632,7 @@ IceInternal::Incoming::invoke(const ServantManagerPtr& servantManager)
     }
     else if(replyStatus == replyOK)
     {
+        _notExist = true;
         if(servantManager && servantManager->hasServant(_current.id))
         {
             replyStatus = replyFacetNotExist;
@@ -598,7 +661,7 @@ IceInternal::Incoming::invoke(const ServantManagerPtr& servantManager)
         return;
     }
 
-    assert(_connection);
+    assert(_responseHandler);
 
     if(_response)
     {
@@ -633,14 +696,14 @@ IceInternal::Incoming::invoke(const ServantManagerPtr& servantManager)
             *(_os.b.begin() + headerSize + 4) = replyStatus; // Reply status position.
         }
 
-        _connection->sendResponse(&_os, _compress);
+        __sendResponse(replyStatus == replyOK);
     }
     else
     {
-        _connection->sendNoResponse();
+        __sendNoResponse(replyStatus == replyOK);
     }
 
-    _connection = 0;
+    _responseHandler = 0;
 }
 
 
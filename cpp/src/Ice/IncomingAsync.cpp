@@ -10,7 +10,7 @@
 #include <Ice/IncomingAsync.h>
 #include <Ice/ServantLocator.h>
 #include <Ice/Object.h>
-#include <Ice/ConnectionI.h>
+#include <Ice/ResponseHandler.h>
 #include <Ice/LocalException.h>
 #include <Ice/Protocol.h>
 #include <Ice/Instance.h>
@@ -54,7 +54,8 @@ Init init;
 IceInternal::IncomingAsync::IncomingAsync(Incoming& in) :
     IncomingBase(in),
     _instanceCopy(_os.instance()),
-    _connectionCopy(_connection),
+    _responseHandlerCopy(_responseHandler),
+    _requestBuffer(in.is()->b.share()),
     _retriable(in.isRetriable()),
     _active(true)
 {
@@ -119,7 +120,7 @@ IceInternal::IncomingAsync::ice_exception(const ::std::exception& ex)
         _active = false;
     }
 
-    if(_connection)
+    if(_responseHandler)
     {
         __exception(ex);
     }
@@ -170,7 +171,7 @@ IceInternal::IncomingAsync::ice_exception()
         _active = false;
     }
 
-    if(_connection)
+    if(_responseHandler)
     {
         __exception();
     }
@@ -196,7 +197,7 @@ IceInternal::IncomingAsync::__response(bool ok)
             return;
         }
 
-        assert(_connection);
+        assert(_responseHandler);
 
         if(_response)
         {
@@ -211,18 +212,18 @@ IceInternal::IncomingAsync::__response(bool ok)
                 *(_os.b.begin() + headerSize + 4) = replyUserException;
             }
 
-            _connection->sendResponse(&_os, _compress);
+            __sendResponse(ok);
         }
         else
         {
-            _connection->sendNoResponse();
+            __sendNoResponse(ok);
         }
 
-        _connection = 0;
+        _responseHandler = 0;
     }
     catch(const LocalException& ex)
     {
-        _connection->invokeException(ex, 1); // Fatal invocation exception
+        _responseHandler->invokeException(_current.requestId, ex, 1); // Fatal invocation exception
     }
 }
 
@@ -240,7 +241,7 @@ IceInternal::IncomingAsync::__exception(const std::exception& exc)
     }
     catch(const LocalException& ex)
     {
-        _connection->invokeException(ex, 1);  // Fatal invocation exception
+        _responseHandler->invokeException(_current.requestId, ex, 1);  // Fatal invocation exception
     }
 }
 
@@ -258,7 +259,7 @@ IceInternal::IncomingAsync::__exception()
     }
     catch(const LocalException& ex)
     {
-        _connection->invokeException(ex, 1);  // Fatal invocation exception
+        _responseHandler->invokeException(_current.requestId, ex, 1);  // Fatal invocation exception
     }
 }
 
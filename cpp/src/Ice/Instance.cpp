@@ -28,9 +28,15 @@
 #include <Ice/LoggerI.h>
 #include <Ice/Network.h>
 #include <Ice/EndpointFactoryManager.h>
+#include <Ice/CodecManager.h>
 #include <Ice/RetryQueue.h>
+#include <Ice/BufferPool.h>
+#include <Ice/MetricsManager.h>
 #include <Ice/TcpEndpointI.h>
 #include <Ice/UdpEndpointI.h>
+#ifndef _WIN32
+#   include <Ice/UnixEndpointI.h>
+#endif
 #include <Ice/DynamicLibrary.h>
 #include <Ice/PluginManagerI.h>
 #include <Ice/Initialize.h>
@@ -335,6 +341,20 @@ IceInternal::Instance::endpointFactoryManager() const
     return _endpointFactoryManager;
 }
 
+CodecManagerPtr
+IceInternal::Instance::codecManager() const
+{
+    IceUtil::RecMutex::Lock sync(*this);
+
+    if(_state == StateDestroyed)
+    {
+        throw CommunicatorDestroyedException(__FILE__, __LINE__);
+    }
+
+    assert(_codecManager);
+    return _codecManager;
+}
+
 DynamicLibraryListPtr
 IceInternal::Instance::dynamicLibraryList() const
 {
@@ -938,6 +958,25 @@ IceInternal::Instance::Instance(const CommunicatorPtr& communicator, const Initi
             }
         }
 
+        //
+        // Message buffers are pooled unless the pool high-water mark is
+        // set to zero.
+        //
+        if(_initData.properties->getPropertyAsIntWithDefault("Ice.BufferPool.HighWater", 4096) > 0)
+        {
+            const_cast<BufferPoolPtr&>(_bufferPool) = new BufferPool(_initData.properties);
+        }
+
+        //
+        // Metrics are collected by default if the admin object is
+        // enabled.
+        //
+        bool admin = !_initData.properties->getProperty("Ice.Admin.Endpoints").empty();
+        if(_initData.properties->getPropertyAsIntWithDefault("Ice.Metrics", admin ? 1 : 0) > 0)
+        {
+            const_cast<MetricsManagerPtr&>(_metrics) = new MetricsManager(_bufferPool);
+        }
+
         //
         // Client ACM enabled by default. Server ACM disabled by default.
         //
@@ -977,6 +1016,14 @@ IceInternal::Instance::Instance(const CommunicatorPtr& communicator, const Initi
         _endpointFactoryManager->add(tcpEndpointFactory);
         EndpointFactoryPtr udpEndpointFactory = new UdpEndpointFactory(this);
         _endpointFactoryManager->add(udpEndpointFactory);
+#ifndef _WIN32
+        EndpointFactoryPtr unixEndpointFactory = new UnixEndpointFactory(this, UnixEndpointType);
+        _endpointFactoryManager->add(unixEndpointFactory);
+        EndpointFactoryPtr shmEndpointFactory = new UnixEndpointFactory(this, ShmEndpointType);
+        _endpointFactoryManager->add(shmEndpointFactory);
+#endif
+
+        _codecManager = new CodecManager;
 
         _dynamicLibraryList = new DynamicLibraryList;
 
@@ -997,7 +1044,7 @@ IceInternal::Instance::Instance(const CommunicatorPtr& communicator, const Initi
         }
 
         //
-        // Add Process and Properties facets
+        // Add Process, Properties and Metrics facets
         //
 
         StringSeq facetSeq = _initData.properties->getPropertyAsList("Ice.Admin.Facets");
@@ -1009,6 +1056,10 @@ IceInternal::Instance::Instance(const CommunicatorPtr& communicator, const Initi
 
         _adminFacets.insert(FacetMap::value_type("Properties", new PropertiesAdminI(_initData.properties)));
         _adminFacets.insert(FacetMap::value_type("Process", new ProcessI(communicator)));
+        if(_metrics)
+        {
+            _adminFacets.insert(FacetMap::value_type("Metrics", new MetricsAdminI(_metrics)));
+        }
 
         __setNoDelete(false);
     }
@@ -1042,6 +1093,7 @@ IceInternal::Instance::~Instance()
     assert(!_routerManager);
     assert(!_locatorManager);
     assert(!_endpointFactoryManager);
+    assert(!_codecManager);
     assert(!_dynamicLibraryList);
     assert(!_pluginManager);
 
@@ -1075,6 +1127,11 @@ IceInternal::Instance::finishSetup(int& argc, char* argv[])
     assert(pluginManagerImpl);
     pluginManagerImpl->loadPlugins(argc, argv);
 
+    //
+    // Plug-ins may register codecs, so the codec selected with
+    // Ice.Compression.Codec is only looked up once they are loaded.
+    //
+    _codecManager->setPreferred(_initData.properties->getPropertyWithDefault("Ice.Compression.Codec", "bzip2"));
 
     //
     // Create threads.
@@ -1083,7 +1140,25 @@ IceInternal::Instance::finishSetup(int& argc, char* argv[])
     {
         bool hasPriority = _initData.properties->getProperty("Ice.ThreadPriority") != "";
         int priority = _initData.properties->getPropertyAsInt("Ice.ThreadPriority");
-        if(hasPriority)
+
+        //
+        // With Ice.Timer.Tick, the timer used for connection timeouts
+        // and ACM keeps its tasks in a timing wheel with the given
+        // resolution, in milliseconds.
+        //
+        int tick = _initData.properties->getPropertyAsInt("Ice.Timer.Tick");
+        if(tick > 0)
+        {
+            if(hasPriority)
+            {
+                _timer = new IceUtil::Timer(IceUtil::Time::milliSeconds(tick), priority);
+            }
+            else
+            {
+                _timer = new IceUtil::Timer(IceUtil::Time::milliSeconds(tick));
+            }
+        }
+        else if(hasPriority)
         {
             _timer = new IceUtil::Timer(priority);
         }
@@ -1310,6 +1385,12 @@ IceInternal::Instance::destroy()
             _endpointFactoryManager = 0;
         }
 
+        if(_codecManager)
+        {
+            _codecManager->destroy();
+            _codecManager = 0;
+        }
+
         if(_pluginManager)
         {
             _pluginManager->destroy();
@@ -29,7 +29,10 @@
 #include <Ice/ObjectFactoryManagerF.h>
 #include <Ice/ObjectAdapterFactoryF.h>
 #include <Ice/EndpointFactoryManagerF.h>
+#include <Ice/CodecManagerF.h>
 #include <Ice/RetryQueueF.h>
+#include <Ice/BufferPoolF.h>
+#include <Ice/MetricsManagerF.h>
 #include <Ice/DynamicLibraryF.h>
 #include <Ice/PluginF.h>
 #include <Ice/Initialize.h>
@@ -73,9 +76,12 @@ public:
     RetryQueuePtr retryQueue();
     IceUtil::TimerPtr timer();
     EndpointFactoryManagerPtr endpointFactoryManager() const;
+    CodecManagerPtr codecManager() const;
     DynamicLibraryListPtr dynamicLibraryList() const;
     Ice::PluginManagerPtr pluginManager() const;
     size_t messageSizeMax() const { return _messageSizeMax; }
+    BufferPool* bufferPool() const { return _bufferPool.get(); }
+    MetricsManager* metrics() const { return _metrics.get(); }
     Ice::Int clientACM() const;
     Ice::Int serverACM() const;
     Ice::Identity stringToIdentity(const std::string&) const;
@@ -117,6 +123,8 @@ private:
     const TraceLevelsPtr _traceLevels; // Immutable, not reset by destroy().
     const DefaultsAndOverridesPtr _defaultsAndOverrides; // Immutable, not reset by destroy().
     const size_t _messageSizeMax; // Immutable, not reset by destroy().
+    const BufferPoolPtr _bufferPool; // Immutable, not reset by destroy().
+    const MetricsManagerPtr _metrics; // Immutable, not reset by destroy().
     const Ice::Int _clientACM; // Immutable, not reset by destroy().
     const Ice::Int _serverACM; // Immutable, not reset by destroy().
     RouterManagerPtr _routerManager;
@@ -134,6 +142,7 @@ private:
     RetryQueuePtr _retryQueue;
     IceUtil::TimerPtr _timer;
     EndpointFactoryManagerPtr _endpointFactoryManager;
+    CodecManagerPtr _codecManager;
     DynamicLibraryListPtr _dynamicLibraryList;
     Ice::PluginManagerPtr _pluginManager;
     const Ice::ImplicitContextIPtr _implicitContext;
@@ -0,0 +1,277 @@
+// **********************************************************************
+//
+// Copyright (c) 2003-2011 ZeroC, Inc. All rights reserved.
+//
+// This copy of Ice is licensed to you under the terms described in the
+// ICE_LICENSE file included in this distribution.
+//
+// **********************************************************************
+
+#include <Ice/LZ4Codec.h>
+#include <Ice/LocalException.h>
+
+using namespace std;
+using namespace Ice;
+using namespace IceInternal;
+
+namespace
+{
+
+//
+// A compressed block is a sequence of (literals, match) pairs. Each
+// pair starts with a token whose high and low nibbles hold the
+// literal length and the match length minus minMatch; the value 15
+// means more length bytes follow. The literals come next, then the
+// match offset as two little-endian bytes. The last sequence only
+// contains literals: the last lastLiterals bytes are always literals
+// and no match starts in the last matchStartLimit bytes.
+//
+const size_t minMatch = 4;
+const size_t lastLiterals = 5;
+const size_t matchStartLimit = 12;
+const size_t maxOffset = 65535;
+const int maxHashLog = 12;
+const int minHashLog = 8;
+const size_t skipTrigger = 6;
+
+const char* const malformed = "malformed LZ4 data";
+
+inline unsigned int
+read32(const Byte* p)
+{
+    unsigned int v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+inline unsigned int
+hashPosition(const Byte* p, int hashLog)
+{
+    return (read32(p) * 2654435761U) >> (32 - hashLog);
+}
+
+inline Byte*
+writeLength(Byte* op, size_t len)
+{
+    for(; len >= 255; len -= 255)
+    {
+        *op++ = 255;
+    }
+    *op++ = static_cast<Byte>(len);
+    return op;
+}
+
+inline size_t
+readLength(const Byte*& ip, const Byte* end)
+{
+    size_t len = 0;
+    Byte b;
+    do
+    {
+        if(ip == end)
+        {
+            throw CompressionException(__FILE__, __LINE__, malformed);
+        }
+        b = *ip++;
+        len += b;
+    }
+    while(b == 255);
+    return len;
+}
+
+}
+
+Byte
+IceInternal::LZ4Codec::id() const
+{
+    return 3;
+}
+
+string
+IceInternal::LZ4Codec::name() const
+{
+    return "lz4";
+}
+
+size_t
+IceInternal::LZ4Codec::compressBound(size_t len) const
+{
+    return len + len / 255 + 16;
+}
+
+size_t
+IceInternal::LZ4Codec::compress(const Byte* src, size_t srcLen, Byte* dst, size_t dstLen, int) const
+{
+    assert(dstLen >= compressBound(srcLen));
+
+    const Byte* const end = src + srcLen;
+    const Byte* ip = src;
+    const Byte* anchor = src;
+    Byte* op = dst;
+
+    if(srcLen > matchStartLimit)
+    {
+        //
+        // Positions of the last occurrence of each hashed 4-byte
+        // sequence, relative to src. Stale or colliding entries are
+        // rejected by comparing the sequences. Small messages use a
+        // smaller part of the table, which is cheaper to clear.
+        //
+        Int table[1 << maxHashLog];
+        int hashLog = maxHashLog;
+        while(hashLog > minHashLog && (static_cast<size_t>(1) << hashLog) > srcLen)
+        {
+            --hashLog;
+        }
+        memset(table, 0, sizeof(Int) << hashLog);
+
+        const Byte* const matchLimit = end - lastLiterals;
+        const Byte* const lastMatchStart = end - matchStartLimit;
+        size_t misses = 0;
+        while(ip <= lastMatchStart)
+        {
+            unsigned int h = hashPosition(ip, hashLog);
+            const Byte* ref = src + table[h];
+            table[h] = static_cast<Int>(ip - src);
+            if(ref >= ip || static_cast<size_t>(ip - ref) > maxOffset || read32(ref) != read32(ip))
+            {
+                //
+                // Skip faster through data that doesn't compress.
+                //
+                ip += 1 + (misses++ >> skipTrigger);
+                continue;
+            }
+            misses = 0;
+
+            while(ip > anchor && ref > src && ip[-1] == ref[-1])
+            {
+                --ip;
+                --ref;
+            }
+
+            const Byte* matchEnd = ip + minMatch;
+            const Byte* r = ref + minMatch;
+            while(matchEnd < matchLimit && *matchEnd == *r)
+            {
+                ++matchEnd;
+                ++r;
+            }
+
+            size_t literalLen = static_cast<size_t>(ip - anchor);
+            size_t matchLen = static_cast<size_t>(matchEnd - ip) - minMatch;
+            size_t offset = static_cast<size_t>(ip - ref);
+
+            Byte* token = op++;
+            *token = static_cast<Byte>((literalLen < 15 ? literalLen : 15) << 4);
+            if(literalLen >= 15)
+            {
+                op = writeLength(op, literalLen - 15);
+            }
+            memcpy(op, anchor, literalLen);
+            op += literalLen;
+
+            *op++ = static_cast<Byte>(offset & 0xff);
+            *op++ = static_cast<Byte>(offset >> 8);
+
+            *token |= static_cast<Byte>(matchLen < 15 ? matchLen : 15);
+            if(matchLen >= 15)
+            {
+                op = writeLength(op, matchLen - 15);
+            }
+
+            ip = anchor = matchEnd;
+        }
+    }
+
+    size_t literalLen = static_cast<size_t>(end - anchor);
+    *op++ = static_cast<Byte>((literalLen < 15 ? literalLen : 15) << 4);
+    if(literalLen >= 15)
+    {
+        op = writeLength(op, literalLen - 15);
+    }
+    memcpy(op, anchor, literalLen);
+    op += literalLen;
+
+    assert(static_cast<size_t>(op - dst) <= dstLen);
+    return static_cast<size_t>(op - dst);
+}
+
+void
+IceInternal::LZ4Codec::uncompress(const Byte* src, size_t srcLen, Byte* dst, size_t dstLen) const
+{
+    const Byte* ip = src;
+    const Byte* const end = src + srcLen;
+    Byte* op = dst;
+    Byte* const oend = dst + dstLen;
+
+    while(true)
+    {
+        if(ip == end)
+        {
+            throw CompressionException(__FILE__, __LINE__, malformed);
+        }
+        Byte token = *ip++;
+
+        size_t literalLen = token >> 4;
+        if(literalLen == 15)
+        {
+            literalLen += readLength(ip, end);
+        }
+        if(literalLen > static_cast<size_t>(end - ip) || literalLen > static_cast<size_t>(oend - op))
+        {
+            throw CompressionException(__FILE__, __LINE__, malformed);
+        }
+        memcpy(op, ip, literalLen);
+        op += literalLen;
+        ip += literalLen;
+
+        if(ip == end)
+        {
+            break; // The last sequence has no match.
+        }
+
+        if(end - ip < 2)
+        {
+            throw CompressionException(__FILE__, __LINE__, malformed);
+        }
+        size_t offset = ip[0] | (static_cast<size_t>(ip[1]) << 8);
+        ip += 2;
+        if(offset == 0 || offset > static_cast<size_t>(op - dst))
+        {
+            throw CompressionException(__FILE__, __LINE__, malformed);
+        }
+
+        size_t matchLen = token & 15;
+        if(matchLen == 15)
+        {
+            matchLen += readLength(ip, end);
+        }
+        matchLen += minMatch;
+        if(matchLen > static_cast<size_t>(oend - op))
+        {
+            throw CompressionException(__FILE__, __LINE__, malformed);
+        }
+
+        const Byte* ref = op - offset;
+        if(offset >= matchLen)
+        {
+            memcpy(op, ref, matchLen);
+            op += matchLen;
+        }
+        else
+        {
+            //
+            // Overlapping match, this repeats the last offset bytes.
+            //
+            for(Byte* const matchEnd = op + matchLen; op != matchEnd;)
+            {
+                *op++ = *ref++;
+            }
+        }
+    }
+
+    if(op != oend)
+    {
+        throw CompressionException(__FILE__, __LINE__, malformed);
+    }
+}
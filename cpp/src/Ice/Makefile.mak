@@ -18,8 +18,14 @@ OBJS		= Acceptor.obj \
 		  Application.obj \
                   Base64.obj \
 		  Buffer.obj \
+		  BufferPool.obj \
 		  BasicStream.obj \
 		  BuiltinSequences.obj \
+		  BZip2Codec.obj \
+		  ChunkedTransfer.obj \
+		  Codec.obj \
+		  CodecManager.obj \
+		  CollocatedRequestHandler.obj \
 		  CommunicatorI.obj \
 		  Communicator.obj \
 		  ConnectRequestHandler.obj \
@@ -33,6 +39,7 @@ OBJS		= Acceptor.obj \
 		  DefaultsAndOverrides.obj \
 		  Direct.obj \
                   DispatchInterceptor.obj \
+		  DispatchQueue.obj \
 		  DLLMain.obj \
 		  DynamicLibrary.obj \
 		  EndpointFactoryManager.obj \
@@ -55,11 +62,14 @@ OBJS		= Acceptor.obj \
 		  Instance.obj \
 		  LocalException.obj \
 		  LocalObject.obj \
+		  LZ4Codec.obj \
 		  LocatorInfo.obj \
 		  Locator.obj \
 		  LoggerI.obj \
 		  Logger.obj \
 		  LoggerUtil.obj \
+		  Metrics.obj \
+		  MetricsManager.obj \
 		  Network.obj \
 		  ObjectAdapterFactory.obj \
 		  ObjectAdapterI.obj \
@@ -84,6 +94,7 @@ OBJS		= Acceptor.obj \
 		  Reference.obj \
 		  RetryQueue.obj \
 		  RequestHandler.obj \
+		  ResponseHandler.obj \
 		  RouterInfo.obj \
 		  Router.obj \
 		  Selector.obj \
@@ -184,6 +195,7 @@ clean::
 	-del /q Locator.cpp $(HDIR)\Locator.h
 	-del /q LoggerF.cpp $(HDIR)\LoggerF.h
 	-del /q Logger.cpp $(HDIR)\Logger.h
+	-del /q Metrics.cpp $(HDIR)\Metrics.h
 	-del /q ObjectAdapterF.cpp $(HDIR)\ObjectAdapterF.h
 	-del /q ObjectAdapter.cpp $(HDIR)\ObjectAdapter.h
 	-del /q ObjectFactoryF.cpp $(HDIR)\ObjectFactoryF.h
@@ -0,0 +1,390 @@
+// **********************************************************************
+//
+// Copyright (c) 2003-2011 ZeroC, Inc. All rights reserved.
+//
+// This copy of Ice is licensed to you under the terms described in the
+// ICE_LICENSE file included in this distribution.
+//
+// **********************************************************************
+
+#include <Ice/MetricsManager.h>
+#include <Ice/BufferPool.h>
+#include <Ice/ThreadPool.h>
+
+#ifndef _WIN32
+#   include <pthread.h>
+#endif
+
+using namespace std;
+using namespace Ice;
+using namespace IceInternal;
+
+IceUtil::Shared* IceInternal::upCast(MetricsManager* p) { return p; }
+
+namespace
+{
+
+const string unknownOperation = "<unknown>";
+
+}
+
+IceInternal::MetricsManager::Record::Record() :
+    count(0),
+    failures(0),
+    totalLatency(0),
+    maxLatency(0),
+    bytesIn(0),
+    bytesOut(0)
+{
+    for(int i = 0; i < histogramSize; ++i)
+    {
+        histogram[i] = 0;
+    }
+}
+
+IceInternal::MetricsManager::Shard::Shard() :
+    current(0),
+    total(0),
+    messagesSent(0),
+    bytesSent(0),
+    messagesReceived(0),
+    bytesReceived(0),
+    queuedMessages(0),
+    maxSendQueue(0)
+{
+}
+
+IceInternal::MetricsManager::MetricsManager(const BufferPoolPtr& bufferPool) :
+    _bufferPool(bufferPool)
+{
+}
+
+IceInternal::MetricsManager::~MetricsManager()
+{
+}
+
+void
+IceInternal::MetricsManager::dispatched(const string& operation, IceUtil::Int64 latency, bool failed,
+                                        size_t bytesIn, size_t bytesOut)
+{
+    Shard& s = shard();
+    IceUtil::Mutex::Lock sync(s);
+    record(s.dispatch, operation, latency, failed, bytesIn, bytesOut);
+}
+
+void
+IceInternal::MetricsManager::invoked(const string& operation, IceUtil::Int64 latency, bool failed,
+                                     size_t bytesIn, size_t bytesOut)
+{
+    Shard& s = shard();
+    IceUtil::Mutex::Lock sync(s);
+    record(s.invocation, operation, latency, failed, bytesIn, bytesOut);
+}
+
+void
+IceInternal::MetricsManager::connectionOpened()
+{
+    Shard& s = shard();
+    IceUtil::Mutex::Lock sync(s);
+    ++s.current;
+    ++s.total;
+}
+
+void
+IceInternal::MetricsManager::connectionClosed()
+{
+    Shard& s = shard();
+    IceUtil::Mutex::Lock sync(s);
+    --s.current;
+}
+
+void
+IceInternal::MetricsManager::messageSent(size_t sz)
+{
+    Shard& s = shard();
+    IceUtil::Mutex::Lock sync(s);
+    ++s.messagesSent;
+    s.bytesSent += static_cast<Long>(sz);
+}
+
+void
+IceInternal::MetricsManager::messageReceived(size_t sz)
+{
+    Shard& s = shard();
+    IceUtil::Mutex::Lock sync(s);
+    ++s.messagesReceived;
+    s.bytesReceived += static_cast<Long>(sz);
+}
+
+void
+IceInternal::MetricsManager::messagesQueued(int delta, size_t depth)
+{
+    Shard& s = shard();
+    IceUtil::Mutex::Lock sync(s);
+    s.queuedMessages += delta;
+    if(static_cast<Long>(depth) > s.maxSendQueue)
+    {
+        s.maxSendQueue = static_cast<Long>(depth);
+    }
+}
+
+void
+IceInternal::MetricsManager::addThreadPool(ThreadPool* threadPool)
+{
+    IceUtil::Mutex::Lock sync(*this);
+    _threadPools.push_back(threadPool);
+}
+
+void
+IceInternal::MetricsManager::removeThreadPool(ThreadPool* threadPool)
+{
+    IceUtil::Mutex::Lock sync(*this);
+    vector<ThreadPool*>::iterator p = find(_threadPools.begin(), _threadPools.end(), threadPool);
+    if(p != _threadPools.end())
+    {
+        _threadPools.erase(p);
+    }
+}
+
+OperationMetricsSeq
+IceInternal::MetricsManager::getDispatchMetrics() const
+{
+    return merge(&Shard::dispatch);
+}
+
+OperationMetricsSeq
+IceInternal::MetricsManager::getInvocationMetrics() const
+{
+    return merge(&Shard::invocation);
+}
+
+ConnectionMetrics
+IceInternal::MetricsManager::getConnectionMetrics() const
+{
+    ConnectionMetrics metrics;
+    metrics.current = 0;
+    metrics.total = 0;
+    metrics.messagesSent = 0;
+    metrics.bytesSent = 0;
+    metrics.messagesReceived = 0;
+    metrics.bytesReceived = 0;
+    metrics.queuedMessages = 0;
+    metrics.maxSendQueue = 0;
+    for(int i = 0; i < numShards; ++i)
+    {
+        const Shard& s = _shards[i];
+        IceUtil::Mutex::Lock sync(s);
+        metrics.current += s.current;
+        metrics.total += s.total;
+        metrics.messagesSent += s.messagesSent;
+        metrics.bytesSent += s.bytesSent;
+        metrics.messagesReceived += s.messagesReceived;
+        metrics.bytesReceived += s.bytesReceived;
+        metrics.queuedMessages += s.queuedMessages;
+        metrics.maxSendQueue = max(metrics.maxSendQueue, s.maxSendQueue);
+    }
+    return metrics;
+}
+
+ThreadPoolMetricsSeq
+IceInternal::MetricsManager::getThreadPoolMetrics() const
+{
+    //
+    // The thread pools are locked while this object is locked, a
+    // thread pool must therefore not be locked when it unregisters.
+    //
+    IceUtil::Mutex::Lock sync(*this);
+    ThreadPoolMetricsSeq metrics;
+    for(vector<ThreadPool*>::const_iterator p = _threadPools.begin(); p != _threadPools.end(); ++p)
+    {
+        metrics.push_back((*p)->getMetrics());
+    }
+    return metrics;
+}
+
+BufferPoolMetrics
+IceInternal::MetricsManager::getBufferPoolMetrics() const
+{
+    BufferPoolMetrics metrics;
+    metrics.allocations = 0;
+    metrics.hits = 0;
+    metrics.releases = 0;
+    metrics.discarded = 0;
+    metrics.unpooled = 0;
+    metrics.cachedBytes = 0;
+    if(_bufferPool)
+    {
+        BufferPool::Stats stats = _bufferPool->stats();
+        metrics.allocations = stats.allocations;
+        metrics.hits = stats.hits;
+        metrics.releases = stats.releases;
+        metrics.discarded = stats.discarded;
+        metrics.unpooled = stats.unpooled;
+        metrics.cachedBytes = stats.cachedBytes;
+    }
+    return metrics;
+}
+
+void
+IceInternal::MetricsManager::reset()
+{
+    for(int i = 0; i < numShards; ++i)
+    {
+        Shard& s = _shards[i];
+        IceUtil::Mutex::Lock sync(s);
+        s.dispatch.clear();
+        s.invocation.clear();
+        s.total = 0;
+        s.messagesSent = 0;
+        s.bytesSent = 0;
+        s.messagesReceived = 0;
+        s.bytesReceived = 0;
+        s.maxSendQueue = 0;
+    }
+}
+
+MetricsManager::Shard&
+IceInternal::MetricsManager::shard()
+{
+    //
+    // Select the shard from the identity of the calling thread, see
+    // BufferPool::shard().
+    //
+#ifdef _WIN32
+    size_t id = static_cast<size_t>(GetCurrentThreadId());
+#else
+    pthread_t self = pthread_self();
+    size_t id = 0;
+    memcpy(&id, &self, min(sizeof(id), sizeof(self)));
+#endif
+    id ^= (id >> 4) ^ (id >> 12) ^ (id >> 20);
+    return _shards[id % numShards];
+}
+
+void
+IceInternal::MetricsManager::record(RecordMap& records, const string& operation, IceUtil::Int64 latency, bool failed,
+                                    size_t bytesIn, size_t bytesOut)
+{
+    RecordMap::iterator p = records.find(operation);
+    if(p == records.end())
+    {
+        if(operation.empty() || records.size() >= maxOperations)
+        {
+            p = records.insert(RecordMap::value_type(unknownOperation, Record())).first;
+        }
+        else
+        {
+            p = records.insert(RecordMap::value_type(operation, Record())).first;
+        }
+    }
+    Record& r = p->second;
+
+    ++r.count;
+    if(failed)
+    {
+        ++r.failures;
+    }
+    r.totalLatency += latency;
+    if(latency > r.maxLatency)
+    {
+        r.maxLatency = latency;
+    }
+    r.bytesIn += static_cast<Long>(bytesIn);
+    r.bytesOut += static_cast<Long>(bytesOut);
+
+    //
+    // The histogram entry is the number of significant bits of the
+    // latency.
+    //
+    int bucket = 0;
+    while(latency > 0 && bucket < histogramSize - 1)
+    {
+        latency >>= 1;
+        ++bucket;
+    }
+    ++r.histogram[bucket];
+}
+
+OperationMetricsSeq
+IceInternal::MetricsManager::merge(RecordMap Shard::* member) const
+{
+    RecordMap merged;
+    for(int i = 0; i < numShards; ++i)
+    {
+        const Shard& s = _shards[i];
+        IceUtil::Mutex::Lock sync(s);
+        const RecordMap& records = s.*member;
+        for(RecordMap::const_iterator p = records.begin(); p != records.end(); ++p)
+        {
+            Record& r = merged[p->first];
+            r.count += p->second.count;
+            r.failures += p->second.failures;
+            r.totalLatency += p->second.totalLatency;
+            r.maxLatency = max(r.maxLatency, p->second.maxLatency);
+            r.bytesIn += p->second.bytesIn;
+            r.bytesOut += p->second.bytesOut;
+            for(int j = 0; j < histogramSize; ++j)
+            {
+                r.histogram[j] += p->second.histogram[j];
+            }
+        }
+    }
+
+    OperationMetricsSeq metrics;
+    metrics.reserve(merged.size());
+    for(RecordMap::const_iterator p = merged.begin(); p != merged.end(); ++p)
+    {
+        OperationMetrics m;
+        m.operation = p->first;
+        m.count = p->second.count;
+        m.failures = p->second.failures;
+        m.totalLatency = p->second.totalLatency;
+        m.maxLatency = p->second.maxLatency;
+        m.bytesIn = p->second.bytesIn;
+        m.bytesOut = p->second.bytesOut;
+        m.latencyHistogram.assign(p->second.histogram, p->second.histogram + histogramSize);
+        metrics.push_back(m);
+    }
+    return metrics;
+}
+
+IceInternal::MetricsAdminI::MetricsAdminI(const MetricsManagerPtr& metrics) :
+    _metrics(metrics)
+{
+}
+
+OperationMetricsSeq
+IceInternal::MetricsAdminI::getDispatchMetrics(const Current&)
+{
+    return _metrics->getDispatchMetrics();
+}
+
+OperationMetricsSeq
+IceInternal::MetricsAdminI::getInvocationMetrics(const Current&)
+{
+    return _metrics->getInvocationMetrics();
+}
+
+ConnectionMetrics
+IceInternal::MetricsAdminI::getConnectionMetrics(const Current&)
+{
+    return _metrics->getConnectionMetrics();
+}
+
+ThreadPoolMetricsSeq
+IceInternal::MetricsAdminI::getThreadPoolMetrics(const Current&)
+{
+    return _metrics->getThreadPoolMetrics();
+}
+
+BufferPoolMetrics
+IceInternal::MetricsAdminI::getBufferPoolMetrics(const Current&)
+{
+    return _metrics->getBufferPoolMetrics();
+}
+
+void
+IceInternal::MetricsAdminI::reset(const Current&)
+{
+    _metrics->reset();
+}
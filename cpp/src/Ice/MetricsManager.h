@@ -0,0 +1,143 @@
+// **********************************************************************
+//
+// Copyright (c) 2003-2011 ZeroC, Inc. All rights reserved.
+//
+// This copy of Ice is licensed to you under the terms described in the
+// ICE_LICENSE file included in this distribution.
+//
+// **********************************************************************
+
+#ifndef ICE_METRICS_MANAGER_H
+#define ICE_METRICS_MANAGER_H
+
+#include <IceUtil/Shared.h>
+#include <IceUtil/Mutex.h>
+#include <Ice/MetricsManagerF.h>
+#include <Ice/BufferPoolF.h>
+#include <Ice/ThreadPoolF.h>
+#include <Ice/Metrics.h>
+#include <map>
+
+namespace IceInternal
+{
+
+//
+// The metrics manager collects the request, connection and thread
+// pool metrics of a communicator. The counters are split in shards
+// selected by the calling thread, like the free lists of the buffer
+// pool, so that the threads recording requests concurrently don't
+// contend on a single mutex. The shards are only merged when the
+// metrics are retrieved.
+//
+class MetricsManager : public IceUtil::Shared, public IceUtil::Mutex
+{
+public:
+
+    MetricsManager(const BufferPoolPtr&);
+    virtual ~MetricsManager();
+
+    //
+    // Record a request dispatched by an object adapter or invoked
+    // through a proxy. The latency is in microseconds. The operation
+    // is empty if the target object, facet or operation of the
+    // request doesn't exist.
+    //
+    void dispatched(const std::string&, IceUtil::Int64, bool, size_t, size_t);
+    void invoked(const std::string&, IceUtil::Int64, bool, size_t, size_t);
+
+    void connectionOpened();
+    void connectionClosed();
+    void messageSent(size_t);
+    void messageReceived(size_t);
+
+    //
+    // Record a change of the number of messages queued for sending by
+    // a connection, the depth is the new size of its send queue.
+    //
+    void messagesQueued(int, size_t);
+
+    //
+    // Thread pools register themselves when they are created and
+    // unregister when they are destroyed.
+    //
+    void addThreadPool(ThreadPool*);
+    void removeThreadPool(ThreadPool*);
+
+    Ice::OperationMetricsSeq getDispatchMetrics() const;
+    Ice::OperationMetricsSeq getInvocationMetrics() const;
+    Ice::ConnectionMetrics getConnectionMetrics() const;
+    Ice::ThreadPoolMetricsSeq getThreadPoolMetrics() const;
+    Ice::BufferPoolMetrics getBufferPoolMetrics() const;
+    void reset();
+
+private:
+
+    //
+    // A shard records at most maxOperations distinct operations, the
+    // requests for other operations and the requests whose operation
+    // is empty are recorded under the "<unknown>" operation. The
+    // operation names of dispatched requests are read from the wire,
+    // clients could otherwise grow the metrics without limit.
+    //
+    enum { numShards = 16, histogramSize = 32, maxOperations = 512 };
+
+    struct Record
+    {
+        Record();
+
+        Ice::Long count;
+        Ice::Long failures;
+        Ice::Long totalLatency;
+        Ice::Long maxLatency;
+        Ice::Long bytesIn;
+        Ice::Long bytesOut;
+        Ice::Long histogram[histogramSize];
+    };
+    typedef std::map<std::string, Record> RecordMap;
+
+    struct Shard : public IceUtil::Mutex
+    {
+        Shard();
+
+        RecordMap dispatch;
+        RecordMap invocation;
+        Ice::Long current;
+        Ice::Long total;
+        Ice::Long messagesSent;
+        Ice::Long bytesSent;
+        Ice::Long messagesReceived;
+        Ice::Long bytesReceived;
+        Ice::Long queuedMessages;
+        Ice::Long maxSendQueue;
+    };
+
+    Shard& shard();
+    static void record(RecordMap&, const std::string&, IceUtil::Int64, bool, size_t, size_t);
+    Ice::OperationMetricsSeq merge(RecordMap Shard::*) const;
+
+    const BufferPoolPtr _bufferPool;
+    Shard _shards[numShards];
+    std::vector<ThreadPool*> _threadPools;
+};
+
+class MetricsAdminI : public Ice::MetricsAdmin
+{
+public:
+
+    MetricsAdminI(const MetricsManagerPtr&);
+
+    virtual Ice::OperationMetricsSeq getDispatchMetrics(const Ice::Current&);
+    virtual Ice::OperationMetricsSeq getInvocationMetrics(const Ice::Current&);
+    virtual Ice::ConnectionMetrics getConnectionMetrics(const Ice::Current&);
+    virtual Ice::ThreadPoolMetricsSeq getThreadPoolMetrics(const Ice::Current&);
+    virtual Ice::BufferPoolMetrics getBufferPoolMetrics(const Ice::Current&);
+    virtual void reset(const Ice::Current&);
+
+private:
+
+    const MetricsManagerPtr _metrics;
+};
+
+}
+
+#endif
@@ -0,0 +1,24 @@
+// **********************************************************************
+//
+// Copyright (c) 2003-2011 ZeroC, Inc. All rights reserved.
+//
+// This copy of Ice is licensed to you under the terms described in the
+// ICE_LICENSE file included in this distribution.
+//
+// **********************************************************************
+
+#ifndef ICE_METRICS_MANAGER_F_H
+#define ICE_METRICS_MANAGER_F_H
+
+#include <Ice/Handle.h>
+
+namespace IceInternal
+{
+
+class MetricsManager;
+IceUtil::Shared* upCast(MetricsManager*);
+typedef Handle<MetricsManager> MetricsManagerPtr;
+
+}
+
+#endif
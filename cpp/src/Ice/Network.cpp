@@ -40,6 +40,8 @@
 #else
 #  include <net/if.h>
 #  include <sys/ioctl.h>
+#  include <sys/un.h>
+#  include <stddef.h> // For offsetof
 #endif
 
 #if defined(__linux) || defined(__APPLE__) || defined(__FreeBSD__)
@@ -2026,3 +2028,178 @@ IceInternal::setTcpBufSize(SOCKET fd, const Ice::PropertiesPtr& properties, cons
         }
     }
 }
+
+#ifndef _WIN32
+SOCKET
+IceInternal::createUnixSocket()
+{
+    SOCKET fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if(fd == INVALID_SOCKET)
+    {
+        SocketException ex(__FILE__, __LINE__);
+        ex.error = getSocketErrno();
+        throw ex;
+    }
+    return fd;
+}
+
+string::size_type
+IceInternal::maxUnixPathLength()
+{
+    struct sockaddr_un addr;
+    return sizeof(addr.sun_path) - 1;
+}
+
+namespace
+{
+
+socklen_t
+unixAddress(const string& path, struct sockaddr_un& addr)
+{
+    assert(path.size() <= maxUnixPathLength());
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    memcpy(addr.sun_path, path.c_str(), path.size());
+    return static_cast<socklen_t>(offsetof(struct sockaddr_un, sun_path) + path.size() + 1);
+}
+
+}
+
+void
+IceInternal::doBindUnix(SOCKET fd, const string& path)
+{
+    struct sockaddr_un addr;
+    socklen_t size = unixAddress(path, addr);
+    if(bind(fd, reinterpret_cast<const struct sockaddr*>(&addr), size) == SOCKET_ERROR)
+    {
+        //
+        // The socket file of a server that did not close its acceptor
+        // (for example because it crashed) remains after the server
+        // is gone. We only remove it if nobody accepts connections on
+        // it anymore.
+        //
+        bool stale = false;
+        if(errno == EADDRINUSE)
+        {
+            SOCKET probe = socket(AF_UNIX, SOCK_STREAM, 0);
+            if(probe != INVALID_SOCKET)
+            {
+                stale = ::connect(probe, reinterpret_cast<const struct sockaddr*>(&addr), size) == SOCKET_ERROR &&
+                        errno == ECONNREFUSED;
+                closeSocketNoThrow(probe);
+            }
+        }
+
+        if(!stale || unlink(path.c_str()) != 0 ||
+           bind(fd, reinterpret_cast<const struct sockaddr*>(&addr), size) == SOCKET_ERROR)
+        {
+            if(stale)
+            {
+                errno = EADDRINUSE;
+            }
+            closeSocketNoThrow(fd);
+            SocketException ex(__FILE__, __LINE__);
+            ex.error = getSocketErrno();
+            throw ex;
+        }
+    }
+}
+
+bool
+IceInternal::doConnectUnix(SOCKET fd, const string& path)
+{
+    struct sockaddr_un addr;
+    socklen_t size = unixAddress(path, addr);
+
+repeatConnect:
+    if(::connect(fd, reinterpret_cast<const struct sockaddr*>(&addr), size) == SOCKET_ERROR)
+    {
+        if(interrupted())
+        {
+            goto repeatConnect;
+        }
+
+        if(connectInProgress())
+        {
+            return false;
+        }
+
+        closeSocketNoThrow(fd);
+        if(connectionRefused() || errno == ENOENT)
+        {
+            ConnectionRefusedException ex(__FILE__, __LINE__);
+            ex.error = getSocketErrno();
+            throw ex;
+        }
+        else if(connectFailed() || errno == EAGAIN) // EAGAIN: the backlog of the acceptor is full.
+        {
+            ConnectFailedException ex(__FILE__, __LINE__);
+            ex.error = getSocketErrno();
+            throw ex;
+        }
+        else
+        {
+            SocketException ex(__FILE__, __LINE__);
+            ex.error = getSocketErrno();
+            throw ex;
+        }
+    }
+    return true;
+}
+
+SOCKET
+IceInternal::doAcceptUnix(SOCKET fd)
+{
+    int ret;
+
+repeatAccept:
+    if((ret = ::accept(fd, 0, 0)) == INVALID_SOCKET)
+    {
+        if(acceptInterrupted())
+        {
+            goto repeatAccept;
+        }
+
+        SocketException ex(__FILE__, __LINE__);
+        ex.error = getSocketErrno();
+        throw ex;
+    }
+    return ret;
+}
+
+bool
+IceInternal::fdToPeerCredentials(SOCKET fd, int& pid, int& uid, int& gid)
+{
+    pid = -1;
+    uid = -1;
+    gid = -1;
+#if defined(SO_PEERCRED)
+    //
+    // The credentials of the peer process when it called connect() or
+    // listen(), as checked by the kernel (the same as SCM_CREDENTIALS).
+    //
+    struct ucred cred;
+    socklen_t len = static_cast<socklen_t>(sizeof(cred));
+    if(getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &cred, &len) == SOCKET_ERROR)
+    {
+        return false;
+    }
+    pid = static_cast<int>(cred.pid);
+    uid = static_cast<int>(cred.uid);
+    gid = static_cast<int>(cred.gid);
+    return true;
+#elif defined(__APPLE__) || defined(__FreeBSD__)
+    uid_t u;
+    gid_t g;
+    if(getpeereid(fd, &u, &g) == SOCKET_ERROR)
+    {
+        return false;
+    }
+    uid = static_cast<int>(u);
+    gid = static_cast<int>(g);
+    return true;
+#else
+    return false;
+#endif
+}
+#endif
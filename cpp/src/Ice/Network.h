@@ -195,6 +195,15 @@ ICE_API void setPort(struct sockaddr_storage&, int);
 ICE_API std::vector<std::string> getHostsForEndpointExpand(const std::string&, ProtocolSupport, bool);
 ICE_API void setTcpBufSize(SOCKET, const Ice::PropertiesPtr&, const Ice::LoggerPtr&);
 
+#ifndef _WIN32
+ICE_API SOCKET createUnixSocket();
+ICE_API std::string::size_type maxUnixPathLength();
+ICE_API void doBindUnix(SOCKET, const std::string&);
+ICE_API bool doConnectUnix(SOCKET, const std::string&);
+ICE_API SOCKET doAcceptUnix(SOCKET);
+ICE_API bool fdToPeerCredentials(SOCKET, int&, int&, int&);
+#endif
+
 ICE_API int getSocketErrno();
 
 }
@@ -27,6 +27,7 @@
 #include <Ice/Locator.h>
 #include <Ice/LoggerUtil.h>
 #include <Ice/ThreadPool.h>
+#include <Ice/DispatchQueue.h>
 #include <Ice/Communicator.h>
 #include <Ice/Router.h>
 #include <Ice/DefaultsAndOverrides.h>
@@ -835,6 +836,15 @@ Ice::ObjectAdapterI::getServantManager() const
     return _servantManager;
 }
 
+DispatchQueuePtr
+Ice::ObjectAdapterI::getDispatchQueue() const
+{
+    //
+    // No mutex lock necessary, _dispatchQueue is immutable.
+    //
+    return _dispatchQueue;
+}
+
 Ice::Int
 Ice::ObjectAdapterI::getACM() const
 {
@@ -948,6 +958,26 @@ Ice::ObjectAdapterI::initialize(const RouterPrx& router)
         {
             _threadPool = new ThreadPool(_instance, _name + ".ThreadPool", 0);
         }
+
+        //
+        // Create the dispatch queue if the requests must be dispatched
+        // according to their priority. The queue would break the
+        // serialization of the requests of a connection.
+        //
+        if(!properties->getProperty(_name + ".DispatchPriority.Weights").empty())
+        {
+            ThreadPoolPtr threadPool = getThreadPool();
+            if(threadPool->serialize())
+            {
+                Warning out(_instance->initializationData().logger);
+                out << _name << ".DispatchPriority.Weights is ignored, " << threadPool->prefix()
+                    << " serializes the requests";
+            }
+            else
+            {
+                _dispatchQueue = new DispatchQueue(_instance, _name, threadPool);
+            }
+        }
         
         _hasAcmTimeout = properties->getProperty(_name + ".ACM") != "";
         if(_hasAcmTimeout)
@@ -1460,6 +1490,13 @@ Ice::ObjectAdapterI::filterProperties(StringSeq& unknownProps)
         "Router.Locator.LocatorCacheTimeout",
         "Router.LocatorCacheTimeout",
         "ProxyOptions",
+        "DispatchPriority.Context",
+        "DispatchPriority.Default",
+        "DispatchPriority.MaxQueued",
+        "DispatchPriority.Reserved",
+        "DispatchPriority.Weights",
+        "ThreadPool.EdgeTriggered",
+        "ThreadPool.Model",
         "ThreadPool.Size",
         "ThreadPool.SizeMax",
         "ThreadPool.SizeWarn",
@@ -1503,6 +1540,15 @@ Ice::ObjectAdapterI::filterProperties(StringSeq& unknownProps)
             }
         }
 
+        //
+        // The operation priorities are suffixed with the operation name.
+        //
+        if(!valid && p->first.find(prefix + "DispatchPriority.Operation.") == 0)
+        {
+            noProps = false;
+            valid = true;
+        }
+
 
         if(!valid && addUnknown)
         {
@@ -26,6 +26,7 @@
 #include <Ice/ConnectorF.h>
 #include <Ice/LocatorInfoF.h>
 #include <Ice/ThreadPoolF.h>
+#include <Ice/DispatchQueueF.h>
 #include <Ice/Exception.h>
 #include <Ice/BuiltinSequences.h>
 #include <list>
@@ -36,7 +37,7 @@ namespace Ice
 class ObjectAdapterI;
 typedef IceUtil::Handle<ObjectAdapterI> ObjectAdapterIPtr;
 
-class ObjectAdapterI : public ObjectAdapter, public IceUtil::Monitor<IceUtil::RecMutex>
+class ICE_API ObjectAdapterI : public ObjectAdapter, public IceUtil::Monitor<IceUtil::RecMutex>
 {
 public:
 
@@ -91,6 +92,7 @@ public:
 
     IceInternal::ThreadPoolPtr getThreadPool() const;
     IceInternal::ServantManagerPtr getServantManager() const;
+    IceInternal::DispatchQueuePtr getDispatchQueue() const;
     Ice::Int getACM() const;
 
 private:
@@ -119,6 +121,7 @@ private:
     bool _hasAcmTimeout;
     Ice::Int _acmTimeout;
     IceInternal::ServantManagerPtr _servantManager;
+    IceInternal::DispatchQueuePtr _dispatchQueue;
     bool _activateOneOffDone;
     const std::string _name;
     const std::string _id;
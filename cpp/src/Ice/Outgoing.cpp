@@ -17,6 +17,7 @@
 #include <Ice/Protocol.h>
 #include <Ice/Instance.h>
 #include <Ice/ReplyStatus.h>
+#include <Ice/MetricsManager.h>
 
 using namespace std;
 using namespace Ice;
@@ -86,8 +87,16 @@ IceInternal::Outgoing::Outgoing(RequestHandler* handler, const string& operation
     _state(StateUnsent),
     _is(handler->getReference()->getInstance().get()),
     _os(handler->getReference()->getInstance().get()),
-    _sent(false)
+    _sent(false),
+    _operation(operation),
+    _invokeStart(0),
+    _encapsStart(0)
 {
+    if(_handler->getReference()->getInstance()->metrics())
+    {
+        _invokeStart = IceUtil::Time::now(IceUtil::Time::Monotonic).toMicroSeconds();
+    }
+
     switch(_handler->getReference()->getMode())
     {
         case Reference::ModeTwoway:
@@ -156,6 +165,7 @@ IceInternal::Outgoing::Outgoing(RequestHandler* handler, const string& operation
         // encapsulation, which makes it possible to forward requests as
         // blobs.
         //
+        _encapsStart = _os.b.size();
         _os.startWriteEncaps();
     }
     catch(const LocalException& ex)
@@ -164,6 +174,28 @@ IceInternal::Outgoing::Outgoing(RequestHandler* handler, const string& operation
     }
 }
 
+IceInternal::Outgoing::~Outgoing()
+{
+    if(_invokeStart && _state != StateUnsent)
+    {
+        //
+        // The invocation failed if it raised an exception, including
+        // the user exception raised by throwUserException().
+        //
+        bool failed = _exception.get() || _state == StateUserException || std::uncaught_exception();
+
+        //
+        // The stream of a batch request is returned to the batch stream
+        // of the connection once the request is queued.
+        //
+        size_t bytesIn = _os.b.size() > _encapsStart ? _os.b.size() - _encapsStart : 0;
+        size_t bytesOut = _is.b.empty() ? 0 : _is.b.size() - headerSize - 5; // Reply payload.
+        IceUtil::Int64 now = IceUtil::Time::now(IceUtil::Time::Monotonic).toMicroSeconds();
+        _handler->getReference()->getInstance()->metrics()->invoked(_operation, now - _invokeStart, failed, bytesIn,
+                                                                     bytesOut);
+    }
+}
+
 bool
 IceInternal::Outgoing::invoke()
 {
@@ -25,6 +25,7 @@
 #include <Ice/ImplicitContextI.h>
 #include <Ice/ThreadPool.h>
 #include <Ice/RetryQueue.h>
+#include <Ice/MetricsManager.h>
 
 using namespace std;
 using namespace Ice;
@@ -103,7 +104,9 @@ Ice::AsyncResult::AsyncResult(const IceInternal::InstancePtr& instance,
     _is(instance.get()),
     _os(instance.get()),
     _state(0),
-    _exception(0)
+    _exception(0),
+    _invokeStart(0),
+    _encapsStart(0)
 {
     if(!_callback)
     {
@@ -266,6 +269,8 @@ Ice::AsyncResult::__exception(const Ice::Exception& ex)
 	_monitor.notifyAll();
     }
 
+    __invoked(false);
+
     if(_callback)
     {
 	try
@@ -324,6 +329,18 @@ Ice::AsyncResult::__response()
     }
 }
 
+void
+Ice::AsyncResult::__invoked(bool ok)
+{
+    if(_invokeStart)
+    {
+        size_t bytesOut = _is.b.size() > headerSize + 5 ? _is.b.size() - headerSize - 5 : 0; // Reply payload.
+        IceUtil::Int64 now = IceUtil::Time::now(IceUtil::Time::Monotonic).toMicroSeconds();
+        _instance->metrics()->invoked(_operation, now - _invokeStart, !ok, _os.b.size() - _encapsStart, bytesOut);
+        _invokeStart = 0;
+    }
+}
+
 void
 Ice::AsyncResult::__check(const AsyncResultPtr& r, const IceProxy::Ice::Object* prx, const string& operation)
 {
@@ -419,6 +436,10 @@ IceInternal::OutgoingAsync::__prepare(const std::string& operation, OperationMod
     _cnt = 0;
     _mode = mode;
     _sentSynchronously = false;
+    if(_instance->metrics())
+    {
+        _invokeStart = IceUtil::Time::now(IceUtil::Time::Monotonic).toMicroSeconds();
+    }
 
     //
     // Can't call async via a batch proxy.
@@ -475,6 +496,7 @@ IceInternal::OutgoingAsync::__prepare(const std::string& operation, OperationMod
         }
     }
         
+    _encapsStart = _os.b.size();
     _os.startWriteEncaps();
 }
 
@@ -496,8 +518,9 @@ IceInternal::OutgoingAsync::__sent(Ice::ConnectionI* connection)
         if(!_proxy->ice_isTwoway())
         {
             _state |= Done | OK;
+            __invoked(true);
         }
-        else if(connection->timeout() > 0)
+        else if(connection && connection->timeout() > 0) // No connection for collocated requests.
         {
             assert(!_timerTaskConnection);
             _timerTaskConnection = connection;
@@ -728,6 +751,7 @@ IceInternal::OutgoingAsync::__finished(BasicStream& is)
     }
 
     assert(replyStatus == replyOK || replyStatus == replyUserException);
+    __invoked(replyStatus == replyOK);
     __response();
 }
 
@@ -8,7 +8,7 @@
 // **********************************************************************
 
 //
-// Generated by makeprops.py from file ..\config\PropertyNames.xml, Mon May 09 07:39:43 2011
+// Generated by makeprops.py from file ../config/PropertyNames.xml, Sat Oct 17 23:18:59 2026
 
 // IMPORTANT: Do not edit this file -- any edits made here will be lost!
 
@@ -20,6 +20,11 @@ const IceInternal::Property IcePropsData[] =
     IceInternal::Property("Ice.ACM.Server", false, 0),
     IceInternal::Property("Ice.Admin.ACM", false, 0),
     IceInternal::Property("Ice.Admin.AdapterId", false, 0),
+    IceInternal::Property("Ice.Admin.DispatchPriority.Context", false, 0),
+    IceInternal::Property("Ice.Admin.DispatchPriority.Default", false, 0),
+    IceInternal::Property("Ice.Admin.DispatchPriority.Operation.*", false, 0),
+    IceInternal::Property("Ice.Admin.DispatchPriority.Reserved", false, 0),
+    IceInternal::Property("Ice.Admin.DispatchPriority.Weights", false, 0),
     IceInternal::Property("Ice.Admin.Endpoints", false, 0),
     IceInternal::Property("Ice.Admin.Locator", false, 0),
     IceInternal::Property("Ice.Admin.PublishedEndpoints", false, 0),
@@ -27,6 +32,8 @@ const IceInternal::Property IcePropsData[] =
     IceInternal::Property("Ice.Admin.ReplicaGroupId", false, 0),
     IceInternal::Property("Ice.Admin.Router", false, 0),
     IceInternal::Property("Ice.Admin.ProxyOptions", false, 0),
+    IceInternal::Property("Ice.Admin.ThreadPool.EdgeTriggered", false, 0),
+    IceInternal::Property("Ice.Admin.ThreadPool.Model", false, 0),
     IceInternal::Property("Ice.Admin.ThreadPool.Size", false, 0),
     IceInternal::Property("Ice.Admin.ThreadPool.SizeMax", false, 0),
     IceInternal::Property("Ice.Admin.ThreadPool.SizeWarn", false, 0),
@@ -40,9 +47,14 @@ const IceInternal::Property IcePropsData[] =
     IceInternal::Property("Ice.Admin.ServerId", false, 0),
     IceInternal::Property("Ice.BackgroundLocatorCacheUpdates", false, 0),
     IceInternal::Property("Ice.BatchAutoFlush", false, 0),
+    IceInternal::Property("Ice.BufferPool.HighWater", false, 0),
+    IceInternal::Property("Ice.BufferPool.MaxSize", false, 0),
     IceInternal::Property("Ice.ChangeUser", false, 0),
+    IceInternal::Property("Ice.Compression.Codec", false, 0),
     IceInternal::Property("Ice.Compression.Level", false, 0),
+    IceInternal::Property("Ice.Compression.MinSize", false, 0),
     IceInternal::Property("Ice.Config", false, 0),
+    IceInternal::Property("Ice.ConnectionPool.Size", false, 0),
     IceInternal::Property("Ice.ConsoleListener", false, 0),
     IceInternal::Property("Ice.Default.CollocationOptimization", true, "Ice.Default.CollocationOptimized"),
     IceInternal::Property("Ice.Default.CollocationOptimized", false, 0),
@@ -75,10 +87,12 @@ const IceInternal::Property IcePropsData[] =
     IceInternal::Property("Ice.EventLog.Source", false, 0),
     IceInternal::Property("Ice.FactoryAssemblies", false, 0),
     IceInternal::Property("Ice.GC.Interval", false, 0),
+    IceInternal::Property("Ice.GC.MaxPause", false, 0),
     IceInternal::Property("Ice.ImplicitContext", false, 0),
     IceInternal::Property("Ice.InitPlugins", false, 0),
     IceInternal::Property("Ice.LogFile", false, 0),
     IceInternal::Property("Ice.MessageSizeMax", false, 0),
+    IceInternal::Property("Ice.Metrics", false, 0),
     IceInternal::Property("Ice.MonitorConnections", false, 0),
     IceInternal::Property("Ice.Nohup", false, 0),
     IceInternal::Property("Ice.NullHandleAbort", false, 0),
@@ -97,9 +111,12 @@ const IceInternal::Property IcePropsData[] =
     IceInternal::Property("Ice.RetryIntervals", false, 0),
     IceInternal::Property("Ice.ServerId", true, 0),
     IceInternal::Property("Ice.ServerIdleTime", false, 0),
+    IceInternal::Property("Ice.SHM.Size", false, 0),
     IceInternal::Property("Ice.StdErr", false, 0),
     IceInternal::Property("Ice.StdOut", false, 0),
     IceInternal::Property("Ice.SyslogFacility", false, 0),
+    IceInternal::Property("Ice.ThreadPool.Client.EdgeTriggered", false, 0),
+    IceInternal::Property("Ice.ThreadPool.Client.Model", false, 0),
     IceInternal::Property("Ice.ThreadPool.Client.Size", false, 0),
     IceInternal::Property("Ice.ThreadPool.Client.SizeMax", false, 0),
     IceInternal::Property("Ice.ThreadPool.Client.SizeWarn", false, 0),
@@ -107,6 +124,8 @@ const IceInternal::Property IcePropsData[] =
     IceInternal::Property("Ice.ThreadPool.Client.Serialize", false, 0),
     IceInternal::Property("Ice.ThreadPool.Client.ThreadIdleTime", false, 0),
     IceInternal::Property("Ice.ThreadPool.Client.ThreadPriority", false, 0),
+    IceInternal::Property("Ice.ThreadPool.Server.EdgeTriggered", false, 0),
+    IceInternal::Property("Ice.ThreadPool.Server.Model", false, 0),
     IceInternal::Property("Ice.ThreadPool.Server.Size", false, 0),
     IceInternal::Property("Ice.ThreadPool.Server.SizeMax", false, 0),
     IceInternal::Property("Ice.ThreadPool.Server.SizeWarn", false, 0),
@@ -115,6 +134,7 @@ const IceInternal::Property IcePropsData[] =
     IceInternal::Property("Ice.ThreadPool.Server.ThreadIdleTime", false, 0),
     IceInternal::Property("Ice.ThreadPool.Server.ThreadPriority", false, 0),
     IceInternal::Property("Ice.ThreadPriority", false, 0),
+    IceInternal::Property("Ice.Timer.Tick", false, 0),
     IceInternal::Property("Ice.Trace.GC", false, 0),
     IceInternal::Property("Ice.Trace.Location", true, "Ice.Trace.Locator"),
     IceInternal::Property("Ice.Trace.Locator", false, 0),
@@ -123,6 +143,7 @@ const IceInternal::Property IcePropsData[] =
     IceInternal::Property("Ice.Trace.Retry", false, 0),
     IceInternal::Property("Ice.Trace.Slicing", false, 0),
     IceInternal::Property("Ice.Trace.ThreadPool", false, 0),
+    IceInternal::Property("Ice.UDP.RcvBatchSize", false, 0),
     IceInternal::Property("Ice.UDP.RcvSize", false, 0),
     IceInternal::Property("Ice.UDP.SndSize", false, 0),
     IceInternal::Property("Ice.TCP.Backlog", false, 0),
@@ -152,6 +173,11 @@ const IceInternal::Property IceBoxPropsData[] =
     IceInternal::Property("IceBox.Service.*", false, 0),
     IceInternal::Property("IceBox.ServiceManager.ACM", false, 0),
     IceInternal::Property("IceBox.ServiceManager.AdapterId", false, 0),
+    IceInternal::Property("IceBox.ServiceManager.DispatchPriority.Context", false, 0),
+    IceInternal::Property("IceBox.ServiceManager.DispatchPriority.Default", false, 0),
+    IceInternal::Property("IceBox.ServiceManager.DispatchPriority.Operation.*", false, 0),
+    IceInternal::Property("IceBox.ServiceManager.DispatchPriority.Reserved", false, 0),
+    IceInternal::Property("IceBox.ServiceManager.DispatchPriority.Weights", false, 0),
     IceInternal::Property("IceBox.ServiceManager.Endpoints", false, 0),
     IceInternal::Property("IceBox.ServiceManager.Locator", false, 0),
     IceInternal::Property("IceBox.ServiceManager.PublishedEndpoints", false, 0),
@@ -159,6 +185,8 @@ const IceInternal::Property IceBoxPropsData[] =
     IceInternal::Property("IceBox.ServiceManager.ReplicaGroupId", false, 0),
     IceInternal::Property("IceBox.ServiceManager.Router", false, 0),
     IceInternal::Property("IceBox.ServiceManager.ProxyOptions", false, 0),
+    IceInternal::Property("IceBox.ServiceManager.ThreadPool.EdgeTriggered", false, 0),
+    IceInternal::Property("IceBox.ServiceManager.ThreadPool.Model", false, 0),
     IceInternal::Property("IceBox.ServiceManager.ThreadPool.Size", false, 0),
     IceInternal::Property("IceBox.ServiceManager.ThreadPool.SizeMax", false, 0),
     IceInternal::Property("IceBox.ServiceManager.ThreadPool.SizeWarn", false, 0),
@@ -210,6 +238,11 @@ const IceInternal::Property IceGridPropsData[] =
     IceInternal::Property("IceGrid.InstanceName", false, 0),
     IceInternal::Property("IceGrid.Node.ACM", false, 0),
     IceInternal::Property("IceGrid.Node.AdapterId", false, 0),
+    IceInternal::Property("IceGrid.Node.DispatchPriority.Context", false, 0),
+    IceInternal::Property("IceGrid.Node.DispatchPriority.Default", false, 0),
+    IceInternal::Property("IceGrid.Node.DispatchPriority.Operation.*", false, 0),
+    IceInternal::Property("IceGrid.Node.DispatchPriority.Reserved", false, 0),
+    IceInternal::Property("IceGrid.Node.DispatchPriority.Weights", false, 0),
     IceInternal::Property("IceGrid.Node.Endpoints", false, 0),
     IceInternal::Property("IceGrid.Node.Locator", false, 0),
     IceInternal::Property("IceGrid.Node.PublishedEndpoints", false, 0),
@@ -217,6 +250,8 @@ const IceInternal::Property IceGridPropsData[] =
     IceInternal::Property("IceGrid.Node.ReplicaGroupId", false, 0),
     IceInternal::Property("IceGrid.Node.Router", false, 0),
     IceInternal::Property("IceGrid.Node.ProxyOptions", false, 0),
+    IceInternal::Property("IceGrid.Node.ThreadPool.EdgeTriggered", false, 0),
+    IceInternal::Property("IceGrid.Node.ThreadPool.Model", false, 0),
     IceInternal::Property("IceGrid.Node.ThreadPool.Size", false, 0),
     IceInternal::Property("IceGrid.Node.ThreadPool.SizeMax", false, 0),
     IceInternal::Property("IceGrid.Node.ThreadPool.SizeWarn", false, 0),
@@ -264,6 +299,11 @@ const IceInternal::Property IceGridPropsData[] =
     IceInternal::Property("IceGrid.Registry.AdminSessionFilters", false, 0),
     IceInternal::Property("IceGrid.Registry.AdminSessionManager.ACM", false, 0),
     IceInternal::Property("IceGrid.Registry.AdminSessionManager.AdapterId", false, 0),
+    IceInternal::Property("IceGrid.Registry.AdminSessionManager.DispatchPriority.Context", false, 0),
+    IceInternal::Property("IceGrid.Registry.AdminSessionManager.DispatchPriority.Default", false, 0),
+    IceInternal::Property("IceGrid.Registry.AdminSessionManager.DispatchPriority.Operation.*", false, 0),
+    IceInternal::Property("IceGrid.Registry.AdminSessionManager.DispatchPriority.Reserved", false, 0),
+    IceInternal::Property("IceGrid.Registry.AdminSessionManager.DispatchPriority.Weights", false, 0),
     IceInternal::Property("IceGrid.Registry.AdminSessionManager.Endpoints", false, 0),
     IceInternal::Property("IceGrid.Registry.AdminSessionManager.Locator", false, 0),
     IceInternal::Property("IceGrid.Registry.AdminSessionManager.PublishedEndpoints", false, 0),
@@ -271,6 +311,8 @@ const IceInternal::Property IceGridPropsData[] =
     IceInternal::Property("IceGrid.Registry.AdminSessionManager.ReplicaGroupId", false, 0),
     IceInternal::Property("IceGrid.Registry.AdminSessionManager.Router", false, 0),
     IceInternal::Property("IceGrid.Registry.AdminSessionManager.ProxyOptions", false, 0),
+    IceInternal::Property("IceGrid.Registry.AdminSessionManager.ThreadPool.EdgeTriggered", false, 0),
+    IceInternal::Property("IceGrid.Registry.AdminSessionManager.ThreadPool.Model", false, 0),
     IceInternal::Property("IceGrid.Registry.AdminSessionManager.ThreadPool.Size", false, 0),
     IceInternal::Property("IceGrid.Registry.AdminSessionManager.ThreadPool.SizeMax", false, 0),
     IceInternal::Property("IceGrid.Registry.AdminSessionManager.ThreadPool.SizeWarn", false, 0),
@@ -289,6 +331,11 @@ const IceInternal::Property IceGridPropsData[] =
     IceInternal::Property("IceGrid.Registry.AdminSSLPermissionsVerifier", false, 0),
     IceInternal::Property("IceGrid.Registry.Client.ACM", false, 0),
     IceInternal::Property("IceGrid.Registry.Client.AdapterId", false, 0),
+    IceInternal::Property("IceGrid.Registry.Client.DispatchPriority.Context", false, 0),
+    IceInternal::Property("IceGrid.Registry.Client.DispatchPriority.Default", false, 0),
+    IceInternal::Property("IceGrid.Registry.Client.DispatchPriority.Operation.*", false, 0),
+    IceInternal::Property("IceGrid.Registry.Client.DispatchPriority.Reserved", false, 0),
+    IceInternal::Property("IceGrid.Registry.Client.DispatchPriority.Weights", false, 0),
     IceInternal::Property("IceGrid.Registry.Client.Endpoints", false, 0),
     IceInternal::Property("IceGrid.Registry.Client.Locator", false, 0),
     IceInternal::Property("IceGrid.Registry.Client.PublishedEndpoints", false, 0),
@@ -296,6 +343,8 @@ const IceInternal::Property IceGridPropsData[] =
     IceInternal::Property("IceGrid.Registry.Client.ReplicaGroupId", false, 0),
     IceInternal::Property("IceGrid.Registry.Client.Router", false, 0),
     IceInternal::Property("IceGrid.Registry.Client.ProxyOptions", false, 0),
+    IceInternal::Property("IceGrid.Registry.Client.ThreadPool.EdgeTriggered", false, 0),
+    IceInternal::Property("IceGrid.Registry.Client.ThreadPool.Model", false, 0),
     IceInternal::Property("IceGrid.Registry.Client.ThreadPool.Size", false, 0),
     IceInternal::Property("IceGrid.Registry.Client.ThreadPool.SizeMax", false, 0),
     IceInternal::Property("IceGrid.Registry.Client.ThreadPool.SizeWarn", false, 0),
@@ -309,6 +358,11 @@ const IceInternal::Property IceGridPropsData[] =
     IceInternal::Property("IceGrid.Registry.DynamicRegistration", false, 0),
     IceInternal::Property("IceGrid.Registry.Internal.ACM", false, 0),
     IceInternal::Property("IceGrid.Registry.Internal.AdapterId", false, 0),
+    IceInternal::Property("IceGrid.Registry.Internal.DispatchPriority.Context", false, 0),
+    IceInternal::Property("IceGrid.Registry.Internal.DispatchPriority.Default", false, 0),
+    IceInternal::Property("IceGrid.Registry.Internal.DispatchPriority.Operation.*", false, 0),
+    IceInternal::Property("IceGrid.Registry.Internal.DispatchPriority.Reserved", false, 0),
+    IceInternal::Property("IceGrid.Registry.Internal.DispatchPriority.Weights", false, 0),
     IceInternal::Property("IceGrid.Registry.Internal.Endpoints", false, 0),
     IceInternal::Property("IceGrid.Registry.Internal.Locator", false, 0),
     IceInternal::Property("IceGrid.Registry.Internal.PublishedEndpoints", false, 0),
@@ -316,6 +370,8 @@ const IceInternal::Property IceGridPropsData[] =
     IceInternal::Property("IceGrid.Registry.Internal.ReplicaGroupId", false, 0),
     IceInternal::Property("IceGrid.Registry.Internal.Router", false, 0),
     IceInternal::Property("IceGrid.Registry.Internal.ProxyOptions", false, 0),
+    IceInternal::Property("IceGrid.Registry.Internal.ThreadPool.EdgeTriggered", false, 0),
+    IceInternal::Property("IceGrid.Registry.Internal.ThreadPool.Model", false, 0),
     IceInternal::Property("IceGrid.Registry.Internal.ThreadPool.Size", false, 0),
     IceInternal::Property("IceGrid.Registry.Internal.ThreadPool.SizeMax", false, 0),
     IceInternal::Property("IceGrid.Registry.Internal.ThreadPool.SizeWarn", false, 0),
@@ -337,6 +393,11 @@ const IceInternal::Property IceGridPropsData[] =
     IceInternal::Property("IceGrid.Registry.ReplicaSessionTimeout", false, 0),
     IceInternal::Property("IceGrid.Registry.Server.ACM", false, 0),
     IceInternal::Property("IceGrid.Registry.Server.AdapterId", false, 0),
+    IceInternal::Property("IceGrid.Registry.Server.DispatchPriority.Context", false, 0),
+    IceInternal::Property("IceGrid.Registry.Server.DispatchPriority.Default", false, 0),
+    IceInternal::Property("IceGrid.Registry.Server.DispatchPriority.Operation.*", false, 0),
+    IceInternal::Property("IceGrid.Registry.Server.DispatchPriority.Reserved", false, 0),
+    IceInternal::Property("IceGrid.Registry.Server.DispatchPriority.Weights", false, 0),
     IceInternal::Property("IceGrid.Registry.Server.Endpoints", false, 0),
     IceInternal::Property("IceGrid.Registry.Server.Locator", false, 0),
     IceInternal::Property("IceGrid.Registry.Server.PublishedEndpoints", false, 0),
@@ -344,6 +405,8 @@ const IceInternal::Property IceGridPropsData[] =
     IceInternal::Property("IceGrid.Registry.Server.ReplicaGroupId", false, 0),
     IceInternal::Property("IceGrid.Registry.Server.Router", false, 0),
     IceInternal::Property("IceGrid.Registry.Server.ProxyOptions", false, 0),
+    IceInternal::Property("IceGrid.Registry.Server.ThreadPool.EdgeTriggered", false, 0),
+    IceInternal::Property("IceGrid.Registry.Server.ThreadPool.Model", false, 0),
     IceInternal::Property("IceGrid.Registry.Server.ThreadPool.Size", false, 0),
     IceInternal::Property("IceGrid.Registry.Server.ThreadPool.SizeMax", false, 0),
     IceInternal::Property("IceGrid.Registry.Server.ThreadPool.SizeWarn", false, 0),
@@ -354,6 +417,11 @@ const IceInternal::Property IceGridPropsData[] =
     IceInternal::Property("IceGrid.Registry.SessionFilters", false, 0),
     IceInternal::Property("IceGrid.Registry.SessionManager.ACM", false, 0),
     IceInternal::Property("IceGrid.Registry.SessionManager.AdapterId", false, 0),
+    IceInternal::Property("IceGrid.Registry.SessionManager.DispatchPriority.Context", false, 0),
+    IceInternal::Property("IceGrid.Registry.SessionManager.DispatchPriority.Default", false, 0),
+    IceInternal::Property("IceGrid.Registry.SessionManager.DispatchPriority.Operation.*", false, 0),
+    IceInternal::Property("IceGrid.Registry.SessionManager.DispatchPriority.Reserved", false, 0),
+    IceInternal::Property("IceGrid.Registry.SessionManager.DispatchPriority.Weights", false, 0),
     IceInternal::Property("IceGrid.Registry.SessionManager.Endpoints", false, 0),
     IceInternal::Property("IceGrid.Registry.SessionManager.Locator", false, 0),
     IceInternal::Property("IceGrid.Registry.SessionManager.PublishedEndpoints", false, 0),
@@ -361,6 +429,8 @@ const IceInternal::Property IceGridPropsData[] =
     IceInternal::Property("IceGrid.Registry.SessionManager.ReplicaGroupId", false, 0),
     IceInternal::Property("IceGrid.Registry.SessionManager.Router", false, 0),
     IceInternal::Property("IceGrid.Registry.SessionManager.ProxyOptions", false, 0),
+    IceInternal::Property("IceGrid.Registry.SessionManager.ThreadPool.EdgeTriggered", false, 0),
+    IceInternal::Property("IceGrid.Registry.SessionManager.ThreadPool.Model", false, 0),
     IceInternal::Property("IceGrid.Registry.SessionManager.ThreadPool.Size", false, 0),
     IceInternal::Property("IceGrid.Registry.SessionManager.ThreadPool.SizeMax", false, 0),
     IceInternal::Property("IceGrid.Registry.SessionManager.ThreadPool.SizeWarn", false, 0),
@@ -407,6 +477,11 @@ const IceInternal::Property IcePatch2PropsData[] =
 {
     IceInternal::Property("IcePatch2.ACM", false, 0),
     IceInternal::Property("IcePatch2.AdapterId", false, 0),
+    IceInternal::Property("IcePatch2.DispatchPriority.Context", false, 0),
+    IceInternal::Property("IcePatch2.DispatchPriority.Default", false, 0),
+    IceInternal::Property("IcePatch2.DispatchPriority.Operation.*", false, 0),
+    IceInternal::Property("IcePatch2.DispatchPriority.Reserved", false, 0),
+    IceInternal::Property("IcePatch2.DispatchPriority.Weights", false, 0),
     IceInternal::Property("IcePatch2.Endpoints", false, 0),
     IceInternal::Property("IcePatch2.Locator", false, 0),
     IceInternal::Property("IcePatch2.PublishedEndpoints", false, 0),
@@ -414,6 +489,8 @@ const IceInternal::Property IcePatch2PropsData[] =
     IceInternal::Property("IcePatch2.ReplicaGroupId", false, 0),
     IceInternal::Property("IcePatch2.Router", false, 0),
     IceInternal::Property("IcePatch2.ProxyOptions", false, 0),
+    IceInternal::Property("IcePatch2.ThreadPool.EdgeTriggered", false, 0),
+    IceInternal::Property("IcePatch2.ThreadPool.Model", false, 0),
     IceInternal::Property("IcePatch2.ThreadPool.Size", false, 0),
     IceInternal::Property("IcePatch2.ThreadPool.SizeMax", false, 0),
     IceInternal::Property("IcePatch2.ThreadPool.SizeWarn", false, 0),
@@ -518,6 +595,11 @@ const IceInternal::Property Glacier2PropsData[] =
     IceInternal::Property("Glacier2.Admin.ThreadPool.StackSize", true, 0),
     IceInternal::Property("Glacier2.Client.ACM", false, 0),
     IceInternal::Property("Glacier2.Client.AdapterId", false, 0),
+    IceInternal::Property("Glacier2.Client.DispatchPriority.Context", false, 0),
+    IceInternal::Property("Glacier2.Client.DispatchPriority.Default", false, 0),
+    IceInternal::Property("Glacier2.Client.DispatchPriority.Operation.*", false, 0),
+    IceInternal::Property("Glacier2.Client.DispatchPriority.Reserved", false, 0),
+    IceInternal::Property("Glacier2.Client.DispatchPriority.Weights", false, 0),
     IceInternal::Property("Glacier2.Client.Endpoints", false, 0),
     IceInternal::Property("Glacier2.Client.Locator", false, 0),
     IceInternal::Property("Glacier2.Client.PublishedEndpoints", false, 0),
@@ -525,6 +607,8 @@ const IceInternal::Property Glacier2PropsData[] =
     IceInternal::Property("Glacier2.Client.ReplicaGroupId", false, 0),
     IceInternal::Property("Glacier2.Client.Router", false, 0),
     IceInternal::Property("Glacier2.Client.ProxyOptions", false, 0),
+    IceInternal::Property("Glacier2.Client.ThreadPool.EdgeTriggered", false, 0),
+    IceInternal::Property("Glacier2.Client.ThreadPool.Model", false, 0),
     IceInternal::Property("Glacier2.Client.ThreadPool.Size", false, 0),
     IceInternal::Property("Glacier2.Client.ThreadPool.SizeMax", false, 0),
     IceInternal::Property("Glacier2.Client.ThreadPool.SizeWarn", false, 0),
@@ -570,6 +654,11 @@ const IceInternal::Property Glacier2PropsData[] =
     IceInternal::Property("Glacier2.RoutingTable.MaxSize", false, 0),
     IceInternal::Property("Glacier2.Server.ACM", false, 0),
     IceInternal::Property("Glacier2.Server.AdapterId", false, 0),
+    IceInternal::Property("Glacier2.Server.DispatchPriority.Context", false, 0),
+    IceInternal::Property("Glacier2.Server.DispatchPriority.Default", false, 0),
+    IceInternal::Property("Glacier2.Server.DispatchPriority.Operation.*", false, 0),
+    IceInternal::Property("Glacier2.Server.DispatchPriority.Reserved", false, 0),
+    IceInternal::Property("Glacier2.Server.DispatchPriority.Weights", false, 0),
     IceInternal::Property("Glacier2.Server.Endpoints", false, 0),
     IceInternal::Property("Glacier2.Server.Locator", false, 0),
     IceInternal::Property("Glacier2.Server.PublishedEndpoints", false, 0),
@@ -577,6 +666,8 @@ const IceInternal::Property Glacier2PropsData[] =
     IceInternal::Property("Glacier2.Server.ReplicaGroupId", false, 0),
     IceInternal::Property("Glacier2.Server.Router", false, 0),
     IceInternal::Property("Glacier2.Server.ProxyOptions", false, 0),
+    IceInternal::Property("Glacier2.Server.ThreadPool.EdgeTriggered", false, 0),
+    IceInternal::Property("Glacier2.Server.ThreadPool.Model", false, 0),
     IceInternal::Property("Glacier2.Server.ThreadPool.Size", false, 0),
     IceInternal::Property("Glacier2.Server.ThreadPool.SizeMax", false, 0),
     IceInternal::Property("Glacier2.Server.ThreadPool.SizeWarn", false, 0),
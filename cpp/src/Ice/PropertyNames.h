@@ -8,7 +8,7 @@
 // **********************************************************************
 
 //
-// Generated by makeprops.py from file ..\config\PropertyNames.xml, Mon May 09 07:39:43 2011
+// Generated by makeprops.py from file ../config/PropertyNames.xml, Sat Oct 17 23:18:59 2026
 
 // IMPORTANT: Do not edit this file -- any edits made here will be lost!
 
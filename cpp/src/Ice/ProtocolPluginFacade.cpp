@@ -10,6 +10,7 @@
 #include <Ice/ProtocolPluginFacade.h>
 #include <Ice/Instance.h>
 #include <Ice/EndpointFactoryManager.h>
+#include <Ice/CodecManager.h>
 #include <Ice/TraceLevels.h>
 #include <Ice/Initialize.h>
 #include <Ice/DefaultsAndOverrides.h>
@@ -74,6 +75,18 @@ IceInternal::ProtocolPluginFacade::getEndpointFactory(Ice::Short type) const
     return _instance->endpointFactoryManager()->get(type);
 }
 
+void
+IceInternal::ProtocolPluginFacade::addCodec(const CodecPtr& codec) const
+{
+    _instance->codecManager()->add(codec);
+}
+
+CodecPtr
+IceInternal::ProtocolPluginFacade::getCodec(Ice::Byte id) const
+{
+    return _instance->codecManager()->get(id);
+}
+
 IceInternal::ProtocolPluginFacade::ProtocolPluginFacade(const CommunicatorPtr& communicator) :
     _instance(getInstance(communicator)),
     _communicator(communicator)
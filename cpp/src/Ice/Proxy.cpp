@@ -16,6 +16,7 @@
 #include <Ice/OutgoingAsync.h>
 #include <Ice/ConnectRequestHandler.h>
 #include <Ice/ConnectionRequestHandler.h>
+#include <Ice/CollocatedRequestHandler.h>
 #include <Ice/Direct.h>
 #include <Ice/Reference.h>
 #include <Ice/EndpointI.h>
@@ -78,6 +79,37 @@ IceInternal::checkedCastImpl(const ObjectPrx& b, const string& f, const string&
     return 0;
 }
 
+//
+// The derived proxies are cached with their delegate, so repeated
+// calls reuse the request handler of the first call. A cached proxy is
+// dropped once it is stale, that is once its delegate was reset after a
+// failure or its connection was closed, and the next call derives a new
+// proxy.
+//
+struct IceProxy::Ice::Object::Variants
+{
+    Variants() : timeout(0)
+    {
+    }
+
+    ObjectPrx modes[Reference::ModeLast + 1];
+    ObjectPrx secure;
+    Int timeout;
+    ObjectPrx timeoutProxy;
+    ObjectPrx context;
+};
+
+IceProxy::Ice::Object::Object() :
+    _delegateReset(false),
+    _variants(0)
+{
+}
+
+IceProxy::Ice::Object::~Object()
+{
+    delete _variants;
+}
+
 bool
 IceProxy::Ice::Object::operator==(const Object& r) const
 {
@@ -642,8 +674,27 @@ IceProxy::Ice::Object::ice_getContext() const
 ObjectPrx
 IceProxy::Ice::Object::ice_context(const Context& newContext) const
 {
-    ObjectPrx proxy = __newInstance();
-    proxy->setup(_reference->changeContext(newContext));
+    ObjectPrx proxy;
+    {
+        IceUtil::Mutex::Lock sync(*this);
+        if(_variants)
+        {
+            proxy = _variants->context;
+        }
+    }
+
+    if(!proxy || proxy->isStale() || proxy->_reference->getContext()->getValue() != newContext)
+    {
+        proxy = __newInstance();
+        proxy->setup(_reference->changeContext(newContext));
+
+        IceUtil::Mutex::Lock sync(*this);
+        if(!_variants)
+        {
+            _variants = new Variants;
+        }
+        _variants->context = proxy;
+    }
     return proxy;
 }
 
@@ -800,8 +851,27 @@ IceProxy::Ice::Object::ice_secure(bool b) const
     }
     else
     {
-        ObjectPrx proxy = __newInstance();
-        proxy->setup(_reference->changeSecure(b));
+        ObjectPrx proxy;
+        {
+            IceUtil::Mutex::Lock sync(*this);
+            if(_variants)
+            {
+                proxy = _variants->secure;
+            }
+        }
+
+        if(!proxy || proxy->isStale())
+        {
+            proxy = __newInstance();
+            proxy->setup(_reference->changeSecure(b));
+
+            IceUtil::Mutex::Lock sync(*this);
+            if(!_variants)
+            {
+                _variants = new Variants;
+            }
+            _variants->secure = proxy;
+        }
         return proxy;
     }
 }
@@ -903,9 +973,7 @@ IceProxy::Ice::Object::ice_twoway() const
     }
     else
     {
-        ObjectPrx proxy = __newInstance();
-        proxy->setup(_reference->changeMode(Reference::ModeTwoway));
-        return proxy;
+        return changeMode(Reference::ModeTwoway);
     }
 }
 
@@ -924,9 +992,7 @@ IceProxy::Ice::Object::ice_oneway() const
     }
     else
     {
-        ObjectPrx proxy = __newInstance();
-        proxy->setup(_reference->changeMode(Reference::ModeOneway));
-        return proxy;
+        return changeMode(Reference::ModeOneway);
     }
 }
 
@@ -945,9 +1011,7 @@ IceProxy::Ice::Object::ice_batchOneway() const
     }
     else
     {
-        ObjectPrx proxy = __newInstance();
-        proxy->setup(_reference->changeMode(Reference::ModeBatchOneway));
-        return proxy;
+        return changeMode(Reference::ModeBatchOneway);
     }
 }
 
@@ -966,9 +1030,7 @@ IceProxy::Ice::Object::ice_datagram() const
     }
     else
     {
-        ObjectPrx proxy = __newInstance();
-        proxy->setup(_reference->changeMode(Reference::ModeDatagram));
-        return proxy;
+        return changeMode(Reference::ModeDatagram);
     }
 }
 
@@ -987,9 +1049,7 @@ IceProxy::Ice::Object::ice_batchDatagram() const
     }
     else
     {
-        ObjectPrx proxy = __newInstance();
-        proxy->setup(_reference->changeMode(Reference::ModeBatchDatagram));
-        return proxy;
+        return changeMode(Reference::ModeBatchDatagram);
     }
 }
 
@@ -1018,6 +1078,20 @@ IceProxy::Ice::Object::ice_compress(bool b) const
 ObjectPrx
 IceProxy::Ice::Object::ice_timeout(int t) const
 {
+    ObjectPrx proxy;
+    {
+        IceUtil::Mutex::Lock sync(*this);
+        if(_variants && _variants->timeout == t)
+        {
+            proxy = _variants->timeoutProxy;
+        }
+    }
+
+    if(proxy && !proxy->isStale())
+    {
+        return proxy;
+    }
+
     ReferencePtr ref = _reference->changeTimeout(t);
     if(ref == _reference)
     {
@@ -1025,8 +1099,16 @@ IceProxy::Ice::Object::ice_timeout(int t) const
     }
     else
     {
-        ObjectPrx proxy = __newInstance();
+        proxy = __newInstance();
         proxy->setup(ref);
+
+        IceUtil::Mutex::Lock sync(*this);
+        if(!_variants)
+        {
+            _variants = new Variants;
+        }
+        _variants->timeout = t;
+        _variants->timeoutProxy = proxy;
         return proxy;
     }
 }
@@ -1225,6 +1307,7 @@ IceProxy::Ice::Object::__handleException(const ::IceInternal::Handle< ::IceDeleg
         if(delegate.get() == _delegate.get())
         {
             _delegate = 0;
+            _delegateReset = true;
         }
     }
 
@@ -1256,6 +1339,7 @@ IceProxy::Ice::Object::__handleExceptionWrapper(const ::IceInternal::Handle< ::I
         if(delegate.get() == _delegate.get())
         {
             _delegate = 0;
+            _delegateReset = true;
         }
     }
 
@@ -1284,6 +1368,7 @@ IceProxy::Ice::Object::__handleExceptionWrapperRelaxed(const ::IceInternal::Hand
             if(del.get() == _delegate.get())
             {
                 _delegate = 0;
+                _delegateReset = true;
             }
         }
 
@@ -1428,6 +1513,75 @@ IceProxy::Ice::Object::createDelegate(bool async)
     return d;
 }
 
+ObjectPrx
+IceProxy::Ice::Object::changeMode(int mode) const
+{
+    ObjectPrx proxy;
+    {
+        IceUtil::Mutex::Lock sync(*this);
+        if(_variants)
+        {
+            proxy = _variants->modes[mode];
+        }
+    }
+
+    if(!proxy || proxy->isStale())
+    {
+        proxy = __newInstance();
+        proxy->setup(_reference->changeMode(static_cast<Reference::Mode>(mode)));
+
+        IceUtil::Mutex::Lock sync(*this);
+        if(!_variants)
+        {
+            _variants = new Variants;
+        }
+        _variants->modes[mode] = proxy;
+    }
+    return proxy;
+}
+
+bool
+IceProxy::Ice::Object::isStale() const
+{
+    Handle< ::IceDelegate::Ice::Object> delegate;
+    {
+        IceUtil::Mutex::Lock sync(*this);
+        if(_delegateReset)
+        {
+            return true;
+        }
+        delegate = _delegate;
+    }
+
+    //
+    // The connection might also have been closed without any
+    // invocation on this proxy noticing it yet. A proxy without a
+    // connection yet, or a collocated proxy which has none, isn't
+    // stale.
+    //
+    RequestHandlerPtr handler = delegate ? delegate->__getRequestHandler() : RequestHandlerPtr();
+    if(handler)
+    {
+        try
+        {
+            ConnectionIPtr connection = handler->getConnection(false);
+            return connection && !connection->isActiveOrHolding();
+        }
+        catch(const CollocationOptimizationException&)
+        {
+            return false;
+        }
+        catch(const LocalException&)
+        {
+            //
+            // The connection establishment failed.
+            //
+            return true;
+        }
+    }
+    return false;
+}
+
 void
 IceProxy::Ice::Object::setup(const ReferencePtr& ref)
 {
@@ -1942,8 +2096,7 @@ IceDelegateD::Ice::Object::ice_flushBatchRequests()
 RequestHandlerPtr
 IceDelegateD::Ice::Object::__getRequestHandler() const
 {
-    throw CollocationOptimizationException(__FILE__, __LINE__);
-    return 0;
+    return __handler;
 }
 
 void
@@ -1967,9 +2120,11 @@ IceDelegateD::Ice::Object::__copyFrom(const ::IceInternal::Handle< ::IceDelegate
 
     assert(!__reference);
     assert(!__adapter);
+    assert(!__handler);
 
     __reference = from->__reference;
     __adapter = from->__adapter;
+    __handler = from->__handler;
 }
 
 void
@@ -2020,9 +2175,11 @@ IceDelegateD::Ice::Object::setup(const ReferencePtr& ref, const ObjectAdapterPtr
 
     assert(!__reference);
     assert(!__adapter);
+    assert(!__handler);
 
     __reference = ref;
     __adapter = adapter;
+    __handler = new CollocatedRequestHandler(ref, adapter);
 }
 
 bool
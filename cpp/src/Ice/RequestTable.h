@@ -0,0 +1,34 @@
+// **********************************************************************
+//
+// Copyright (c) 2003-2011 ZeroC, Inc. All rights reserved.
+//
+// This copy of Ice is licensed to you under the terms described in the
+// ICE_LICENSE file included in this distribution.
+//
+// **********************************************************************
+
+#ifndef ICE_REQUEST_TABLE_H
+#define ICE_REQUEST_TABLE_H
+
+#include <Ice/HashTable.h>
+
+namespace IceInternal
+{
+
+//
+// Table of the outstanding requests of a connection, indexed by
+// request id. Inserting and erasing requests doesn't allocate memory
+// once the table has grown to the number of outstanding requests.
+//
+// The request id looked up by find() may be any value read from a
+// reply, ids which were never inserted, including ids which aren't
+// positive, are never found.
+//
+template<typename T>
+class RequestTable : public HashTable<Ice::Int, T, IntHash>
+{
+};
+
+}
+
+#endif
@@ -0,0 +1,48 @@
+// **********************************************************************
+//
+// Copyright (c) 2003-2011 ZeroC, Inc. All rights reserved.
+//
+// This copy of Ice is licensed to you under the terms described in the
+// ICE_LICENSE file included in this distribution.
+//
+// **********************************************************************
+
+#ifndef ICE_RESPONSE_HANDLER_H
+#define ICE_RESPONSE_HANDLER_H
+
+#include <IceUtil/Shared.h>
+
+#include <Ice/ResponseHandlerF.h>
+#include <Ice/Config.h>
+
+namespace Ice
+{
+
+class LocalException;
+
+}
+
+namespace IceInternal
+{
+
+class BasicStream;
+
+//
+// The receiver of the responses of dispatched requests: the
+// connection which received the request, or the collocated request
+// handler which dispatched it.
+//
+class ResponseHandler : virtual public ::IceUtil::Shared
+{
+public:
+
+    virtual ~ResponseHandler();
+
+    virtual void sendResponse(BasicStream*, Ice::Byte) = 0;
+    virtual void sendNoResponse() = 0;
+    virtual void invokeException(Ice::Int, const Ice::LocalException&, int) = 0;
+};
+
+}
+
+#endif
@@ -13,6 +13,8 @@
 #include <Ice/LoggerUtil.h>
 #include <Ice/LocalException.h>
 
+#include <algorithm>
+
 using namespace std;
 using namespace IceInternal;
 
@@ -149,10 +151,12 @@ Selector::getNextHandler(SocketOperation& status, int timeout)
 
 #elif defined(ICE_USE_KQUEUE) || defined(ICE_USE_EPOLL)
 
-Selector::Selector(const InstancePtr& instance) : _instance(instance)
+Selector::Selector(const InstancePtr& instance) : _instance(instance), _selecting(false)
 {
     _events.resize(256);
 #if defined(ICE_USE_EPOLL)
+    _edgeTriggered = false;
+    _poll = false;
     _queueFd = epoll_create(1);
     if(_queueFd < 0)
     {
@@ -168,7 +172,6 @@ Selector::Selector(const InstancePtr& instance) : _instance(instance)
         ex.error = getSocketErrno();
         throw ex;
     }
-    _selecting = false;
 #endif
 }
 
@@ -201,6 +204,14 @@ Selector::update(EventHandler* handler, SocketOperation remove, SocketOperation
         return;
     }
 
+#if defined(ICE_USE_EPOLL)
+    if(_edgeTriggered && handler->_edgeTriggered)
+    {
+        updateEdgeTriggered(handler, previous);
+        return;
+    }
+#endif
+
     SOCKET fd = handler->getNativeInfo()->fd();
 #if defined(ICE_USE_EPOLL)
     epoll_event event;
@@ -279,6 +290,23 @@ Selector::enable(EventHandler* handler, SocketOperation status)
     }
     handler->_disabled = static_cast<SocketOperation>(handler->_disabled & ~status);
 
+#if defined(ICE_USE_EPOLL)
+    if(_edgeTriggered && handler->_edgeTriggered)
+    {
+        //
+        // If the handler is still ready, the select in progress must
+        // return it. Re-arming the file descriptor wakes it up if the
+        // file descriptor is indeed ready. Otherwise, the next select
+        // will return the handler.
+        //
+        if(handler->_ready & handler->_registered & status && _selecting)
+        {
+            control(EPOLL_CTL_MOD, handler, EPOLLIN | EPOLLOUT | EPOLLET);
+        }
+        return;
+    }
+#endif
+
     if(handler->_registered & status)
     {
         SOCKET fd = handler->getNativeInfo()->fd();
@@ -315,6 +343,13 @@ Selector::disable(EventHandler* handler, SocketOperation status)
         return;
     }
     handler->_disabled = static_cast<SocketOperation>(handler->_disabled | status);
+
+#if defined(ICE_USE_EPOLL)
+    if(_edgeTriggered && handler->_edgeTriggered)
+    {
+        return; // Events of disabled operations are recorded but not returned, see finishSelect().
+    }
+#endif
     
     if(handler->_registered & status)
     {
@@ -352,6 +387,81 @@ Selector::finish(EventHandler* handler)
     }
 }
 
+#if defined(ICE_USE_EPOLL)
+void
+Selector::setEdgeTriggered(bool edgeTriggered)
+{
+    _edgeTriggered = edgeTriggered;
+}
+
+void
+Selector::clearReady(EventHandler* handler, SocketOperation status)
+{
+    handler->_ready = static_cast<SocketOperation>(handler->_ready & ~status);
+}
+
+void
+Selector::updateEdgeTriggered(EventHandler* handler, SocketOperation previous)
+{
+    if(!previous)
+    {
+        //
+        // epoll reports the current readiness of the file descriptor
+        // when it's added.
+        //
+        control(EPOLL_CTL_ADD, handler, EPOLLIN | EPOLLOUT | EPOLLET);
+    }
+    else if(!handler->_registered)
+    {
+        control(EPOLL_CTL_DEL, handler, 0);
+        handler->_ready = SocketOperationNone;
+        if(handler->_readyQueued)
+        {
+            //
+            // The handler might be destroyed once it's unregistered,
+            // it must be removed from the ready handlers.
+            //
+            vector<EventHandler*>::iterator p = find(_readyHandlers.begin(), _readyHandlers.end(), handler);
+            assert(p != _readyHandlers.end());
+            *p = _readyHandlers.back();
+            _readyHandlers.pop_back();
+            handler->_readyQueued = false;
+        }
+    }
+    else
+    {
+        //
+        // Write readiness isn't recorded while the handler isn't
+        // registered for writes (it's reported with most events), so
+        // the file descriptor is re-armed to have epoll report it
+        // again if the handler is ready. A handler registering for
+        // reads is only re-armed if it's still ready and a select is
+        // in progress, see enable().
+        //
+        SocketOperation added = static_cast<SocketOperation>(handler->_registered & ~previous);
+        if(added & SocketOperationWrite ||
+           (added & handler->_ready & ~handler->_disabled && _selecting))
+        {
+            control(EPOLL_CTL_MOD, handler, EPOLLIN | EPOLLOUT | EPOLLET);
+        }
+    }
+}
+
+void
+Selector::control(int op, EventHandler* handler, int events)
+{
+    epoll_event event;
+    memset(&event, 0, sizeof(epoll_event));
+    event.data.ptr = handler;
+    event.events = events;
+    if(epoll_ctl(_queueFd, op, handler->getNativeInfo()->fd(), &event) != 0)
+    {
+        Ice::Error out(_instance->initializationData().logger);
+        out << "error while updating selector:\n" << IceUtilInternal::errorToString(IceInternal::getSocketErrno());
+    }
+}
+#endif
+
 #if defined(ICE_USE_KQUEUE)
 void 
 Selector::updateSelector()
@@ -366,6 +476,107 @@ Selector::updateSelector()
 }
 #endif
 
+void
+Selector::startSelect()
+{
+    _selecting = true;
+#if defined(ICE_USE_EPOLL)
+    //
+    // epoll won't report the edge-triggered handlers which are still
+    // ready, the select must not block if some can be returned.
+    //
+    _poll = false;
+    for(vector<EventHandler*>::const_iterator p = _readyHandlers.begin(); p != _readyHandlers.end(); ++p)
+    {
+        if((*p)->_ready & (*p)->_registered & ~(*p)->_disabled)
+        {
+            _poll = true;
+            break;
+        }
+    }
+#else
+    if(!_changes.empty())
+    {
+        updateSelector();
+    }
+#endif
+}
+
+void
+#if defined(ICE_USE_EPOLL)
+Selector::finishSelect(vector<pair<EventHandler*, SocketOperation> >& handlers)
+#else
+Selector::finishSelect(vector<pair<EventHandler*, SocketOperation> >&)
+#endif
+{
+    _selecting = false;
+#if defined(ICE_USE_EPOLL)
+    if(!_edgeTriggered)
+    {
+        return;
+    }
+
+    //
+    // Record the readiness reported for the edge-triggered handlers
+    // and replace their events with the operations they are ready
+    // for. Reads and writes are returned separately, the thread pool
+    // clears the readiness of the returned operation if the handler
+    // doesn't complete its IO.
+    //
+    vector<pair<EventHandler*, SocketOperation> >::iterator q = handlers.begin();
+    for(vector<pair<EventHandler*, SocketOperation> >::const_iterator p = handlers.begin(); p != handlers.end(); ++p)
+    {
+        EventHandler* handler = p->first;
+        if(!handler->_edgeTriggered)
+        {
+            *q++ = *p;
+            continue;
+        }
+
+        SocketOperation ready = static_cast<SocketOperation>(p->second & handler->_registered & SocketOperationWrite);
+        if(handler->_registered) // The handler might have been unregistered while selecting.
+        {
+            ready = static_cast<SocketOperation>(ready | (p->second & SocketOperationRead));
+        }
+        if(ready)
+        {
+            handler->_ready = static_cast<SocketOperation>(handler->_ready | ready);
+            if(!handler->_readyQueued)
+            {
+                _readyHandlers.push_back(handler);
+                handler->_readyQueued = true;
+            }
+        }
+    }
+    handlers.erase(q, handlers.end());
+
+    vector<EventHandler*>::iterator p = _readyHandlers.begin();
+    while(p != _readyHandlers.end())
+    {
+        EventHandler* handler = *p;
+        if(!handler->_ready)
+        {
+            handler->_readyQueued = false;
+            *p = _readyHandlers.back();
+            _readyHandlers.pop_back();
+            continue;
+        }
+
+        SocketOperation status = static_cast<SocketOperation>(handler->_ready & handler->_registered & 
+                                                              ~handler->_disabled);
+        if(status & SocketOperationWrite)
+        {
+            handlers.push_back(make_pair(handler, SocketOperationWrite));
+        }
+        if(status & SocketOperationRead)
+        {
+            handlers.push_back(make_pair(handler, SocketOperationRead));
+        }
+        ++p;
+    }
+#endif
+}
+
 void 
 Selector::select(vector<pair<EventHandler*, SocketOperation> >& handlers, int timeout)
 {
@@ -373,7 +584,7 @@ Selector::select(vector<pair<EventHandler*, SocketOperation> >& handlers, int ti
     while(true)
     {
 #if defined(ICE_USE_EPOLL)
-        ret = epoll_wait(_queueFd, &_events[0], _events.size(), timeout > 0 ? timeout * 1000 : -1);
+        ret = epoll_wait(_queueFd, &_events[0], _events.size(), _poll ? 0 : (timeout > 0 ? timeout * 1000 : -1));
 #else
         assert(!_events.empty());
         if(timeout > 0)
@@ -405,13 +616,19 @@ Selector::select(vector<pair<EventHandler*, SocketOperation> >& handlers, int ti
         break;
     }
 
+    handlers.clear();
+#if defined(ICE_USE_EPOLL)
+    if(ret == 0 && _poll)
+    {
+        return; // The ready handlers are returned by finishSelect().
+    }
+#endif
     if(ret == 0)
     {
         throw SelectorTimeoutException();
     }
 
     assert(ret > 0);
-    handlers.clear();
     for(int i = 0; i < ret; ++i)
     {
         pair<EventHandler*, SocketOperation> p;
@@ -575,7 +792,7 @@ Selector::startSelect()
 }
 
 void
-Selector::finishSelect()
+Selector::finishSelect(vector<pair<EventHandler*, SocketOperation> >&)
 {
     _selecting = false;
 }
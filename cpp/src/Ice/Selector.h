@@ -82,42 +82,46 @@ public:
     void disable(EventHandler*, SocketOperation);
     void finish(EventHandler*);
 
+#if defined(ICE_USE_EPOLL)
+    //
+    // With edge-triggered notifications, the file descriptors of the
+    // handlers supporting it are registered once for reads and writes
+    // and epoll only reports when they become ready. The readiness is
+    // recorded with the handler and the selector keeps returning it
+    // until the handler returns from message() without completing
+    // IO, which means that its IO would block. The thread pool calls
+    // clearReady() in this case.
+    //
+    void setEdgeTriggered(bool);
+    void clearReady(EventHandler*, SocketOperation);
+#endif
+
 #if defined(ICE_USE_KQUEUE)
     void updateSelector();
 #endif    
 
-    void
-    startSelect()
-    {
-#ifdef ICE_USE_KQUEUE
-        _selecting = true;
-        if(!_changes.empty())
-        {
-            updateSelector();
-        }
-#endif
-    }
-
-    void
-    finishSelect()
-    {
-#ifdef ICE_USE_KQUEUE
-        _selecting = false;
-#endif
-    }
-
+    void startSelect();
+    void finishSelect(std::vector<std::pair<EventHandler*, SocketOperation> >&);
     void select(std::vector<std::pair<EventHandler*, SocketOperation> >&, int);
 
 private:
 
+#if defined(ICE_USE_EPOLL)
+    void updateEdgeTriggered(EventHandler*, SocketOperation);
+    void control(int, EventHandler*, int);
+#endif
+
     const InstancePtr _instance;
 #if defined(ICE_USE_EPOLL)
     std::vector<struct epoll_event> _events;
+    bool _edgeTriggered;
+    bool _poll; // True if the select shouldn't block because edge-triggered handlers are still ready.
+    std::vector<EventHandler*> _readyHandlers; // The edge-triggered handlers with recorded readiness.
 #else
     std::vector<struct kevent> _events;
     std::vector<struct kevent> _changes;
-    bool _selecting;
 #endif
+    bool _selecting;
     int _queueFd;
 };
 
@@ -142,7 +146,7 @@ public:
     void finish(EventHandler*);
 
     void startSelect();
-    void finishSelect();
+    void finishSelect(std::vector<std::pair<EventHandler*, SocketOperation> >&);
     void select(std::vector<std::pair<EventHandler*, SocketOperation> >&, int);
 
 private:
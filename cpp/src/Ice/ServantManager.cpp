@@ -14,49 +14,204 @@
 #include <Ice/Instance.h>
 #include <IceUtil/StringUtil.h>
 
+#include <vector>
+
 using namespace std;
 using namespace Ice;
 using namespace IceInternal;
 
 ICE_DECLSPEC_EXPORT IceUtil::Shared* IceInternal::upCast(ServantManager* p) { return p; }
 
-void
-IceInternal::ServantManager::addServant(const ObjectPtr& object, const Identity& ident, const string& facet)
+namespace
 {
-    IceUtil::Mutex::Lock sync(*this);
-    
-    assert(_instance); // Must not be called after destruction.
 
-    ServantMapMap::iterator p = _servantMapMapHint;
+//
+// FNV-1a hash of the identity.
+//
+size_t
+hashIdentity(const Identity& ident)
+{
+    unsigned int h = 2166136261U;
+    for(string::const_iterator p = ident.name.begin(); p != ident.name.end(); ++p)
+    {
+        h = (h ^ static_cast<unsigned char>(*p)) * 16777619U;
+    }
+    h *= 16777619U; // Separates the name from the category.
+    for(string::const_iterator p = ident.category.begin(); p != ident.category.end(); ++p)
+    {
+        h = (h ^ static_cast<unsigned char>(*p)) * 16777619U;
+    }
+    return h;
+}
+
+}
+
+//
+// A stripe is a hash table of identities chained through
+// Entry::next. The low bits of the hash of an identity select its
+// stripe and the next bits its bucket in the stripe.
+//
+class IceInternal::ServantManager::Stripe : public IceUtil::Mutex, private IceUtil::noncopyable
+{
+public:
+
+    struct Entry
+    {
+        Identity ident;
+        size_t hash;
+        FacetMap facets;
+        Entry* next;
+    };
 
-    if(p == _servantMapMap.end() || p->first != ident)
+    Stripe() :
+        _buckets(16),
+        _count(0)
     {
-        p = _servantMapMap.find(ident);
     }
 
-    if(p == _servantMapMap.end())
+    ~Stripe()
     {
-        p = _servantMapMap.insert(_servantMapMapHint, pair<const Identity, FacetMap>(ident, FacetMap()));
+        vector<Entry*> buckets;
+        take(buckets);
+        destroy(buckets);
     }
-    else
+
+    FacetMap*
+    find(const Identity& ident, size_t hash) const
+    {
+        for(Entry* e = _buckets[bucket(hash)]; e; e = e->next)
+        {
+            if(e->hash == hash && e->ident == ident)
+            {
+                return &e->facets;
+            }
+        }
+        return 0;
+    }
+
+    FacetMap&
+    insert(const Identity& ident, size_t hash)
     {
-        if(p->second.find(facet) != p->second.end())
+        FacetMap* facets = find(ident, hash);
+        if(facets)
         {
-            AlreadyRegisteredException ex(__FILE__, __LINE__);
-            ex.kindOfObject = "servant";
-            ex.id = _instance->identityToString(ident);
-            if(!facet.empty())
+            return *facets;
+        }
+
+        if(_count >= _buckets.size())
+        {
+            vector<Entry*> buckets(_buckets.size() * 2);
+            _buckets.swap(buckets);
+            for(vector<Entry*>::const_iterator p = buckets.begin(); p != buckets.end(); ++p)
             {
-                string fs = nativeToUTF8(_instance->initializationData().stringConverter, facet);
-                ex.id += " -f " + IceUtilInternal::escapeString(fs, "");
+                for(Entry* e = *p; e;)
+                {
+                    Entry* next = e->next;
+                    Entry*& b = _buckets[bucket(e->hash)];
+                    e->next = b;
+                    b = e;
+                    e = next;
+                }
             }
-            throw ex;
         }
+
+        Entry* e = new Entry;
+        e->ident = ident;
+        e->hash = hash;
+        Entry*& b = _buckets[bucket(hash)];
+        e->next = b;
+        b = e;
+        ++_count;
+        return e->facets;
     }
 
-    _servantMapMapHint = p;
+    void
+    erase(const Identity& ident, size_t hash)
+    {
+        for(Entry** p = &_buckets[bucket(hash)]; *p; p = &(*p)->next)
+        {
+            if((*p)->hash == hash && (*p)->ident == ident)
+            {
+                Entry* e = *p;
+                *p = e->next;
+                delete e;
+                --_count;
+                return;
+            }
+        }
+    }
+
+    //
+    // Removes all the entries, which are returned in the buckets and
+    // must be destroyed with destroy().
+    //
+    void
+    take(vector<Entry*>& buckets)
+    {
+        vector<Entry*>(16).swap(buckets);
+        _buckets.swap(buckets);
+        _count = 0;
+    }
 
-    p->second.insert(pair<const string, ObjectPtr>(facet, object));
+    static void
+    destroy(const vector<Entry*>& buckets)
+    {
+        for(vector<Entry*>::const_iterator p = buckets.begin(); p != buckets.end(); ++p)
+        {
+            for(Entry* e = *p; e;)
+            {
+                Entry* next = e->next;
+                delete e;
+                e = next;
+            }
+        }
+    }
+
+private:
+
+    size_t
+    bucket(size_t hash) const
+    {
+        return (hash >> ServantManager::stripeBits) & (_buckets.size() - 1);
+    }
+
+    vector<Entry*> _buckets;
+    size_t _count;
+};
+
+IceInternal::ServantManager::Stripe&
+IceInternal::ServantManager::stripe(const Identity& ident, size_t& hash) const
+{
+    hash = hashIdentity(ident);
+    return *_stripes[hash & ((1 << stripeBits) - 1)];
+}
+
+void
+IceInternal::ServantManager::addServant(const ObjectPtr& object, const Identity& ident, const string& facet)
+{
+    IceUtil::Mutex::Lock sync(*this);
+    
+    assert(_instance); // Must not be called after destruction.
+
+    size_t hash;
+    Stripe& s = stripe(ident, hash);
+    IceUtil::Mutex::Lock sync2(s);
+
+    FacetMap& facets = s.insert(ident, hash);
+    if(facets.find(facet) != facets.end())
+    {
+        AlreadyRegisteredException ex(__FILE__, __LINE__);
+        ex.kindOfObject = "servant";
+        ex.id = _instance->identityToString(ident);
+        if(!facet.empty())
+        {
+            string fs = nativeToUTF8(_instance->initializationData().stringConverter, facet);
+            ex.id += " -f " + IceUtilInternal::escapeString(fs, "");
+        }
+        throw ex;
+    }
+
+    facets.insert(pair<const string, ObjectPtr>(facet, object));
 }
 
 void
@@ -66,8 +221,9 @@ IceInternal::ServantManager::addDefaultServant(const ObjectPtr& object, const st
 
     assert(_instance); // Must not be called after destruction.
 
-    DefaultServantMap::iterator p = _defaultServantMap.find(category);
-    if(p != _defaultServantMap.end())
+    DefaultServantMapPtr defaultServantMap = _defaultServantMap ?
+        new SharedMap<DefaultServantMap>(_defaultServantMap->map) : new SharedMap<DefaultServantMap>();
+    if(!defaultServantMap->map.insert(pair<const string, ObjectPtr>(category, object)).second)
     {
         AlreadyRegisteredException ex(__FILE__, __LINE__);
         ex.kindOfObject = "default servant";
@@ -75,7 +231,8 @@ IceInternal::ServantManager::addDefaultServant(const ObjectPtr& object, const st
         throw ex;
     }
 
-    _defaultServantMap.insert(pair<const string, ObjectPtr>(category, object));
+    IceUtil::Mutex::Lock sync2(_mapsMutex);
+    _defaultServantMap = defaultServantMap;
 }
 
 ObjectPtr
@@ -92,15 +249,13 @@ IceInternal::ServantManager::removeServant(const Identity& ident, const string&
     
     assert(_instance); // Must not be called after destruction.
 
-    ServantMapMap::iterator p = _servantMapMapHint;
-    FacetMap::iterator q;
+    size_t hash;
+    Stripe& s = stripe(ident, hash);
+    IceUtil::Mutex::Lock sync2(s);
 
-    if(p == _servantMapMap.end() || p->first != ident)
-    {
-        p = _servantMapMap.find(ident);
-    }
-    
-    if(p == _servantMapMap.end() || (q = p->second.find(facet)) == p->second.end())
+    FacetMap* facets = s.find(ident, hash);
+    FacetMap::iterator q;
+    if(!facets || (q = facets->find(facet)) == facets->end())
     {
         NotRegisteredException ex(__FILE__, __LINE__);
         ex.kindOfObject = "servant";
@@ -114,19 +269,11 @@ IceInternal::ServantManager::removeServant(const Identity& ident, const string&
     }
 
     servant = q->second;
-    p->second.erase(q);
+    facets->erase(q);
 
-    if(p->second.empty())
+    if(facets->empty())
     {
-        if(p == _servantMapMapHint)
-        {
-            _servantMapMap.erase(p++);
-            _servantMapMapHint = p;
-        }
-        else
-        {
-            _servantMapMap.erase(p);
-        }
+        s.erase(ident, hash);
     }
     return servant;
 }
@@ -145,8 +292,8 @@ IceInternal::ServantManager::removeDefaultServant(const string& category)
 
     assert(_instance); // Must not be called after destruction.
 
-    DefaultServantMap::iterator p = _defaultServantMap.find(category);
-    if(p == _defaultServantMap.end())
+    DefaultServantMap::const_iterator p;
+    if(!_defaultServantMap || (p = _defaultServantMap->map.find(category)) == _defaultServantMap->map.end())
     {
         NotRegisteredException ex(__FILE__, __LINE__);
         ex.kindOfObject = "default servant";
@@ -155,8 +302,16 @@ IceInternal::ServantManager::removeDefaultServant(const string& category)
     }
 
     servant = p->second;
-    _defaultServantMap.erase(p);
 
+    DefaultServantMapPtr defaultServantMap;
+    if(_defaultServantMap->map.size() > 1)
+    {
+        defaultServantMap = new SharedMap<DefaultServantMap>(_defaultServantMap->map);
+        defaultServantMap->map.erase(category);
+    }
+
+    IceUtil::Mutex::Lock sync2(_mapsMutex);
+    _defaultServantMap = defaultServantMap;
     return servant;
 }
 
@@ -167,14 +322,12 @@ IceInternal::ServantManager::removeAllFacets(const Identity& ident)
     
     assert(_instance); // Must not be called after destruction.
 
-    ServantMapMap::iterator p = _servantMapMapHint;
+    size_t hash;
+    Stripe& s = stripe(ident, hash);
+    IceUtil::Mutex::Lock sync2(s);
 
-    if(p == _servantMapMap.end() || p->first != ident)
-    {
-        p = _servantMapMap.find(ident);
-    }
-    
-    if(p == _servantMapMap.end())
+    FacetMap* facets = s.find(ident, hash);
+    if(!facets)
     {
         NotRegisteredException ex(__FILE__, __LINE__);
         ex.kindOfObject = "servant";
@@ -182,145 +335,98 @@ IceInternal::ServantManager::removeAllFacets(const Identity& ident)
         throw ex;
     }
 
-    FacetMap result = p->second;
-
-    if(p == _servantMapMapHint)
-    {
-        _servantMapMap.erase(p++);
-        _servantMapMapHint = p;
-    }
-    else
-    {
-        _servantMapMap.erase(p);
-    }
-
+    FacetMap result = *facets;
+    s.erase(ident, hash);
     return result;
 }
 
 ObjectPtr
 IceInternal::ServantManager::findServant(const Identity& ident, const string& facet) const
 {
-    IceUtil::Mutex::Lock sync(*this);
-    
     //
-    // This assert is not valid if the adapter dispatch incoming
-    // requests from bidir connections. This method might be called if
-    // requests are received over the bidir connection after the
-    // adapter was deactivated.
+    // This method might be called if requests are received over a
+    // bidir connection after the adapter was deactivated, the stripes
+    // are then empty.
     //
-    //assert(_instance); // Must not be called after destruction.
-
-    ServantMapMap::iterator p = _servantMapMapHint;
-    FacetMap::iterator q;
-    
-    ServantMapMap& servantMapMap = const_cast<ServantMapMap&>(_servantMapMap);
-
-    if(p == servantMapMap.end() || p->first != ident)
     {
-        p = servantMapMap.find(ident);
-    }
-    
-    if(p == servantMapMap.end() || (q = p->second.find(facet)) == p->second.end())
-    {
-        DefaultServantMap::const_iterator p = _defaultServantMap.find(ident.category);
-        if(p == _defaultServantMap.end())
+        size_t hash;
+        Stripe& s = stripe(ident, hash);
+        IceUtil::Mutex::Lock sync(s);
+
+        FacetMap* facets = s.find(ident, hash);
+        if(facets)
         {
-            p = _defaultServantMap.find("");
-            if(p == _defaultServantMap.end())
-            {
-                return 0;
-            }
-            else
+            FacetMap::const_iterator q = facets->find(facet);
+            if(q != facets->end())
             {
-                return p->second;
+                return q->second;
             }
         }
-        else
-        {
-            return p->second;
-        }
     }
-    else
+
+    DefaultServantMapPtr defaultServantMap = this->defaultServantMap();
+    if(!defaultServantMap)
+    {
+        return 0;
+    }
+
+    DefaultServantMap::const_iterator p = defaultServantMap->map.find(ident.category);
+    if(p == defaultServantMap->map.end())
     {
-        _servantMapMapHint = p;
-        return q->second;
+        p = defaultServantMap->map.find("");
+        if(p == defaultServantMap->map.end())
+        {
+            return 0;
+        }
     }
+    return p->second;
 }
 
 ObjectPtr
 IceInternal::ServantManager::findDefaultServant(const string& category) const
 {
-    IceUtil::Mutex::Lock sync(*this);
-
-    DefaultServantMap::const_iterator p = _defaultServantMap.find(category);
-    if(p == _defaultServantMap.end())
+    DefaultServantMapPtr defaultServantMap = this->defaultServantMap();
+    if(!defaultServantMap)
     {
         return 0;
     }
-    else
+
+    DefaultServantMap::const_iterator p = defaultServantMap->map.find(category);
+    if(p == defaultServantMap->map.end())
     {
-        return p->second;
+        return 0;
     }
+    return p->second;
 }
 
 FacetMap
 IceInternal::ServantManager::findAllFacets(const Identity& ident) const
 {
-    IceUtil::Mutex::Lock sync(*this);
-    
-    assert(_instance); // Must not be called after destruction.
+    size_t hash;
+    Stripe& s = stripe(ident, hash);
+    IceUtil::Mutex::Lock sync(s);
 
-    ServantMapMap::iterator p = _servantMapMapHint;
-    
-    ServantMapMap& servantMapMap = const_cast<ServantMapMap&>(_servantMapMap);
-
-    if(p == servantMapMap.end() || p->first != ident)
-    {
-        p = servantMapMap.find(ident);
-    }
-    
-    if(p == servantMapMap.end())
+    FacetMap* facets = s.find(ident, hash);
+    if(!facets)
     {
         return FacetMap();
     }
     else
     {
-        _servantMapMapHint = p;
-        return p->second;
+        return *facets;
     }
 }
 
 bool
 IceInternal::ServantManager::hasServant(const Identity& ident) const
 {
-    IceUtil::Mutex::Lock sync(*this);
-    
-    //
-    // This assert is not valid if the adapter dispatch incoming
-    // requests from bidir connections. This method might be called if
-    // requests are received over the bidir connection after the
-    // adapter was deactivated.
-    //
-    //assert(_instance); // Must not be called after destruction.
+    size_t hash;
+    Stripe& s = stripe(ident, hash);
+    IceUtil::Mutex::Lock sync(s);
 
-    ServantMapMap::iterator p = _servantMapMapHint;
-    ServantMapMap& servantMapMap = const_cast<ServantMapMap&>(_servantMapMap);
-
-    if(p == servantMapMap.end() || p->first != ident)
-    {
-        p = servantMapMap.find(ident);
-    }
-    
-    if(p == servantMapMap.end())
-    {
-        return false;
-    }
-    else
-    {
-        _servantMapMapHint = p;
-        assert(!p->second.empty());
-        return true;
-    }
+    FacetMap* facets = s.find(ident, hash);
+    assert(!facets || !facets->empty());
+    return facets != 0;
 }
 
 void
@@ -330,16 +436,17 @@ IceInternal::ServantManager::addServantLocator(const ServantLocatorPtr& locator,
 
     assert(_instance); // Must not be called after destruction.
 
-    if((_locatorMapHint != _locatorMap.end() && _locatorMapHint->first == category)
-       || _locatorMap.find(category) != _locatorMap.end())
+    LocatorMapPtr locatorMap = _locatorMap ? new SharedMap<LocatorMap>(_locatorMap->map) : new SharedMap<LocatorMap>();
+    if(!locatorMap->map.insert(pair<const string, ServantLocatorPtr>(category, locator)).second)
     {
         AlreadyRegisteredException ex(__FILE__, __LINE__);
         ex.kindOfObject = "servant locator";
         ex.id = category;
         throw ex;
     }
-    
-    _locatorMapHint = _locatorMap.insert(_locatorMapHint, pair<const string, ServantLocatorPtr>(category, locator));
+
+    IceUtil::Mutex::Lock sync2(_mapsMutex);
+    _locatorMap = locatorMap;
 }
 
 ServantLocatorPtr
@@ -349,21 +456,8 @@ IceInternal::ServantManager::removeServantLocator(const string& category)
 
     assert(_instance); // Must not be called after destruction.
 
-    map<string, ServantLocatorPtr>::iterator p = _locatorMap.end();
-    if(_locatorMapHint != p)
-    {
-        if(_locatorMapHint->first == category)
-        {
-            p = _locatorMapHint;
-        }
-    }
-
-    if(p == _locatorMap.end())
-    {
-        p = _locatorMap.find(category);
-    }
-
-    if(p == _locatorMap.end())
+    LocatorMap::const_iterator p;
+    if(!_locatorMap || (p = _locatorMap->map.find(category)) == _locatorMap->map.end())
     {
         NotRegisteredException ex(__FILE__, __LINE__);
         ex.kindOfObject = "servant locator";
@@ -372,58 +466,49 @@ IceInternal::ServantManager::removeServantLocator(const string& category)
     }
 
     ServantLocatorPtr locator = p->second;
-    _locatorMap.erase(p);
-    _locatorMapHint = _locatorMap.begin();
+
+    LocatorMapPtr locatorMap;
+    if(_locatorMap->map.size() > 1)
+    {
+        locatorMap = new SharedMap<LocatorMap>(_locatorMap->map);
+        locatorMap->map.erase(category);
+    }
+
+    IceUtil::Mutex::Lock sync2(_mapsMutex);
+    _locatorMap = locatorMap;
     return locator;
 }
 
 ServantLocatorPtr
 IceInternal::ServantManager::findServantLocator(const string& category) const
 {
-    IceUtil::Mutex::Lock sync(*this);
-    
     //
-    // This assert is not valid if the adapter dispatch incoming
-    // requests from bidir connections. This method might be called if
-    // requests are received over the bidir connection after the
-    // adapter was deactivated.
+    // This method might be called if requests are received over a
+    // bidir connection after the adapter was deactivated, the map is
+    // then null.
     //
-    //assert(_instance); // Must not be called after destruction.
-
-    map<string, ServantLocatorPtr>& locatorMap =
-        const_cast<map<string, ServantLocatorPtr>&>(_locatorMap);
-
-    map<string, ServantLocatorPtr>::iterator p = locatorMap.end();
-    if(_locatorMapHint != locatorMap.end())
+    LocatorMapPtr locatorMap = this->locatorMap();
+    if(!locatorMap)
     {
-        if(_locatorMapHint->first == category)
-        {
-            p = _locatorMapHint;
-        }
-    }
-    
-    if(p == locatorMap.end())
-    {
-        p = locatorMap.find(category);
-    }
-    
-    if(p != locatorMap.end())
-    {
-        _locatorMapHint = p;
-        return p->second;
+        return 0;
     }
-    else
+
+    LocatorMap::const_iterator p = locatorMap->map.find(category);
+    if(p == locatorMap->map.end())
     {
         return 0;
     }
+    return p->second;
 }
 
 IceInternal::ServantManager::ServantManager(const InstancePtr& instance, const string& adapterName)
     : _instance(instance),
-      _adapterName(adapterName),
-      _servantMapMapHint(_servantMapMap.end()),
-      _locatorMapHint(_locatorMap.end())
+      _adapterName(adapterName)
 {
+    for(int i = 0; i < (1 << stripeBits); ++i)
+    {
+        _stripes[i] = new Stripe;
+    }
 }
 
 IceInternal::ServantManager::~ServantManager()
@@ -434,13 +519,18 @@ IceInternal::ServantManager::~ServantManager()
     // properly deactivated.
     //
     //assert(!_instance);
+
+    for(int i = 0; i < (1 << stripeBits); ++i)
+    {
+        delete _stripes[i];
+    }
 }
 
 void
 IceInternal::ServantManager::destroy()
 {
-    ServantMapMap servantMapMap;
-    map<string, ServantLocatorPtr> locatorMap;
+    vector<Stripe::Entry*> servants[1 << stripeBits];
+    LocatorMapPtr locatorMap;
     Ice::LoggerPtr logger;
 
     {
@@ -449,15 +539,24 @@ IceInternal::ServantManager::destroy()
         assert(_instance); // Must not be called after destruction.
         
         logger = _instance->initializationData().logger;
-        servantMapMap.swap(_servantMapMap);
-        _servantMapMapHint = _servantMapMap.end();
+        for(int i = 0; i < (1 << stripeBits); ++i)
+        {
+            IceUtil::Mutex::Lock sync2(*_stripes[i]);
+            _stripes[i]->take(servants[i]);
+        }
         
-        locatorMap.swap(_locatorMap);
-        _locatorMapHint = _locatorMap.end();
+        IceUtil::Mutex::Lock sync3(_mapsMutex);
+        locatorMap = _locatorMap;
+        _locatorMap = 0;
         _instance = 0;
     }
 
-    for(map<string, ServantLocatorPtr>::const_iterator p = locatorMap.begin(); p != locatorMap.end(); ++p)
+    LocatorMap locators;
+    if(locatorMap)
+    {
+        locators = locatorMap->map;
+    }
+    for(LocatorMap::const_iterator p = locators.begin(); p != locators.end(); ++p)
     {
         try
         {
@@ -485,6 +584,24 @@ IceInternal::ServantManager::destroy()
     // hold any internal Ice mutex while running user code (such as servant
     // or servant locator destructors). 
     //
-    servantMapMap.clear();
-    locatorMap.clear();
+    for(int i = 0; i < (1 << stripeBits); ++i)
+    {
+        Stripe::destroy(servants[i]);
+    }
+    locators.clear();
+    locatorMap = 0;
+}
+
+IceInternal::ServantManager::DefaultServantMapPtr
+IceInternal::ServantManager::defaultServantMap() const
+{
+    IceUtil::Mutex::Lock sync(_mapsMutex);
+    return _defaultServantMap;
+}
+
+IceInternal::ServantManager::LocatorMapPtr
+IceInternal::ServantManager::locatorMap() const
+{
+    IceUtil::Mutex::Lock sync(_mapsMutex);
+    return _locatorMap;
 }
@@ -28,7 +28,19 @@ class ObjectAdapterI;
 namespace IceInternal
 {
 
-class ServantManager : public IceUtil::Shared, public IceUtil::Mutex
+//
+// The servants are kept in a hash table of identities split in
+// stripes, each with its own mutex. Looking up a servant only locks
+// the stripe of its identity, so dispatch threads don't contend unless
+// they look up identities of the same stripe while it's updated.
+// Adding and removing servants also locks the servant manager, which
+// serializes the updates.
+//
+// The default servants and the servant locators are copied on write.
+// Looking them up only locks _mapsMutex to take the current copy,
+// which is then searched unlocked.
+//
+class ICE_API ServantManager : public IceUtil::Shared, public IceUtil::Mutex
 {
 public:
 
@@ -53,20 +65,47 @@ private:
     void destroy();
     friend class Ice::ObjectAdapterI;
 
-    InstancePtr _instance;
+    class Stripe;
+    Stripe& stripe(const Ice::Identity&, size_t&) const;
 
-    const std::string _adapterName;
+    template<typename T> class SharedMap : public IceUtil::Shared
+    {
+    public:
+
+        SharedMap()
+        {
+        }
+
+        SharedMap(const T& m) :
+            map(m)
+        {
+        }
+
+        T map;
+    };
 
-    typedef std::map<Ice::Identity, Ice::FacetMap> ServantMapMap;
     typedef std::map<std::string, Ice::ObjectPtr> DefaultServantMap;
+    typedef IceUtil::Handle<SharedMap<DefaultServantMap> > DefaultServantMapPtr;
+    typedef std::map<std::string, Ice::ServantLocatorPtr> LocatorMap;
+    typedef IceUtil::Handle<SharedMap<LocatorMap> > LocatorMapPtr;
+
+    DefaultServantMapPtr defaultServantMap() const;
+    LocatorMapPtr locatorMap() const;
 
-    ServantMapMap _servantMapMap;
-    mutable ServantMapMap::iterator _servantMapMapHint;
+    InstancePtr _instance;
+
+    const std::string _adapterName;
 
-    DefaultServantMap _defaultServantMap;
+    static const int stripeBits = 6;
+    Stripe* _stripes[1 << stripeBits];
 
-    std::map<std::string, Ice::ServantLocatorPtr> _locatorMap;
-    mutable std::map<std::string, Ice::ServantLocatorPtr>::iterator _locatorMapHint;
+    //
+    // The maps are null while empty, and otherwise never modified
+    // once assigned.
+    //
+    DefaultServantMapPtr _defaultServantMap;
+    LocatorMapPtr _locatorMap;
+    IceUtil::Mutex _mapsMutex;
 };
 
 }
@@ -0,0 +1,1089 @@
+// **********************************************************************
+//
+// Copyright (c) 2003-2011 ZeroC, Inc. All rights reserved.
+//
+// This copy of Ice is licensed to you under the terms described in the
+// ICE_LICENSE file included in this distribution.
+//
+// **********************************************************************
+
+#include <IceUtil/Random.h>
+#include <Ice/ShmTransceiver.h>
+#include <Ice/Connection.h>
+#include <Ice/Instance.h>
+#include <Ice/TraceLevels.h>
+#include <Ice/LoggerUtil.h>
+#include <Ice/Stats.h>
+#include <Ice/Buffer.h>
+#include <Ice/Network.h>
+#include <Ice/Properties.h>
+#include <Ice/LocalException.h>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+
+#if !defined(__GNUC__) && defined(__sun)
+#   include <atomic.h>
+#endif
+
+//
+// With memfd_create() and file seals, the segment is sealed against
+// resizing so that the peer can't make the accesses to its mapping
+// fail with SIGBUS by truncating the segment.
+//
+#if defined(MFD_ALLOW_SEALING) && defined(F_ADD_SEALS)
+#   define ICE_SHM_SEALING
+#endif
+
+using namespace std;
+using namespace Ice;
+using namespace IceInternal;
+
+//
+// The layout of a shared memory segment is a SegmentHeader, followed
+// by the Ring structures of both directions, followed by the data of
+// both rings. The first ring carries the data sent by the connecting
+// side, the second ring the data sent by the accepting side.
+//
+// The writer position of a ring is kept with a "signaled" bit in the
+// same word, so that the reader can only clear the bit if no data was
+// written since it found the ring empty. The writer sends a wakeup
+// byte over the socket each time it sets the bit; the reader receives
+// one wakeup byte each time it clears the bit. A wakeup byte is thus
+// pending on the socket, and the thread pool reports the connection
+// readable, as long as the ring contains data the reader didn't see.
+//
+// When the ring is full, the writer sends the rest of the buffer over
+// the socket in an inline record. The reader only reads the inline
+// records once the ring is empty, and the writer only uses the ring
+// again once the reader consumed all the inline records, so the data
+// is received in the order it was sent.
+//
+struct IceInternal::ShmTransceiver::Ring
+{
+    volatile unsigned int state;
+    volatile unsigned int inlineStarted;
+    char pad1[56];
+
+    volatile unsigned int tail;
+    volatile unsigned int inlineConsumed;
+    char pad2[56];
+};
+
+namespace
+{
+
+struct SegmentHeader
+{
+    Byte magic[4];
+    Int version;
+    Int size;
+    char pad[52];
+};
+
+const Byte segmentMagic[] = { 0x49, 0x63, 0x65, 0x4d }; // 'I', 'c', 'e', 'M'
+const Int segmentVersion = 1;
+
+const size_t minSize = 4096;
+const size_t maxSize = 1024 * 1024 * 1024;
+
+const unsigned int positionMask = 0x7fffffff;
+const unsigned int signaledBit = 1;
+
+const Byte handshakeByte = 'H';
+const Byte wakeupByte = 'W';
+const Byte inlineByte = 'D';
+const size_t recordSize = 5;
+
+#if defined(__GNUC__)
+
+inline void
+memoryBarrier()
+{
+    __sync_synchronize();
+}
+
+inline bool
+compareAndSwap(volatile unsigned int* p, unsigned int oldValue, unsigned int newValue)
+{
+    return __sync_bool_compare_and_swap(p, oldValue, newValue);
+}
+
+#elif defined(__sun)
+
+inline void
+memoryBarrier()
+{
+    membar_enter();
+    membar_exit();
+}
+
+inline bool
+compareAndSwap(volatile unsigned int* p, unsigned int oldValue, unsigned int newValue)
+{
+    return atomic_cas_uint(p, oldValue, newValue) == oldValue;
+}
+
+#else
+#   error "No atomic operations available for the shm transport"
+#endif
+
+inline unsigned int
+load(volatile unsigned int* p)
+{
+    unsigned int value = *p;
+    memoryBarrier();
+    return value;
+}
+
+inline void
+store(volatile unsigned int* p, unsigned int value)
+{
+    memoryBarrier();
+    *p = value;
+}
+
+void
+throwSyscallException(const char* file, int line)
+{
+    SyscallException ex(file, line);
+    ex.error = getSystemErrno();
+    throw ex;
+}
+
+void
+throwInvalidPosition(const char* file, int line)
+{
+    ProtocolException ex(file, line);
+    ex.reason = "invalid shm ring position";
+    throw ex;
+}
+
+void
+throwSocketException(const char* file, int line)
+{
+    if(connectionLost())
+    {
+        ConnectionLostException ex(file, line);
+        ex.error = getSocketErrno();
+        throw ex;
+    }
+    else
+    {
+        SocketException ex(file, line);
+        ex.error = getSocketErrno();
+        throw ex;
+    }
+}
+
+}
+
+NativeInfoPtr
+IceInternal::ShmTransceiver::getNativeInfo()
+{
+    return this;
+}
+
+SocketOperation
+IceInternal::ShmTransceiver::initialize()
+{
+    try
+    {
+        if(_state == StateNeedConnect)
+        {
+            _state = StateConnectPending;
+            return SocketOperationConnect;
+        }
+        else if(_state == StateConnectPending)
+        {
+            doFinishConnect(_fd);
+            _state = StateNeedHandshake;
+        }
+
+        if(_state == StateNeedHandshake)
+        {
+            if(_incoming)
+            {
+                if(!receiveHandshake())
+                {
+                    return SocketOperationRead;
+                }
+            }
+            else
+            {
+                if(!_segment)
+                {
+                    createSegment();
+                }
+                if(!sendHandshake())
+                {
+                    return SocketOperationWrite;
+                }
+            }
+            connected();
+        }
+    }
+    catch(const Ice::LocalException& ex)
+    {
+        if(_traceLevels->network >= 2)
+        {
+            Trace out(_logger, _traceLevels->networkCat);
+            out << "failed to establish shm connection to " << _path << "\n" << ex;
+        }
+        throw;
+    }
+    assert(_state == StateConnected);
+    return SocketOperationNone;
+}
+
+void
+IceInternal::ShmTransceiver::close()
+{
+    if(_state == StateConnected && _traceLevels->network >= 1)
+    {
+        Trace out(_logger, _traceLevels->networkCat);
+        out << "closing shm connection\n" << toString();
+    }
+
+    if(_segment)
+    {
+        munmap(_segment, _segmentSize);
+        _segment = 0;
+    }
+    if(_segmentFd != -1)
+    {
+        ::close(_segmentFd);
+        _segmentFd = -1;
+    }
+
+    assert(_fd != INVALID_SOCKET);
+    try
+    {
+        closeSocket(_fd);
+        _fd = INVALID_SOCKET;
+    }
+    catch(const SocketException&)
+    {
+        _fd = INVALID_SOCKET;
+        throw;
+    }
+}
+
+bool
+IceInternal::ShmTransceiver::write(Buffer& buf)
+{
+    while(buf.i != buf.b.end())
+    {
+        size_t packetSize = static_cast<size_t>(buf.b.end() - buf.i);
+
+        //
+        // Finish sending the inline record in progress.
+        //
+        if(_outRecordPos < recordSize)
+        {
+            size_t n = sendSome(_outRecord + _outRecordPos, recordSize - _outRecordPos);
+            if(n == 0)
+            {
+                return false;
+            }
+            _outRecordPos += n;
+            continue;
+        }
+        else if(_inlineOut > 0)
+        {
+            size_t n = sendSome(&*buf.i, min(packetSize, _inlineOut));
+            if(n == 0)
+            {
+                return false;
+            }
+
+            if(_traceLevels->network >= 3)
+            {
+                Trace out(_logger, _traceLevels->networkCat);
+                out << "sent " << n << " of " << packetSize << " bytes via shm socket\n" << toString();
+            }
+
+            if(_stats)
+            {
+                _stats->bytesSent(type(), static_cast<Int>(n));
+            }
+
+            buf.i += n;
+            _inlineOut -= n;
+            continue;
+        }
+
+        //
+        // Copy as much as possible to the ring, unless the reader
+        // still has inline records to consume.
+        //
+        if(load(&_out->inlineConsumed) == _inlineStarted)
+        {
+            //
+            // The reader position is in memory shared with the peer,
+            // it's checked before it's used to compute offsets.
+            //
+            size_t used = (_head - load(&_out->tail)) & positionMask;
+            if(used > _size)
+            {
+                throwInvalidPosition(__FILE__, __LINE__);
+            }
+            size_t space = _size - used;
+            if(space > 0)
+            {
+                size_t n = min(packetSize, space);
+                size_t offset = _head & (_size - 1);
+                size_t first = min(n, _size - offset);
+                memcpy(_outData + offset, &*buf.i, first);
+                memcpy(_outData, &*buf.i + first, n - first);
+                _head = (_head + static_cast<unsigned int>(n)) & positionMask;
+
+                //
+                // Publish the new position. The compare-and-swap is
+                // also the barrier which makes the data visible to
+                // the reader before the position.
+                //
+                unsigned int oldState;
+                do
+                {
+                    oldState = _out->state;
+                }
+                while(!compareAndSwap(&_out->state, oldState, (_head << 1) | signaledBit));
+
+                if(_traceLevels->network >= 3)
+                {
+                    Trace out(_logger, _traceLevels->networkCat);
+                    out << "sent " << n << " of " << packetSize << " bytes via shm\n" << toString();
+                }
+
+                if(_stats)
+                {
+                    _stats->bytesSent(type(), static_cast<Int>(n));
+                }
+
+                buf.i += n;
+
+                if(!(oldState & signaledBit))
+                {
+                    //
+                    // If the wakeup can't be sent now, the socket is
+                    // full and the reader has data to read anyway. It
+                    // is sent before anything else is written to the
+                    // socket.
+                    //
+                    ++_wakeupsPending;
+                    flushWakeups();
+                }
+                continue;
+            }
+        }
+
+        //
+        // Start an inline record with the rest of the buffer.
+        //
+        if(!flushWakeups())
+        {
+            return false;
+        }
+        Int length = static_cast<Int>(min(packetSize, static_cast<size_t>(0x7fffffff)));
+        _outRecord[0] = inlineByte;
+        memcpy(_outRecord + 1, &length, sizeof(length));
+        _outRecordPos = 0;
+        _inlineOut = static_cast<size_t>(length);
+        store(&_out->inlineStarted, ++_inlineStarted);
+    }
+
+    return true;
+}
+
+bool
+IceInternal::ShmTransceiver::read(Buffer& buf)
+{
+    while(buf.i != buf.b.end())
+    {
+        size_t packetSize = static_cast<size_t>(buf.b.end() - buf.i);
+
+        //
+        // Finish receiving the inline record in progress.
+        //
+        if(_inRecordPos > 0)
+        {
+            if(!readRecordHeader())
+            {
+                return false;
+            }
+            continue;
+        }
+        else if(_inlineIn > 0)
+        {
+            size_t n = receiveSome(&*buf.i, min(packetSize, _inlineIn));
+            if(n == 0)
+            {
+                return false;
+            }
+
+            if(_traceLevels->network >= 3)
+            {
+                Trace out(_logger, _traceLevels->networkCat);
+                out << "received " << n << " of " << packetSize << " bytes via shm socket\n" << toString();
+            }
+
+            if(_stats)
+            {
+                _stats->bytesReceived(type(), static_cast<Int>(n));
+            }
+
+            buf.i += n;
+            _inlineIn -= n;
+            if(_inlineIn == 0)
+            {
+                store(&_in->inlineConsumed, ++_inlineConsumed);
+            }
+            continue;
+        }
+
+        unsigned int state = load(&_in->state);
+        size_t available = ((state >> 1) - _tail) & positionMask;
+        if(available > _size)
+        {
+            throwInvalidPosition(__FILE__, __LINE__);
+        }
+        if(available > 0)
+        {
+            size_t n = min(packetSize, available);
+            size_t offset = _tail & (_size - 1);
+            size_t first = min(n, _size - offset);
+            memcpy(&*buf.i, _inData + offset, first);
+            memcpy(&*buf.i + first, _inData, n - first);
+            _tail = (_tail + static_cast<unsigned int>(n)) & positionMask;
+            store(&_in->tail, _tail);
+
+            if(_traceLevels->network >= 3)
+            {
+                Trace out(_logger, _traceLevels->networkCat);
+                out << "received " << n << " of " << packetSize << " bytes via shm\n" << toString();
+            }
+
+            if(_stats)
+            {
+                _stats->bytesReceived(type(), static_cast<Int>(n));
+            }
+
+            buf.i += n;
+            continue;
+        }
+
+        //
+        // The ring is empty. Clear the signaled bit, which fails if
+        // the writer added data in the meantime, and receive the
+        // wakeup byte sent when the bit was set.
+        //
+        if(state & signaledBit)
+        {
+            if(compareAndSwap(&_in->state, state, state & ~signaledBit))
+            {
+                ++_owedWakeups;
+            }
+            continue;
+        }
+
+        //
+        // The wakeup bytes precede the inline records on the socket.
+        //
+        if(_owedWakeups > 0)
+        {
+            if(!receiveWakeups())
+            {
+                return false;
+            }
+            continue;
+        }
+
+        if(load(&_in->inlineStarted) != _inlineConsumed)
+        {
+            if(!readRecordHeader())
+            {
+                return false;
+            }
+            continue;
+        }
+
+        //
+        // Nothing is expected on the socket, but the thread pool might
+        // have woken us up because the peer closed it. Otherwise, data
+        // on the socket was sent after the shared memory was updated,
+        // so check the rings again.
+        //
+        if(!peekSocket())
+        {
+            return false;
+        }
+        else if(load(&_in->state) == state && load(&_in->inlineStarted) == _inlineConsumed)
+        {
+            ProtocolException ex(__FILE__, __LINE__);
+            ex.reason = "unexpected data on shm socket";
+            throw ex;
+        }
+    }
+
+    return true;
+}
+
+string
+IceInternal::ShmTransceiver::type() const
+{
+    return "shm";
+}
+
+string
+IceInternal::ShmTransceiver::toString() const
+{
+    return _desc;
+}
+
+Ice::ConnectionInfoPtr
+IceInternal::ShmTransceiver::getInfo() const
+{
+    assert(_fd != INVALID_SOCKET);
+    Ice::ShmConnectionInfoPtr info = new Ice::ShmConnectionInfo();
+    info->path = _path;
+    info->peerPid = _peerPid;
+    info->peerUid = _peerUid;
+    info->peerGid = _peerGid;
+    info->size = static_cast<Int>(_size);
+    return info;
+}
+
+void
+IceInternal::ShmTransceiver::checkSendSize(const Buffer& buf, size_t messageSizeMax)
+{
+    if(buf.b.size() > messageSizeMax)
+    {
+        Ex::throwMemoryLimitException(__FILE__, __LINE__, buf.b.size(), messageSizeMax);
+    }
+}
+
+IceInternal::ShmTransceiver::ShmTransceiver(const InstancePtr& instance, SOCKET fd, const string& path,
+                                            bool incoming) :
+    NativeInfo(fd),
+    _traceLevels(instance->traceLevels()),
+    _logger(instance->initializationData().logger),
+    _stats(instance->initializationData().stats),
+    _path(path),
+    _incoming(incoming),
+    _state(incoming ? StateNeedHandshake : StateNeedConnect),
+    _peerPid(-1),
+    _peerUid(-1),
+    _peerGid(-1),
+    _size(0),
+    _segmentFd(-1),
+    _segment(0),
+    _segmentSize(0),
+    _in(0),
+    _out(0),
+    _inData(0),
+    _outData(0),
+    _head(0),
+    _inlineStarted(0),
+    _wakeupsPending(0),
+    _outRecordPos(recordSize),
+    _inlineOut(0),
+    _tail(0),
+    _inlineConsumed(0),
+    _owedWakeups(0),
+    _inRecordPos(0),
+    _inlineIn(0)
+{
+    setBlock(_fd, false);
+
+    if(!incoming)
+    {
+        //
+        // The connecting side chooses the size of the rings, rounded
+        // up to a power of two.
+        //
+        Int size = instance->initializationData().properties->getPropertyAsIntWithDefault("Ice.SHM.Size", 1024 * 1024);
+        _size = minSize;
+        while(_size < maxSize && static_cast<Int>(_size) < size)
+        {
+            _size *= 2;
+        }
+    }
+}
+
+IceInternal::ShmTransceiver::~ShmTransceiver()
+{
+    assert(_fd == INVALID_SOCKET);
+    assert(!_segment);
+}
+
+void
+IceInternal::ShmTransceiver::connect()
+{
+    try
+    {
+        if(doConnectUnix(_fd, _path))
+        {
+            _state = StateNeedHandshake;
+        }
+    }
+    catch(...)
+    {
+        _fd = INVALID_SOCKET;
+        throw;
+    }
+}
+
+void
+IceInternal::ShmTransceiver::connected()
+{
+    _state = StateConnected;
+
+    fdToPeerCredentials(_fd, _peerPid, _peerUid, _peerGid);
+
+    ostringstream s;
+    s << "path = " << _path;
+    if(_peerUid != -1)
+    {
+        s << "\npeer uid = " << _peerUid << ", gid = " << _peerGid;
+        if(_peerPid != -1)
+        {
+            s << ", pid = " << _peerPid;
+        }
+    }
+    s << "\nring size = " << _size;
+    _desc = s.str();
+
+    if(!_incoming && _traceLevels->network >= 1)
+    {
+        Trace out(_logger, _traceLevels->networkCat);
+        out << "shm connection established\n" << _desc;
+    }
+}
+
+size_t
+IceInternal::ShmTransceiver::segmentSize(size_t size)
+{
+    return sizeof(SegmentHeader) + 2 * sizeof(Ring) + 2 * size;
+}
+
+void
+IceInternal::ShmTransceiver::createSegment()
+{
+#ifdef ICE_SHM_SEALING
+    int fd = memfd_create("ice-shm", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    if(fd == -1)
+    {
+        throwSyscallException(__FILE__, __LINE__);
+    }
+
+    _segmentFd = fd;
+    if(ftruncate(fd, static_cast<off_t>(segmentSize(_size))) == -1 ||
+       fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL) == -1)
+    {
+        throwSyscallException(__FILE__, __LINE__);
+    }
+#else
+    //
+    // The segment is removed from the name space as soon as it is
+    // created, it only lives as long as it's mapped by the two sides.
+    //
+    int fd = -1;
+    for(int i = 0; fd == -1; ++i)
+    {
+        ostringstream name;
+        name << "/ice-shm-" << getpid() << "-" << IceUtilInternal::random();
+        fd = shm_open(name.str().c_str(), O_RDWR | O_CREAT | O_EXCL, S_IRUSR | S_IWUSR);
+        if(fd == -1)
+        {
+            if(errno != EEXIST || i == 10)
+            {
+                throwSyscallException(__FILE__, __LINE__);
+            }
+        }
+        else
+        {
+            shm_unlink(name.str().c_str());
+        }
+    }
+
+    _segmentFd = fd;
+    if(ftruncate(fd, static_cast<off_t>(segmentSize(_size))) == -1)
+    {
+        throwSyscallException(__FILE__, __LINE__);
+    }
+#endif
+
+    mapSegment(fd, _size);
+
+    SegmentHeader* header = reinterpret_cast<SegmentHeader*>(_segment);
+    memcpy(header->magic, segmentMagic, sizeof(segmentMagic));
+    header->version = segmentVersion;
+    header->size = static_cast<Int>(_size);
+}
+
+void
+IceInternal::ShmTransceiver::mapSegment(int fd, size_t size)
+{
+    assert(!_segment);
+    _size = size;
+    _segmentSize = segmentSize(size);
+    void* segment = mmap(0, _segmentSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if(segment == MAP_FAILED)
+    {
+        throwSyscallException(__FILE__, __LINE__);
+    }
+    _segment = segment;
+
+    Ring* rings = reinterpret_cast<Ring*>(static_cast<Byte*>(_segment) + sizeof(SegmentHeader));
+    Byte* data = reinterpret_cast<Byte*>(rings + 2);
+    if(_incoming)
+    {
+        _in = &rings[0];
+        _inData = data;
+        _out = &rings[1];
+        _outData = data + size;
+    }
+    else
+    {
+        _out = &rings[0];
+        _outData = data;
+        _in = &rings[1];
+        _inData = data + size;
+    }
+}
+
+bool
+IceInternal::ShmTransceiver::sendHandshake()
+{
+    //
+    // Pass the segment file descriptor to the peer.
+    //
+    Byte b = handshakeByte;
+    struct iovec iov;
+    iov.iov_base = reinterpret_cast<char*>(&b);
+    iov.iov_len = 1;
+
+    char control[CMSG_SPACE(sizeof(int))];
+    memset(control, 0, sizeof(control));
+
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+
+    struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+    memcpy(CMSG_DATA(cmsg), &_segmentFd, sizeof(int));
+
+    while(sendmsg(_fd, &msg, 0) == SOCKET_ERROR)
+    {
+        if(interrupted())
+        {
+            continue;
+        }
+
+        if(wouldBlock())
+        {
+            return false;
+        }
+
+        throwSocketException(__FILE__, __LINE__);
+    }
+
+    ::close(_segmentFd);
+    _segmentFd = -1;
+    return true;
+}
+
+bool
+IceInternal::ShmTransceiver::receiveHandshake()
+{
+    Byte b = 0;
+    struct iovec iov;
+    iov.iov_base = reinterpret_cast<char*>(&b);
+    iov.iov_len = 1;
+
+    char control[CMSG_SPACE(sizeof(int))];
+
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+
+    //
+    // The segment file descriptor must not be inherited by child
+    // processes, as it would keep the segment alive.
+    //
+#ifdef MSG_CMSG_CLOEXEC
+    const int flags = MSG_CMSG_CLOEXEC;
+#else
+    const int flags = 0;
+#endif
+
+    ssize_t ret;
+    while((ret = recvmsg(_fd, &msg, flags)) == SOCKET_ERROR)
+    {
+        if(interrupted())
+        {
+            continue;
+        }
+
+        if(wouldBlock())
+        {
+            return false;
+        }
+
+        throwSocketException(__FILE__, __LINE__);
+    }
+
+    if(ret == 0)
+    {
+        ConnectionLostException ex(__FILE__, __LINE__);
+        ex.error = 0;
+        throw ex;
+    }
+
+    struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+    if(cmsg && cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_RIGHTS &&
+       cmsg->cmsg_len == CMSG_LEN(sizeof(int)))
+    {
+        memcpy(&_segmentFd, CMSG_DATA(cmsg), sizeof(int));
+    }
+
+    if(b != handshakeByte || _segmentFd == -1 || (msg.msg_flags & MSG_CTRUNC))
+    {
+        ProtocolException ex(__FILE__, __LINE__);
+        ex.reason = "invalid shm handshake";
+        throw ex;
+    }
+
+#ifdef ICE_SHM_SEALING
+    //
+    // The segment must be sealed against resizing before its size is
+    // checked, the peer could otherwise still truncate it once it's
+    // mapped.
+    //
+    int seals = fcntl(_segmentFd, F_GET_SEALS);
+    if(seals == -1 || (seals & (F_SEAL_SHRINK | F_SEAL_GROW)) != (F_SEAL_SHRINK | F_SEAL_GROW))
+    {
+        ProtocolException ex(__FILE__, __LINE__);
+        ex.reason = "unsealed shm segment";
+        throw ex;
+    }
+#endif
+
+    //
+    // Check the segment before trusting the size it advertises.
+    //
+    struct stat st;
+    if(fstat(_segmentFd, &st) == -1)
+    {
+        throwSyscallException(__FILE__, __LINE__);
+    }
+
+    SegmentHeader header;
+    if(static_cast<size_t>(st.st_size) < sizeof(header) ||
+       pread(_segmentFd, &header, sizeof(header), 0) != static_cast<ssize_t>(sizeof(header)) ||
+       memcmp(header.magic, segmentMagic, sizeof(segmentMagic)) != 0 || header.version != segmentVersion ||
+       header.size < static_cast<Int>(minSize) || header.size > static_cast<Int>(maxSize) ||
+       (header.size & (header.size - 1)) != 0 ||
+       static_cast<size_t>(st.st_size) != segmentSize(static_cast<size_t>(header.size)))
+    {
+        ProtocolException ex(__FILE__, __LINE__);
+        ex.reason = "invalid shm segment";
+        throw ex;
+    }
+
+    mapSegment(_segmentFd, static_cast<size_t>(header.size));
+
+    ::close(_segmentFd);
+    _segmentFd = -1;
+    return true;
+}
+
+bool
+IceInternal::ShmTransceiver::flushWakeups()
+{
+    while(_wakeupsPending > 0)
+    {
+        Byte buf[64];
+        size_t n = min(static_cast<size_t>(_wakeupsPending), sizeof(buf));
+        memset(buf, wakeupByte, n);
+        n = sendSome(buf, n);
+        if(n == 0)
+        {
+            return false;
+        }
+        _wakeupsPending -= static_cast<unsigned int>(n);
+    }
+    return true;
+}
+
+bool
+IceInternal::ShmTransceiver::receiveWakeups()
+{
+    Byte buf[64];
+    size_t n = receiveSome(buf, min(static_cast<size_t>(_owedWakeups), sizeof(buf)));
+    if(n == 0)
+    {
+        return false;
+    }
+
+    for(size_t i = 0; i < n; ++i)
+    {
+        if(buf[i] != wakeupByte)
+        {
+            ProtocolException ex(__FILE__, __LINE__);
+            ex.reason = "invalid shm wakeup";
+            throw ex;
+        }
+    }
+    _owedWakeups -= static_cast<unsigned int>(n);
+    return true;
+}
+
+bool
+IceInternal::ShmTransceiver::readRecordHeader()
+{
+    size_t n = receiveSome(_inRecord + _inRecordPos, recordSize - _inRecordPos);
+    if(n == 0)
+    {
+        return false;
+    }
+
+    _inRecordPos += n;
+    if(_inRecordPos == recordSize)
+    {
+        Int length;
+        memcpy(&length, _inRecord + 1, sizeof(length));
+        if(_inRecord[0] != inlineByte || length <= 0)
+        {
+            ProtocolException ex(__FILE__, __LINE__);
+            ex.reason = "invalid shm inline record";
+            throw ex;
+        }
+        _inlineIn = static_cast<size_t>(length);
+        _inRecordPos = 0;
+    }
+    return true;
+}
+
+size_t
+IceInternal::ShmTransceiver::sendSome(const Byte* data, size_t size)
+{
+    assert(_fd != INVALID_SOCKET);
+    while(true)
+    {
+        ssize_t ret = ::send(_fd, reinterpret_cast<const char*>(data), size, 0);
+        if(ret == 0)
+        {
+            ConnectionLostException ex(__FILE__, __LINE__);
+            ex.error = 0;
+            throw ex;
+        }
+
+        if(ret == SOCKET_ERROR)
+        {
+            if(interrupted())
+            {
+                continue;
+            }
+
+            if(noBuffers() && size > 1024)
+            {
+                size /= 2;
+                continue;
+            }
+
+            if(wouldBlock())
+            {
+                return 0;
+            }
+
+            throwSocketException(__FILE__, __LINE__);
+        }
+
+        return static_cast<size_t>(ret);
+    }
+}
+
+bool
+IceInternal::ShmTransceiver::peekSocket()
+{
+    assert(_fd != INVALID_SOCKET);
+    while(true)
+    {
+        Byte b;
+        ssize_t ret = ::recv(_fd, reinterpret_cast<char*>(&b), 1, MSG_PEEK);
+        if(ret == 0)
+        {
+            ConnectionLostException ex(__FILE__, __LINE__);
+            ex.error = 0;
+            throw ex;
+        }
+
+        if(ret == SOCKET_ERROR)
+        {
+            if(interrupted())
+            {
+                continue;
+            }
+
+            if(wouldBlock())
+            {
+                return false;
+            }
+
+            throwSocketException(__FILE__, __LINE__);
+        }
+
+        return true;
+    }
+}
+
+size_t
+IceInternal::ShmTransceiver::receiveSome(Byte* data, size_t size)
+{
+    assert(_fd != INVALID_SOCKET);
+    while(true)
+    {
+        ssize_t ret = ::recv(_fd, reinterpret_cast<char*>(data), size, 0);
+        if(ret == 0)
+        {
+            ConnectionLostException ex(__FILE__, __LINE__);
+            ex.error = 0;
+            throw ex;
+        }
+
+        if(ret == SOCKET_ERROR)
+        {
+            if(interrupted())
+            {
+                continue;
+            }
+
+            if(noBuffers() && size > 1024)
+            {
+                size /= 2;
+                continue;
+            }
+
+            if(wouldBlock())
+            {
+                return 0;
+            }
+
+            throwSocketException(__FILE__, __LINE__);
+        }
+
+        return static_cast<size_t>(ret);
+    }
+}
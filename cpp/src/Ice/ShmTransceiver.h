@@ -0,0 +1,137 @@
+// **********************************************************************
+//
+// Copyright (c) 2003-2011 ZeroC, Inc. All rights reserved.
+//
+// This copy of Ice is licensed to you under the terms described in the
+// ICE_LICENSE file included in this distribution.
+//
+// **********************************************************************
+
+#ifndef ICE_SHM_TRANSCEIVER_H
+#define ICE_SHM_TRANSCEIVER_H
+
+#include <Ice/InstanceF.h>
+#include <Ice/TraceLevelsF.h>
+#include <Ice/LoggerF.h>
+#include <Ice/StatsF.h>
+#include <Ice/Transceiver.h>
+
+namespace IceInternal
+{
+
+class UnixConnector;
+class UnixAcceptor;
+
+//
+// A transceiver which exchanges the protocol messages through a pair
+// of single-producer/single-consumer ring buffers in a shared memory
+// segment. The segment is created by the connecting side and passed
+// to the accepting side over a Unix domain socket. The socket is also
+// the file descriptor the thread pool waits on: the writer only sends
+// a wakeup byte on it when the reader may be idle, and the data which
+// doesn't fit in a full ring buffer is sent inline over the socket.
+//
+class ShmTransceiver : public Transceiver, public NativeInfo
+{
+    enum State
+    {
+        StateNeedConnect,
+        StateConnectPending,
+        StateNeedHandshake,
+        StateConnected
+    };
+
+public:
+
+    virtual NativeInfoPtr getNativeInfo();
+
+    virtual SocketOperation initialize();
+    virtual void close();
+    virtual bool write(Buffer&);
+    virtual bool read(Buffer&);
+    virtual std::string type() const;
+    virtual std::string toString() const;
+    virtual Ice::ConnectionInfoPtr getInfo() const;
+    virtual void checkSendSize(const Buffer&, size_t);
+
+private:
+
+    struct Ring;
+
+    ShmTransceiver(const InstancePtr&, SOCKET, const std::string&, bool);
+    virtual ~ShmTransceiver();
+
+    void connect();
+    void connected();
+
+    static size_t segmentSize(size_t);
+
+    void createSegment();
+    void mapSegment(int, size_t);
+    bool sendHandshake();
+    bool receiveHandshake();
+
+    bool flushWakeups();
+    bool receiveWakeups();
+    bool readRecordHeader();
+    bool peekSocket();
+    size_t sendSome(const Ice::Byte*, size_t);
+    size_t receiveSome(Ice::Byte*, size_t);
+
+    friend class UnixConnector;
+    friend class UnixAcceptor;
+
+    const TraceLevelsPtr _traceLevels;
+    const Ice::LoggerPtr _logger;
+    const Ice::StatsPtr _stats;
+    const std::string _path;
+    const bool _incoming;
+
+    State _state;
+    std::string _desc;
+
+    int _peerPid;
+    int _peerUid;
+    int _peerGid;
+
+    //
+    // The shared memory segment, and the rings for each direction.
+    //
+    size_t _size;
+    int _segmentFd;
+    void* _segment;
+    size_t _segmentSize;
+    Ring* _in;
+    Ring* _out;
+    Ice::Byte* _inData;
+    Ice::Byte* _outData;
+
+    //
+    // Writer state: the position of the writer in the outgoing ring,
+    // the number of inline records started, the number of wakeup
+    // bytes not sent yet, and the inline record being sent.
+    //
+    unsigned int _head;
+    unsigned int _inlineStarted;
+    unsigned int _wakeupsPending;
+    Ice::Byte _outRecord[5];
+    size_t _outRecordPos;
+    size_t _inlineOut;
+
+    //
+    // Reader state: the position of the reader in the incoming ring,
+    // the number of inline records consumed, the number of wakeup
+    // bytes acknowledged but not received yet, and the inline record
+    // being received.
+    //
+    unsigned int _tail;
+    unsigned int _inlineConsumed;
+    unsigned int _owedWakeups;
+    Ice::Byte _inRecord[5];
+    size_t _inRecordPos;
+    size_t _inlineIn;
+};
+
+}
+
+#endif
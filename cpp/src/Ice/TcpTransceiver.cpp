@@ -17,10 +17,31 @@
 #include <Ice/Network.h>
 #include <Ice/LocalException.h>
 
+#ifndef _WIN32
+#   include <sys/uio.h>
+#   include <limits.h>
+#endif
+
 using namespace std;
 using namespace Ice;
 using namespace IceInternal;
 
+#ifndef _WIN32
+namespace
+{
+
+//
+// The maximum number of buffers sent with a single writev() call.
+//
+#if defined(IOV_MAX) && IOV_MAX < 64
+const int maxGatherBuffers = IOV_MAX;
+#else
+const int maxGatherBuffers = 64;
+#endif
+
+}
+#endif
+
 NativeInfoPtr
 IceInternal::TcpTransceiver::getNativeInfo()
 {
@@ -194,6 +215,134 @@ IceInternal::TcpTransceiver::write(Buffer& buf)
     return true;
 }
 
+#ifndef _WIN32
+bool
+IceInternal::TcpTransceiver::gatherWrite(const vector<Buffer*>& bufs)
+{
+    vector<Buffer*>::const_iterator first = bufs.begin();
+    while(true)
+    {
+        //
+        // Skip the buffers which are already fully written.
+        //
+        while(first != bufs.end() && (*first)->i == (*first)->b.end())
+        {
+            ++first;
+        }
+
+        if(first == bufs.end())
+        {
+            return true;
+        }
+
+        struct iovec iov[maxGatherBuffers];
+        int iovcnt = 0;
+        size_t packetSize = 0;
+        for(vector<Buffer*>::const_iterator p = first; p != bufs.end() && iovcnt < maxGatherBuffers; ++p)
+        {
+            size_t len = static_cast<size_t>((*p)->b.end() - (*p)->i);
+            if(len > 0)
+            {
+                iov[iovcnt].iov_base = reinterpret_cast<char*>(&*(*p)->i);
+                iov[iovcnt].iov_len = len;
+                packetSize += len;
+                ++iovcnt;
+            }
+        }
+
+        if(iovcnt == 1)
+        {
+            //
+            // Nothing to gather, use the regular write.
+            //
+            if(!write(**first))
+            {
+                return false;
+            }
+            continue;
+        }
+
+        assert(_fd != INVALID_SOCKET);
+        ssize_t ret = ::writev(_fd, iov, iovcnt);
+        if(ret == 0)
+        {
+            ConnectionLostException ex(__FILE__, __LINE__);
+            ex.error = 0;
+            throw ex;
+        }
+
+        if(ret == SOCKET_ERROR)
+        {
+            if(interrupted())
+            {
+                continue;
+            }
+
+            if(noBuffers())
+            {
+                //
+                // Let write() reduce the packet size for the first buffer.
+                //
+                if(!write(**first))
+                {
+                    return false;
+                }
+                continue;
+            }
+
+            if(wouldBlock())
+            {
+                return false;
+            }
+
+            if(connectionLost())
+            {
+                ConnectionLostException ex(__FILE__, __LINE__);
+                ex.error = getSocketErrno();
+                throw ex;
+            }
+            else
+            {
+                SocketException ex(__FILE__, __LINE__);
+                ex.error = getSocketErrno();
+                throw ex;
+            }
+        }
+
+        if(_traceLevels->network >= 3)
+        {
+            Trace out(_logger, _traceLevels->networkCat);
+            out << "sent " << ret << " of " << packetSize << " bytes in " << iovcnt << " buffers via tcp\n"
+                << toString();
+        }
+
+        if(_stats)
+        {
+            _stats->bytesSent(type(), static_cast<Int>(ret));
+        }
+
+        //
+        // Advance the buffer iterators past the bytes that were sent.
+        //
+        size_t sent = static_cast<size_t>(ret);
+        for(vector<Buffer*>::const_iterator p = first; p != bufs.end() && sent > 0; ++p)
+        {
+            size_t len = static_cast<size_t>((*p)->b.end() - (*p)->i);
+            if(sent >= len)
+            {
+                (*p)->i = (*p)->b.end();
+                sent -= len;
+            }
+            else
+            {
+                (*p)->i += sent;
+                sent = 0;
+            }
+        }
+    }
+}
+#endif
+
 bool
 IceInternal::TcpTransceiver::read(Buffer& buf)
 {
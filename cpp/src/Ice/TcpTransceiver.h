@@ -42,6 +42,9 @@ public:
     virtual void close();
     virtual bool write(Buffer&);
     virtual bool read(Buffer&);
+#ifndef _WIN32
+    virtual bool gatherWrite(const std::vector<Buffer*>&);
+#endif
 #ifdef ICE_USE_IOCP
     virtual bool startWrite(Buffer&);
     virtual void finishWrite(Buffer&);
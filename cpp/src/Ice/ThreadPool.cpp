@@ -25,6 +25,7 @@
 #include <Ice/ObjectAdapterFactory.h>
 #include <Ice/Properties.h>
 #include <Ice/TraceLevels.h>
+#include <Ice/MetricsManager.h>
 
 using namespace std;
 using namespace Ice;
@@ -227,6 +228,13 @@ IceInternal::ThreadPoolWorkQueue::queue(const ThreadPoolWorkItemPtr& item)
 #endif
 }
 
+size_t
+IceInternal::ThreadPoolWorkQueue::size() const
+{
+    Lock sync(*this);
+    return _workItems.size();
+}
+
 #ifdef ICE_USE_IOCP
 bool
 IceInternal::ThreadPoolWorkQueue::startAsync(SocketOperation)
@@ -382,6 +390,8 @@ IceInternal::ThreadPool::ThreadPool(const InstancePtr& instance, const string& p
 #ifndef ICE_USE_IOCP
     _inUseIO(0),
     _nextHandler(_handlers.end()),
+    _nextReactor(0),
+    _idleReactors(0),
 #endif
     _promote(true)
 {
@@ -442,14 +452,54 @@ IceInternal::ThreadPool::ThreadPool(const InstancePtr& instance, const string& p
         threadIdleTime = 0;
     }
 
+    //
+    // With the Reactor model, the pool has a fixed number of threads,
+    // each with its own selector.
+    //
+    bool reactor = false;
+    string model = properties->getPropertyWithDefault(_prefix + ".Model", "LeaderFollower");
+    if(model == "Reactor")
+    {
+#ifdef ICE_USE_IOCP
+        Warning out(_instance->initializationData().logger);
+        out << _prefix << ".Model=Reactor is not supported with IOCP; using the LeaderFollower model";
+#else
+        reactor = true;
+        sizeMax = size;
+        sizeWarn = 0;
+#endif
+    }
+    else if(model != "LeaderFollower")
+    {
+        Warning out(_instance->initializationData().logger);
+        out << "unknown value `" << model << "' for " << _prefix << ".Model; using the LeaderFollower model";
+    }
+
+    //
+    // With edge-triggered notifications, the thread pool doesn't need
+    // to update the selector when connections are enabled, disabled
+    // or change their registration, see Selector::setEdgeTriggered().
+    //
+    bool edgeTriggered = properties->getPropertyAsInt(_prefix + ".EdgeTriggered") > 0;
+#ifndef ICE_USE_EPOLL
+    if(edgeTriggered)
+    {
+        Warning out(_instance->initializationData().logger);
+        out << _prefix << ".EdgeTriggered is only supported with epoll";
+        edgeTriggered = false;
+    }
+#endif
+
     const_cast<int&>(_size) = size;
     const_cast<int&>(_sizeMax) = sizeMax;
     const_cast<int&>(_sizeWarn) = sizeWarn;
     const_cast<int&>(_sizeIO) = min(sizeMax, nProcessors);
     const_cast<int&>(_threadIdleTime) = threadIdleTime;
 
-#ifdef ICE_USE_IOCP
+#if defined(ICE_USE_IOCP)
     _selector.setup(_sizeIO);
+#elif defined(ICE_USE_EPOLL)
+    _selector.setEdgeTriggered(edgeTriggered);
 #endif
 
     int stackSize = properties->getPropertyAsInt(_prefix + ".StackSize");
@@ -469,13 +519,36 @@ IceInternal::ThreadPool::ThreadPool(const InstancePtr& instance, const string& p
         const_cast<int&>(_priority) = properties->getPropertyAsInt("Ice.ThreadPriority");
     }
 
-    _workQueue = new ThreadPoolWorkQueue(this, _instance, _selector);
+#ifndef ICE_USE_IOCP
+    if(reactor)
+    {
+        for(int i = 0; i < _size; ++i)
+        {
+            _reactors.push_back(new Reactor(this, _instance));
+#ifdef ICE_USE_EPOLL
+            _reactors.back()->selector.setEdgeTriggered(edgeTriggered);
+#endif
+        }
+    }
+    else
+#endif
+    {
+        _workQueue = new ThreadPoolWorkQueue(this, _instance, _selector);
+    }
 
     if(_instance->traceLevels()->threadPool >= 1)
     {
         Trace out(_instance->initializationData().logger, _instance->traceLevels()->threadPoolCat);
         out << "creating " << _prefix << ": Size = " << _size << ", SizeMax = " << _sizeMax << ", SizeWarn = "
             << _sizeWarn;
+        if(reactor)
+        {
+            out << ", Model = Reactor";
+        }
+        if(edgeTriggered)
+        {
+            out << ", EdgeTriggered = 1";
+        }
     }
 
     __setNoDelete(true);
@@ -483,7 +556,11 @@ IceInternal::ThreadPool::ThreadPool(const InstancePtr& instance, const string& p
     {
         for(int i = 0 ; i < _size ; ++i)
         {
+#ifndef ICE_USE_IOCP
+            IceUtil::ThreadPtr thread = new EventHandlerThread(this, reactor ? _reactors[i] : ReactorPtr());
+#else
             IceUtil::ThreadPtr thread = new EventHandlerThread(this);
+#endif
             if(_hasPriority)
             {
                 thread->start(_stackSize, _priority);
@@ -513,6 +590,11 @@ IceInternal::ThreadPool::ThreadPool(const InstancePtr& instance, const string& p
         throw;
     }
     __setNoDelete(false);
+
+    if(_instance->metrics())
+    {
+        _instance->metrics()->addThreadPool(this);
+    }
 }
 
 IceInternal::ThreadPool::~ThreadPool()
@@ -523,10 +605,33 @@ IceInternal::ThreadPool::~ThreadPool()
 void
 IceInternal::ThreadPool::destroy()
 {
-    Lock sync(*this);
-    assert(!_destroyed);
-    _destroyed = true;
-    _workQueue->destroy();
+    {
+        Lock sync(*this);
+        assert(!_destroyed);
+        _destroyed = true;
+#ifndef ICE_USE_IOCP
+        if(!_reactors.empty())
+        {
+            for(vector<ReactorPtr>::const_iterator p = _reactors.begin(); p != _reactors.end(); ++p)
+            {
+                (*p)->workQueue->destroy();
+            }
+        }
+        else
+#endif
+        {
+            _workQueue->destroy();
+        }
+    }
+
+    //
+    // The metrics manager locks the thread pool to get its metrics, it
+    // must not be called with the thread pool locked.
+    //
+    if(_instance->metrics())
+    {
+        _instance->metrics()->removeThreadPool(this);
+    }
 }
 
 void
@@ -534,12 +639,52 @@ IceInternal::ThreadPool::initialize(const EventHandlerPtr& handler)
 {
     Lock sync(*this);
     assert(!_destroyed);
+#ifndef ICE_USE_IOCP
+    if(!_reactors.empty())
+    {
+        //
+        // Assign the handler to the least loaded reactor. The search
+        // starts after the reactor of the previous assignment, so that
+        // handlers are assigned round-robin to reactors with the same
+        // load.
+        //
+        size_t reactor = _nextReactor;
+        for(size_t i = 1; i < _reactors.size(); ++i)
+        {
+            size_t n = (_nextReactor + i) % _reactors.size();
+            if(_reactors[n]->load < _reactors[reactor]->load)
+            {
+                reactor = n;
+            }
+        }
+        _nextReactor = (reactor + 1) % _reactors.size();
+        ++_reactors[reactor]->load;
+        handler->_reactor = static_cast<int>(reactor);
+
+        IceUtil::Mutex::Lock sync(*_reactors[reactor]);
+        _reactors[reactor]->selector.initialize(handler.get());
+        return;
+    }
+#endif
     _selector.initialize(handler.get());
 }
 
 void
 IceInternal::ThreadPool::update(const EventHandlerPtr& handler, SocketOperation remove, SocketOperation add)
 {
+#ifndef ICE_USE_IOCP
+    if(handler->_reactor >= 0)
+    {
+        //
+        // Only the reactor of the handler needs to be locked, the
+        // reactors are immutable.
+        //
+        Reactor& reactor = *_reactors[handler->_reactor];
+        IceUtil::Mutex::Lock sync(reactor);
+        reactor.selector.update(handler.get(), remove, add);
+        return;
+    }
+#endif
     Lock sync(*this);
     assert(!_destroyed);
     _selector.update(handler.get(), remove, add);
@@ -548,6 +693,29 @@ IceInternal::ThreadPool::update(const EventHandlerPtr& handler, SocketOperation
 void
 IceInternal::ThreadPool::finish(const EventHandlerPtr& handler)
 {
+#ifndef ICE_USE_IOCP
+    if(handler->_reactor >= 0)
+    {
+        Reactor& reactor = *_reactors[handler->_reactor];
+        {
+            Lock sync(*this);
+            assert(!_destroyed);
+            --reactor.load;
+        }
+
+        IceUtil::Mutex::Lock sync(reactor);
+        reactor.selector.finish(handler.get()); // This must be called before!
+        reactor.workQueue->queue(new FinishedWorkItem(handler));
+
+        //
+        // Clear the ready handlers of the reactor, see below.
+        //
+        reactor.handlers.clear();
+        reactor.nextHandler = reactor.handlers.end();
+        return;
+    }
+#endif
+
     Lock sync(*this);
     assert(!_destroyed);
 #ifndef ICE_USE_IOCP
@@ -577,6 +745,19 @@ IceInternal::ThreadPool::finish(const EventHandlerPtr& handler)
 void
 IceInternal::ThreadPool::execute(const ThreadPoolWorkItemPtr& workItem)
 {
+#ifndef ICE_USE_IOCP
+    if(!_reactors.empty())
+    {
+        ReactorPtr reactor;
+        {
+            Lock sync(*this);
+            reactor = _reactors[_nextReactor];
+            _nextReactor = (_nextReactor + 1) % _reactors.size();
+        }
+        reactor->workQueue->queue(workItem);
+        return;
+    }
+#endif
     _workQueue->queue(workItem);
 }
 
@@ -597,7 +778,15 @@ IceInternal::ThreadPool::joinWithAllThreads()
     }
 
 #ifndef ICE_USE_IOCP
-    _selector.finish(_workQueue.get());
+    for(vector<ReactorPtr>::const_iterator p = _reactors.begin(); p != _reactors.end(); ++p)
+    {
+        (*p)->selector.finish((*p)->workQueue.get());
+        (*p)->selector.destroy();
+    }
+    if(_workQueue)
+    {
+        _selector.finish(_workQueue.get());
+    }
 #endif
     _selector.destroy();
 }
@@ -608,6 +797,55 @@ IceInternal::ThreadPool::prefix() const
     return _prefix;
 }
 
+int
+IceInternal::ThreadPool::sizeMax() const
+{
+    return _sizeMax;
+}
+
+bool
+IceInternal::ThreadPool::serialize() const
+{
+    return _serialize;
+}
+
+ThreadPoolMetrics
+IceInternal::ThreadPool::getMetrics() const
+{
+    Lock sync(*this);
+    ThreadPoolMetrics metrics;
+    metrics.name = _prefix;
+    metrics.threads = static_cast<Int>(_threads.size());
+    metrics.inUse = _inUse;
+    metrics.sizeMax = _sizeMax;
+
+    //
+    // The queued events are the ready handlers which haven't been
+    // picked up by a thread yet and the queued work items.
+    //
+    size_t queued = 0;
+#ifndef ICE_USE_IOCP
+    if(!_reactors.empty())
+    {
+        for(vector<ReactorPtr>::const_iterator p = _reactors.begin(); p != _reactors.end(); ++p)
+        {
+            IceUtil::Mutex::Lock syncReactor(**p);
+            queued += (*p)->handlers.end() - (*p)->nextHandler;
+            queued += (*p)->workQueue->size();
+        }
+    }
+    else
+    {
+        queued += _handlers.end() - _nextHandler;
+        queued += _workQueue->size();
+    }
+#else
+    queued += _workQueue->size();
+#endif
+    metrics.queued = static_cast<Int>(queued);
+    return metrics;
+}
+
 void
 IceInternal::ThreadPool::run(const IceUtil::ThreadPtr& thread)
 {
@@ -658,13 +896,24 @@ IceInternal::ThreadPool::run(const IceUtil::ThreadPtr& thread)
 
         {
             Lock sync(*this);
+#ifdef ICE_USE_EPOLL
+            if(current._handler && !current._ioCompleted)
+            {
+                //
+                // The handler's IO would block if it didn't call
+                // ioCompleted(). An edge-triggered handler isn't
+                // ready anymore until the selector reports it.
+                //
+                _selector.clearReady(current._handler.get(), current.operation);
+            }
+#endif
             if(!current._handler)
             {
                 if(select)
                 {
+                    _selector.finishSelect(handlers);
                     _handlers.swap(handlers);
                     _nextHandler = _handlers.begin();
-                    _selector.finishSelect();
                     select = false;
                 }
                 else if(!current._leader && followerWait(thread, current))
@@ -845,6 +1094,17 @@ IceInternal::ThreadPool::ioCompleted(ThreadPoolCurrent& current)
 {
     current._ioCompleted = true; // Set the IO completed flag to specifiy that ioCompleted() has been called.
 
+#ifndef ICE_USE_IOCP
+    if(!_reactors.empty())
+    {
+        //
+        // With the Reactor model, the events of the handler are only
+        // dispatched by this thread, there's no follower to promote.
+        //
+        return _serialize;
+    }
+#endif
+
     if(_sizeMax > 1)
     {
         IceUtil::Monitor<IceUtil::Mutex>::Lock sync(*this);
@@ -1063,13 +1323,127 @@ IceInternal::ThreadPool::followerWait(const IceUtil::ThreadPtr& thread, ThreadPo
     _promote = false;
     return false;
 }
+
+void
+IceInternal::ThreadPool::runReactor(const ReactorPtr& reactor)
+{
+    ThreadPoolCurrent current(_instance, this);
+    bool select = false;
+    vector<pair<EventHandler*, SocketOperation> > handlers;
+    while(true)
+    {
+        if(current._handler)
+        {
+            try
+            {
+                current._handler->message(current);
+            }
+            catch(ThreadPoolDestroyedException&)
+            {
+                return;
+            }
+            catch(const exception& ex)
+            {
+                Error out(_instance->initializationData().logger);
+                out << "exception in `" << _prefix << "':\n" << ex << "\nevent handler: " 
+                    << current._handler->toString();
+            }
+            catch(...)
+            {
+                Error out(_instance->initializationData().logger);
+                out << "exception in `" << _prefix << "':\nevent handler: " << current._handler->toString();
+            }
+        }
+        else if(select)
+        {
+            try
+            {
+                reactor->selector.select(handlers, _serverIdleTime);
+            }
+            catch(SelectorTimeoutException&)
+            {
+                //
+                // The server is idle once the selects of all the
+                // reactors timed out.
+                //
+                if(!reactor->idle)
+                {
+                    Lock sync(*this);
+                    reactor->idle = true;
+                    if(++_idleReactors == static_cast<int>(_reactors.size()) && !_destroyed)
+                    {
+                        reactor->workQueue->queue(new ShutdownWorkItem(_instance)); // Select timed-out.
+                    }
+                }
+                continue;
+            }
+
+            if(reactor->idle)
+            {
+                Lock sync(*this);
+                reactor->idle = false;
+                --_idleReactors;
+            }
+        }
+
+        IceUtil::Mutex::Lock sync(*reactor);
+        if(select)
+        {
+            reactor->selector.finishSelect(handlers);
+            reactor->handlers.swap(handlers);
+            reactor->nextHandler = reactor->handlers.begin();
+            select = false;
+        }
+#ifdef ICE_USE_EPOLL
+        else if(current._handler && !current._ioCompleted)
+        {
+            reactor->selector.clearReady(current._handler.get(), current.operation); // See run().
+        }
+#endif
+
+        //
+        // Get the next ready handler or select if there are none.
+        //
+        if(reactor->nextHandler != reactor->handlers.end())
+        {
+            current._ioCompleted = false;
+            current._handler = reactor->nextHandler->first;
+            current.operation = reactor->nextHandler->second;
+            ++reactor->nextHandler;
+        }
+        else
+        {
+            current._handler = 0;
+            reactor->selector.startSelect();
+            select = true;
+        }
+    }
+}
+
+IceInternal::ThreadPool::Reactor::Reactor(ThreadPool* threadPool, const InstancePtr& instance) :
+    selector(instance),
+    load(0),
+    idle(false)
+{
+    nextHandler = handlers.end();
+    workQueue = new ThreadPoolWorkQueue(threadPool, instance, selector);
+}
 #endif
 
+#ifndef ICE_USE_IOCP
+IceInternal::ThreadPool::EventHandlerThread::EventHandlerThread(const ThreadPoolPtr& pool, const ReactorPtr& reactor) :
+    IceUtil::Thread(pool->_prefix + " thread"),
+    _pool(pool),
+    _reactor(reactor)
+{
+}
+#else
 IceInternal::ThreadPool::EventHandlerThread::EventHandlerThread(const ThreadPoolPtr& pool) :
     IceUtil::Thread(pool->_prefix + " thread"),
     _pool(pool)
 {
 }
+#endif
 
 void
 IceInternal::ThreadPool::EventHandlerThread::run()
@@ -1094,7 +1468,16 @@ IceInternal::ThreadPool::EventHandlerThread::run()
 
     try
     {
-        _pool->run(this);
+#ifndef ICE_USE_IOCP
+        if(_reactor)
+        {
+            _pool->runReactor(_reactor);
+        }
+        else
+#endif
+        {
+            _pool->run(this);
+        }
     }
     catch(const exception& ex)
     {
@@ -1126,6 +1509,9 @@ IceInternal::ThreadPool::EventHandlerThread::run()
     }
 
     _pool = 0; // Break cyclic dependency.
+#ifndef ICE_USE_IOCP
+    _reactor = 0;
+#endif
 }
 
 ThreadPoolCurrent::ThreadPoolCurrent(const InstancePtr& instance, const ThreadPoolPtr& threadPool) :
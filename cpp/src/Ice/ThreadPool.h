@@ -24,6 +24,7 @@
 #include <Ice/EventHandler.h>
 #include <Ice/Selector.h>
 #include <Ice/BasicStream.h>
+#include <Ice/Metrics.h>
 
 #include <set>
 #include <list>
@@ -61,6 +62,10 @@ public:
     void joinWithAllThreads();
 
     std::string prefix() const;
+    int sizeMax() const;
+    bool serialize() const;
+
+    Ice::ThreadPoolMetrics getMetrics() const;
 
 private:
 
@@ -74,6 +79,30 @@ private:
 #else
     void promoteFollower(ThreadPoolCurrent&);
     bool followerWait(const IceUtil::ThreadPtr&, ThreadPoolCurrent&);
+
+    //
+    // With the Reactor model, each thread of the pool owns a reactor:
+    // a selector and a work queue with the event handlers assigned to
+    // the thread. Events of a handler are always dispatched by the
+    // thread of its reactor and the reactor's mutex is only shared
+    // with the threads updating its handlers.
+    //
+    class Reactor : public IceUtil::Shared, public IceUtil::Mutex
+    {
+    public:
+
+        Reactor(ThreadPool*, const InstancePtr&);
+
+        Selector selector;
+        ThreadPoolWorkQueuePtr workQueue;
+        std::vector<std::pair<EventHandler*, SocketOperation> > handlers;
+        std::vector<std::pair<EventHandler*, SocketOperation> >::const_iterator nextHandler;
+        int load; // Number of handlers assigned to the reactor, protected by the thread pool mutex.
+        bool idle; // True if the select timed out, only used by the reactor thread.
+    };
+    typedef IceUtil::Handle<Reactor> ReactorPtr;
+
+    void runReactor(const ReactorPtr&);
 #endif
 
     const InstancePtr _instance;
@@ -86,12 +115,19 @@ private:
     {
     public:
         
+#ifndef ICE_USE_IOCP
+        EventHandlerThread(const ThreadPoolPtr&, const ReactorPtr& = 0);
+#else
         EventHandlerThread(const ThreadPoolPtr&);
+#endif
         virtual void run();
 
     private:
 
         ThreadPoolPtr _pool;
+#ifndef ICE_USE_IOCP
+        ReactorPtr _reactor;
+#endif
     };
 
     friend class EventHandlerThread;
@@ -114,6 +150,10 @@ private:
     int _inUseIO; // Number of threads that are currently performing IO.
     std::vector<std::pair<EventHandler*, SocketOperation> > _handlers;
     std::vector<std::pair<EventHandler*, SocketOperation> >::const_iterator _nextHandler;
+
+    std::vector<ReactorPtr> _reactors; // Empty unless the pool uses the Reactor model.
+    size_t _nextReactor;
+    int _idleReactors;
 #endif
 
     bool _promote;
@@ -185,6 +225,7 @@ public:
 
     void destroy();
     void queue(const ThreadPoolWorkItemPtr&);
+    size_t size() const;
 
 #ifdef ICE_USE_IOCP
     bool startAsync(SocketOperation);
@@ -11,6 +11,7 @@
 #include <IceUtil/MutexPtrLock.h>
 #include <IceUtil/StringUtil.h>
 #include <Ice/TraceUtil.h>
+#include <Ice/Codec.h>
 #include <Ice/Instance.h>
 #include <Ice/Object.h>
 #include <Ice/Proxy.h>
@@ -169,7 +170,15 @@ printHeader(ostream& s, BasicStream& stream)
 
         default:
         {
-            s << "(unknown)";
+            if(compress & compressResponseFlag)
+            {
+                s << "(not compressed; compress response with codec " << static_cast<int>(compress & codecIdMask)
+                  << ", if any)";
+            }
+            else
+            {
+                s << "(compressed with codec " << static_cast<int>(compress) << "; compress response, if any)";
+            }
             break;
         }
     }
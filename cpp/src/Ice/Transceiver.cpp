@@ -8,6 +8,7 @@
 // **********************************************************************
 
 #include <Ice/Transceiver.h>
+#include <Ice/Buffer.h>
 
 using namespace std;
 using namespace Ice;
@@ -15,3 +16,22 @@ using namespace IceInternal;
 
 IceUtil::Shared* IceInternal::upCast(Transceiver* p) { return p; }
 
+
+bool
+IceInternal::Transceiver::gatherWrite(const vector<Buffer*>& bufs)
+{
+    for(vector<Buffer*>::const_iterator p = bufs.begin(); p != bufs.end(); ++p)
+    {
+        if((*p)->i != (*p)->b.end() && !write(**p))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool
+IceInternal::Transceiver::hasMoreData() const
+{
+    return false;
+}
@@ -15,6 +15,8 @@
 #include <Ice/ConnectionF.h>
 #include <Ice/Network.h>
 
+#include <vector>
+
 namespace IceInternal
 {
 
@@ -29,6 +31,23 @@ public:
     virtual void close() = 0;
     virtual bool write(Buffer&) = 0;
     virtual bool read(Buffer&) = 0;
+
+    //
+    // Write several buffers, in order. Returns true if all the
+    // buffers were fully written. The default implementation writes
+    // the buffers one after the other with write(); transceivers
+    // which support scatter/gather I/O override it to send the
+    // buffers with a single system call.
+    //
+    virtual bool gatherWrite(const std::vector<Buffer*>&);
+
+    //
+    // Returns true if a message was already received from the network
+    // and can be read without waiting for the socket to be readable.
+    // The default implementation returns false; transceivers which
+    // receive several datagrams with a single system call override it.
+    //
+    virtual bool hasMoreData() const;
 #ifdef ICE_USE_IOCP
     virtual bool startWrite(Buffer&) = 0;
     virtual void finishWrite(Buffer&) = 0;
@@ -31,6 +31,24 @@ using namespace std;
 using namespace Ice;
 using namespace IceInternal;
 
+#ifdef ICE_USE_MMSG
+namespace
+{
+
+//
+// The maximum number of datagrams sent with a single sendmmsg() call.
+//
+const int maxSendBatchSize = 64;
+
+int
+rcvBatchSize(const InstancePtr& instance)
+{
+    return max(1, instance->initializationData().properties->getPropertyAsIntWithDefault("Ice.UDP.RcvBatchSize", 16));
+}
+
+}
+#endif
+
 NativeInfoPtr
 IceInternal::UdpTransceiver::getNativeInfo()
 {
@@ -195,6 +213,19 @@ IceInternal::UdpTransceiver::read(Buffer& buf)
     assert(_fd != INVALID_SOCKET);
 
     const int packetSize = min(_maxPacketSize, _rcvSize - _udpOverhead);
+
+#ifdef ICE_USE_MMSG
+    //
+    // An incoming transceiver which must connect to the first peer
+    // receives the first datagram on its own, so that datagrams from
+    // other peers aren't received along with it.
+    //
+    if(_rcvBatchSize > 1 && _state != StateNeedConnect)
+    {
+        return readBatch(buf, packetSize);
+    }
+#endif
+
     buf.b.resize(packetSize);
     buf.i = buf.b.begin();
 
@@ -296,6 +327,226 @@ repeat:
     return true;
 }
 
+#ifdef ICE_USE_MMSG
+bool
+IceInternal::UdpTransceiver::gatherWrite(const vector<Buffer*>& bufs)
+{
+    assert(_fd != INVALID_SOCKET && _state >= StateConnected);
+
+    socklen_t len = 0;
+    if(_state == StateNotConnected)
+    {
+        if(_peerAddr.ss_family == AF_INET)
+        {
+            len = sizeof(sockaddr_in);
+        }
+        else if(_peerAddr.ss_family == AF_INET6)
+        {
+            len = sizeof(sockaddr_in6);
+        }
+        else
+        {
+            // No peer has sent a datagram yet.
+            SocketException ex(__FILE__, __LINE__);
+            ex.error = 0;
+            throw ex;
+        }
+    }
+
+    vector<Buffer*>::const_iterator first = bufs.begin();
+    while(true)
+    {
+        //
+        // Skip the datagrams which are already sent.
+        //
+        while(first != bufs.end() && (*first)->i == (*first)->b.end())
+        {
+            ++first;
+        }
+
+        if(first == bufs.end())
+        {
+            return true;
+        }
+
+        //
+        // Each buffer is sent as a separate datagram.
+        //
+        struct mmsghdr msgs[maxSendBatchSize];
+        struct iovec iov[maxSendBatchSize];
+        int count = 0;
+        for(vector<Buffer*>::const_iterator p = first; p != bufs.end() && count < maxSendBatchSize; ++p, ++count)
+        {
+            assert((*p)->i == (*p)->b.begin());
+            assert(min(_maxPacketSize, _sndSize - _udpOverhead) >= static_cast<int>((*p)->b.size()));
+
+            iov[count].iov_base = reinterpret_cast<char*>(&(*p)->b[0]);
+            iov[count].iov_len = (*p)->b.size();
+            memset(&msgs[count], 0, sizeof(msgs[count]));
+            msgs[count].msg_hdr.msg_iov = &iov[count];
+            msgs[count].msg_hdr.msg_iovlen = 1;
+            if(len > 0)
+            {
+                msgs[count].msg_hdr.msg_name = reinterpret_cast<struct sockaddr*>(&_peerAddr);
+                msgs[count].msg_hdr.msg_namelen = len;
+            }
+        }
+
+        if(count == 1)
+        {
+            //
+            // Nothing to batch, use the regular write.
+            //
+            if(!write(**first))
+            {
+                return false;
+            }
+            continue;
+        }
+
+        int ret = sendmmsg(_fd, msgs, count, 0);
+        if(ret == SOCKET_ERROR)
+        {
+            if(interrupted())
+            {
+                continue;
+            }
+
+            if(wouldBlock())
+            {
+                return false;
+            }
+
+            SocketException ex(__FILE__, __LINE__);
+            ex.error = getSocketErrno();
+            throw ex;
+        }
+
+        size_t bytes = 0;
+        for(int i = 0; i < ret; ++i, ++first)
+        {
+            assert(msgs[i].msg_len == (*first)->b.size());
+            bytes += msgs[i].msg_len;
+            (*first)->i = (*first)->b.end();
+        }
+
+        if(_traceLevels->network >= 3)
+        {
+            Trace out(_logger, _traceLevels->networkCat);
+            out << "sent " << bytes << " bytes in " << ret << " datagrams via udp\n" << toString();
+        }
+
+        if(_stats)
+        {
+            _stats->bytesSent(type(), static_cast<Int>(bytes));
+        }
+    }
+}
+
+bool
+IceInternal::UdpTransceiver::hasMoreData() const
+{
+    return _rcvBatchNext < _rcvBatchCount;
+}
+
+bool
+IceInternal::UdpTransceiver::readBatch(Buffer& buf, int packetSize)
+{
+    if(_rcvBatchNext == _rcvBatchCount)
+    {
+        if(_rcvBatch.empty())
+        {
+            //
+            // Allocate the batch on the first read, only the
+            // transceivers which receive datagrams need it.
+            //
+            _rcvBatchData.resize(static_cast<size_t>(_rcvBatchSize) * packetSize);
+            _rcvBatch.resize(_rcvBatchSize);
+            _rcvBatchIov.resize(_rcvBatchSize);
+            _rcvBatchAddr.resize(_rcvBatchSize);
+            for(int i = 0; i < _rcvBatchSize; ++i)
+            {
+                _rcvBatchIov[i].iov_base = reinterpret_cast<char*>(&_rcvBatchData[0]) + i * packetSize;
+                _rcvBatchIov[i].iov_len = packetSize;
+            }
+        }
+
+        for(int i = 0; i < _rcvBatchSize; ++i)
+        {
+            memset(&_rcvBatch[i], 0, sizeof(_rcvBatch[i]));
+            _rcvBatch[i].msg_hdr.msg_iov = &_rcvBatchIov[i];
+            _rcvBatch[i].msg_hdr.msg_iovlen = 1;
+            if(_state == StateNotConnected)
+            {
+                _rcvBatch[i].msg_hdr.msg_name = reinterpret_cast<struct sockaddr*>(&_rcvBatchAddr[i]);
+                _rcvBatch[i].msg_hdr.msg_namelen = static_cast<socklen_t>(sizeof(struct sockaddr_storage));
+            }
+        }
+
+        int ret;
+        while((ret = recvmmsg(_fd, &_rcvBatch[0], _rcvBatchSize, 0, 0)) == SOCKET_ERROR)
+        {
+            if(interrupted())
+            {
+                continue;
+            }
+
+            if(wouldBlock())
+            {
+                return false;
+            }
+
+            if(connectionLost())
+            {
+                ConnectionLostException ex(__FILE__, __LINE__);
+                ex.error = getSocketErrno();
+                throw ex;
+            }
+            else
+            {
+                SocketException ex(__FILE__, __LINE__);
+                ex.error = getSocketErrno();
+                throw ex;
+            }
+        }
+        _rcvBatchCount = ret;
+        _rcvBatchNext = 0;
+    }
+
+    //
+    // A truncated datagram fills the whole buffer, this is detected
+    // at the connection level when the Ice message size is checked
+    // against the buffer size.
+    //
+    const int n = _rcvBatchNext++;
+    const size_t size = _rcvBatch[n].msg_len;
+    const Byte* data = static_cast<const Byte*>(_rcvBatchIov[n].iov_base);
+    buf.b.resize(size);
+    if(size > 0)
+    {
+        memcpy(&buf.b[0], data, size);
+    }
+    buf.i = buf.b.end();
+
+    if(_state == StateNotConnected)
+    {
+        _peerAddr = _rcvBatchAddr[n];
+    }
+
+    if(_traceLevels->network >= 3)
+    {
+        Trace out(_logger, _traceLevels->networkCat);
+        out << "received " << size << " bytes via udp\n" << toString();
+    }
+
+    if(_stats)
+    {
+        _stats->bytesReceived(type(), static_cast<Int>(size));
+    }
+    return true;
+}
+#endif
+
 #ifdef ICE_USE_IOCP
 bool
 IceInternal::UdpTransceiver::startWrite(Buffer& buf)
@@ -598,6 +849,11 @@ IceInternal::UdpTransceiver::UdpTransceiver(const InstancePtr& instance, const s
     _incoming(false),
     _addr(addr),
     _state(StateNeedConnect)
+#ifdef ICE_USE_MMSG
+    , _rcvBatchSize(rcvBatchSize(instance)),
+    _rcvBatchCount(0),
+    _rcvBatchNext(0)
+#endif
 #ifdef ICE_USE_IOCP
     , _read(SocketOperationRead), 
     _write(SocketOperationWrite)
@@ -653,6 +909,11 @@ IceInternal::UdpTransceiver::UdpTransceiver(const InstancePtr& instance, const s
     _incoming(true),
     _addr(getAddressForServer(host, port, instance->protocolSupport())),
     _state(connect ? StateNeedConnect : StateNotConnected)
+#ifdef ICE_USE_MMSG
+    , _rcvBatchSize(rcvBatchSize(instance)),
+    _rcvBatchCount(0),
+    _rcvBatchNext(0)
+#endif
 #ifdef ICE_USE_IOCP
     , _read(SocketOperationRead), 
     _write(SocketOperationWrite)
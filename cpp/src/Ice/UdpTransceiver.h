@@ -26,6 +26,13 @@
 #   include <sys/socket.h> // For struct sockaddr_storage
 #endif
 
+//
+// recvmmsg() and sendmmsg() are available with glibc 2.14 or later.
+//
+#if defined(__linux) && defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 14))
+#   define ICE_USE_MMSG 1
+#endif
+
 namespace IceInternal
 {
 
@@ -54,6 +61,10 @@ public:
     virtual void close();
     virtual bool write(Buffer&);
     virtual bool read(Buffer&);
+#ifdef ICE_USE_MMSG
+    virtual bool gatherWrite(const std::vector<Buffer*>&);
+    virtual bool hasMoreData() const;
+#endif
 #ifdef ICE_USE_IOCP
     virtual bool startWrite(Buffer&);
     virtual void finishWrite(Buffer&);
@@ -74,6 +85,9 @@ private:
     virtual ~UdpTransceiver();
 
     void setBufSize(const InstancePtr&);
+#ifdef ICE_USE_MMSG
+    bool readBatch(Buffer&, int);
+#endif
 
     friend class UdpEndpointI;
     friend class UdpConnector;
@@ -92,6 +106,20 @@ private:
     static const int _udpOverhead;
     static const int _maxPacketSize;
 
+#ifdef ICE_USE_MMSG
+    //
+    // The datagrams received with a single recvmmsg() call which
+    // weren't returned by read() yet.
+    //
+    const int _rcvBatchSize;
+    std::vector<Ice::Byte> _rcvBatchData;
+    std::vector<struct mmsghdr> _rcvBatch;
+    std::vector<struct iovec> _rcvBatchIov;
+    std::vector<struct sockaddr_storage> _rcvBatchAddr;
+    int _rcvBatchCount;
+    int _rcvBatchNext;
+#endif
+
 #ifdef ICE_USE_IOCP
     AsyncInfo _read;
     AsyncInfo _write;
@@ -0,0 +1,119 @@
+// **********************************************************************
+//
+// Copyright (c) 2003-2011 ZeroC, Inc. All rights reserved.
+//
+// This copy of Ice is licensed to you under the terms described in the
+// ICE_LICENSE file included in this distribution.
+//
+// **********************************************************************
+
+#include <Ice/UnixAcceptor.h>
+#include <Ice/UnixTransceiver.h>
+#include <Ice/ShmTransceiver.h>
+#include <Ice/UnixEndpointI.h>
+#include <Ice/Instance.h>
+#include <Ice/TraceLevels.h>
+#include <Ice/LoggerUtil.h>
+#include <Ice/Network.h>
+#include <Ice/Exception.h>
+#include <Ice/Properties.h>
+
+using namespace std;
+using namespace Ice;
+using namespace IceInternal;
+
+NativeInfoPtr
+IceInternal::UnixAcceptor::getNativeInfo()
+{
+    return this;
+}
+
+void
+IceInternal::UnixAcceptor::close()
+{
+    if(_traceLevels->network >= 1)
+    {
+        Trace out(_logger, _traceLevels->networkCat);
+        out << "stopping to accept " << unixProtocol(_type) << " connections at " << toString();
+    }
+
+    SOCKET fd = _fd;
+    _fd = INVALID_SOCKET;
+    closeSocket(fd);
+
+    //
+    // Remove the socket file, otherwise the next server can't bind
+    // to the same path without first checking that it's stale.
+    //
+    unlink(_path.c_str());
+}
+
+void
+IceInternal::UnixAcceptor::listen()
+{
+    try
+    {
+        doListen(_fd, _backlog);
+    }
+    catch(...)
+    {
+        _fd = INVALID_SOCKET;
+        throw;
+    }
+
+    if(_traceLevels->network >= 1)
+    {
+        Trace out(_logger, _traceLevels->networkCat);
+        out << "accepting " << unixProtocol(_type) << " connections at " << toString();
+    }
+}
+
+TransceiverPtr
+IceInternal::UnixAcceptor::accept()
+{
+    SOCKET fd = doAcceptUnix(_fd);
+    if(_traceLevels->network >= 1)
+    {
+        Trace out(_logger, _traceLevels->networkCat);
+        out << "accepted " << unixProtocol(_type) << " connection at " << toString();
+    }
+    if(_type == ShmEndpointType)
+    {
+        return new ShmTransceiver(_instance, fd, _path, true);
+    }
+    return new UnixTransceiver(_instance, fd, _path, true);
+}
+
+string
+IceInternal::UnixAcceptor::toString() const
+{
+    return _path;
+}
+
+IceInternal::UnixAcceptor::UnixAcceptor(const InstancePtr& instance, Short type, const string& path) :
+    _instance(instance),
+    _traceLevels(instance->traceLevels()),
+    _logger(instance->initializationData().logger),
+    _type(type),
+    _path(path)
+{
+#ifdef SOMAXCONN
+    _backlog = instance->initializationData().properties->getPropertyAsIntWithDefault("Ice.TCP.Backlog", SOMAXCONN);
+#else
+    _backlog = instance->initializationData().properties->getPropertyAsIntWithDefault("Ice.TCP.Backlog", 511);
+#endif
+
+    _fd = createUnixSocket();
+    setBlock(_fd, false);
+    if(_traceLevels->network >= 2)
+    {
+        Trace out(_logger, _traceLevels->networkCat);
+        out << "attempting to bind to unix socket " << toString();
+    }
+    doBindUnix(_fd, _path);
+}
+
+IceInternal::UnixAcceptor::~UnixAcceptor()
+{
+    assert(_fd == INVALID_SOCKET);
+}
@@ -0,0 +1,50 @@
+// **********************************************************************
+//
+// Copyright (c) 2003-2011 ZeroC, Inc. All rights reserved.
+//
+// This copy of Ice is licensed to you under the terms described in the
+// ICE_LICENSE file included in this distribution.
+//
+// **********************************************************************
+
+#ifndef ICE_UNIX_ACCEPTOR_H
+#define ICE_UNIX_ACCEPTOR_H
+
+#include <Ice/TransceiverF.h>
+#include <Ice/InstanceF.h>
+#include <Ice/TraceLevelsF.h>
+#include <Ice/LoggerF.h>
+#include <Ice/Acceptor.h>
+
+namespace IceInternal
+{
+
+class UnixAcceptor : public Acceptor, public NativeInfo
+{
+public:
+
+    virtual NativeInfoPtr getNativeInfo();
+
+    virtual void close();
+    virtual void listen();
+    virtual TransceiverPtr accept();
+    virtual std::string toString() const;
+
+private:
+
+    UnixAcceptor(const InstancePtr&, Ice::Short, const std::string&);
+    virtual ~UnixAcceptor();
+    friend class UnixEndpointI;
+
+    const InstancePtr _instance;
+    const TraceLevelsPtr _traceLevels;
+    const ::Ice::LoggerPtr _logger;
+    const Ice::Short _type;
+    const std::string _path;
+
+    int _backlog;
+};
+
+}
+
+#endif
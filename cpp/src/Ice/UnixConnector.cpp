@@ -0,0 +1,163 @@
+// **********************************************************************
+//
+// Copyright (c) 2003-2011 ZeroC, Inc. All rights reserved.
+//
+// This copy of Ice is licensed to you under the terms described in the
+// ICE_LICENSE file included in this distribution.
+//
+// **********************************************************************
+
+#include <Ice/UnixConnector.h>
+#include <Ice/UnixTransceiver.h>
+#include <Ice/ShmTransceiver.h>
+#include <Ice/UnixEndpointI.h>
+#include <Ice/Instance.h>
+#include <Ice/TraceLevels.h>
+#include <Ice/LoggerUtil.h>
+#include <Ice/Network.h>
+#include <Ice/Exception.h>
+
+using namespace std;
+using namespace Ice;
+using namespace IceInternal;
+
+TransceiverPtr
+IceInternal::UnixConnector::connect()
+{
+    if(_traceLevels->network >= 2)
+    {
+        Trace out(_logger, _traceLevels->networkCat);
+        out << "trying to establish " << unixProtocol(_type) << " connection to " << toString();
+    }
+
+    try
+    {
+        if(_type == ShmEndpointType)
+        {
+            ShmTransceiver* transceiver = new ShmTransceiver(_instance, createUnixSocket(), _path, false);
+            TransceiverPtr p = transceiver;
+            transceiver->connect();
+            return p;
+        }
+        else
+        {
+            UnixTransceiver* transceiver = new UnixTransceiver(_instance, createUnixSocket(), _path, false);
+            TransceiverPtr p = transceiver;
+            transceiver->connect();
+            return p;
+        }
+    }
+    catch(const Ice::LocalException& ex)
+    {
+        if(_traceLevels->network >= 2)
+        {
+            Trace out(_logger, _traceLevels->networkCat);
+            out << "failed to establish " << unixProtocol(_type) << " connection to " << toString() << "\n" << ex;
+        }
+        throw;
+    }
+}
+
+Short
+IceInternal::UnixConnector::type() const
+{
+    return _type;
+}
+
+string
+IceInternal::UnixConnector::toString() const
+{
+    return _path;
+}
+
+bool
+IceInternal::UnixConnector::operator==(const Connector& r) const
+{
+    const UnixConnector* p = dynamic_cast<const UnixConnector*>(&r);
+    if(!p)
+    {
+        return false;
+    }
+
+    if(_type != p->_type)
+    {
+        return false;
+    }
+
+    if(_path != p->_path)
+    {
+        return false;
+    }
+
+    if(_timeout != p->_timeout)
+    {
+        return false;
+    }
+
+    if(_connectionId != p->_connectionId)
+    {
+        return false;
+    }
+
+    return true;
+}
+
+bool
+IceInternal::UnixConnector::operator!=(const Connector& r) const
+{
+    return !operator==(r);
+}
+
+bool
+IceInternal::UnixConnector::operator<(const Connector& r) const
+{
+    const UnixConnector* p = dynamic_cast<const UnixConnector*>(&r);
+    if(!p)
+    {
+        return type() < r.type();
+    }
+
+    if(_type < p->_type)
+    {
+        return true;
+    }
+    else if(p->_type < _type)
+    {
+        return false;
+    }
+
+    if(_timeout < p->_timeout)
+    {
+        return true;
+    }
+    else if(p->_timeout < _timeout)
+    {
+        return false;
+    }
+
+    if(_connectionId < p->_connectionId)
+    {
+        return true;
+    }
+    else if(p->_connectionId < _connectionId)
+    {
+        return false;
+    }
+    return _path < p->_path;
+}
+
+IceInternal::UnixConnector::UnixConnector(const InstancePtr& instance, Short type, const string& path,
+                                          Ice::Int timeout, const string& connectionId) :
+    _instance(instance),
+    _traceLevels(instance->traceLevels()),
+    _logger(instance->initializationData().logger),
+    _type(type),
+    _path(path),
+    _timeout(timeout),
+    _connectionId(connectionId)
+{
+}
+
+IceInternal::UnixConnector::~UnixConnector()
+{
+}
@@ -0,0 +1,539 @@
+// **********************************************************************
+//
+// Copyright (c) 2003-2011 ZeroC, Inc. All rights reserved.
+//
+// This copy of Ice is licensed to you under the terms described in the
+// ICE_LICENSE file included in this distribution.
+//
+// **********************************************************************
+
+#include <Ice/UnixEndpointI.h>
+#include <Ice/Network.h>
+#include <Ice/UnixAcceptor.h>
+#include <Ice/UnixConnector.h>
+#include <Ice/BasicStream.h>
+#include <Ice/LocalException.h>
+#include <Ice/Instance.h>
+#include <Ice/HashUtil.h>
+
+using namespace std;
+using namespace Ice;
+using namespace IceInternal;
+
+IceInternal::UnixEndpointI::UnixEndpointI(const InstancePtr& instance, Short type, const string& pa, Int ti,
+                                          const string& conId, bool co) :
+    _instance(instance),
+    _type(type),
+    _path(pa),
+    _timeout(ti),
+    _connectionId(conId),
+    _compress(co)
+{
+}
+
+IceInternal::UnixEndpointI::UnixEndpointI(const InstancePtr& instance, Short type, const string& str) :
+    _instance(instance),
+    _type(type),
+    _timeout(-1),
+    _compress(false)
+{
+    const string delim = " \t\n\r";
+    const string protocol = unixProtocol(_type);
+
+    string::size_type beg;
+    string::size_type end = 0;
+
+    while(true)
+    {
+        beg = str.find_first_not_of(delim, end);
+        if(beg == string::npos)
+        {
+            break;
+        }
+
+        end = str.find_first_of(delim, beg);
+        if(end == string::npos)
+        {
+            end = str.length();
+        }
+
+        string option = str.substr(beg, end - beg);
+        if(option.length() != 2 || option[0] != '-')
+        {
+            EndpointParseException ex(__FILE__, __LINE__);
+            ex.str = "expected an endpoint option but found `" + option + "' in endpoint `" + protocol + " " + str + "'";
+            throw ex;
+        }
+
+        string argument;
+        string::size_type argumentBeg = str.find_first_not_of(delim, end);
+        if(argumentBeg != string::npos && str[argumentBeg] != '-')
+        {
+            beg = argumentBeg;
+            end = str.find_first_of(delim, beg);
+            if(end == string::npos)
+            {
+                end = str.length();
+            }
+            argument = str.substr(beg, end - beg);
+            if(argument[0] == '\"' && argument[argument.size() - 1] == '\"')
+            {
+                argument = argument.substr(1, argument.size() - 2);
+            }
+        }
+
+        switch(option[1])
+        {
+            case 'p':
+            {
+                if(argument.empty())
+                {
+                    EndpointParseException ex(__FILE__, __LINE__);
+                    ex.str = "no argument provided for -p option in endpoint `" + protocol + " " + str + "'";
+                    throw ex;
+                }
+                const_cast<string&>(_path) = argument;
+                break;
+            }
+
+            case 't':
+            {
+                if(argument.empty())
+                {
+                    EndpointParseException ex(__FILE__, __LINE__);
+                    ex.str = "no argument provided for -t option in endpoint `" + protocol + " " + str + "'";
+                    throw ex;
+                }
+                istringstream t(argument);
+                if(!(t >> const_cast<Int&>(_timeout)) || !t.eof())
+                {
+                    EndpointParseException ex(__FILE__, __LINE__);
+                    ex.str = "invalid timeout value `" + argument + "' in endpoint `" + protocol + " " + str + "'";
+                    throw ex;
+                }
+                break;
+            }
+
+            case 'z':
+            {
+                if(!argument.empty())
+                {
+                    EndpointParseException ex(__FILE__, __LINE__);
+                    ex.str = "unexpected argument `" + argument + "' provided for -z option in `" + protocol + " " + str + "'";
+                    throw ex;
+                }
+                const_cast<bool&>(_compress) = true;
+                break;
+            }
+
+            default:
+            {
+                EndpointParseException ex(__FILE__, __LINE__);
+                ex.str = "unknown option `" + option + "' in `" + protocol + " " + str + "'";
+                throw ex;
+            }
+        }
+    }
+
+    if(_path.empty())
+    {
+        EndpointParseException ex(__FILE__, __LINE__);
+        ex.str = "no -p option in endpoint `" + protocol + " " + str + "'";
+        throw ex;
+    }
+    else if(_path.size() > maxUnixPathLength())
+    {
+        EndpointParseException ex(__FILE__, __LINE__);
+        ex.str = "path `" + _path + "' too long in endpoint `" + protocol + " " + str + "'";
+        throw ex;
+    }
+}
+
+IceInternal::UnixEndpointI::UnixEndpointI(BasicStream* s, Short type) :
+    _instance(s->instance()),
+    _type(type),
+    _timeout(-1),
+    _compress(false)
+{
+    s->startReadEncaps();
+    s->read(const_cast<string&>(_path), false);
+    s->read(const_cast<Int&>(_timeout));
+    s->read(const_cast<bool&>(_compress));
+    s->endReadEncaps();
+}
+
+void
+IceInternal::UnixEndpointI::streamWrite(BasicStream* s) const
+{
+    s->write(_type);
+    s->startWriteEncaps();
+    s->write(_path, false);
+    s->write(_timeout);
+    s->write(_compress);
+    s->endWriteEncaps();
+}
+
+string
+IceInternal::UnixEndpointI::toString() const
+{
+    //
+    // WARNING: Certain features, such as proxy validation in Glacier2,
+    // depend on the format of proxy strings. Changes to toString() and
+    // methods called to generate parts of the reference string could break
+    // these features. Please review for all features that depend on the
+    // format of proxyToString() before changing this and related code.
+    //
+    ostringstream s;
+    s << unixProtocol(_type) << " -p ";
+    bool addQuote = _path.find(':') != string::npos;
+    if(addQuote)
+    {
+        s << "\"";
+    }
+    s << _path;
+    if(addQuote)
+    {
+        s << "\"";
+    }
+
+    if(_timeout != -1)
+    {
+        s << " -t " << _timeout;
+    }
+    if(_compress)
+    {
+        s << " -z";
+    }
+    return s.str();
+}
+
+namespace
+{
+
+template<typename T, Ice::Short Type> class InfoI : public T
+{
+public:
+
+    InfoI(Ice::Int to, bool comp, const string& path) :
+        T(to, comp, path)
+    {
+    }
+
+    virtual Ice::Short
+    type() const
+    {
+        return Type;
+    }
+
+    virtual bool
+    datagram() const
+    {
+        return false;
+    }
+
+    virtual bool
+    secure() const
+    {
+        return false;
+    }
+};
+
+}
+
+EndpointInfoPtr
+IceInternal::UnixEndpointI::getInfo() const
+{
+    if(_type == ShmEndpointType)
+    {
+        return new InfoI<Ice::ShmEndpointInfo, ShmEndpointType>(_timeout, _compress, _path);
+    }
+    return new InfoI<Ice::UnixEndpointInfo, UnixEndpointType>(_timeout, _compress, _path);
+}
+
+Short
+IceInternal::UnixEndpointI::type() const
+{
+    return _type;
+}
+
+Int
+IceInternal::UnixEndpointI::timeout() const
+{
+    return _timeout;
+}
+
+EndpointIPtr
+IceInternal::UnixEndpointI::timeout(Int timeout) const
+{
+    if(timeout == _timeout)
+    {
+        return const_cast<UnixEndpointI*>(this);
+    }
+    else
+    {
+        return new UnixEndpointI(_instance, _type, _path, timeout, _connectionId, _compress);
+    }
+}
+
+EndpointIPtr
+IceInternal::UnixEndpointI::connectionId(const string& connectionId) const
+{
+    if(connectionId == _connectionId)
+    {
+        return const_cast<UnixEndpointI*>(this);
+    }
+    else
+    {
+        return new UnixEndpointI(_instance, _type, _path, _timeout, connectionId, _compress);
+    }
+}
+
+bool
+IceInternal::UnixEndpointI::compress() const
+{
+    return _compress;
+}
+
+EndpointIPtr
+IceInternal::UnixEndpointI::compress(bool compress) const
+{
+    if(compress == _compress)
+    {
+        return const_cast<UnixEndpointI*>(this);
+    }
+    else
+    {
+        return new UnixEndpointI(_instance, _type, _path, _timeout, _connectionId, compress);
+    }
+}
+
+bool
+IceInternal::UnixEndpointI::datagram() const
+{
+    return false;
+}
+
+bool
+IceInternal::UnixEndpointI::secure() const
+{
+    return false;
+}
+
+TransceiverPtr
+IceInternal::UnixEndpointI::transceiver(EndpointIPtr& endp) const
+{
+    endp = const_cast<UnixEndpointI*>(this);
+    return 0;
+}
+
+vector<ConnectorPtr>
+IceInternal::UnixEndpointI::connectors() const
+{
+    vector<ConnectorPtr> connectors;
+    connectors.push_back(new UnixConnector(_instance, _type, _path, _timeout, _connectionId));
+    return connectors;
+}
+
+void
+IceInternal::UnixEndpointI::connectors_async(const EndpointI_connectorsPtr& callback) const
+{
+    //
+    // There is no address to resolve.
+    //
+    callback->connectors(connectors());
+}
+
+AcceptorPtr
+IceInternal::UnixEndpointI::acceptor(EndpointIPtr& endp, const string&) const
+{
+    UnixAcceptor* p = new UnixAcceptor(_instance, _type, _path);
+    endp = const_cast<UnixEndpointI*>(this);
+    return p;
+}
+
+vector<EndpointIPtr>
+IceInternal::UnixEndpointI::expand() const
+{
+    vector<EndpointIPtr> endps;
+    endps.push_back(const_cast<UnixEndpointI*>(this));
+    return endps;
+}
+
+bool
+IceInternal::UnixEndpointI::equivalent(const EndpointIPtr& endpoint) const
+{
+    const UnixEndpointI* unixEndpointI = dynamic_cast<const UnixEndpointI*>(endpoint.get());
+    if(!unixEndpointI)
+    {
+        return false;
+    }
+    return unixEndpointI->_type == _type && unixEndpointI->_path == _path;
+}
+
+bool
+IceInternal::UnixEndpointI::operator==(const LocalObject& r) const
+{
+    const UnixEndpointI* p = dynamic_cast<const UnixEndpointI*>(&r);
+    if(!p)
+    {
+        return false;
+    }
+
+    if(this == p)
+    {
+        return true;
+    }
+
+    if(_type != p->_type)
+    {
+        return false;
+    }
+
+    if(_path != p->_path)
+    {
+        return false;
+    }
+
+    if(_timeout != p->_timeout)
+    {
+        return false;
+    }
+
+    if(_connectionId != p->_connectionId)
+    {
+        return false;
+    }
+
+    if(_compress != p->_compress)
+    {
+        return false;
+    }
+
+    return true;
+}
+
+bool
+IceInternal::UnixEndpointI::operator<(const LocalObject& r) const
+{
+    const UnixEndpointI* p = dynamic_cast<const UnixEndpointI*>(&r);
+    if(!p)
+    {
+        const EndpointI* e = dynamic_cast<const EndpointI*>(&r);
+        if(!e)
+        {
+            return false;
+        }
+        return type() < e->type();
+    }
+
+    if(this == p)
+    {
+        return false;
+    }
+
+    if(_type < p->_type)
+    {
+        return true;
+    }
+    else if(p->_type < _type)
+    {
+        return false;
+    }
+
+    if(_path < p->_path)
+    {
+        return true;
+    }
+    else if (p->_path < _path)
+    {
+        return false;
+    }
+
+    if(_timeout < p->_timeout)
+    {
+        return true;
+    }
+    else if(p->_timeout < _timeout)
+    {
+        return false;
+    }
+
+    if(_connectionId < p->_connectionId)
+    {
+        return true;
+    }
+    else if(p->_connectionId < _connectionId)
+    {
+        return false;
+    }
+
+    if(!_compress && p->_compress)
+    {
+        return true;
+    }
+    else if(p->_compress < _compress)
+    {
+        return false;
+    }
+
+    return false;
+}
+
+Ice::Int
+IceInternal::UnixEndpointI::hashInit() const
+{
+    Ice::Int h = 0;
+    hashAdd(h, _type);
+    hashAdd(h, _path);
+    hashAdd(h, _timeout);
+    hashAdd(h, _connectionId);
+    hashAdd(h, _compress);
+    return h;
+}
+
+IceInternal::UnixEndpointFactory::UnixEndpointFactory(const InstancePtr& instance, Short type) :
+    _instance(instance),
+    _type(type)
+{
+}
+
+IceInternal::UnixEndpointFactory::~UnixEndpointFactory()
+{
+}
+
+Short
+IceInternal::UnixEndpointFactory::type() const
+{
+    return _type;
+}
+
+string
+IceInternal::UnixEndpointFactory::protocol() const
+{
+    return unixProtocol(_type);
+}
+
+EndpointIPtr
+IceInternal::UnixEndpointFactory::create(const std::string& str, bool) const
+{
+    return new UnixEndpointI(_instance, _type, str);
+}
+
+EndpointIPtr
+IceInternal::UnixEndpointFactory::read(BasicStream* s) const
+{
+    return new UnixEndpointI(s, _type);
+}
+
+void
+IceInternal::UnixEndpointFactory::destroy()
+{
+    _instance = 0;
+}
+
+string
+IceInternal::unixProtocol(Short type)
+{
+    assert(type == UnixEndpointType || type == ShmEndpointType);
+    return type == ShmEndpointType ? "shm" : "unix";
+}
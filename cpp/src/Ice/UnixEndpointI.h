@@ -0,0 +1,98 @@
+// **********************************************************************
+//
+// Copyright (c) 2003-2011 ZeroC, Inc. All rights reserved.
+//
+// This copy of Ice is licensed to you under the terms described in the
+// ICE_LICENSE file included in this distribution.
+//
+// **********************************************************************
+
+#ifndef ICE_UNIX_ENDPOINT_I_H
+#define ICE_UNIX_ENDPOINT_I_H
+
+#include <Ice/EndpointI.h>
+#include <Ice/EndpointFactory.h>
+
+namespace IceInternal
+{
+
+//
+// The endpoints of the unix and shm transports. Both establish their
+// connections over a Unix domain socket and only differ by the
+// transceiver which exchanges the messages, selected by the type of
+// the endpoint.
+//
+class UnixEndpointI : public EndpointI
+{
+public:
+
+    UnixEndpointI(const InstancePtr&, Ice::Short, const std::string&, Ice::Int, const std::string&, bool);
+    UnixEndpointI(const InstancePtr&, Ice::Short, const std::string&);
+    UnixEndpointI(BasicStream*, Ice::Short);
+
+    virtual void streamWrite(BasicStream*) const;
+    virtual std::string toString() const;
+    virtual Ice::EndpointInfoPtr getInfo() const;
+    virtual Ice::Short type() const;
+    virtual Ice::Int timeout() const;
+    virtual EndpointIPtr timeout(Ice::Int) const;
+    virtual EndpointIPtr connectionId(const ::std::string&) const;
+    virtual bool compress() const;
+    virtual EndpointIPtr compress(bool) const;
+    virtual bool datagram() const;
+    virtual bool secure() const;
+    virtual TransceiverPtr transceiver(EndpointIPtr&) const;
+    virtual std::vector<ConnectorPtr> connectors() const;
+    virtual void connectors_async(const EndpointI_connectorsPtr&) const;
+    virtual AcceptorPtr acceptor(EndpointIPtr&, const std::string&) const;
+    virtual std::vector<EndpointIPtr> expand() const;
+    virtual bool equivalent(const EndpointIPtr&) const;
+
+    virtual bool operator==(const Ice::LocalObject&) const;
+    virtual bool operator<(const Ice::LocalObject&) const;
+
+private:
+
+    virtual ::Ice::Int hashInit() const;
+
+    //
+    // All members are const, because endpoints are immutable.
+    //
+    const InstancePtr _instance;
+    const Ice::Short _type;
+    const std::string _path;
+    const Ice::Int _timeout;
+    const std::string _connectionId;
+    const bool _compress;
+};
+
+class UnixEndpointFactory : public EndpointFactory
+{
+public:
+
+    virtual ~UnixEndpointFactory();
+
+    virtual Ice::Short type() const;
+    virtual std::string protocol() const;
+    virtual EndpointIPtr create(const std::string&, bool) const;
+    virtual EndpointIPtr read(BasicStream*) const;
+    virtual void destroy();
+
+private:
+
+    UnixEndpointFactory(const InstancePtr&, Ice::Short);
+    friend class Instance;
+
+    InstancePtr _instance;
+    const Ice::Short _type;
+};
+
+//
+// Returns the protocol name of the given endpoint type, "unix" or
+// "shm".
+//
+std::string unixProtocol(Ice::Short);
+
+}
+
+#endif
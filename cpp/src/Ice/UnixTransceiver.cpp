@@ -0,0 +1,468 @@
+// **********************************************************************
+//
+// Copyright (c) 2003-2011 ZeroC, Inc. All rights reserved.
+//
+// This copy of Ice is licensed to you under the terms described in the
+// ICE_LICENSE file included in this distribution.
+//
+// **********************************************************************
+
+#include <Ice/UnixTransceiver.h>
+#include <Ice/Connection.h>
+#include <Ice/Instance.h>
+#include <Ice/TraceLevels.h>
+#include <Ice/LoggerUtil.h>
+#include <Ice/Stats.h>
+#include <Ice/Buffer.h>
+#include <Ice/Network.h>
+#include <Ice/LocalException.h>
+
+#include <sys/uio.h>
+#include <limits.h>
+
+using namespace std;
+using namespace Ice;
+using namespace IceInternal;
+
+namespace
+{
+
+//
+// The maximum number of buffers sent with a single writev() call.
+//
+#if defined(IOV_MAX) && IOV_MAX < 64
+const int maxGatherBuffers = IOV_MAX;
+#else
+const int maxGatherBuffers = 64;
+#endif
+
+}
+
+NativeInfoPtr
+IceInternal::UnixTransceiver::getNativeInfo()
+{
+    return this;
+}
+
+SocketOperation
+IceInternal::UnixTransceiver::initialize()
+{
+    if(_state == StateNeedConnect)
+    {
+        _state = StateConnectPending;
+        return SocketOperationConnect;
+    }
+    else if(_state <= StateConnectPending)
+    {
+        try
+        {
+            doFinishConnect(_fd);
+            connected();
+        }
+        catch(const Ice::LocalException& ex)
+        {
+            if(_traceLevels->network >= 2)
+            {
+                Trace out(_logger, _traceLevels->networkCat);
+                out << "failed to establish unix connection to " << _path << "\n" << ex;
+            }
+            throw;
+        }
+    }
+    assert(_state == StateConnected);
+    return SocketOperationNone;
+}
+
+void
+IceInternal::UnixTransceiver::close()
+{
+    if(_state == StateConnected && _traceLevels->network >= 1)
+    {
+        Trace out(_logger, _traceLevels->networkCat);
+        out << "closing unix connection\n" << toString();
+    }
+
+    assert(_fd != INVALID_SOCKET);
+    try
+    {
+        closeSocket(_fd);
+        _fd = INVALID_SOCKET;
+    }
+    catch(const SocketException&)
+    {
+        _fd = INVALID_SOCKET;
+        throw;
+    }
+}
+
+bool
+IceInternal::UnixTransceiver::write(Buffer& buf)
+{
+    // Its impossible for the packetSize to be more than an Int.
+    int packetSize = static_cast<int>(buf.b.end() - buf.i);
+
+    while(buf.i != buf.b.end())
+    {
+        assert(_fd != INVALID_SOCKET);
+
+        ssize_t ret = ::send(_fd, reinterpret_cast<const char*>(&*buf.i), packetSize, 0);
+        if(ret == 0)
+        {
+            ConnectionLostException ex(__FILE__, __LINE__);
+            ex.error = 0;
+            throw ex;
+        }
+
+        if(ret == SOCKET_ERROR)
+        {
+            if(interrupted())
+            {
+                continue;
+            }
+
+            if(noBuffers() && packetSize > 1024)
+            {
+                packetSize /= 2;
+                continue;
+            }
+
+            if(wouldBlock())
+            {
+                return false;
+            }
+
+            if(connectionLost())
+            {
+                ConnectionLostException ex(__FILE__, __LINE__);
+                ex.error = getSocketErrno();
+                throw ex;
+            }
+            else
+            {
+                SocketException ex(__FILE__, __LINE__);
+                ex.error = getSocketErrno();
+                throw ex;
+            }
+        }
+
+        if(_traceLevels->network >= 3)
+        {
+            Trace out(_logger, _traceLevels->networkCat);
+            out << "sent " << ret << " of " << packetSize << " bytes via unix\n" << toString();
+        }
+
+        if(_stats)
+        {
+            _stats->bytesSent(type(), static_cast<Int>(ret));
+        }
+
+        buf.i += ret;
+
+        if(packetSize > buf.b.end() - buf.i)
+        {
+            packetSize = static_cast<int>(buf.b.end() - buf.i);
+        }
+    }
+
+    return true;
+}
+
+bool
+IceInternal::UnixTransceiver::gatherWrite(const vector<Buffer*>& bufs)
+{
+    vector<Buffer*>::const_iterator first = bufs.begin();
+    while(true)
+    {
+        //
+        // Skip the buffers which are already fully written.
+        //
+        while(first != bufs.end() && (*first)->i == (*first)->b.end())
+        {
+            ++first;
+        }
+
+        if(first == bufs.end())
+        {
+            return true;
+        }
+
+        struct iovec iov[maxGatherBuffers];
+        int iovcnt = 0;
+        size_t packetSize = 0;
+        for(vector<Buffer*>::const_iterator p = first; p != bufs.end() && iovcnt < maxGatherBuffers; ++p)
+        {
+            size_t len = static_cast<size_t>((*p)->b.end() - (*p)->i);
+            if(len > 0)
+            {
+                iov[iovcnt].iov_base = reinterpret_cast<char*>(&*(*p)->i);
+                iov[iovcnt].iov_len = len;
+                packetSize += len;
+                ++iovcnt;
+            }
+        }
+
+        if(iovcnt == 1)
+        {
+            //
+            // Nothing to gather, use the regular write.
+            //
+            if(!write(**first))
+            {
+                return false;
+            }
+            continue;
+        }
+
+        assert(_fd != INVALID_SOCKET);
+        ssize_t ret = ::writev(_fd, iov, iovcnt);
+        if(ret == 0)
+        {
+            ConnectionLostException ex(__FILE__, __LINE__);
+            ex.error = 0;
+            throw ex;
+        }
+
+        if(ret == SOCKET_ERROR)
+        {
+            if(interrupted())
+            {
+                continue;
+            }
+
+            if(noBuffers())
+            {
+                //
+                // Let write() reduce the packet size for the first buffer.
+                //
+                if(!write(**first))
+                {
+                    return false;
+                }
+                continue;
+            }
+
+            if(wouldBlock())
+            {
+                return false;
+            }
+
+            if(connectionLost())
+            {
+                ConnectionLostException ex(__FILE__, __LINE__);
+                ex.error = getSocketErrno();
+                throw ex;
+            }
+            else
+            {
+                SocketException ex(__FILE__, __LINE__);
+                ex.error = getSocketErrno();
+                throw ex;
+            }
+        }
+
+        if(_traceLevels->network >= 3)
+        {
+            Trace out(_logger, _traceLevels->networkCat);
+            out << "sent " << ret << " of " << packetSize << " bytes in " << iovcnt << " buffers via unix\n"
+                << toString();
+        }
+
+        if(_stats)
+        {
+            _stats->bytesSent(type(), static_cast<Int>(ret));
+        }
+
+        //
+        // Advance the buffer iterators past the bytes that were sent.
+        //
+        size_t sent = static_cast<size_t>(ret);
+        for(vector<Buffer*>::const_iterator p = first; p != bufs.end() && sent > 0; ++p)
+        {
+            size_t len = static_cast<size_t>((*p)->b.end() - (*p)->i);
+            if(sent >= len)
+            {
+                (*p)->i = (*p)->b.end();
+                sent -= len;
+            }
+            else
+            {
+                (*p)->i += sent;
+                sent = 0;
+            }
+        }
+    }
+}
+
+bool
+IceInternal::UnixTransceiver::read(Buffer& buf)
+{
+    // Its impossible for the packetSize to be more than an Int.
+    int packetSize = static_cast<int>(buf.b.end() - buf.i);
+
+    while(buf.i != buf.b.end())
+    {
+        assert(_fd != INVALID_SOCKET);
+        ssize_t ret = ::recv(_fd, reinterpret_cast<char*>(&*buf.i), packetSize, 0);
+
+        if(ret == 0)
+        {
+            ConnectionLostException ex(__FILE__, __LINE__);
+            ex.error = 0;
+            throw ex;
+        }
+
+        if(ret == SOCKET_ERROR)
+        {
+            if(interrupted())
+            {
+                continue;
+            }
+
+            if(noBuffers() && packetSize > 1024)
+            {
+                packetSize /= 2;
+                continue;
+            }
+
+            if(wouldBlock())
+            {
+                return false;
+            }
+
+            if(connectionLost())
+            {
+                ConnectionLostException ex(__FILE__, __LINE__);
+                ex.error = getSocketErrno();
+                throw ex;
+            }
+            else
+            {
+                SocketException ex(__FILE__, __LINE__);
+                ex.error = getSocketErrno();
+                throw ex;
+            }
+        }
+
+        if(_traceLevels->network >= 3)
+        {
+            Trace out(_logger, _traceLevels->networkCat);
+            out << "received " << ret << " of " << packetSize << " bytes via unix\n" << toString();
+        }
+
+        if(_stats)
+        {
+            _stats->bytesReceived(type(), static_cast<Int>(ret));
+        }
+
+        buf.i += ret;
+
+        packetSize = static_cast<int>(buf.b.end() - buf.i);
+    }
+
+    return true;
+}
+
+string
+IceInternal::UnixTransceiver::type() const
+{
+    return "unix";
+}
+
+string
+IceInternal::UnixTransceiver::toString() const
+{
+    return _desc;
+}
+
+Ice::ConnectionInfoPtr
+IceInternal::UnixTransceiver::getInfo() const
+{
+    assert(_fd != INVALID_SOCKET);
+    Ice::UnixConnectionInfoPtr info = new Ice::UnixConnectionInfo();
+    info->path = _path;
+    info->peerPid = _peerPid;
+    info->peerUid = _peerUid;
+    info->peerGid = _peerGid;
+    return info;
+}
+
+void
+IceInternal::UnixTransceiver::checkSendSize(const Buffer& buf, size_t messageSizeMax)
+{
+    if(buf.b.size() > messageSizeMax)
+    {
+        Ex::throwMemoryLimitException(__FILE__, __LINE__, buf.b.size(), messageSizeMax);
+    }
+}
+
+IceInternal::UnixTransceiver::UnixTransceiver(const InstancePtr& instance, SOCKET fd, const string& path,
+                                              bool incoming) :
+    NativeInfo(fd),
+    _traceLevels(instance->traceLevels()),
+    _logger(instance->initializationData().logger),
+    _stats(instance->initializationData().stats),
+    _path(path),
+    _incoming(incoming),
+    _state(StateNeedConnect),
+    _peerPid(-1),
+    _peerUid(-1),
+    _peerGid(-1)
+{
+    setBlock(_fd, false);
+    if(incoming)
+    {
+        connected();
+    }
+}
+
+IceInternal::UnixTransceiver::~UnixTransceiver()
+{
+    assert(_fd == INVALID_SOCKET);
+}
+
+void
+IceInternal::UnixTransceiver::connect()
+{
+    try
+    {
+        if(doConnectUnix(_fd, _path))
+        {
+            connected();
+        }
+    }
+    catch(...)
+    {
+        _fd = INVALID_SOCKET;
+        throw;
+    }
+}
+
+void
+IceInternal::UnixTransceiver::connected()
+{
+    _state = StateConnected;
+
+    //
+    // The kernel records the credentials of both ends when the
+    // connection is established, so the peer can't forge them.
+    //
+    fdToPeerCredentials(_fd, _peerPid, _peerUid, _peerGid);
+
+    ostringstream s;
+    s << "path = " << _path;
+    if(_peerUid != -1)
+    {
+        s << "\npeer uid = " << _peerUid << ", gid = " << _peerGid;
+        if(_peerPid != -1)
+        {
+            s << ", pid = " << _peerPid;
+        }
+    }
+    _desc = s.str();
+
+    if(!_incoming && _traceLevels->network >= 1)
+    {
+        Trace out(_logger, _traceLevels->networkCat);
+        out << "unix connection established\n" << _desc;
+    }
+}
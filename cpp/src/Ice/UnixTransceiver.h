@@ -0,0 +1,78 @@
+// **********************************************************************
+//
+// Copyright (c) 2003-2011 ZeroC, Inc. All rights reserved.
+//
+// This copy of Ice is licensed to you under the terms described in the
+// ICE_LICENSE file included in this distribution.
+//
+// **********************************************************************
+
+#ifndef ICE_UNIX_TRANSCEIVER_H
+#define ICE_UNIX_TRANSCEIVER_H
+
+#include <Ice/InstanceF.h>
+#include <Ice/TraceLevelsF.h>
+#include <Ice/LoggerF.h>
+#include <Ice/StatsF.h>
+#include <Ice/Transceiver.h>
+
+namespace IceInternal
+{
+
+class UnixConnector;
+class UnixAcceptor;
+
+class UnixTransceiver : public Transceiver, public NativeInfo
+{
+    enum State
+    {
+        StateNeedConnect,
+        StateConnectPending,
+        StateConnected
+    };
+
+public:
+
+    virtual NativeInfoPtr getNativeInfo();
+
+    virtual SocketOperation initialize();
+    virtual void close();
+    virtual bool write(Buffer&);
+    virtual bool read(Buffer&);
+    virtual bool gatherWrite(const std::vector<Buffer*>&);
+    virtual std::string type() const;
+    virtual std::string toString() const;
+    virtual Ice::ConnectionInfoPtr getInfo() const;
+    virtual void checkSendSize(const Buffer&, size_t);
+
+private:
+
+    UnixTransceiver(const InstancePtr&, SOCKET, const std::string&, bool);
+    virtual ~UnixTransceiver();
+
+    void connect();
+    void connected();
+
+    friend class UnixConnector;
+    friend class UnixAcceptor;
+
+    const TraceLevelsPtr _traceLevels;
+    const Ice::LoggerPtr _logger;
+    const Ice::StatsPtr _stats;
+    const std::string _path;
+    const bool _incoming;
+
+    State _state;
+    std::string _desc;
+
+    //
+    // The credentials of the peer process, or -1 if they are unknown.
+    //
+    int _peerPid;
+    int _peerUid;
+    int _peerGid;
+};
+
+}
+
+#endif
@@ -54,6 +54,15 @@
 #include <stdio.h>
 #endif
 
+//
+// SSE2 is always available on x86-64, and on x86 when the compiler
+// is told to use it.
+//
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#   define ICE_USE_SSE2
+#   include <emmintrin.h>
+#endif
+
 using namespace IceUtil;
 
 namespace IceUtilInternal
@@ -415,6 +424,151 @@ ConversionResult ConvertUTF8toUTF32 (
     return result;
 }
 
+/* --------------------------------------------------------------------- */
+
+//
+// ASCII runs are checked and copied 16 characters at a time with
+// SSE2, the remaining characters one at a time.
+//
+const UTF8* findNonASCII(const UTF8* source, const UTF8* sourceEnd)
+{
+#ifdef ICE_USE_SSE2
+    while(sourceEnd - source >= 16)
+    {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source));
+        if(_mm_movemask_epi8(v) != 0)
+        {
+            break;
+        }
+        source += 16;
+    }
+#endif
+    while(source != sourceEnd && *source < 0x80)
+    {
+        ++source;
+    }
+    return source;
+}
+
+void copyASCII(const UTF8** sourceStart, const UTF8* sourceEnd, UTF16** targetStart, UTF16* targetEnd)
+{
+    const UTF8* source = *sourceStart;
+    UTF16* target = *targetStart;
+#ifdef ICE_USE_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    while(sourceEnd - source >= 16 && targetEnd - target >= 16)
+    {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source));
+        if(_mm_movemask_epi8(v) != 0)
+        {
+            break;
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(target), _mm_unpacklo_epi8(v, zero));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(target + 8), _mm_unpackhi_epi8(v, zero));
+        source += 16;
+        target += 16;
+    }
+#endif
+    while(source != sourceEnd && target != targetEnd && *source < 0x80)
+    {
+        *target++ = *source++;
+    }
+    *sourceStart = source;
+    *targetStart = target;
+}
+
+void copyASCII(const UTF8** sourceStart, const UTF8* sourceEnd, UTF32** targetStart, UTF32* targetEnd)
+{
+    const UTF8* source = *sourceStart;
+    UTF32* target = *targetStart;
+#ifdef ICE_USE_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    while(sourceEnd - source >= 16 && targetEnd - target >= 16)
+    {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source));
+        if(_mm_movemask_epi8(v) != 0)
+        {
+            break;
+        }
+        __m128i lo = _mm_unpacklo_epi8(v, zero);
+        __m128i hi = _mm_unpackhi_epi8(v, zero);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(target), _mm_unpacklo_epi16(lo, zero));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(target + 4), _mm_unpackhi_epi16(lo, zero));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(target + 8), _mm_unpacklo_epi16(hi, zero));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(target + 12), _mm_unpackhi_epi16(hi, zero));
+        source += 16;
+        target += 16;
+    }
+#endif
+    while(source != sourceEnd && target != targetEnd && *source < 0x80)
+    {
+        *target++ = *source++;
+    }
+    *sourceStart = source;
+    *targetStart = target;
+}
+
+void copyASCII(const UTF16** sourceStart, const UTF16* sourceEnd, UTF8** targetStart, UTF8* targetEnd)
+{
+    const UTF16* source = *sourceStart;
+    UTF8* target = *targetStart;
+#ifdef ICE_USE_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i nonASCII = _mm_set1_epi16(static_cast<short>(0xFF80));
+    while(sourceEnd - source >= 16 && targetEnd - target >= 16)
+    {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + 8));
+        __m128i bits = _mm_and_si128(_mm_or_si128(a, b), nonASCII);
+        if(_mm_movemask_epi8(_mm_cmpeq_epi16(bits, zero)) != 0xFFFF)
+        {
+            break;
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(target), _mm_packus_epi16(a, b));
+        source += 16;
+        target += 16;
+    }
+#endif
+    while(source != sourceEnd && target != targetEnd && *source < 0x80)
+    {
+        *target++ = static_cast<UTF8>(*source++);
+    }
+    *sourceStart = source;
+    *targetStart = target;
+}
+
+void copyASCII(const UTF32** sourceStart, const UTF32* sourceEnd, UTF8** targetStart, UTF8* targetEnd)
+{
+    const UTF32* source = *sourceStart;
+    UTF8* target = *targetStart;
+#ifdef ICE_USE_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i nonASCII = _mm_set1_epi32(~0x7F);
+    while(sourceEnd - source >= 16 && targetEnd - target >= 16)
+    {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + 4));
+        __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + 8));
+        __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + 12));
+        __m128i bits = _mm_and_si128(_mm_or_si128(_mm_or_si128(a, b), _mm_or_si128(c, d)), nonASCII);
+        if(_mm_movemask_epi8(_mm_cmpeq_epi32(bits, zero)) != 0xFFFF)
+        {
+            break;
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(target),
+                         _mm_packus_epi16(_mm_packs_epi32(a, b), _mm_packs_epi32(c, d)));
+        source += 16;
+        target += 16;
+    }
+#endif
+    while(source != sourceEnd && target != targetEnd && *source < 0x80)
+    {
+        *target++ = static_cast<UTF8>(*source++);
+    }
+    *sourceStart = source;
+    *targetStart = target;
+}
+
 /* ---------------------------------------------------------------------
 
     Note A.
@@ -451,6 +605,10 @@ Boolean isLegalUTF8Sequence(const UTF8 *source, const UTF8 *sourceEnd) {
         return true;
     }
     while(true) {
+        source = findNonASCII(source, sourceEnd);
+        if(source == sourceEnd) {
+            return true;
+        }
         int length = trailingBytesForUTF8[*source]+1;
         // Is buffer big enough to contain character?
         if (source+length > sourceEnd) {
@@ -134,6 +134,24 @@ ConversionResult ConvertUTF32toUTF8(
     const UTF32** sourceStart, const UTF32* sourceEnd, 
     UTF8** targetStart, UTF8* targetEnd, IceUtil::ConversionFlags flags);
 
+//
+// Returns a pointer to the first non-ASCII character of the source,
+// or sourceEnd if all the characters are ASCII.
+//
+const UTF8* findNonASCII(const UTF8* source, const UTF8* sourceEnd);
+
+//
+// Copy the ASCII characters at the start of the source to the target,
+// until a non-ASCII character or the end of either buffer is reached.
+// *sourceStart and *targetStart are updated like with the ConvertXXX
+// functions. ASCII characters are never part of a multi-unit sequence,
+// so a run of ASCII characters always ends on a character boundary.
+//
+void copyASCII(const UTF8** sourceStart, const UTF8* sourceEnd, UTF16** targetStart, UTF16* targetEnd);
+void copyASCII(const UTF8** sourceStart, const UTF8* sourceEnd, UTF32** targetStart, UTF32* targetEnd);
+void copyASCII(const UTF16** sourceStart, const UTF16* sourceEnd, UTF8** targetStart, UTF8* targetEnd);
+void copyASCII(const UTF32** sourceStart, const UTF32* sourceEnd, UTF8** targetStart, UTF8* targetEnd);
+
 //
 // isLegalUTFSequence is declared in IceUtil/Unicode.h
 //
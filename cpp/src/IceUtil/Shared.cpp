@@ -115,7 +115,16 @@ IceUtil::Shared::__incRef()
     assert(InterlockedExchangeAdd(&_ref, 0) >= 0);
     InterlockedIncrement(&_ref);
 #elif defined(ICE_HAS_GCC_BUILTINS)
+#   if defined(__ATOMIC_RELAXED)
+    //
+    // Taking a new reference requires an existing one, so the
+    // increment doesn't need to be ordered with other memory
+    // accesses.
+    //
+    int c = __atomic_fetch_add(&_ref, 1, __ATOMIC_RELAXED);
+#   else
     int c = __sync_fetch_and_add(&_ref, 1);
+#   endif
     assert(c >= 0);
 #elif defined(ICE_HAS_ATOMIC_FUNCTIONS)
     assert(IceUtilInternal::atomicExchangeAdd(&_ref, 0) >= 0);
@@ -139,7 +148,16 @@ IceUtil::Shared::__decRef()
         delete this;
     }
 #elif defined(ICE_HAS_GCC_BUILTINS)
+#   if defined(__ATOMIC_ACQ_REL)
+    //
+    // The release makes the accesses to the object through this
+    // reference visible to the thread deleting it, and the acquire
+    // makes the deleting thread see them.
+    //
+    int c = __atomic_fetch_sub(&_ref, 1, __ATOMIC_ACQ_REL);
+#   else
     int c = __sync_fetch_and_sub(&_ref, 1);
+#   endif
     assert(c > 0);
     if(c == 1 && !_noDelete)
     {
@@ -176,7 +194,11 @@ IceUtil::Shared::__getRef() const
 #if defined(_WIN32)
     return InterlockedExchangeAdd(const_cast<LONG*>(&_ref), 0);
 #elif defined(ICE_HAS_GCC_BUILTINS)
+#   if defined(__ATOMIC_RELAXED)
+    return __atomic_load_n(&_ref, __ATOMIC_RELAXED);
+#   else
     return __sync_fetch_and_sub(const_cast<volatile int*>(&_ref), 0);
+#   endif
 #elif defined(ICE_HAS_ATOMIC_FUNCTIONS)
     return IceUtilInternal::atomicExchangeAdd(const_cast<volatile int*>(&_ref), 0);
 #else
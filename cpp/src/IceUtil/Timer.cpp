@@ -10,12 +10,504 @@
 #include <IceUtil/Timer.h>
 #include <IceUtil/Exception.h>
 
+#include <vector>
+
 using namespace std;
 using namespace IceUtil;
 
+namespace
+{
+
+void
+runTask(const TimerTaskPtr& task)
+{
+    try
+    {
+        task->runTimerTask();
+    }
+    catch(const IceUtil::Exception& e)
+    {
+        cerr << "IceUtil::Timer::run(): uncaught exception:\n" << e.what();
+#ifdef __GNUC__
+        cerr << "\n" << e.ice_stackTrace();
+#endif
+        cerr << endl;
+    } 
+    catch(const std::exception& e)
+    {
+        cerr << "IceUtil::Timer::run(): uncaught exception:\n" << e.what() << endl;
+    } 
+    catch(...)
+    {
+        cerr << "IceUtil::Timer::run(): uncaught exception" << endl;
+    }
+}
+
+//
+// The wheel has 4 levels of 256 slots. The slots of the first level
+// hold the tasks due at each of the next 256 ticks, those of the next
+// level the tasks due in each of the next 256 spans of 256 ticks, and
+// so on. When the first level wraps around, the tasks of the next slot
+// of the second level are redistributed to the first level, and so on
+// for the upper levels.
+//
+const int slotBits = 8;
+const Int64 slotCount = 1 << slotBits;
+const Int64 slotMask = slotCount - 1;
+const int levelCount = 4;
+const Int64 maxDelta = (static_cast<Int64>(1) << (slotBits * levelCount)) - 1;
+const int wordBits = 32;
+
+}
+
+//
+// The timing wheel. All its methods are called with the timer monitor
+// locked.
+//
+// Cancelling a task only removes it from the task table and releases
+// it: the entry stays in its slot and is deleted once the wheel
+// reaches it. Tasks cancelled and scheduled again repeatedly, such as
+// connection timeouts, would leave many such entries behind, so the
+// slots are swept once the cancelled entries outnumber the scheduled
+// tasks.
+//
+class IceUtil::Timer::Wheel
+{
+public:
+
+    struct Entry
+    {
+        TimerTaskPtr task; // Null once cancelled.
+        Int64 expires; // In ticks.
+        IceUtil::Time delay; // For repeated tasks.
+        Entry* next; // In a slot or the ready list.
+        Entry* hashNext; // In the task table.
+    };
+
+    Wheel(const IceUtil::Time& tick) :
+        _tick(tick.toMicroSeconds()),
+        _start(IceUtil::Time::now(IceUtil::Time::Monotonic)),
+        _current(0),
+        _entries(0),
+        _ready(0),
+        _readyTail(0),
+        _buckets(64),
+        _count(0)
+    {
+        assert(_tick > 0);
+        for(int i = 0; i < levelCount; ++i)
+        {
+            for(int j = 0; j < slotCount; ++j)
+            {
+                _slots[i][j] = 0;
+            }
+        }
+        fill(_occupied, _occupied + slotCount / wordBits, 0U);
+    }
+
+    ~Wheel()
+    {
+        clear();
+    }
+
+    void
+    clear()
+    {
+        for(int i = 0; i < levelCount; ++i)
+        {
+            for(int j = 0; j < slotCount; ++j)
+            {
+                deleteAll(_slots[i][j]);
+                _slots[i][j] = 0;
+            }
+        }
+        fill(_occupied, _occupied + slotCount / wordBits, 0U);
+        deleteAll(_ready);
+        _ready = _readyTail = 0;
+        fill(_buckets.begin(), _buckets.end(), static_cast<Entry*>(0));
+        _entries = 0;
+        _count = 0;
+    }
+
+    //
+    // Returns false if the task is already scheduled.
+    //
+    bool
+    schedule(const TimerTaskPtr& task, const IceUtil::Time& now, const IceUtil::Time& time,
+             const IceUtil::Time& delay)
+    {
+        if(find(task))
+        {
+            return false;
+        }
+        catchUp(now);
+
+        Entry* e = new Entry;
+        e->task = task;
+        e->expires = toTicks(time);
+        e->delay = delay;
+        e->next = 0;
+        insert(e);
+        add(e);
+        return true;
+    }
+
+    //
+    // Returns false if the task isn't scheduled.
+    //
+    bool
+    cancel(const TimerTaskPtr& task)
+    {
+        Entry* e = remove(task.get());
+        if(!e)
+        {
+            return false;
+        }
+        e->task = 0;
+        if(_entries > 2 * _count + 1024)
+        {
+            sweep();
+        }
+        return true;
+    }
+
+    //
+    // Moves the wheel to the given time and returns the next task to
+    // run, if any. One-time tasks are no longer scheduled once
+    // returned.
+    //
+    Entry*
+    next(const IceUtil::Time& now)
+    {
+        advance(toTicks(now + IceUtil::Time::microSeconds(1)) - 1);
+        while(_ready)
+        {
+            Entry* e = _ready;
+            _ready = e->next;
+            if(!_ready)
+            {
+                _readyTail = 0;
+            }
+            if(!e->task)
+            {
+                delete e;
+                continue;
+            }
+            if(e->delay == IceUtil::Time())
+            {
+                remove(e->task.get());
+            }
+            return e;
+        }
+        return 0;
+    }
+
+    //
+    // Called once the task of an entry returned by next() has run:
+    // schedules it again if it's a repeated task that wasn't
+    // cancelled.
+    //
+    void
+    ran(Entry* e, const IceUtil::Time& now)
+    {
+        if(e->task && e->delay != IceUtil::Time())
+        {
+            catchUp(now);
+            e->expires = toTicks(now + e->delay);
+            add(e);
+        }
+        else
+        {
+            delete e;
+        }
+    }
+
+    //
+    // The time at which the wheel must move next, or a null time if
+    // there's nothing to wait for. Past the end of the first level,
+    // the wheel must move for the upper levels to be redistributed.
+    //
+    IceUtil::Time
+    wakeUpTime() const
+    {
+        if(_entries == 0)
+        {
+            return IceUtil::Time();
+        }
+        return _start + IceUtil::Time::microSeconds(nextTick(_current + 1) * _tick);
+    }
+
+private:
+
+    //
+    // The wheel doesn't move while it's empty, as the timer thread
+    // has nothing to wait for. Before adding an entry, it's moved to
+    // the current time, otherwise the entry would be added relative
+    // to the last tick reached and the wheel would have to go through
+    // all the ticks since then.
+    //
+    void
+    catchUp(const IceUtil::Time& now)
+    {
+        if(_entries == 0)
+        {
+            _current = max(_current, toTicks(now + IceUtil::Time::microSeconds(1)) - 1);
+        }
+    }
+
+    //
+    // Returns the first tick from the given one whose slot of the
+    // first level isn't empty, or the start of the next span of the
+    // first level, where the upper levels must be redistributed. The
+    // empty slots are skipped a word of the occupied slot bitmap at a
+    // time.
+    //
+    Int64
+    nextTick(Int64 t) const
+    {
+        int i = static_cast<int>(t & slotMask);
+        if(i == 0)
+        {
+            return t;
+        }
+        for(int j = i; j < slotCount;)
+        {
+            unsigned int word = _occupied[j / wordBits] >> (j % wordBits);
+            if(word == 0)
+            {
+                j = (j / wordBits + 1) * wordBits;
+                continue;
+            }
+            for(; (word & 1) == 0; word >>= 1)
+            {
+                ++j;
+            }
+            return t + (j - i);
+        }
+        return t + (slotCount - i);
+    }
+
+    Int64
+    toTicks(const IceUtil::Time& time) const
+    {
+        //
+        // Rounded up so that tasks never run early.
+        //
+        Int64 t = (time - _start).toMicroSeconds();
+        return t <= 0 ? 0 : (t + _tick - 1) / _tick;
+    }
+
+    void
+    add(Entry* e)
+    {
+        Int64 delta = e->expires - _current;
+        if(delta <= 0)
+        {
+            e->next = 0;
+            if(_readyTail)
+            {
+                _readyTail->next = e;
+            }
+            else
+            {
+                _ready = e;
+            }
+            _readyTail = e;
+            return;
+        }
+
+        //
+        // Tasks due beyond the range of the wheel are put in the last
+        // slot it reaches and redistributed from there.
+        //
+        Int64 expires = delta > maxDelta ? _current + maxDelta : e->expires;
+        int level = 0;
+        while(level < levelCount - 1 && delta >= (static_cast<Int64>(1) << (slotBits * (level + 1))))
+        {
+            ++level;
+        }
+        int index = static_cast<int>((expires >> (slotBits * level)) & slotMask);
+        if(level == 0)
+        {
+            _occupied[index / wordBits] |= 1U << (index % wordBits);
+        }
+        Entry*& slot = _slots[level][index];
+        e->next = slot;
+        slot = e;
+        ++_entries;
+    }
+
+    void
+    advance(Int64 ticks)
+    {
+        while(_current < ticks)
+        {
+            if(_entries == 0)
+            {
+                _current = ticks;
+                break;
+            }
+
+            Int64 next = nextTick(_current + 1);
+            if(next > ticks)
+            {
+                _current = ticks;
+                break;
+            }
+            _current = next;
+
+            for(int level = 1; level < levelCount; ++level)
+            {
+                if((_current & ((static_cast<Int64>(1) << (slotBits * level)) - 1)) != 0)
+                {
+                    break;
+                }
+                redistribute(_slots[level][(_current >> (slotBits * level)) & slotMask]);
+            }
+            int index = static_cast<int>(_current & slotMask);
+            _occupied[index / wordBits] &= ~(1U << (index % wordBits));
+            redistribute(_slots[0][index]);
+        }
+    }
+
+    void
+    redistribute(Entry*& slot)
+    {
+        Entry* e = slot;
+        slot = 0;
+        while(e)
+        {
+            Entry* next = e->next;
+            --_entries;
+            if(e->task)
+            {
+                add(e);
+            }
+            else
+            {
+                delete e;
+            }
+            e = next;
+        }
+    }
+
+    void
+    sweep()
+    {
+        for(int i = 0; i < levelCount; ++i)
+        {
+            for(int j = 0; j < slotCount; ++j)
+            {
+                for(Entry** p = &_slots[i][j]; *p;)
+                {
+                    if((*p)->task)
+                    {
+                        p = &(*p)->next;
+                    }
+                    else
+                    {
+                        Entry* e = *p;
+                        *p = e->next;
+                        delete e;
+                        --_entries;
+                    }
+                }
+            }
+        }
+    }
+
+    static void
+    deleteAll(Entry* e)
+    {
+        while(e)
+        {
+            Entry* next = e->next;
+            delete e;
+            e = next;
+        }
+    }
+
+    //
+    // The task table, a hash table of the scheduled entries chained
+    // through Entry::hashNext.
+    //
+    size_t
+    bucket(const TimerTask* task) const
+    {
+        size_t h = reinterpret_cast<size_t>(task);
+        return (h ^ (h >> 9)) & (_buckets.size() - 1);
+    }
+
+    Entry*
+    find(const TimerTaskPtr& task) const
+    {
+        for(Entry* e = _buckets[bucket(task.get())]; e; e = e->hashNext)
+        {
+            if(e->task.get() == task.get())
+            {
+                return e;
+            }
+        }
+        return 0;
+    }
+
+    void
+    insert(Entry* e)
+    {
+        if(_count >= _buckets.size())
+        {
+            vector<Entry*> buckets(_buckets.size() * 2);
+            _buckets.swap(buckets);
+            for(vector<Entry*>::const_iterator p = buckets.begin(); p != buckets.end(); ++p)
+            {
+                for(Entry* q = *p; q;)
+                {
+                    Entry* next = q->hashNext;
+                    Entry*& b = _buckets[bucket(q->task.get())];
+                    q->hashNext = b;
+                    b = q;
+                    q = next;
+                }
+            }
+        }
+        Entry*& b = _buckets[bucket(e->task.get())];
+        e->hashNext = b;
+        b = e;
+        ++_count;
+    }
+
+    Entry*
+    remove(const TimerTask* task)
+    {
+        for(Entry** p = &_buckets[bucket(task)]; *p; p = &(*p)->hashNext)
+        {
+            if((*p)->task.get() == task)
+            {
+                Entry* e = *p;
+                *p = e->hashNext;
+                --_count;
+                return e;
+            }
+        }
+        return 0;
+    }
+
+    const Int64 _tick; // In microseconds.
+    const IceUtil::Time _start;
+    Int64 _current; // The last tick reached.
+    size_t _entries; // In the slots, including cancelled tasks.
+    Entry* _slots[levelCount][slotCount];
+    unsigned int _occupied[slotCount / wordBits]; // The non-empty slots of the first level.
+    Entry* _ready;
+    Entry* _readyTail;
+    vector<Entry*> _buckets;
+    size_t _count;
+};
+
 Timer::Timer() :
     Thread("IceUtil timer thread"),
-    _destroyed(false)
+    _destroyed(false),
+    _wheel(0)
 {
     __setNoDelete(true);
     start();
@@ -24,13 +516,51 @@ Timer::Timer() :
 
 Timer::Timer(int priority) :
     Thread("IceUtil timer thread"),
-    _destroyed(false)
+    _destroyed(false),
+    _wheel(0)
 {
     __setNoDelete(true);
     start(0, priority);
     __setNoDelete(false);
 }
 
+Timer::Timer(const IceUtil::Time& tick) :
+    Thread("IceUtil timer thread"),
+    _destroyed(false),
+    _wheel(0)
+{
+    if(tick <= IceUtil::Time())
+    {
+        throw IllegalArgumentException(__FILE__, __LINE__, "invalid tick");
+    }
+    _wheel = new Wheel(tick);
+
+    __setNoDelete(true);
+    start();
+    __setNoDelete(false);
+}
+
+Timer::Timer(const IceUtil::Time& tick, int priority) :
+    Thread("IceUtil timer thread"),
+    _destroyed(false),
+    _wheel(0)
+{
+    if(tick <= IceUtil::Time())
+    {
+        throw IllegalArgumentException(__FILE__, __LINE__, "invalid tick");
+    }
+    _wheel = new Wheel(tick);
+
+    __setNoDelete(true);
+    start(0, priority);
+    __setNoDelete(false);
+}
+
+Timer::~Timer()
+{
+    delete _wheel;
+}
+
 void
 Timer::destroy()
 {
@@ -44,6 +574,10 @@ Timer::destroy()
         _monitor.notify();
         _tasks.clear();
         _tokens.clear();
+        if(_wheel)
+        {
+            _wheel->clear();
+        }
     }
 
     if(getThreadControl() == ThreadControl())
@@ -72,12 +606,22 @@ Timer::schedule(const TimerTaskPtr& task, const IceUtil::Time& delay)
         throw IllegalArgumentException(__FILE__, __LINE__, "invalid delay");
     }
 
-    bool inserted = _tasks.insert(make_pair(task, time)).second;
-    if(!inserted)
+    if(_wheel)
     {
-        throw IllegalArgumentException(__FILE__, __LINE__, "task is already schedulded");
+        if(!_wheel->schedule(task, now, time, IceUtil::Time()))
+        {
+            throw IllegalArgumentException(__FILE__, __LINE__, "task is already schedulded");
+        }
+    }
+    else
+    {
+        bool inserted = _tasks.insert(make_pair(task, time)).second;
+        if(!inserted)
+        {
+            throw IllegalArgumentException(__FILE__, __LINE__, "task is already schedulded");
+        }
+        _tokens.insert(Token(time, IceUtil::Time(), task));
     }
-    _tokens.insert(Token(time, IceUtil::Time(), task));
 
     if(_wakeUpTime == IceUtil::Time() || time < _wakeUpTime)
     {
@@ -101,12 +645,30 @@ Timer::scheduleRepeated(const TimerTaskPtr& task, const IceUtil::Time& delay)
         throw IllegalArgumentException(__FILE__, __LINE__, "invalid delay");
     }
 
-    bool inserted = _tasks.insert(make_pair(task, token.scheduledTime)).second;
-    if(!inserted)
+    if(_wheel)
+    {
+        //
+        // A null delay would make the wheel take the task for a
+        // one-time task.
+        //
+        if(delay <= IceUtil::Time())
+        {
+            throw IllegalArgumentException(__FILE__, __LINE__, "invalid delay");
+        }
+        if(!_wheel->schedule(task, now, token.scheduledTime, delay))
+        {
+            throw IllegalArgumentException(__FILE__, __LINE__, "task is already schedulded");
+        }
+    }
+    else
     {
-        throw IllegalArgumentException(__FILE__, __LINE__, "task is already schedulded");
+        bool inserted = _tasks.insert(make_pair(task, token.scheduledTime)).second;
+        if(!inserted)
+        {
+            throw IllegalArgumentException(__FILE__, __LINE__, "task is already schedulded");
+        }
+        _tokens.insert(token); 
     }
-    _tokens.insert(token); 
    
     if(_wakeUpTime == IceUtil::Time() || token.scheduledTime < _wakeUpTime)
     {
@@ -123,6 +685,11 @@ Timer::cancel(const TimerTaskPtr& task)
         return false;
     }
 
+    if(_wheel)
+    {
+        return _wheel->cancel(task);
+    }
+
     map<TimerTaskPtr, IceUtil::Time, TimerTaskCompare>::iterator p = _tasks.find(task);
     if(p == _tasks.end())
     {
@@ -138,6 +705,12 @@ Timer::cancel(const TimerTaskPtr& task)
 void
 Timer::run()
 {
+    if(_wheel)
+    {
+        runWheel();
+        return;
+    }
+
     Token token(IceUtil::Time(), IceUtil::Time(), 0);
     while(true)
     {
@@ -220,26 +793,77 @@ Timer::run()
 
         if(token.task)
         {
-            try
+            runTask(token.task);
+        }
+    }
+}
+
+void
+Timer::runWheel()
+{
+    Wheel::Entry* entry = 0;
+    while(true)
+    {
+        TimerTaskPtr task;
+        {
+            IceUtil::Monitor<IceUtil::Mutex>::Lock sync(_monitor);
+
+            if(entry && !_destroyed)
             {
-                token.task->runTimerTask();
+                _wheel->ran(entry, IceUtil::Time::now(IceUtil::Time::Monotonic));
+                entry = 0;
             }
-            catch(const IceUtil::Exception& e)
-            {
-                cerr << "IceUtil::Timer::run(): uncaught exception:\n" << e.what();
-#ifdef __GNUC__
-                cerr << "\n" << e.ice_stackTrace();
-#endif
-                cerr << endl;
-            } 
-            catch(const std::exception& e)
+
+            while(!_destroyed)
             {
-                cerr << "IceUtil::Timer::run(): uncaught exception:\n" << e.what() << endl;
-            } 
-            catch(...)
+                const IceUtil::Time now = IceUtil::Time::now(IceUtil::Time::Monotonic);
+                entry = _wheel->next(now);
+                if(entry)
+                {
+                    task = entry->task;
+                    break;
+                }
+
+                _wakeUpTime = _wheel->wakeUpTime();
+                if(_wakeUpTime == IceUtil::Time())
+                {
+                    _monitor.wait();
+                    continue;
+                }
+
+                try 
+                {
+                    _monitor.timedWait(_wakeUpTime - now);
+                } 
+                catch(const IceUtil::InvalidTimeoutException&)
+                {
+                    IceUtil::Time timeout = (_wakeUpTime - now) / 2;
+                    while(timeout > IceUtil::Time())
+                    {
+                        try 
+                        {
+                            _monitor.timedWait(timeout);
+                            break;
+                        } 
+                        catch(const IceUtil::InvalidTimeoutException&)
+                        {
+                            timeout = timeout / 2;
+                        }
+                    }
+                }
+            }
+
+            if(_destroyed)
             {
-                cerr << "IceUtil::Timer::run(): uncaught exception" << endl;
+                break;
             }
         }
+
+        runTask(task);
     }
+
+    //
+    // The entry of the last task run isn't in the wheel anymore.
+    //
+    delete entry;
 }
@@ -16,6 +16,57 @@ using namespace IceUtilInternal;
 
 namespace
 {
+
+//
+// The number of source units converted by each call to a ConvertXXX
+// function. A character is at most 6 units long in UTF-8 and 2 in
+// UTF-16, so each chunk holds at least one complete character.
+//
+const int chunkSize = 64;
+
+//
+// Converts the runs of ASCII characters of the source with
+// copyASCII() and the other characters with the given ConvertXXX
+// function. After a non-ASCII character, the ConvertXXX function
+// converts a chunk of the source before copyASCII() is tried again,
+// so that text with few ASCII characters isn't converted a character
+// at a time.
+//
+template<typename S, typename T>
+ConversionResult
+convertUTF(const S** sourceStart, const S* sourceEnd, T** targetStart, T* targetEnd, ConversionFlags flags,
+           ConversionResult (*convert)(const S**, const S*, T**, T*, ConversionFlags))
+{
+    while(true)
+    {
+        copyASCII(sourceStart, sourceEnd, targetStart, targetEnd);
+        if(*sourceStart == sourceEnd)
+        {
+            return conversionOK;
+        }
+        if(*targetStart == targetEnd)
+        {
+            return targetExhausted;
+        }
+
+        const S* chunkEnd = sourceEnd - *sourceStart > chunkSize ? *sourceStart + chunkSize : sourceEnd;
+        ConversionResult result = convert(sourceStart, chunkEnd, targetStart, targetEnd, flags);
+        if(result == sourceExhausted && chunkEnd != sourceEnd)
+        {
+            //
+            // The chunk ends with an incomplete character, the
+            // ConvertXXX function stopped at its start and it's
+            // converted with the next chunk.
+            //
+            continue;
+        }
+        if(result != conversionOK)
+        {
+            return result;
+        }
+    }
+}
+
 //
 // Helper class, base never defined
 // Usage: WstringHelper<sizeof(wchar_t)>::toUTF8 and fromUTF8.
@@ -39,20 +90,20 @@ struct WstringHelper<2>
         const wchar_t*& sourceStart, const wchar_t* sourceEnd, 
         Byte*& targetStart, Byte* targetEnd, ConversionFlags flags)
     {
-        return ConvertUTF16toUTF8(
+        return convertUTF(
             reinterpret_cast<const UTF16**>(&sourceStart),
             reinterpret_cast<const UTF16*>(sourceEnd),
-            &targetStart, targetEnd, flags);
+            &targetStart, targetEnd, flags, ConvertUTF16toUTF8);
     }
     
     static ConversionResult fromUTF8(
         const Byte*& sourceStart, const Byte* sourceEnd, 
         wchar_t*& targetStart, wchar_t* targetEnd, ConversionFlags flags)
     {
-        return ConvertUTF8toUTF16(
+        return convertUTF(
             &sourceStart, sourceEnd,
             reinterpret_cast<UTF16**>(&targetStart),
-            reinterpret_cast<UTF16*>(targetEnd), flags);
+            reinterpret_cast<UTF16*>(targetEnd), flags, ConvertUTF8toUTF16);
     }
 };
 
@@ -63,20 +114,20 @@ struct WstringHelper<4>
         const wchar_t*& sourceStart, const wchar_t* sourceEnd, 
         Byte*& targetStart, Byte* targetEnd, ConversionFlags flags)
     {
-        return ConvertUTF32toUTF8(
+        return convertUTF(
             reinterpret_cast<const UTF32**>(&sourceStart),
             reinterpret_cast<const UTF32*>(sourceEnd),
-            &targetStart, targetEnd, flags);
+            &targetStart, targetEnd, flags, ConvertUTF32toUTF8);
     }
     
     static ConversionResult fromUTF8(
         const Byte*& sourceStart, const Byte* sourceEnd, 
         wchar_t*& targetStart, wchar_t* targetEnd, ConversionFlags flags)
     {
-        return ConvertUTF8toUTF32(
+        return convertUTF(
             &sourceStart, sourceEnd,
             reinterpret_cast<UTF32**>(&targetStart),
-            reinterpret_cast<UTF32*>(targetEnd), flags);
+            reinterpret_cast<UTF32*>(targetEnd), flags, ConvertUTF8toUTF32);
     }
 };
 }
@@ -108,11 +159,18 @@ IceUtilInternal::convertUTF8ToUTFWstring(const Byte*& sourceStart, const Byte* s
                                  std::wstring& target, ConversionFlags flags)
 {
     //
-    // Could be reimplemented without this temporary wchar_t buffer
+    // The UTF-8 source has at least as many bytes as the result has
+    // characters, the string is converted in place and then shrunk.
     //
     size_t size = static_cast<size_t>(sourceEnd - sourceStart);
-    wchar_t* outBuf = new wchar_t[size];
-    wchar_t* targetStart = outBuf; 
+    if(size == 0)
+    {
+        target.clear();
+        return conversionOK;
+    }
+
+    std::wstring s(size, L'\0');
+    wchar_t* targetStart = &s[0];
     wchar_t* targetEnd = targetStart + size;
 
     ConversionResult result =  
@@ -121,10 +179,9 @@ IceUtilInternal::convertUTF8ToUTFWstring(const Byte*& sourceStart, const Byte* s
 
     if(result == conversionOK)
     {
-        std::wstring s(outBuf, static_cast<size_t>(targetStart - outBuf));
+        s.resize(static_cast<size_t>(targetStart - &s[0]));
         s.swap(target);
     }
-    delete[] outBuf;
     return result;
 }
 
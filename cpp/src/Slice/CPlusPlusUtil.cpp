@@ -10,6 +10,7 @@
 #include <Slice/CPlusPlusUtil.h>
 #include <Slice/Util.h>
 #include <cstring>
+#include <sstream>
 
 #ifndef _WIN32
 #  include <fcntl.h>
@@ -817,10 +818,25 @@ Slice::writeMarshalUnmarshalCode(Output& out, const TypePtr& type, const string&
                 //
                 // Use array (pair<const TYPE*, const TYPE*>). In parameters only.
                 //
+                size_t wireSize;
+                size_t alignment;
+                bool inPlace = false;
                 if(!builtin || builtin->kind() == Builtin::KindObject || builtin->kind() == Builtin::KindObjectProxy)
                 {
                     seqType = findMetaData(seq->getMetaData());
-                    if(seqType.empty())
+                    if(seqType.empty() && !(typeCtx & TypeContextAMIPrivateEnd) &&
+                       hasWireLayout(seq->type(), wireSize, alignment))
+                    {
+                        //
+                        // The generated read function sets the array
+                        // to the data of the stream if possible.
+                        //
+                        out << nl << typeToString(type) << " ___" << fixedParam << ";";
+                        out << nl << scope << "__" << funcSeq << (pointer ? "" : "&") << stream << ", "
+                            << fixedParam << ", ___" << fixedParam << ");";
+                        inPlace = true;
+                    }
+                    else if(seqType.empty())
                     {
                         out << nl << typeToString(type) << " ___" << fixedParam << ";";
                         out << nl << scope << "__" << funcSeq << (pointer ? "" : "&") << stream << ", ___"
@@ -868,8 +884,8 @@ Slice::writeMarshalUnmarshalCode(Output& out, const TypePtr& type, const string&
                     out << nl << stream << deref << func << "___" << fixedParam << ");";
                 }
 
-                if(!builtin || builtin->kind() == Builtin::KindString || builtin->kind() == Builtin::KindObject ||
-                        builtin->kind() == Builtin::KindObjectProxy)
+                if(!inPlace && (!builtin || builtin->kind() == Builtin::KindString ||
+                                builtin->kind() == Builtin::KindObject || builtin->kind() == Builtin::KindObjectProxy))
                 {
                     if(typeCtx & TypeContextAMIPrivateEnd)
                     {
@@ -1417,3 +1433,253 @@ Slice::inWstringModule(const SequencePtr& seq)
     }
     return false;
 }
+
+bool
+Slice::hasWireLayout(const TypePtr& type, size_t& size, size_t& alignment)
+{
+    BuiltinPtr builtin = BuiltinPtr::dynamicCast(type);
+    if(builtin)
+    {
+        switch(builtin->kind())
+        {
+            case Builtin::KindByte:
+            case Builtin::KindShort:
+            case Builtin::KindInt:
+            case Builtin::KindLong:
+            case Builtin::KindFloat:
+            case Builtin::KindDouble:
+            {
+                size = builtin->minWireSize();
+                alignment = size;
+                return true;
+            }
+            default:
+            {
+                //
+                // The C++ representation of bool isn't specified, the
+                // other builtin types have a variable size.
+                //
+                return false;
+            }
+        }
+    }
+
+    StructPtr st = StructPtr::dynamicCast(type);
+    if(!st || findMetaData(st->getMetaData()) == "class")
+    {
+        return false;
+    }
+
+    size = 0;
+    alignment = 1;
+    DataMemberList dataMembers = st->dataMembers();
+    for(DataMemberList::const_iterator p = dataMembers.begin(); p != dataMembers.end(); ++p)
+    {
+        size_t sz;
+        size_t al;
+        if(!hasWireLayout((*p)->type(), sz, al))
+        {
+            return false;
+        }
+        size += sz;
+        alignment = max(alignment, al);
+    }
+    return size > 0;
+}
+
+bool
+Slice::getEncodedSize(const TypePtr& type, const string& param, const StringList& metaData, int typeCtx,
+                      size_t& size, StringList& terms)
+{
+    BuiltinPtr builtin = BuiltinPtr::dynamicCast(type);
+    if(builtin)
+    {
+        switch(builtin->kind())
+        {
+            case Builtin::KindString:
+            {
+                terms.push_back("::IceInternal::BasicStream::encodedSize(" + param + ")");
+                return true;
+            }
+            case Builtin::KindObject:
+            case Builtin::KindObjectProxy:
+            case Builtin::KindLocalObject:
+            {
+                return false;
+            }
+            default:
+            {
+                size += builtin->minWireSize();
+                return true;
+            }
+        }
+    }
+
+    EnumPtr en = EnumPtr::dynamicCast(type);
+    if(en)
+    {
+        size += en->minWireSize();
+        return true;
+    }
+
+    ostringstream os;
+
+    StructPtr st = StructPtr::dynamicCast(type);
+    if(st)
+    {
+        if(st->isLocal())
+        {
+            return false;
+        }
+        if(!st->isVariableLength())
+        {
+            size += st->minWireSize();
+            return true;
+        }
+
+        //
+        // The struct has a generated __encodedSize() member function
+        // if the sizes of all its data members can be computed.
+        //
+        DataMemberList dataMembers = st->dataMembers();
+        for(DataMemberList::const_iterator p = dataMembers.begin(); p != dataMembers.end(); ++p)
+        {
+            size_t sz = 0;
+            StringList l;
+            if(!getEncodedSize((*p)->type(), "", (*p)->getMetaData(), 0, sz, l))
+            {
+                return false;
+            }
+        }
+        terms.push_back(param + (findMetaData(st->getMetaData()) == "class" ? "->" : ".") + "__encodedSize()");
+        return true;
+    }
+
+    SequencePtr seq = SequencePtr::dynamicCast(type);
+    if(seq)
+    {
+        size_t elementSize = 0;
+        StringList elementTerms;
+        if(seq->isLocal() || !getEncodedSize(seq->type(), "", seq->typeMetaData(), 0, elementSize, elementTerms))
+        {
+            return false;
+        }
+
+        //
+        // The size of sequences of fixed-size elements is computed
+        // in place, the other sequences have a generated
+        // __encodedSize<Name>() function. Sequences mapped to ranges
+        // or to other types must have fixed-size elements.
+        //
+        string seqType = findMetaData(metaData, typeCtx);
+        if(seqType == "array" || seqType == "range:array")
+        {
+            if(!elementTerms.empty())
+            {
+                return false;
+            }
+            os << "::IceInternal::BasicStream::encodedSize(static_cast<size_t>(" << param << ".second - " << param
+               << ".first), " << elementSize << ")";
+        }
+        else if(seqType.find("range") == 0)
+        {
+            return false;
+        }
+        else if(elementTerms.empty())
+        {
+            bool protobuf;
+            findMetaData(seq, seq->getMetaData(), protobuf);
+            if(protobuf && seqType.empty())
+            {
+                return false;
+            }
+            os << "::IceInternal::BasicStream::encodedSize(" << param << ".size(), " << elementSize << ")";
+        }
+        else
+        {
+            bool protobuf;
+            findMetaData(seq, seq->getMetaData(), protobuf);
+            if(protobuf || !seqType.empty())
+            {
+                return false;
+            }
+            os << fixKwd(seq->scope()) << "__encodedSize" << fixKwd(seq->name()) << "(" << param << ")";
+        }
+        terms.push_back(os.str());
+        return true;
+    }
+
+    DictionaryPtr dict = DictionaryPtr::dynamicCast(type);
+    if(dict)
+    {
+        size_t elementSize = 0;
+        StringList elementTerms;
+        if(dict->isLocal() ||
+           !getEncodedSize(dict->keyType(), "", dict->keyMetaData(), 0, elementSize, elementTerms) ||
+           !getEncodedSize(dict->valueType(), "", dict->valueMetaData(), 0, elementSize, elementTerms))
+        {
+            return false;
+        }
+
+        if(elementTerms.empty())
+        {
+            os << "::IceInternal::BasicStream::encodedSize(" << param << ".size(), " << elementSize << ")";
+        }
+        else
+        {
+            os << fixKwd(dict->scope()) << "__encodedSize" << fixKwd(dict->name()) << "(" << param << ")";
+        }
+        terms.push_back(os.str());
+        return true;
+    }
+
+    //
+    // The size of class instances and proxies isn't known until they
+    // are marshaled.
+    //
+    return false;
+}
+
+string
+Slice::encodedSizeToString(size_t size, const StringList& terms)
+{
+    ostringstream os;
+    if(size > 0 || terms.empty())
+    {
+        os << size;
+    }
+    for(StringList::const_iterator p = terms.begin(); p != terms.end(); ++p)
+    {
+        if(p != terms.begin() || size > 0)
+        {
+            os << " + ";
+        }
+        os << *p;
+    }
+    return os.str();
+}
+
+void
+Slice::writeExpandCode(Output& out, const ParamDeclList& params, const TypePtr& ret, const StringList& metaData,
+                       int typeCtx)
+{
+    size_t size = 0;
+    StringList terms;
+    for(ParamDeclList::const_iterator p = params.begin(); p != params.end(); ++p)
+    {
+        getEncodedSize((*p)->type(), fixKwd((*p)->name()), (*p)->getMetaData(), typeCtx, size, terms);
+    }
+    if(ret)
+    {
+        getEncodedSize(ret, "__ret", metaData, typeCtx, size, terms);
+    }
+
+    //
+    // Parameters of fixed size fit in the initial buffer of the
+    // stream in practice, there's nothing to expand.
+    //
+    if(!terms.empty())
+    {
+        out << nl << "__os->expand(" << encodedSizeToString(size, terms) << ");";
+    }
+}
@@ -147,6 +147,97 @@ writeDataMemberInitializers(IceUtilInternal::Output& C, const DataMemberList& me
     }
 }
 
+//
+// Writes the switch statements which select the name of the given
+// length among the candidates, see writeNameLookup() below.
+//
+static void
+writeNameSwitch(IceUtilInternal::Output& C, const vector<string>& names, const list<int>& candidates,
+                string::size_type length, const string& array)
+{
+    assert(!candidates.empty());
+    if(candidates.size() == 1)
+    {
+        C << nl << "if(s == " << array << '[' << candidates.front() << "])";
+        C << sb;
+        C << nl << "return " << candidates.front() << ';';
+        C << eb;
+        return;
+    }
+
+    //
+    // Switch on the character which tells apart the most candidates.
+    //
+    string::size_type pos = 0;
+    size_t best = 0;
+    for(string::size_type i = 0; i < length; ++i)
+    {
+        set<char> chars;
+        for(list<int>::const_iterator q = candidates.begin(); q != candidates.end(); ++q)
+        {
+            chars.insert(names[*q][i]);
+        }
+        if(chars.size() > best)
+        {
+            best = chars.size();
+            pos = i;
+        }
+    }
+    assert(best > 1);
+
+    map<char, list<int> > groups;
+    for(list<int>::const_iterator q = candidates.begin(); q != candidates.end(); ++q)
+    {
+        groups[names[*q][pos]].push_back(*q);
+    }
+
+    C << nl << "switch(s[" << static_cast<int>(pos) << "])";
+    C << sb;
+    for(map<char, list<int> >::const_iterator q = groups.begin(); q != groups.end(); ++q)
+    {
+        C << nl << "case '" << q->first << "':";
+        C << sb;
+        writeNameSwitch(C, names, q->second, length, array);
+        C << nl << "break;";
+        C << eb;
+    }
+    C << eb;
+}
+
+//
+// Writes a function which returns the position of a string in the
+// given array of names, or -1 if the string isn't one of the names.
+// The names are told apart with a switch on the length of the string
+// and on the characters at which names of the same length differ, so
+// that only one string comparison is needed.
+//
+static void
+writeNameLookup(IceUtilInternal::Output& C, const string& function, const StringList& nameList, const string& array)
+{
+    vector<string> names(nameList.begin(), nameList.end());
+    map<string::size_type, list<int> > lengths;
+    for(int i = 0; i < static_cast<int>(names.size()); ++i)
+    {
+        lengths[names[i].size()].push_back(i);
+    }
+
+    C << sp << nl << "static int" << nl << function << "(const ::std::string& s)";
+    C << sb;
+    C << nl << "switch(s.size())";
+    C << sb;
+    for(map<string::size_type, list<int> >::const_iterator q = lengths.begin(); q != lengths.end(); ++q)
+    {
+        C << nl << "case " << static_cast<int>(q->first) << ':';
+        C << sb;
+        writeNameSwitch(C, names, q->second, q->first, array);
+        C << nl << "break;";
+        C << eb;
+    }
+    C << eb;
+    C << nl << "return -1;";
+    C << eb;
+}
+
 Slice::Gen::Gen(const string& base, const string& headerExtension, const string& sourceExtension,
                 const vector<string>& extraHeaders, const string& include,
                 const vector<string>& includePaths, const string& dllExport, const string& dir,
@@ -1225,6 +1316,18 @@ Slice::Gen::TypesVisitor::visitStructEnd(const StructPtr& p)
         H << sp << nl << dllExport << "void __write(::IceInternal::BasicStream*) const;";
         H << nl << dllExport << "void __read(::IceInternal::BasicStream*);";
 
+        //
+        // The encoded size of fixed-size structs is a constant, it's
+        // folded in the size of the enclosing types and parameters.
+        //
+        size_t size = 0;
+        StringList terms;
+        bool encodedSize = p->isVariableLength() && getEncodedSize(p, "", StringList(), 0, size, terms);
+        if(encodedSize)
+        {
+            H << nl << dllExport << "size_t __encodedSize() const;";
+        }
+
         if(_stream)
         {
             H.zeroIndent();
@@ -1254,6 +1357,20 @@ Slice::Gen::TypesVisitor::visitStructEnd(const StructPtr& p)
         }
         C << eb;
 
+        if(encodedSize)
+        {
+            size = 0;
+            terms.clear();
+            for(q = dataMembers.begin(); q != dataMembers.end(); ++q)
+            {
+                getEncodedSize((*q)->type(), fixKwd((*q)->name()), (*q)->getMetaData(), 0, size, terms);
+            }
+            C << sp << nl << "size_t" << nl << scoped.substr(2) << "::__encodedSize() const";
+            C << sb;
+            C << nl << "return " << encodedSizeToString(size, terms) << ';';
+            C << eb;
+        }
+
         if(_stream)
         {
             C << sp;
@@ -1424,6 +1541,28 @@ Slice::Gen::TypesVisitor::visitSequence(const SequencePtr& p)
         string scoped = fixKwd(p->scoped());
         string scope = fixKwd(p->scope());
 
+        //
+        // The encoded size of sequences of fixed-size elements is
+        // computed in place.
+        //
+        size_t size = 0;
+        StringList terms;
+        if(!protobuf && getEncodedSize(type, "(*p)", p->typeMetaData(), 0, size, terms) && !terms.empty())
+        {
+            H << nl << _dllExport << "size_t __encodedSize" << name << "(const " << name << "&);";
+
+            C << sp << nl << "size_t" << nl << scope.substr(2) << "__encodedSize" << name << "(const " << scoped
+              << "& v)";
+            C << sb;
+            C << nl << "size_t sz = ::IceInternal::BasicStream::encodedSize(v.size(), " << size << ");";
+            C << nl << "for(" << name << "::const_iterator p = v.begin(); p != v.end(); ++p)";
+            C << sb;
+            C << nl << "sz += " << encodedSizeToString(0, terms) << ';';
+            C << eb;
+            C << nl << "return sz;";
+            C << eb;
+        }
+
         if(protobuf || !seqType.empty())
         {
             string typeName = name;
@@ -1566,9 +1705,23 @@ Slice::Gen::TypesVisitor::visitSequence(const SequencePtr& p)
         }
         else if(!builtin || builtin->kind() == Builtin::KindObject || builtin->kind() == Builtin::KindObjectProxy)
         {
+            //
+            // The sequences of structs whose C++ layout can match the
+            // encoding are copied with a single memcpy if the layout
+            // matches for the C++ compiler and the platform.
+            //
+            size_t wireSize = 0;
+            size_t alignment = 0;
+            bool wireLayout = hasWireLayout(type, wireSize, alignment);
+
             H << nl << _dllExport << "void __write" << name << "(::IceInternal::BasicStream*, const " << s
               << "*, const " << s << "*);";
             H << nl << _dllExport << "void __read" << name << "(::IceInternal::BasicStream*, " << name << "&);";
+            if(wireLayout)
+            {
+                H << nl << _dllExport << "void __read" << name << "(::IceInternal::BasicStream*, ::std::pair<const "
+                  << s << "*, const " << s << "*>&, " << name << "&);";
+            }
 
             if(_stream)
             {
@@ -1590,6 +1743,21 @@ Slice::Gen::TypesVisitor::visitSequence(const SequencePtr& p)
             C << sb;
             C << nl << "::Ice::Int size = static_cast< ::Ice::Int>(end - begin);";
             C << nl << "__os->writeSize(size);";
+            if(wireLayout)
+            {
+                C.zeroIndent();
+                C << nl << "#ifdef ICE_NATIVE_WIRE_LAYOUT";
+                C.restoreIndent();
+                C << nl << "if(sizeof(" << s << ") == " << wireSize << ")";
+                C << sb;
+                C << nl << "__os->writeBlob(reinterpret_cast<const ::Ice::Byte*>(begin), static_cast<size_t>(size) * "
+                  << wireSize << ");";
+                C << nl << "return;";
+                C << eb;
+                C.zeroIndent();
+                C << nl << "#endif";
+                C.restoreIndent();
+            }
             C << nl << "for(int i = 0; i < size; ++i)";
             C << sb;
             writeMarshalUnmarshalCode(C, type, "begin[i]", true);
@@ -1602,12 +1770,73 @@ Slice::Gen::TypesVisitor::visitSequence(const SequencePtr& p)
             C << nl << "::Ice::Int sz;";
             C << nl << "__is->readAndCheckSeqSize(" << type->minWireSize() << ", sz);";
             C << nl << "v.resize(sz);";
+            if(wireLayout)
+            {
+                C.zeroIndent();
+                C << nl << "#ifdef ICE_NATIVE_WIRE_LAYOUT";
+                C.restoreIndent();
+                C << nl << "if(sizeof(" << s << ") == " << wireSize << ")";
+                C << sb;
+                C << nl << "const ::Ice::Byte* data;";
+                C << nl << "__is->readBlob(data, static_cast<size_t>(sz) * " << wireSize << ");";
+                C << nl << "if(sz > 0)";
+                C << sb;
+                C << nl << "memcpy(&v[0], data, static_cast<size_t>(sz) * " << wireSize << ");";
+                C << eb;
+                C << nl << "return;";
+                C << eb;
+                C.zeroIndent();
+                C << nl << "#endif";
+                C.restoreIndent();
+            }
             C << nl << "for(int i = 0; i < sz; ++i)";
             C << sb;
             writeMarshalUnmarshalCode(C, type, "v[i]", false);
             C << eb;
             C << eb;
 
+            if(wireLayout)
+            {
+                //
+                // For ["cpp:array"] parameters, the sequence is read
+                // in place from the stream if the data is aligned,
+                // otherwise it's copied to the given vector.
+                //
+                C << sp << nl << "void" << nl << scope.substr(2) << "__read" << name
+                  << "(::IceInternal::BasicStream* __is, ::std::pair<const " << s << "*, const " << s << "*>& v, "
+                  << scoped << "& __tmp)";
+                C << sb;
+                C.zeroIndent();
+                C << nl << "#ifdef ICE_NATIVE_WIRE_LAYOUT";
+                C.restoreIndent();
+                C << nl << "if(sizeof(" << s << ") == " << wireSize << ")";
+                C << sb;
+                C << nl << "::Ice::Int sz;";
+                C << nl << "__is->readAndCheckSeqSize(" << type->minWireSize() << ", sz);";
+                C << nl << "const ::Ice::Byte* data;";
+                C << nl << "__is->readBlob(data, static_cast<size_t>(sz) * " << wireSize << ");";
+                if(alignment > 1)
+                {
+                    C << nl << "if(sz > 0 && (reinterpret_cast<size_t>(data) & " << alignment - 1 << ") != 0)";
+                    C << sb;
+                    C << nl << scoped << "(sz).swap(__tmp);";
+                    C << nl << "memcpy(&__tmp[0], data, static_cast<size_t>(sz) * " << wireSize << ");";
+                    C << nl << "data = reinterpret_cast<const ::Ice::Byte*>(&__tmp[0]);";
+                    C << eb;
+                }
+                C << nl << "v.first = reinterpret_cast<const " << s << "*>(data);";
+                C << nl << "v.second = v.first + sz;";
+                C << nl << "return;";
+                C << eb;
+                C.zeroIndent();
+                C << nl << "#endif";
+                C.restoreIndent();
+                C << nl << "__read" << name << "(__is, __tmp);";
+                C << nl << "v.first = __tmp.empty() ? 0 : &__tmp[0];";
+                C << nl << "v.second = v.first + __tmp.size();";
+                C << eb;
+            }
+
             if(_stream)
             {
                 C << sp;
@@ -1682,6 +1911,29 @@ Slice::Gen::TypesVisitor::visitDictionary(const DictionaryPtr& p)
         H << nl << _dllExport << "void __write" << name << "(::IceInternal::BasicStream*, const " << name << "&);";
         H << nl << _dllExport << "void __read" << name << "(::IceInternal::BasicStream*, " << name << "&);";
 
+        //
+        // The encoded size of dictionaries of fixed-size keys and
+        // values is computed in place.
+        //
+        size_t size = 0;
+        StringList terms;
+        if(getEncodedSize(keyType, "p->first", p->keyMetaData(), 0, size, terms) &&
+           getEncodedSize(valueType, "p->second", p->valueMetaData(), 0, size, terms) && !terms.empty())
+        {
+            H << nl << _dllExport << "size_t __encodedSize" << name << "(const " << name << "&);";
+
+            C << sp << nl << "size_t" << nl << scope.substr(2) << "__encodedSize" << name << "(const " << scoped
+              << "& v)";
+            C << sb;
+            C << nl << "size_t sz = ::IceInternal::BasicStream::encodedSize(v.size(), " << size << ");";
+            C << nl << "for(" << scoped << "::const_iterator p = v.begin(); p != v.end(); ++p)";
+            C << sb;
+            C << nl << "sz += " << encodedSizeToString(0, terms) << ';';
+            C << eb;
+            C << nl << "return sz;";
+            C << eb;
+        }
+
         if(_stream)
         {
             H.zeroIndent();
@@ -2634,6 +2886,7 @@ Slice::Gen::ProxyVisitor::visitOperation(const OperationPtr& p)
     C << sb;
     C << nl << "__result->__prepare(" << flatName << ", " << operationModeToString(p->sendMode()) << ", __ctx);";
     C << nl << "::IceInternal::BasicStream* __os = __result->__getOs();";
+    writeExpandCode(C, inParams, 0, StringList(), true);
     writeMarshalCode(C, inParams, 0, StringList(), true);
     if(p->sendsClasses())
     {
@@ -3188,6 +3441,7 @@ Slice::Gen::DelegateMVisitor::visitOperation(const OperationPtr& p)
         C << nl << "try";
         C << sb;
         C << nl << "::IceInternal::BasicStream* __os = __og.os();";
+        writeExpandCode(C, inParams, 0, StringList(), true);
         writeMarshalCode(C, inParams, 0, StringList(), true);
         if(p->sendsClasses())
         {
@@ -4039,11 +4293,13 @@ Slice::Gen::ObjectVisitor::visitClassDefStart(const ClassDefPtr& p)
         }
         C << eb << ';';
 
+        writeNameLookup(C, flatName + "_find", ids, flatName);
+
         C << sp;
         C << nl << "bool" << nl << scoped.substr(2)
           << "::ice_isA(const ::std::string& _s, const ::Ice::Current&) const";
         C << sb;
-        C << nl << "return ::std::binary_search(" << flatName << ", " << flatName << " + " << ids.size() << ", _s);";
+        C << nl << "return " << flatName << "_find(_s) >= 0;";
         C << eb;
 
         C << sp;
@@ -4129,21 +4385,14 @@ Slice::Gen::ObjectVisitor::visitClassDefEnd(const ClassDefPtr& p)
                 }
             }
             C << eb << ';';
+
+            writeNameLookup(C, flatName + "_find", allOpNames, flatName);
+
             C << sp;
             C << nl << "::Ice::DispatchStatus" << nl << scoped.substr(2)
               << "::__dispatch(::IceInternal::Incoming& in, const ::Ice::Current& current)";
             C << sb;
-
-            C << nl << "::std::pair< ::std::string*, ::std::string*> r = "
-              << "::std::equal_range(" << flatName << ", " << flatName << " + " << allOpNames.size()
-              << ", current.operation);";
-            C << nl << "if(r.first == r.second)";
-            C << sb;
-            C << nl << "throw ::Ice::OperationNotExistException(__FILE__, __LINE__, current.id, "
-              << "current.facet, current.operation);";
-            C << eb;
-            C << sp;
-            C << nl << "switch(r.first - " << flatName << ')';
+            C << nl << "switch(" << flatName << "_find(current.operation))";
             C << sb;
             int i = 0;
             for(q = allOpNames.begin(); q != allOpNames.end(); ++q)
@@ -4155,7 +4404,6 @@ Slice::Gen::ObjectVisitor::visitClassDefEnd(const ClassDefPtr& p)
             }
             C << eb;
             C << sp;
-            C << nl << "assert(false);";
             C << nl << "throw ::Ice::OperationNotExistException(__FILE__, __LINE__, current.id, "
               << "current.facet, current.operation);";
             C << eb;
@@ -4212,15 +4460,13 @@ Slice::Gen::ObjectVisitor::visitClassDefEnd(const ClassDefPtr& p)
                   << "::ice_operationAttributes(const ::std::string& opName) const";
                 C << sb;
 
-                C << nl << "::std::pair< ::std::string*, ::std::string*> r = "
-                  << "::std::equal_range(" << flatName << ", " << flatName << " + " << allOpNames.size()
-                  << ", opName);";
-                C << nl << "if(r.first == r.second)";
+                C << nl << "int pos = " << flatName << "_find(opName);";
+                C << nl << "if(pos < 0)";
                 C << sb;
                 C << nl << "return -1;";
                 C << eb;
 
-                C << nl << "return " << opAttrFlatName << "[r.first - " << flatName << "];";
+                C << nl << "return " << opAttrFlatName << "[pos];";
                 C << eb;
             }
         }
@@ -4719,6 +4965,7 @@ Slice::Gen::ObjectVisitor::visitOperation(const OperationPtr& p)
                 C << retS << " __ret = ";
             }
             C << fixKwd(name) << args << ';';
+            writeExpandCode(C, outParams, ret, p->getMetaData());
             writeMarshalCode(C, outParams, ret, p->getMetaData());
             if(p->returnsClasses())
             {
@@ -6593,6 +6840,7 @@ Slice::Gen::AsyncImplVisitor::visitOperation(const OperationPtr& p)
         C << nl << "try";
         C << sb;
         C << nl << "::IceInternal::BasicStream* __os = this->__os();";
+        writeExpandCode(C, outParams, ret, p->getMetaData(), true);
         writeMarshalCode(C, outParams, 0, StringList(), true);
         if(ret)
         {
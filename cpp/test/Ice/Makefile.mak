@@ -38,13 +38,23 @@ SUBDIRS		= proxy \
 		  defaultValue \
 		  threadPoolPriority \
 		  stream \
+		  requestTable \
+		  bufferPool \
+		  codec \
+		  chunkedTransfer \
+		  servantManager \
+		  classGraph \
 
 !if "$(CPP_COMPILER)" != "VC60"
 SUBDIRS		= $(SUBDIRS) \
 		  ami \
 		  custom \
 		  invoke \
-		  properties
+		  properties \
+		  collocatedAsync \
+		  connectionPool \
+		  metrics \
+		  dispatchPriority
 !endif
 
 $(EVERYTHING)::
@@ -0,0 +1,303 @@
+// **********************************************************************
+//
+// Copyright (c) 2003-2011 ZeroC, Inc. All rights reserved.
+//
+// This copy of Ice is licensed to you under the terms described in the
+// ICE_LICENSE file included in this distribution.
+//
+// **********************************************************************
+
+#include <IceUtil/IceUtil.h>
+#include <Ice/Ice.h>
+#include <Ice/Buffer.h>
+#include <Ice/BufferPool.h>
+#include <TestCommon.h>
+
+using namespace std;
+using namespace IceInternal;
+
+namespace
+{
+
+BufferPoolPtr
+createPool(int maxSize = 64, int highWater = 4096)
+{
+    Ice::PropertiesPtr properties = Ice::createProperties();
+    ostringstream os;
+    os << maxSize;
+    properties->setProperty("Ice.BufferPool.MaxSize", os.str());
+    os.str("");
+    os << highWater;
+    properties->setProperty("Ice.BufferPool.HighWater", os.str());
+    return new BufferPool(properties);
+}
+
+void
+fill(Ice::Byte* p, size_t sz, int seed)
+{
+    for(size_t i = 0; i < sz; ++i)
+    {
+        p[i] = static_cast<Ice::Byte>(i * 7 + seed);
+    }
+}
+
+bool
+check(const Ice::Byte* p, size_t sz, int seed)
+{
+    for(size_t i = 0; i < sz; ++i)
+    {
+        if(p[i] != static_cast<Ice::Byte>(i * 7 + seed))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+}
+
+int
+main(int, char**)
+{
+    //
+    // The statistics of the pool are summed over its shards, and this
+    // test allocates and releases all the buffers from the same
+    // thread, so the buffers it releases are found by its next
+    // allocations.
+    //
+    cout << "testing size classes... " << flush;
+    {
+        BufferPoolPtr pool = createPool();
+        const size_t sizes[] = { 1, 255, 256, 257, 1000, 1024, 4097, 65535, 65536 };
+        const size_t classes[] = { 256, 256, 256, 512, 1024, 1024, 8192, 65536, 65536 };
+        for(size_t i = 0; i < sizeof(sizes) / sizeof(size_t); ++i)
+        {
+            size_t capacity = 0;
+            Ice::Byte* p = pool->allocate(sizes[i], capacity);
+            test(p && capacity == classes[i]);
+            fill(p, capacity, static_cast<int>(i));
+            pool->release(p, capacity);
+        }
+
+        BufferPool::Stats stats = pool->stats();
+        test(stats.allocations == 9 && stats.releases == 9 && stats.discarded == 0 && stats.unpooled == 0);
+        test(stats.hits == 4); // 255, 256, 1024 and 65536 bytes.
+    }
+    cout << "ok" << endl;
+
+    cout << "testing buffer reuse... " << flush;
+    {
+        BufferPoolPtr pool = createPool();
+        size_t capacity;
+        Ice::Byte* p = pool->allocate(100, capacity);
+        test(capacity == 256);
+        pool->release(p, capacity);
+        test(pool->stats().cachedBytes == 256);
+
+        //
+        // A buffer of another size class doesn't reuse the cached
+        // buffer, a buffer of the same class does.
+        //
+        size_t capacity2;
+        Ice::Byte* q = pool->allocate(300, capacity2);
+        test(q != p && capacity2 == 512);
+        test(pool->stats().hits == 0 && pool->stats().cachedBytes == 256);
+
+        Ice::Byte* r = pool->allocate(200, capacity);
+        test(r == p && capacity == 256);
+        test(pool->stats().hits == 1 && pool->stats().cachedBytes == 0);
+
+        pool->release(q, capacity2);
+        pool->release(r, capacity);
+        test(pool->stats().cachedBytes == 768);
+        test(pool->allocate(512, capacity) == q && capacity == 512);
+        pool->release(q, capacity);
+    }
+    cout << "ok" << endl;
+
+    cout << "testing reallocation... " << flush;
+    {
+        BufferPoolPtr pool = createPool();
+        size_t capacity;
+        Ice::Byte* p = pool->allocate(256, capacity);
+        fill(p, capacity, 1);
+
+        //
+        // Within the same size class, the buffer is kept.
+        //
+        size_t newCapacity;
+        test(pool->reallocate(p, capacity, 256, 200, newCapacity) == p && newCapacity == 256);
+
+        //
+        // Growing and shrinking across size classes preserves the used
+        // bytes and releases the previous buffer to the pool.
+        //
+        Ice::Byte* q = pool->reallocate(p, capacity, 256, 1000, newCapacity);
+        test(q && q != p && newCapacity == 1024);
+        test(check(q, 256, 1));
+        test(pool->stats().cachedBytes == 256);
+        capacity = newCapacity;
+        fill(q, capacity, 2);
+
+        Ice::Byte* r = pool->reallocate(q, capacity, 300, 300, newCapacity);
+        test(r && newCapacity == 512);
+        test(check(r, 300, 2));
+        test(pool->stats().cachedBytes == 256 + 1024);
+        capacity = newCapacity;
+
+        //
+        // Shrinking to a smaller class reuses the cached buffer.
+        //
+        Ice::Byte* s = pool->reallocate(r, capacity, 100, 100, newCapacity);
+        test(s == p && newCapacity == 256);
+        test(check(s, 100, 2));
+        pool->release(s, newCapacity);
+
+        //
+        // Reallocating a null buffer allocates it.
+        //
+        Ice::Long allocations = pool->stats().allocations;
+        s = pool->reallocate(0, 0, 0, 100, newCapacity);
+        test(s && newCapacity == 256 && pool->stats().allocations == allocations + 1);
+        pool->release(s, newCapacity);
+    }
+    cout << "ok" << endl;
+
+    cout << "testing unpooled buffers... " << flush;
+    {
+        //
+        // Buffers larger than Ice.BufferPool.MaxSize bypass the pool.
+        //
+        BufferPoolPtr pool = createPool(4);
+        size_t capacity;
+        Ice::Byte* p = pool->allocate(4097, capacity);
+        test(p && capacity == 4097);
+        BufferPool::Stats stats = pool->stats();
+        test(stats.unpooled == 1 && stats.allocations == 0);
+        fill(p, capacity, 3);
+
+        size_t newCapacity;
+        Ice::Byte* q = pool->reallocate(p, capacity, 4097, 10000, newCapacity);
+        test(q && newCapacity == 10000);
+        test(check(q, 4097, 3));
+        test(pool->stats().cachedBytes == 0);
+        capacity = newCapacity;
+
+        //
+        // Shrinking to a pooled size moves the data to a pooled buffer,
+        // the large buffer isn't cached once released.
+        //
+        Ice::Byte* r = pool->reallocate(q, capacity, 1000, 1000, newCapacity);
+        test(r && newCapacity == 1024);
+        test(check(r, 1000, 3));
+        test(pool->stats().cachedBytes == 0);
+
+        Ice::Byte* s = pool->reallocate(r, newCapacity, 1000, 5000, capacity);
+        test(s && capacity == 5000);
+        test(check(s, 1000, 3));
+        test(pool->stats().cachedBytes == 1024);
+
+        pool->release(s, capacity);
+        stats = pool->stats();
+        test(stats.cachedBytes == 1024 && stats.discarded == 0);
+    }
+    cout << "ok" << endl;
+
+    cout << "testing high-water mark... " << flush;
+    {
+        //
+        // The high-water mark is split between the 16 shards: a shard
+        // caches at most 1KB.
+        //
+        BufferPoolPtr pool = createPool(64, 16);
+        vector<Ice::Byte*> buffers;
+        size_t capacity;
+        for(int i = 0; i < 4; ++i)
+        {
+            buffers.push_back(pool->allocate(512, capacity));
+        }
+        for(vector<Ice::Byte*>::const_iterator p = buffers.begin(); p != buffers.end(); ++p)
+        {
+            pool->release(*p, capacity);
+        }
+        BufferPool::Stats stats = pool->stats();
+        test(stats.releases == 4 && stats.discarded == 2 && stats.cachedBytes == 1024);
+    }
+    cout << "ok" << endl;
+
+    cout << "testing shared buffers... " << flush;
+    {
+        BufferPoolPtr pool = createPool();
+        {
+            //
+            // The memory of a shared container remains valid and
+            // isn't returned to the pool until the last handle is
+            // released, whether the container is cleared or swapped.
+            //
+            Buffer buf(1024 * 1024, pool.get());
+            buf.b.resize(100);
+            fill(buf.b.begin(), 100, 4);
+            const Ice::Byte* data = buf.b.begin();
+            SharedBufferPtr shared = buf.b.share();
+            test(shared && buf.b.share().get() == shared.get());
+
+            buf.b.clear();
+            test(buf.b.empty());
+            test(check(data, 100, 4));
+            test(pool->stats().cachedBytes == 0);
+            shared = 0;
+            test(pool->stats().cachedBytes == 256);
+
+            buf.b.resize(100);
+            fill(buf.b.begin(), 100, 5);
+            data = buf.b.begin();
+            shared = buf.b.share();
+
+            Buffer other(1024 * 1024);
+            buf.swapBuffer(other);
+            test(buf.b.empty() && other.b.begin() == data);
+            other.b.clear();
+            test(check(data, 100, 5));
+            test(pool->stats().cachedBytes == 0);
+            shared = 0;
+            test(pool->stats().cachedBytes == 256);
+        }
+
+        {
+            //
+            // Resizing or reusing a shared container copies its content
+            // into new memory, the shared memory isn't modified.
+            //
+            Buffer buf(1024 * 1024, pool.get());
+            buf.b.resize(100);
+            fill(buf.b.begin(), 100, 6);
+            const Ice::Byte* data = buf.b.begin();
+            SharedBufferPtr shared = buf.b.share();
+
+            buf.b.resize(200);
+            test(buf.b.begin() != data);
+            test(check(buf.b.begin(), 100, 6));
+            fill(buf.b.begin(), 200, 7);
+            test(check(data, 100, 6));
+
+            data = buf.b.begin();
+            shared = buf.b.share();
+            buf.b.reset();
+            test(buf.b.empty());
+            buf.b.resize(50);
+            test(buf.b.begin() != data);
+            fill(buf.b.begin(), 50, 8);
+            test(check(data, 200, 7));
+            shared = 0;
+        }
+
+        //
+        // All the memory was returned to the pool.
+        //
+        BufferPool::Stats stats = pool->stats();
+        test(stats.releases == stats.allocations);
+    }
+    cout << "ok" << endl;
+
+    return EXIT_SUCCESS;
+}
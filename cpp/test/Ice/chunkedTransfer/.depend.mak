@@ -0,0 +1 @@
+Client$(OBJEXT): Client.cpp "$(includedir)/IceUtil/IceUtil.h" "$(includedir)/Ice/Ice.h" "$(includedir)/Ice/ChunkedTransfer.h" ../../include/TestCommon.h
@@ -0,0 +1,372 @@
+// **********************************************************************
+//
+// Copyright (c) 2003-2011 ZeroC, Inc. All rights reserved.
+//
+// This copy of Ice is licensed to you under the terms described in the
+// ICE_LICENSE file included in this distribution.
+//
+// **********************************************************************
+
+#include <IceUtil/IceUtil.h>
+#include <Ice/Ice.h>
+#include <TestCommon.h>
+
+using namespace std;
+using namespace Ice;
+
+namespace
+{
+
+inline Byte
+pattern(Long offset)
+{
+    return static_cast<Byte>((offset * 31) ^ (offset >> 13));
+}
+
+class TestError
+{
+};
+
+//
+// Produces size bytes of a known pattern, optionally failing or
+// pausing after the given number of chunks. If lastWithData is true,
+// the call producing the last data returns false.
+//
+class ProducerI : public ChunkProducer
+{
+public:
+
+    ProducerI(Long size, int failAfter = -1, bool lastWithData = false, int pauseAfter = -1) :
+        _size(size),
+        _offset(0),
+        _failAfter(failAfter),
+        _lastWithData(lastWithData),
+        _pauseAfter(pauseAfter)
+    {
+    }
+
+    virtual bool
+    produce(vector<Byte>& chunk, size_t chunkSize)
+    {
+        if(_failAfter == 0)
+        {
+            throw TestError();
+        }
+        --_failAfter;
+
+        if(_pauseAfter-- == 0)
+        {
+            IceUtil::ThreadControl::sleep(IceUtil::Time::milliSeconds(2500));
+        }
+
+        if(_offset == _size)
+        {
+            return false;
+        }
+        size_t sz = static_cast<size_t>(min(static_cast<Long>(chunkSize), _size - _offset));
+        chunk.resize(sz);
+        for(size_t i = 0; i < sz; ++i)
+        {
+            chunk[i] = pattern(_offset++);
+        }
+        return !_lastWithData || _offset < _size;
+    }
+
+private:
+
+    const Long _size;
+    Long _offset;
+    int _failAfter;
+    const bool _lastWithData;
+    int _pauseAfter;
+};
+
+//
+// Checks that the chunks are consumed in order.
+//
+class ConsumerI : public ChunkConsumer, public IceUtil::Mutex
+{
+public:
+
+    ConsumerI(int failAfter) :
+        _size(0),
+        _chunks(0),
+        _failAfter(failAfter),
+        _finished(false),
+        _aborted(false),
+        _valid(true)
+    {
+    }
+
+    virtual void
+    consume(const pair<const Byte*, const Byte*>& chunk, const Current& current)
+    {
+        IceUtil::Mutex::Lock sync(*this);
+        _context = current.ctx;
+        if(_chunks++ == _failAfter)
+        {
+            throw TestError();
+        }
+        for(const Byte* p = chunk.first; p != chunk.second; ++p)
+        {
+            _valid = _valid && *p == pattern(_size++);
+        }
+    }
+
+    virtual void
+    finished(const Current&)
+    {
+        IceUtil::Mutex::Lock sync(*this);
+        _finished = true;
+    }
+
+    virtual void
+    aborted(const Current&)
+    {
+        IceUtil::Mutex::Lock sync(*this);
+        _aborted = true;
+    }
+
+    void
+    check(Long size, bool finished, bool aborted)
+    {
+        IceUtil::Mutex::Lock sync(*this);
+        test(_valid);
+        test(!finished || _size == size);
+        test(_finished == finished);
+        test(_aborted == aborted);
+    }
+
+    Context
+    context()
+    {
+        IceUtil::Mutex::Lock sync(*this);
+        return _context;
+    }
+
+private:
+
+    Long _size;
+    int _chunks;
+    const int _failAfter;
+    bool _finished;
+    bool _aborted;
+    bool _valid;
+    Context _context;
+};
+typedef IceUtil::Handle<ConsumerI> ConsumerIPtr;
+
+class ReceiverI : public ChunkReceiver, public IceUtil::Mutex
+{
+public:
+
+    //
+    // Transfers expire after one second without chunks.
+    //
+    ReceiverI() :
+        ChunkReceiver(IceUtil::Time::seconds(1)),
+        _failAfter(-1)
+    {
+    }
+
+    virtual ChunkConsumerPtr
+    createConsumer(const Current&)
+    {
+        IceUtil::Mutex::Lock sync(*this);
+        _consumer = new ConsumerI(_failAfter);
+        return _consumer;
+    }
+
+    void
+    failAfter(int chunks)
+    {
+        IceUtil::Mutex::Lock sync(*this);
+        _failAfter = chunks;
+    }
+
+    ConsumerIPtr
+    consumer()
+    {
+        IceUtil::Mutex::Lock sync(*this);
+        return _consumer;
+    }
+
+private:
+
+    int _failAfter;
+    ConsumerIPtr _consumer;
+};
+typedef IceUtil::Handle<ReceiverI> ReceiverIPtr;
+
+}
+
+int
+main(int argc, char* argv[])
+{
+    //
+    // The receiver only accepts messages up to 1MB and dispatches
+    // with several threads, so chunks may be dispatched out of order.
+    //
+    InitializationData initData;
+    initData.properties = createProperties(argc, argv);
+    initData.properties->setProperty("Ice.MessageSizeMax", "1024");
+    initData.properties->setProperty("Ice.ThreadPool.Server.Size", "4");
+    initData.properties->setProperty("Ice.Warn.Dispatch", "0");
+    initData.properties->setProperty("TestAdapter.Endpoints", "tcp -h 127.0.0.1 -p 12010");
+    CommunicatorPtr server = initialize(initData);
+    ObjectAdapterPtr adapter = server->createObjectAdapter("TestAdapter");
+    ReceiverIPtr receiver = new ReceiverI;
+    adapter->add(receiver, server->stringToIdentity("receiver"));
+    adapter->activate();
+
+    initData.properties = createProperties();
+    initData.properties->setProperty("Ice.MessageSizeMax", "1024");
+    CommunicatorPtr client = initialize(initData);
+    ObjectPrx proxy = client->stringToProxy("receiver:tcp -h 127.0.0.1 -p 12010");
+
+    cout << "testing chunked transfers... " << flush;
+    {
+        proxy->ice_ping();
+
+        test(sendChunked(proxy, new ProducerI(0)) == 0);
+        receiver->consumer()->check(0, true, false);
+
+        test(sendChunked(proxy, new ProducerI(1)) == 1);
+        receiver->consumer()->check(1, true, false);
+
+        test(sendChunked(proxy, new ProducerI(1000), 1000) == 1000);
+        receiver->consumer()->check(1000, true, false);
+
+        test(sendChunked(proxy, new ProducerI(1001), 10, 1) == 1001);
+        receiver->consumer()->check(1001, true, false);
+
+        //
+        // Much larger than Ice.MessageSizeMax.
+        //
+        const Long size = 16 * 1024 * 1024 + 17;
+        test(sendChunked(proxy, new ProducerI(size)) == size);
+        receiver->consumer()->check(size, true, false);
+
+        test(sendChunked(proxy, new ProducerI(size), 4096, 64) == size);
+        receiver->consumer()->check(size, true, false);
+
+        //
+        // The producer returns false along with the last data.
+        //
+        test(sendChunked(proxy, new ProducerI(0, -1, true)) == 0);
+        receiver->consumer()->check(0, true, false);
+
+        test(sendChunked(proxy, new ProducerI(1, -1, true)) == 1);
+        receiver->consumer()->check(1, true, false);
+
+        test(sendChunked(proxy, new ProducerI(1000, -1, true), 100) == 1000);
+        receiver->consumer()->check(1000, true, false);
+
+        test(sendChunked(proxy, new ProducerI(1001, -1, true), 100, 2) == 1001);
+        receiver->consumer()->check(1001, true, false);
+    }
+    cout << "ok" << endl;
+
+    cout << "testing request context... " << flush;
+    {
+        //
+        // The transfer doesn't use the request context, the consumer
+        // gets the context of the proxy.
+        //
+        test(sendChunked(proxy, new ProducerI(1000), 100) == 1000);
+        test(receiver->consumer()->context().empty());
+
+        Context ctx;
+        ctx["app"] = "1";
+        test(sendChunked(proxy->ice_context(ctx), new ProducerI(1000), 100) == 1000);
+        receiver->consumer()->check(1000, true, false);
+        test(receiver->consumer()->context() == ctx);
+    }
+    cout << "ok" << endl;
+
+    cout << "testing aborted transfers... " << flush;
+    {
+        receiver->failAfter(10);
+        try
+        {
+            sendChunked(proxy, new ProducerI(1024 * 1024), 1024);
+            test(false);
+        }
+        catch(const UnknownException&)
+        {
+        }
+        receiver->consumer()->check(0, false, true);
+        receiver->failAfter(-1);
+
+        try
+        {
+            sendChunked(proxy, new ProducerI(1024 * 1024, 20), 1024, 4);
+            test(false);
+        }
+        catch(const TestError&)
+        {
+        }
+        receiver->consumer()->check(0, false, true);
+
+        try
+        {
+            sendChunked(proxy, new ProducerI(1024), 0);
+            test(false);
+        }
+        catch(const IceUtil::IllegalArgumentException&)
+        {
+        }
+
+        try
+        {
+            sendChunked(proxy->ice_identity(client->stringToIdentity("unknown")), new ProducerI(1024 * 1024), 1024);
+            test(false);
+        }
+        catch(const ObjectNotExistException&)
+        {
+        }
+    }
+    cout << "ok" << endl;
+
+    cout << "testing expired transfers... " << flush;
+    {
+        //
+        // The producer pauses longer than the idle timeout of the
+        // receiver, which aborts the transfer and rejects the next
+        // chunk as it is outside of the window of a new transfer.
+        //
+        try
+        {
+            sendChunked(proxy, new ProducerI(1024 * 1024, -1, false, 10), 1024, 4);
+            test(false);
+        }
+        catch(const UnknownLocalException&)
+        {
+        }
+        receiver->consumer()->check(0, false, true);
+    }
+    cout << "ok" << endl;
+
+    cout << "measuring throughput:" << endl;
+    {
+        const Long size = 64 * 1024 * 1024;
+        const size_t chunkSizes[] = { 16 * 1024, 256 * 1024 };
+        const int windows[] = { 1, 8 };
+        for(unsigned int i = 0; i < sizeof(chunkSizes) / sizeof(size_t); ++i)
+        {
+            for(unsigned int j = 0; j < sizeof(windows) / sizeof(int); ++j)
+            {
+                IceUtil::Time start = IceUtil::Time::now(IceUtil::Time::Monotonic);
+                test(sendChunked(proxy, new ProducerI(size), chunkSizes[i], windows[j]) == size);
+                IceUtil::Time elapsed = IceUtil::Time::now(IceUtil::Time::Monotonic) - start;
+                receiver->consumer()->check(size, true, false);
+                cout << "  " << chunkSizes[i] / 1024 << "KB chunks, window " << windows[j] << ": "
+                     << size / (1024 * 1024) / elapsed.toSecondsDouble() << "MB/s" << endl;
+            }
+        }
+    }
+
+    client->destroy();
+    server->destroy();
+    return EXIT_SUCCESS;
+}
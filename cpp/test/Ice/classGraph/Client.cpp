@@ -0,0 +1,215 @@
+// **********************************************************************
+//
+// Copyright (c) 2003-2011 ZeroC, Inc. All rights reserved.
+//
+// This copy of Ice is licensed to you under the terms described in the
+// ICE_LICENSE file included in this distribution.
+//
+// **********************************************************************
+
+#include <IceUtil/IceUtil.h>
+#include <Ice/Ice.h>
+#include <Ice/BasicStream.h>
+#include <Ice/Instance.h>
+#include <TestCommon.h>
+#include <Test.h>
+
+using namespace std;
+using namespace Test;
+
+namespace
+{
+
+//
+// Returns the nodes of a complete binary tree, the children of node
+// i are the nodes 2i + 1 and 2i + 2.
+//
+NodeSeq
+createTree(int size)
+{
+    NodeSeq seq;
+    for(int i = 0; i < size; ++i)
+    {
+        seq.push_back(new Node(i, 0, 0));
+    }
+    for(int i = 0; i < size; ++i)
+    {
+        if(2 * i + 1 < size)
+        {
+            seq[i]->left = seq[2 * i + 1];
+        }
+        if(2 * i + 2 < size)
+        {
+            seq[i]->right = seq[2 * i + 2];
+        }
+    }
+    return seq;
+}
+
+void
+checkTree(const NodeSeq& seq, int size)
+{
+    test(static_cast<int>(seq.size()) == size);
+    for(int i = 0; i < size; ++i)
+    {
+        test(seq[i]->value == i);
+        test(seq[i]->left.get() == (2 * i + 1 < size ? seq[2 * i + 1].get() : 0));
+        test(seq[i]->right.get() == (2 * i + 2 < size ? seq[2 * i + 2].get() : 0));
+    }
+}
+
+void
+writeTree(IceInternal::BasicStream& os, const NodeSeq& seq)
+{
+    os.startWriteEncaps();
+    __writeNodeSeq(&os, &seq[0], &seq[0] + seq.size());
+    os.writePendingObjects();
+    os.endWriteEncaps();
+}
+
+void
+readTree(IceInternal::BasicStream& is, NodeSeq& seq)
+{
+    is.startReadEncaps();
+    __readNodeSeq(&is, seq);
+    is.readPendingObjects();
+    is.endReadEncaps();
+}
+
+}
+
+int
+run(int, char**, const Ice::CommunicatorPtr& communicator)
+{
+    IceInternal::InstancePtr instance = IceInternal::getInstance(communicator);
+
+    cout << "testing class graphs... " << flush;
+    {
+        NodeSeq seq = createTree(1000);
+
+        //
+        // Several encapsulations on the same stream reuse the tables
+        // of the first one, the instance and type id indexes of each
+        // encapsulation must start over.
+        //
+        IceInternal::BasicStream os(instance.get());
+        for(int i = 0; i < 3; ++i)
+        {
+            writeTree(os, seq);
+        }
+
+        IceInternal::BasicStream is(instance.get());
+        is.swap(os);
+        is.i = is.b.begin();
+        for(int i = 0; i < 3; ++i)
+        {
+            NodeSeq result;
+            readTree(is, result);
+            checkTree(result, 1000);
+            test(result[0].get() != seq[0].get());
+        }
+        test(is.i == is.b.end());
+    }
+
+    {
+        //
+        // An encapsulation nested in the marshaling of another one
+        // uses its own tables.
+        //
+        NodeSeq seq = createTree(10);
+        IceInternal::BasicStream os(instance.get());
+        os.startWriteEncaps();
+        os.write(Ice::ObjectPtr(seq[0]));
+        writeTree(os, seq);
+        os.write(Ice::ObjectPtr(seq[1]));
+        os.writePendingObjects();
+        os.endWriteEncaps();
+
+        IceInternal::BasicStream is(instance.get());
+        is.swap(os);
+        is.i = is.b.begin();
+        NodeSeq result;
+        NodePtr first;
+        NodePtr second;
+        is.startReadEncaps();
+        is.read(__patch__NodePtr, &first);
+        readTree(is, result);
+        is.read(__patch__NodePtr, &second);
+        is.readPendingObjects();
+        is.endReadEncaps();
+        checkTree(result, 10);
+        test(first->value == 0 && second->value == 1);
+        test(first->left.get() == second.get());
+        test(first.get() != result[0].get());
+    }
+    cout << "ok" << endl;
+
+    cout << "benchmarking class graphs:" << endl;
+    const int sizes[] = { 127, 4095, 131071 };
+    for(unsigned int i = 0; i < sizeof(sizes) / sizeof(int); ++i)
+    {
+        const int repetitions = 1000000 / sizes[i];
+        NodeSeq seq = createTree(sizes[i]);
+
+        IceUtil::Time writeTime;
+        IceUtil::Time readTime;
+        IceInternal::BasicStream os(instance.get(), true);
+        IceInternal::BasicStream is(instance.get(), true);
+        for(int j = 0; j < repetitions; ++j)
+        {
+            os.clear();
+            os.b.clear();
+            IceUtil::Time start = IceUtil::Time::now(IceUtil::Time::Monotonic);
+            writeTree(os, seq);
+            writeTime += IceUtil::Time::now(IceUtil::Time::Monotonic) - start;
+
+            is.clear();
+            is.b.clear();
+            is.swap(os);
+            is.i = is.b.begin();
+            NodeSeq result;
+            start = IceUtil::Time::now(IceUtil::Time::Monotonic);
+            readTree(is, result);
+            readTime += IceUtil::Time::now(IceUtil::Time::Monotonic) - start;
+            test(static_cast<int>(result.size()) == sizes[i]);
+        }
+
+        cout << "  " << sizes[i] << " nodes: write " << writeTime.toMilliSecondsDouble() / repetitions << "ms, "
+             << "read " << readTime.toMilliSecondsDouble() / repetitions << "ms" << endl;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+int
+main(int argc, char* argv[])
+{
+    int status;
+    Ice::CommunicatorPtr communicator;
+
+    try
+    {
+        communicator = Ice::initialize(argc, argv);
+        status = run(argc, argv, communicator);
+    }
+    catch(const Ice::Exception& ex)
+    {
+        cerr << ex << endl;
+        status = EXIT_FAILURE;
+    }
+
+    if(communicator)
+    {
+        try
+        {
+            communicator->destroy();
+        }
+        catch(const Ice::Exception& ex)
+        {
+            cerr << ex << endl;
+            status = EXIT_FAILURE;
+        }
+    }
+
+    return status;
+}
@@ -0,0 +1 @@
+Client$(OBJEXT): Client.cpp "$(includedir)/IceUtil/IceUtil.h" "$(includedir)/Ice/Ice.h" "$(includedir)/Ice/Codec.h" "$(includedir)/Ice/CodecF.h" "$(includedir)/Ice/ProtocolPluginFacade.h" ../../include/TestCommon.h
@@ -0,0 +1,352 @@
+// **********************************************************************
+//
+// Copyright (c) 2003-2011 ZeroC, Inc. All rights reserved.
+//
+// This copy of Ice is licensed to you under the terms described in the
+// ICE_LICENSE file included in this distribution.
+//
+// **********************************************************************
+
+#include <IceUtil/IceUtil.h>
+#include <Ice/Ice.h>
+#include <Ice/Codec.h>
+#include <Ice/ProtocolPluginFacade.h>
+#include <TestCommon.h>
+
+using namespace std;
+using namespace Ice;
+using namespace IceInternal;
+
+namespace
+{
+
+class EchoI : public Blobject
+{
+public:
+
+    virtual bool
+    ice_invoke(const vector<Byte>& inParams, vector<Byte>& outParams, const Current&)
+    {
+        outParams = inParams;
+        return true;
+    }
+};
+
+//
+// Records the protocol traces to check the compression status of the
+// messages.
+//
+class TraceLoggerI : public Logger, public IceUtil::Mutex
+{
+public:
+
+    virtual void print(const string&) {}
+    virtual void warning(const string&) {}
+    virtual void error(const string&) {}
+    virtual LoggerPtr cloneWithPrefix(const string&) { return this; }
+
+    virtual void
+    trace(const string&, const string& message)
+    {
+        IceUtil::Mutex::Lock sync(*this);
+        _traces.push_back(message);
+    }
+
+    bool
+    contains(const string& str)
+    {
+        IceUtil::Mutex::Lock sync(*this);
+        for(vector<string>::const_iterator p = _traces.begin(); p != _traces.end(); ++p)
+        {
+            if(p->find(str) != string::npos)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void
+    clear()
+    {
+        IceUtil::Mutex::Lock sync(*this);
+        _traces.clear();
+    }
+
+private:
+
+    vector<string> _traces;
+};
+typedef IceUtil::Handle<TraceLoggerI> TraceLoggerIPtr;
+
+//
+// The encoding of a sequence of records similar to those found in
+// typical requests: an identifier, a few names, a timestamp and some
+// numeric values.
+//
+vector<Byte>
+typicalEncapsulation(const CommunicatorPtr& communicator, int records)
+{
+    static const char* names[] = { "Widget", "Gadget", "Sprocket", "Gizmo", "Doohickey", "Thingamajig" };
+    static const char* units[] = { "kg", "m", "s", "EUR", "USD" };
+
+    OutputStreamPtr out = createOutputStream(communicator);
+    out->writeSize(records);
+    for(int i = 0; i < records; ++i)
+    {
+        ostringstream os;
+        os << names[i % 6] << '-' << i;
+        out->write(static_cast<Int>(i));
+        out->write(os.str());
+        out->write(string(units[rand() % 5]));
+        out->write(static_cast<Long>(1300000000000LL + i * 997));
+        out->write(static_cast<Double>(rand() % 100000) / 100);
+        out->write(rand() % 2 == 0);
+        out->writeSize(4);
+        for(int j = 0; j < 4; ++j)
+        {
+            out->write(static_cast<Int>(rand() % 1000));
+        }
+    }
+    vector<Byte> bytes;
+    out->finished(bytes);
+    return bytes;
+}
+
+vector<Byte>
+randomBytes(size_t size)
+{
+    vector<Byte> bytes(size);
+    for(vector<Byte>::iterator p = bytes.begin(); p != bytes.end(); ++p)
+    {
+        *p = static_cast<Byte>(rand());
+    }
+    return bytes;
+}
+
+void
+roundTrip(const CodecPtr& codec, const vector<Byte>& data)
+{
+    vector<Byte> compressed(codec->compressBound(data.size()));
+    size_t sz = codec->compress(&data[0], data.size(), &compressed[0], compressed.size(), 1);
+    test(sz <= compressed.size());
+
+    vector<Byte> uncompressed(data.size());
+    codec->uncompress(&compressed[0], sz, &uncompressed[0], uncompressed.size());
+    test(uncompressed == data);
+
+    //
+    // The data must fill the destination buffer exactly.
+    //
+    uncompressed.resize(data.size() + 1);
+    try
+    {
+        codec->uncompress(&compressed[0], sz, &uncompressed[0], uncompressed.size());
+        test(false);
+    }
+    catch(const CompressionException&)
+    {
+    }
+}
+
+void
+benchmark(const CodecPtr& codec, const string& name, const vector<Byte>& data)
+{
+    const size_t total = 16 * 1024 * 1024;
+    const int iterations = static_cast<int>(total / data.size() > 0 ? total / data.size() : 1);
+
+    vector<Byte> compressed(codec->compressBound(data.size()));
+    vector<Byte> uncompressed(data.size());
+    size_t sz = 0;
+
+    IceUtil::Time start = IceUtil::Time::now(IceUtil::Time::Monotonic);
+    for(int i = 0; i < iterations; ++i)
+    {
+        sz = codec->compress(&data[0], data.size(), &compressed[0], compressed.size(), 1);
+    }
+    IceUtil::Time compressTime = IceUtil::Time::now(IceUtil::Time::Monotonic) - start;
+
+    start = IceUtil::Time::now(IceUtil::Time::Monotonic);
+    for(int i = 0; i < iterations; ++i)
+    {
+        codec->uncompress(&compressed[0], sz, &uncompressed[0], uncompressed.size());
+    }
+    IceUtil::Time uncompressTime = IceUtil::Time::now(IceUtil::Time::Monotonic) - start;
+    test(uncompressed == data);
+
+    double mb = static_cast<double>(data.size()) * iterations / (1024 * 1024);
+    cout << "  " << codec->name() << ", " << name << " (" << data.size() << " bytes): ratio " << static_cast<double>(data.size()) / sz
+         << ", compress " << mb / compressTime.toSecondsDouble() << "MB/s, uncompress "
+         << mb / uncompressTime.toSecondsDouble() << "MB/s" << endl;
+}
+
+}
+
+int
+main(int argc, char* argv[])
+{
+    CommunicatorPtr communicator = initialize(argc, argv);
+    ProtocolPluginFacadePtr facade = getProtocolPluginFacade(communicator);
+
+    CodecPtr bzip2 = facade->getCodec(bzip2CodecId);
+    CodecPtr lz4 = facade->getCodec(3);
+    test(bzip2 && bzip2->name() == "bzip2");
+    test(lz4 && lz4->name() == "lz4");
+    CodecPtr codecs[] = { bzip2, lz4 };
+
+    cout << "testing codecs... " << flush;
+    {
+        for(unsigned int i = 0; i < sizeof(codecs) / sizeof(CodecPtr); ++i)
+        {
+            for(size_t sz = 1; sz < 100; ++sz)
+            {
+                roundTrip(codecs[i], randomBytes(sz));
+                roundTrip(codecs[i], vector<Byte>(sz, 7));
+            }
+            roundTrip(codecs[i], randomBytes(200000));
+            roundTrip(codecs[i], vector<Byte>(200000, 7));
+            roundTrip(codecs[i], typicalEncapsulation(communicator, 10));
+            roundTrip(codecs[i], typicalEncapsulation(communicator, 10000));
+
+            //
+            // Matches with offsets close to the 64KB limit.
+            //
+            vector<Byte> data = randomBytes(72000);
+            copy(data.begin(), data.begin() + 5000, data.begin() + 65534);
+            roundTrip(codecs[i], data);
+        }
+    }
+    cout << "ok" << endl;
+
+    cout << "testing malformed data... " << flush;
+    {
+        vector<Byte> data = typicalEncapsulation(communicator, 100);
+        for(unsigned int i = 0; i < sizeof(codecs) / sizeof(CodecPtr); ++i)
+        {
+            vector<Byte> compressed(codecs[i]->compressBound(data.size()));
+            size_t sz = codecs[i]->compress(&data[0], data.size(), &compressed[0], compressed.size(), 1);
+            vector<Byte> uncompressed(data.size());
+            for(size_t len = 0; len < sz; len += sz / 10)
+            {
+                try
+                {
+                    codecs[i]->uncompress(&compressed[0], len, &uncompressed[0], uncompressed.size());
+                    test(false);
+                }
+                catch(const CompressionException&)
+                {
+                }
+            }
+
+            for(int j = 0; j < 1000; ++j)
+            {
+                vector<Byte> corrupted(compressed.begin(), compressed.begin() + sz);
+                corrupted[rand() % sz] = static_cast<Byte>(rand());
+                try
+                {
+                    codecs[i]->uncompress(&corrupted[0], corrupted.size(), &uncompressed[0], uncompressed.size());
+                }
+                catch(const CompressionException&)
+                {
+                }
+            }
+        }
+    }
+    cout << "ok" << endl;
+
+    cout << "testing codec negotiation... " << flush;
+    {
+        TraceLoggerIPtr serverLogger = new TraceLoggerI;
+        InitializationData initData;
+        initData.properties = createProperties();
+        initData.properties->setProperty("Ice.Compression.Codec", "lz4");
+        initData.properties->setProperty("Ice.Trace.Protocol", "1");
+        initData.logger = serverLogger;
+        CommunicatorPtr server = initialize(initData);
+        server->getProperties()->setProperty("TestAdapter.Endpoints", "tcp -h 127.0.0.1 -p 12010");
+        ObjectAdapterPtr adapter = server->createObjectAdapter("TestAdapter");
+        adapter->add(new EchoI, server->stringToIdentity("echo"));
+        adapter->activate();
+
+        TraceLoggerIPtr clientLogger = new TraceLoggerI;
+        initData.properties = createProperties();
+        initData.properties->setProperty("Ice.Compression.MinSize", "1000");
+        initData.properties->setProperty("Ice.Trace.Protocol", "1");
+        initData.logger = clientLogger;
+        CommunicatorPtr client = initialize(initData);
+        ObjectPrx echo = client->stringToProxy("echo:tcp -h 127.0.0.1 -p 12010")->ice_compress(true);
+
+        vector<Byte> data = typicalEncapsulation(client, 1000);
+        vector<Byte> result;
+        test(echo->ice_invoke("echo", Normal, data, result));
+        test(result == data);
+        test(serverLogger->contains("compressed with codec 3; compress response"));
+        test(clientLogger->contains("compressed with codec 3; compress response"));
+
+        //
+        // Messages smaller than Ice.Compression.MinSize are not
+        // compressed but still request a compressed response.
+        //
+        serverLogger->clear();
+        clientLogger->clear();
+        data.resize(500);
+        test(echo->ice_invoke("echo", Normal, data, result));
+        test(result == data);
+        test(serverLogger->contains("not compressed; compress response with codec 3"));
+        test(clientLogger->contains("compressed with codec 3; compress response"));
+
+        //
+        // A client without the codec preferred by the server keeps
+        // using bzip2.
+        //
+        serverLogger->clear();
+        echo->ice_getConnection()->close(false);
+        server->destroy();
+
+        initData.properties = createProperties();
+        initData.properties->setProperty("Ice.Trace.Protocol", "1");
+        initData.logger = serverLogger;
+        server = initialize(initData);
+        server->getProperties()->setProperty("TestAdapter.Endpoints", "tcp -h 127.0.0.1 -p 12010");
+        adapter = server->createObjectAdapter("TestAdapter");
+        adapter->add(new EchoI, server->stringToIdentity("echo"));
+        adapter->activate();
+
+        data = typicalEncapsulation(client, 1000);
+        test(echo->ice_invoke("echo", Normal, data, result));
+        test(result == data);
+        test(serverLogger->contains("(compressed; compress response, if any)"));
+        test(!serverLogger->contains("codec 3"));
+
+        client->destroy();
+        server->destroy();
+
+        initData.properties = createProperties();
+        initData.properties->setProperty("Ice.Compression.Codec", "unknown");
+        try
+        {
+            initialize(initData);
+            test(false);
+        }
+        catch(const InitializationException&)
+        {
+        }
+    }
+    cout << "ok" << endl;
+
+    cout << "benchmarking codecs:" << endl;
+    {
+        vector<Byte> typical = typicalEncapsulation(communicator, 10);
+        vector<Byte> large = typicalEncapsulation(communicator, 10000);
+        vector<Byte> random = randomBytes(large.size());
+        for(unsigned int i = 0; i < sizeof(codecs) / sizeof(CodecPtr); ++i)
+        {
+            benchmark(codecs[i], "typical request", typical);
+            benchmark(codecs[i], "large request", large);
+            benchmark(codecs[i], "random data", random);
+        }
+    }
+
+    communicator->destroy();
+    return EXIT_SUCCESS;
+}
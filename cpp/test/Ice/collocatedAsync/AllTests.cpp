@@ -0,0 +1,146 @@
+// **********************************************************************
+//
+// Copyright (c) 2003-2011 ZeroC, Inc. All rights reserved.
+//
+// This copy of Ice is licensed to you under the terms described in the
+// ICE_LICENSE file included in this distribution.
+//
+// **********************************************************************
+
+#include <Ice/Ice.h>
+#include <TestCommon.h>
+#include <TestI.h>
+
+using namespace std;
+using namespace Test;
+
+namespace
+{
+
+double
+measure(const TestIntfPrx& proxy, int count)
+{
+    IceUtil::Time start = IceUtil::Time::now(IceUtil::Time::Monotonic);
+    for(int i = 0; i < count; ++i)
+    {
+        test(proxy->end_op(proxy->begin_op(i)) == i + 1);
+    }
+    IceUtil::Time elapsed = IceUtil::Time::now(IceUtil::Time::Monotonic) - start;
+    return elapsed.toMicroSecondsDouble() / count;
+}
+
+}
+
+void
+allTests(const Ice::CommunicatorPtr& communicator)
+{
+    communicator->getProperties()->setProperty("TestAdapter.Endpoints", "default -p 12010");
+    Ice::ObjectAdapterPtr adapter = communicator->createObjectAdapter("TestAdapter");
+    TestIntfIPtr servant = new TestIntfI;
+    adapter->add(servant, communicator->stringToIdentity("test"));
+    adapter->activate();
+
+    TestIntfPrx collocated = TestIntfPrx::uncheckedCast(communicator->stringToProxy("test:default -p 12010"));
+    TestIntfPrx remote = collocated->ice_collocationOptimized(false);
+
+    cout << "testing collocated AMI... " << flush;
+    {
+        Ice::AsyncResultPtr r = collocated->begin_op(5);
+        test(r->isSent() && r->sentSynchronously());
+        test(collocated->end_op(r) == 6);
+
+        vector<Ice::AsyncResultPtr> results;
+        for(int i = 0; i < 100; ++i)
+        {
+            results.push_back(collocated->begin_op(i));
+        }
+        for(int i = 0; i < 100; ++i)
+        {
+            test(collocated->end_op(results[i]) == i + 1);
+        }
+
+        //
+        // Collocated requests are dispatched without connection.
+        //
+        test(!collocated->end_hasConnection(collocated->begin_hasConnection()));
+        test(remote->end_hasConnection(remote->begin_hasConnection()));
+
+        try
+        {
+            collocated->end_opException(collocated->begin_opException());
+            test(false);
+        }
+        catch(const TestIntfException& ex)
+        {
+            test(ex.reason == "opException");
+        }
+
+        try
+        {
+            TestIntfPrx unknown = TestIntfPrx::uncheckedCast(communicator->stringToProxy("unknown:default -p 12010"));
+            unknown->end_op(unknown->begin_op(0));
+            test(false);
+        }
+        catch(const Ice::ObjectNotExistException&)
+        {
+        }
+
+        try
+        {
+            collocated->ice_getConnection();
+            test(false);
+        }
+        catch(const Ice::CollocationOptimizationException&)
+        {
+        }
+    }
+    cout << "ok" << endl;
+
+    cout << "testing collocated AMD... " << flush;
+    {
+        vector<Ice::AsyncResultPtr> results;
+        for(int i = 0; i < 100; ++i)
+        {
+            results.push_back(collocated->begin_opAMD(i));
+        }
+        for(int i = 0; i < 100; ++i)
+        {
+            test(collocated->end_opAMD(results[i]) == i + 1);
+        }
+
+        try
+        {
+            collocated->end_opAMDException(collocated->begin_opAMDException());
+            test(false);
+        }
+        catch(const TestIntfException& ex)
+        {
+            test(ex.reason == "opAMDException");
+        }
+    }
+    cout << "ok" << endl;
+
+    cout << "testing collocated oneway AMI... " << flush;
+    {
+        TestIntfPrx oneway = collocated->ice_oneway();
+        for(int i = 0; i < 100; ++i)
+        {
+            Ice::AsyncResultPtr r = oneway->begin_opOneway();
+            test(r->isCompleted() && r->sentSynchronously());
+            oneway->end_opOneway(r);
+        }
+        servant->waitForOneways(100);
+    }
+    cout << "ok" << endl;
+
+    cout << "measuring AMI round trips (microseconds per call):" << endl;
+    {
+        const int count = 20000;
+        measure(collocated, 1000);
+        measure(remote, 1000);
+        cout << "  collocated: " << measure(collocated, count) << ", loopback: " << measure(remote, count) << endl;
+    }
+
+    servant->destroy();
+    adapter->destroy();
+}
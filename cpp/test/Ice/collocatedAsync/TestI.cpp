@@ -0,0 +1,136 @@
+// **********************************************************************
+//
+// Copyright (c) 2003-2011 ZeroC, Inc. All rights reserved.
+//
+// This copy of Ice is licensed to you under the terms described in the
+// ICE_LICENSE file included in this distribution.
+//
+// **********************************************************************
+
+#include <Ice/Ice.h>
+#include <TestI.h>
+
+using namespace std;
+
+namespace
+{
+
+//
+// Completes AMD requests from the timer thread, after the dispatch
+// thread returned.
+//
+class OpAMDTask : public IceUtil::TimerTask
+{
+public:
+
+    OpAMDTask(const Test::AMD_TestIntf_opAMDPtr& cb, Ice::Int value) :
+        _cb(cb),
+        _value(value)
+    {
+    }
+
+    virtual void
+    runTimerTask()
+    {
+        _cb->ice_response(_value + 1);
+    }
+
+private:
+
+    const Test::AMD_TestIntf_opAMDPtr _cb;
+    const Ice::Int _value;
+};
+
+class OpAMDExceptionTask : public IceUtil::TimerTask
+{
+public:
+
+    OpAMDExceptionTask(const Test::AMD_TestIntf_opAMDExceptionPtr& cb) :
+        _cb(cb)
+    {
+    }
+
+    virtual void
+    runTimerTask()
+    {
+        Test::TestIntfException ex;
+        ex.reason = "opAMDException";
+        _cb->ice_exception(ex);
+    }
+
+private:
+
+    const Test::AMD_TestIntf_opAMDExceptionPtr _cb;
+};
+
+}
+
+TestIntfI::TestIntfI() :
+    _timer(new IceUtil::Timer),
+    _oneways(0)
+{
+}
+
+Ice::Int
+TestIntfI::op(Ice::Int value, const Ice::Current&)
+{
+    return value + 1;
+}
+
+void
+TestIntfI::opAMD_async(const Test::AMD_TestIntf_opAMDPtr& cb, Ice::Int value, const Ice::Current&)
+{
+    if(value % 2 == 0)
+    {
+        cb->ice_response(value + 1);
+    }
+    else
+    {
+        _timer->schedule(new OpAMDTask(cb, value), IceUtil::Time());
+    }
+}
+
+void
+TestIntfI::opAMDException_async(const Test::AMD_TestIntf_opAMDExceptionPtr& cb, const Ice::Current&)
+{
+    _timer->schedule(new OpAMDExceptionTask(cb), IceUtil::Time());
+}
+
+void
+TestIntfI::opException(const Ice::Current&)
+{
+    Test::TestIntfException ex;
+    ex.reason = "opException";
+    throw ex;
+}
+
+bool
+TestIntfI::hasConnection(const Ice::Current& current)
+{
+    return current.con ? true : false;
+}
+
+void
+TestIntfI::opOneway(const Ice::Current&)
+{
+    Lock sync(*this);
+    ++_oneways;
+    notifyAll();
+}
+
+void
+TestIntfI::waitForOneways(int count)
+{
+    Lock sync(*this);
+    while(_oneways < count)
+    {
+        wait();
+    }
+    _oneways = 0;
+}
+
+void
+TestIntfI::destroy()
+{
+    _timer->destroy();
+}
@@ -0,0 +1,41 @@
+// **********************************************************************
+//
+// Copyright (c) 2003-2011 ZeroC, Inc. All rights reserved.
+//
+// This copy of Ice is licensed to you under the terms described in the
+// ICE_LICENSE file included in this distribution.
+//
+// **********************************************************************
+
+#ifndef TEST_I_H
+#define TEST_I_H
+
+#include <IceUtil/Monitor.h>
+#include <IceUtil/Mutex.h>
+#include <IceUtil/Timer.h>
+#include <Test.h>
+
+class TestIntfI : public Test::TestIntf, public IceUtil::Monitor<IceUtil::Mutex>
+{
+public:
+
+    TestIntfI();
+
+    virtual Ice::Int op(Ice::Int, const Ice::Current&);
+    virtual void opAMD_async(const Test::AMD_TestIntf_opAMDPtr&, Ice::Int, const Ice::Current&);
+    virtual void opAMDException_async(const Test::AMD_TestIntf_opAMDExceptionPtr&, const Ice::Current&);
+    virtual void opException(const Ice::Current&);
+    virtual bool hasConnection(const Ice::Current&);
+    virtual void opOneway(const Ice::Current&);
+
+    void waitForOneways(int);
+    void destroy();
+
+private:
+
+    const IceUtil::TimerPtr _timer;
+    int _oneways;
+};
+typedef IceUtil::Handle<TestIntfI> TestIntfIPtr;
+
+#endif
@@ -0,0 +1,105 @@
+// **********************************************************************
+//
+// Copyright (c) 2003-2011 ZeroC, Inc. All rights reserved.
+//
+// This copy of Ice is licensed to you under the terms described in the
+// ICE_LICENSE file included in this distribution.
+//
+// **********************************************************************
+
+#include <Ice/Ice.h>
+#include <TestCommon.h>
+#include <Test.h>
+#include <set>
+
+using namespace std;
+using namespace Test;
+
+namespace
+{
+
+//
+// Sends count concurrent requests with the given proxy and returns
+// the connections that received them.
+//
+set<string>
+concurrentRequests(const TestIntfPrx& prx, int count)
+{
+    vector<Ice::AsyncResultPtr> results;
+    for(int i = 0; i < count; ++i)
+    {
+        results.push_back(prx->begin_getConnection(100));
+    }
+
+    set<string> connections;
+    for(vector<Ice::AsyncResultPtr>::const_iterator p = results.begin(); p != results.end(); ++p)
+    {
+        connections.insert(prx->end_getConnection(*p));
+    }
+    return connections;
+}
+
+}
+
+TestIntfPrx
+allTests(const Ice::CommunicatorPtr& communicator)
+{
+    string ref = "test:default -p 12010";
+    TestIntfPrx intf = TestIntfPrx::checkedCast(communicator->stringToProxy(ref));
+    test(intf);
+
+    cout << "testing idle pool... " << flush;
+    {
+        //
+        // The pool only grows when all its connections have outstanding requests.
+        //
+        TestIntfPrx prx = intf->ice_connectionCached(false);
+        string connection = intf->getConnection(0);
+        for(int i = 0; i < 10; ++i)
+        {
+            test(prx->getConnection(0) == connection);
+            test(prx->ice_getConnection() == intf->ice_getConnection());
+        }
+    }
+    cout << "ok" << endl;
+
+    cout << "testing concurrent requests... " << flush;
+    {
+        TestIntfPrx prx = intf->ice_connectionCached(false);
+        set<string> connections;
+        for(int i = 0; i < 5; ++i)
+        {
+            set<string> s = concurrentRequests(prx, 40);
+            connections.insert(s.begin(), s.end());
+        }
+        test(connections.size() > 1);
+        test(connections.size() <= 4);
+    }
+    cout << "ok" << endl;
+
+    cout << "testing cached connection... " << flush;
+    {
+        //
+        // A proxy that caches its connection keeps using it.
+        //
+        TestIntfPrx prx = TestIntfPrx::uncheckedCast(communicator->stringToProxy(ref));
+        Ice::ConnectionPtr connection = prx->ice_getConnection();
+        test(concurrentRequests(prx, 40).size() == 1);
+        test(prx->ice_getConnection() == connection);
+    }
+    cout << "ok" << endl;
+
+    cout << "testing pool size of 1... " << flush;
+    {
+        Ice::InitializationData initData;
+        initData.properties = communicator->getProperties()->clone();
+        initData.properties->setProperty("Ice.ConnectionPool.Size", "1");
+        Ice::CommunicatorPtr comm = Ice::initialize(initData);
+        TestIntfPrx prx = TestIntfPrx::uncheckedCast(comm->stringToProxy(ref))->ice_connectionCached(false);
+        test(concurrentRequests(prx, 40).size() == 1);
+        comm->destroy();
+    }
+    cout << "ok" << endl;
+
+    return intf;
+}
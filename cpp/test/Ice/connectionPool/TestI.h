@@ -0,0 +1,23 @@
+// **********************************************************************
+//
+// Copyright (c) 2003-2011 ZeroC, Inc. All rights reserved.
+//
+// This copy of Ice is licensed to you under the terms described in the
+// ICE_LICENSE file included in this distribution.
+//
+// **********************************************************************
+
+#ifndef TEST_I_H
+#define TEST_I_H
+
+#include <Test.h>
+
+class TestIntfI : virtual public Test::TestIntf
+{
+public:
+
+    virtual std::string getConnection(Ice::Int, const Ice::Current&);
+    virtual void shutdown(const Ice::Current&);
+};
+
+#endif
@@ -1150,6 +1150,16 @@ public:
         called();
     }
     
+    void opPointArray(const pair<const Test::Point*, const Test::Point*>& ret,
+                      const pair<const Test::Point*, const Test::Point*>& out,
+                      const InParamPtr& cookie)
+    {
+        const pair<const Test::Point*, const Test::Point*>& in = getIn(ret, cookie);
+        test(arrayRangeEquals<Test::Point>(out, in));
+        test(arrayRangeEquals<Test::Point>(ret, in));
+        called();
+    }
+
     void opBoolRange(const pair<Test::BoolSeq::const_iterator, Test::BoolSeq::const_iterator>& ret,
                      const pair<Test::BoolSeq::const_iterator, Test::BoolSeq::const_iterator>& out,
                      const InParamPtr& cookie)
@@ -1576,6 +1586,42 @@ allTests(const Ice::CommunicatorPtr& communicator, bool collocated)
         test(ret == in);
     }
 
+    {
+        Test::Point inArray[100];
+        for(int i = 0; i < 100; ++i)
+        {
+            inArray[i].x = i;
+            inArray[i].y = i * 0.5;
+            inArray[i].z = -i;
+        }
+        Test::PointSeq in(inArray, inArray + 100);
+
+        Test::PointSeq out;
+        pair<const Test::Point*, const Test::Point*> inPair(inArray, inArray);
+        Test::PointSeq ret = t->opPointArray(inPair, out);
+        test(out.empty());
+        test(ret.empty());
+
+        inPair.second = inArray + 100;
+        ret = t->opPointArray(inPair, out);
+        test(out == in);
+        test(ret == in);
+    }
+
+    {
+        Test::PaddedSeq in(5);
+        for(int i = 0; i < 5; ++i)
+        {
+            in[i].b = static_cast<Ice::Byte>(i);
+            in[i].i = i * 1000;
+        }
+
+        Test::PaddedSeq out;
+        Test::PaddedSeq ret = t->opPaddedSeq(in, out);
+        test(out == in);
+        test(ret == in);
+    }
+
     {
         Test::BoolSeq in(5);
         in[0] = false;
@@ -3071,6 +3117,23 @@ allTests(const Ice::CommunicatorPtr& communicator, bool collocated)
             cb->check();
         }
 
+        {
+            Test::Point inArray[10];
+            for(int i = 0; i < 10; ++i)
+            {
+                inArray[i].x = i;
+                inArray[i].y = i * 2;
+                inArray[i].z = i * 3;
+            }
+            pair<const Test::Point*, const Test::Point*> inPair(inArray, inArray + 10);
+
+            CallbackPtr cb = new Callback();
+            Test::Callback_TestIntf_opPointArrayPtr callback =
+                Test::newCallback_TestIntf_opPointArray(cb, &Callback::opPointArray, &Callback::noEx);
+            t->begin_opPointArray(inPair, callback, newInParam(inPair));
+            cb->check();
+        }
+
         {
             Test::BoolSeq in(5);
             in[0] = false;
@@ -3519,6 +3582,32 @@ allTests(const Ice::CommunicatorPtr& communicator, bool collocated)
         }
 
         cout << "ok" << endl;
+
+        cout << "testing array views held after dispatch... " << flush;
+        {
+            //
+            // With the AMD server, the view on the request is held
+            // until the next request, which has the same size and
+            // would reuse the memory of the first one if it had been
+            // released.
+            //
+            Test::ByteSeq in(16 * 1024);
+            Test::ByteSeq overwrite(in.size());
+            for(Test::ByteSeq::size_type i = 0; i < in.size(); ++i)
+            {
+                in[i] = static_cast<Ice::Byte>(i % 256);
+                overwrite[i] = static_cast<Ice::Byte>(255 - i % 256);
+            }
+            pair<const Ice::Byte*, const Ice::Byte*> inPair(&in[0], &in[0] + in.size());
+
+            for(int i = 0; i < 10; ++i)
+            {
+                Ice::AsyncResultPtr r = t->begin_opHeldByteArray(inPair);
+                t->releaseHeldByteArray(overwrite);
+                test(t->end_opHeldByteArray(r) == in);
+            }
+        }
+        cout << "ok" << endl;
     }
 
     cout << "testing class mapped structs ... " << flush;
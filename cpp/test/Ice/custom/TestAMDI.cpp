@@ -50,6 +50,23 @@ TestIntfI::opVariableArray_async(const Test::AMD_TestIntf_opVariableArrayPtr& op
     opVariableArrayCB->ice_response(outSeq, outSeq);
 }
 
+void
+TestIntfI::opPointArray_async(const Test::AMD_TestIntf_opPointArrayPtr& opPointArrayCB,
+                              const std::pair<const Test::Point*, const Test::Point*>& inSeq,
+                              const Ice::Current&)
+{
+    Test::PointSeq outSeq(inSeq.first, inSeq.second);
+    opPointArrayCB->ice_response(outSeq, outSeq);
+}
+
+void
+TestIntfI::opPaddedSeq_async(const Test::AMD_TestIntf_opPaddedSeqPtr& opPaddedSeqCB,
+                             const Test::PaddedSeq& inSeq,
+                             const Ice::Current&)
+{
+    opPaddedSeqCB->ice_response(inSeq, inSeq);
+}
+
 void
 TestIntfI::opBoolRange_async(const Test::AMD_TestIntf_opBoolRangePtr& opBoolRangeCB,
                              const std::pair<Test::BoolSeq::const_iterator, Test::BoolSeq::const_iterator>& inSeq,
@@ -308,6 +325,55 @@ TestIntfI::opOutRangeByteSeq_async(const ::Test::AMD_TestIntf_opOutRangeByteSeqP
                                 ::Test::ByteSeq::const_iterator>(inS.begin(), inS.end()));
 }
 
+void
+TestIntfI::opHeldByteArray_async(const ::Test::AMD_TestIntf_opHeldByteArrayPtr& cb,
+                                 const std::pair<const ::Ice::Byte*, const ::Ice::Byte*>& inSeq,
+                                 const ::Ice::Current&)
+{
+    //
+    // The callback keeps the request alive, the response is sent
+    // from the view once releaseHeldByteArray is called. Requests
+    // might be dispatched out of order, in which case there is
+    // nothing to hold.
+    //
+    ::Test::AMD_TestIntf_releaseHeldByteArrayPtr releaseCB;
+    {
+        IceUtil::Mutex::Lock sync(_mutex);
+        if(!_releaseCB)
+        {
+            _heldCB = cb;
+            _heldSeq = inSeq;
+            return;
+        }
+        releaseCB = _releaseCB;
+        _releaseCB = 0;
+    }
+    cb->ice_response(inSeq);
+    releaseCB->ice_response();
+}
+
+void
+TestIntfI::releaseHeldByteArray_async(const ::Test::AMD_TestIntf_releaseHeldByteArrayPtr& cb,
+                                      const ::Test::ByteSeq&,
+                                      const ::Ice::Current&)
+{
+    ::Test::AMD_TestIntf_opHeldByteArrayPtr heldCB;
+    std::pair<const ::Ice::Byte*, const ::Ice::Byte*> heldSeq;
+    {
+        IceUtil::Mutex::Lock sync(_mutex);
+        if(!_heldCB)
+        {
+            _releaseCB = cb;
+            return;
+        }
+        heldCB = _heldCB;
+        heldSeq = _heldSeq;
+        _heldCB = 0;
+    }
+    heldCB->ice_response(heldSeq);
+    cb->ice_response();
+}
+
 void
 TestIntfI::shutdown_async(const Test::AMD_TestIntf_shutdownPtr& shutdownCB,
                           const Ice::Current& current)
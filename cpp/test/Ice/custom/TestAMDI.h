@@ -10,6 +10,7 @@
 #ifndef TEST_I_H
 #define TEST_I_H
 
+#include <IceUtil/Mutex.h>
 #include <TestAMD.h>
 
 class TestIntfI : virtual public Test::TestIntf
@@ -34,6 +35,14 @@ public:
                                        const std::pair<const Test::Variable*, const Test::Variable*>&,
                                        const Ice::Current&);
 
+    virtual void opPointArray_async(const Test::AMD_TestIntf_opPointArrayPtr&,
+                                    const std::pair<const Test::Point*, const Test::Point*>&,
+                                    const Ice::Current&);
+
+    virtual void opPaddedSeq_async(const Test::AMD_TestIntf_opPaddedSeqPtr&,
+                                   const Test::PaddedSeq&,
+                                   const Ice::Current&);
+
     virtual void opBoolRange_async(const Test::AMD_TestIntf_opBoolRangePtr&,
                                    const std::pair<Test::BoolSeq::const_iterator, Test::BoolSeq::const_iterator>&,
                                    const Ice::Current&);
@@ -151,12 +160,25 @@ public:
                                          const ::Test::ByteSeq&,
                                          const ::Ice::Current&);
 
+    virtual void opHeldByteArray_async(const ::Test::AMD_TestIntf_opHeldByteArrayPtr&,
+                                       const std::pair<const ::Ice::Byte*, const ::Ice::Byte*>&,
+                                       const ::Ice::Current&);
+
+    virtual void releaseHeldByteArray_async(const ::Test::AMD_TestIntf_releaseHeldByteArrayPtr&,
+                                            const ::Test::ByteSeq&,
+                                            const ::Ice::Current&);
+
     virtual void shutdown_async(const Test::AMD_TestIntf_shutdownPtr&,
                                 const Ice::Current&);
 
 private:
 
     Ice::CommunicatorPtr _communicator;
+
+    IceUtil::Mutex _mutex;
+    ::Test::AMD_TestIntf_opHeldByteArrayPtr _heldCB;
+    std::pair<const ::Ice::Byte*, const ::Ice::Byte*> _heldSeq;
+    ::Test::AMD_TestIntf_releaseHeldByteArrayPtr _releaseCB;
 };
 
 #endif
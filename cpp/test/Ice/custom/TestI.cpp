@@ -51,6 +51,24 @@ TestIntfI::opVariableArray(const std::pair<const Test::Variable*, const Test::Va
     return outSeq;
 }
 
+Test::PointSeq
+TestIntfI::opPointArray(const std::pair<const Test::Point*, const Test::Point*>& inSeq,
+                        Test::PointSeq& outSeq,
+                        const Ice::Current&)
+{
+    Test::PointSeq(inSeq.first, inSeq.second).swap(outSeq);
+    return outSeq;
+}
+
+Test::PaddedSeq
+TestIntfI::opPaddedSeq(const Test::PaddedSeq& inSeq,
+                       Test::PaddedSeq& outSeq,
+                       const Ice::Current&)
+{
+    outSeq = inSeq;
+    return inSeq;
+}
+
 Test::BoolSeq
 TestIntfI::opBoolRange(const std::pair<Test::BoolSeq::const_iterator, Test::BoolSeq::const_iterator>& inSeq,
                        Test::BoolSeq& outSeq,
@@ -305,6 +323,17 @@ TestIntfI::opOutRangeByteSeq(const Test::ByteSeq& data, Test::ByteSeq& copy, con
     copy = data;
 }
 
+Test::ByteSeq
+TestIntfI::opHeldByteArray(const std::pair<const Ice::Byte*, const Ice::Byte*>& inSeq, const Ice::Current&)
+{
+    return Test::ByteSeq(inSeq.first, inSeq.second);
+}
+
+void
+TestIntfI::releaseHeldByteArray(const Test::ByteSeq&, const Ice::Current&)
+{
+}
+
 void
 TestIntfI::shutdown(const Ice::Current& current)
 {
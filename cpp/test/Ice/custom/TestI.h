@@ -34,6 +34,14 @@ public:
                                                Test::VariableList&,
                                                const Ice::Current&);
 
+    virtual Test::PointSeq opPointArray(const std::pair<const Test::Point*, const Test::Point*>&,
+                                        Test::PointSeq&,
+                                        const Ice::Current&);
+
+    virtual Test::PaddedSeq opPaddedSeq(const Test::PaddedSeq&,
+                                        Test::PaddedSeq&,
+                                        const Ice::Current&);
+
     virtual Test::BoolSeq opBoolRange(const std::pair<Test::BoolSeq::const_iterator, Test::BoolSeq::const_iterator>&,
                                       Test::BoolSeq&,
                                       const Ice::Current&);
@@ -149,6 +157,10 @@ public:
     
     virtual void opOutRangeByteSeq(const Test::ByteSeq&, Test::ByteSeq&, const Ice::Current&);
 
+    virtual Test::ByteSeq opHeldByteArray(const std::pair<const Ice::Byte*, const Ice::Byte*>&, const Ice::Current&);
+
+    virtual void releaseHeldByteArray(const Test::ByteSeq&, const Ice::Current&);
+
     virtual void shutdown(const Ice::Current&);
 
 private:
@@ -0,0 +1,189 @@
+// **********************************************************************
+//
+// Copyright (c) 2003-2011 ZeroC, Inc. All rights reserved.
+//
+// This copy of Ice is licensed to you under the terms described in the
+// ICE_LICENSE file included in this distribution.
+//
+// **********************************************************************
+
+#include <Ice/Ice.h>
+#include <IceUtil/Thread.h>
+#include <TestCommon.h>
+#include <Test.h>
+
+using namespace std;
+using namespace Test;
+
+namespace
+{
+
+Ice::Context
+priority(int level)
+{
+    ostringstream os;
+    os << level;
+    Ice::Context ctx;
+    ctx["priority"] = os.str();
+    return ctx;
+}
+
+}
+
+TestIntfPrx
+allTests(const Ice::CommunicatorPtr& communicator)
+{
+    string ref = "test:default -p 12010";
+    TestIntfPrx intf = TestIntfPrx::checkedCast(communicator->stringToProxy(ref));
+    test(intf);
+
+    cout << "testing reserved threads... " << flush;
+    {
+        //
+        // hold() has the default priority, it blocks the only thread
+        // which dispatches the requests of levels 1 and 2. The
+        // requests of level 0 are still dispatched by the reserved
+        // thread.
+        //
+        Ice::AsyncResultPtr hold = intf->begin_hold();
+        intf->waitForHold();
+        intf->op();
+        intf->record(0, priority(0));
+
+        Ice::AsyncResultPtr r1 = intf->begin_record(1);
+        Ice::AsyncResultPtr r2 = intf->begin_record(2, priority(2));
+        intf->op();
+        IceUtil::ThreadControl::sleep(IceUtil::Time::milliSeconds(100));
+        test(!r1->isCompleted() && !r2->isCompleted());
+
+        intf->release();
+        intf->end_hold(hold);
+        intf->end_record(r1);
+        intf->end_record(r2);
+
+        Ice::IntSeq records = intf->getRecords();
+        test(records.size() == 3);
+        test(records[0] == 0);
+    }
+    cout << "ok" << endl;
+
+    cout << "testing weighted scheduling... " << flush;
+    {
+        //
+        // Queue the requests of level 2 before the requests of level
+        // 1. Level 1 has three times the weight of level 2, it gets
+        // three quarters of the dispatches once the queued requests
+        // are dispatched.
+        //
+        Ice::AsyncResultPtr hold = intf->begin_hold();
+        intf->waitForHold();
+
+        vector<Ice::AsyncResultPtr> results;
+        for(int i = 0; i < 8; ++i)
+        {
+            results.push_back(intf->begin_record(200 + i, priority(2)));
+        }
+        for(int i = 0; i < 8; ++i)
+        {
+            results.push_back(intf->begin_record(100 + i, priority(1)));
+        }
+
+        //
+        // The requests are read in order, all the records are queued
+        // once this request returns.
+        //
+        intf->op();
+
+        intf->release();
+        intf->end_hold(hold);
+        for(vector<Ice::AsyncResultPtr>::const_iterator p = results.begin(); p != results.end(); ++p)
+        {
+            intf->end_record(*p);
+        }
+
+        Ice::IntSeq records = intf->getRecords();
+        test(records.size() == 16);
+
+        int level1 = 0;
+        int last1 = -1;
+        int last2 = -1;
+        for(int i = 0; i < 16; ++i)
+        {
+            if(records[i] < 200)
+            {
+                test(records[i] == 100 + ++last1); // The requests of a level are dispatched in order.
+                if(i < 8)
+                {
+                    ++level1;
+                }
+            }
+            else
+            {
+                test(records[i] == 200 + ++last2);
+            }
+        }
+        test(level1 >= 5 && level1 <= 7);
+    }
+    cout << "ok" << endl;
+
+    cout << "testing priority context... " << flush;
+    {
+        //
+        // Invalid priorities are ignored and levels greater than the
+        // lowest level are adjusted.
+        //
+        Ice::AsyncResultPtr hold = intf->begin_hold();
+        intf->waitForHold();
+
+        Ice::Context ctx;
+        ctx["priority"] = "high";
+        Ice::AsyncResultPtr r1 = intf->begin_record(1, ctx);
+        Ice::AsyncResultPtr r2 = intf->begin_record(2, priority(10));
+        intf->record(0, priority(-1));
+        intf->op();
+        test(!r1->isCompleted() && !r2->isCompleted());
+
+        intf->release();
+        intf->end_hold(hold);
+        intf->end_record(r1);
+        intf->end_record(r2);
+        test(intf->getRecords().size() == 3);
+    }
+    cout << "ok" << endl;
+
+    cout << "testing queue limit... " << flush;
+    {
+        //
+        // The connection isn't read once more than 20 requests of
+        // levels 1 and 2 are queued, the requests of level 0 sent over
+        // the same connection are delayed until the queue drains.
+        // Other connections are still read.
+        //
+        Ice::AsyncResultPtr hold = intf->begin_hold();
+        intf->waitForHold();
+
+        vector<Ice::AsyncResultPtr> results;
+        for(int i = 0; i < 24; ++i)
+        {
+            results.push_back(intf->begin_record(i));
+        }
+        Ice::AsyncResultPtr op = intf->begin_op();
+
+        TestIntfPrx other = TestIntfPrx::uncheckedCast(intf->ice_connectionId("other"));
+        other->op();
+        IceUtil::ThreadControl::sleep(IceUtil::Time::milliSeconds(100));
+        test(!op->isCompleted());
+
+        other->release();
+        intf->end_hold(hold);
+        intf->end_op(op);
+        for(vector<Ice::AsyncResultPtr>::const_iterator p = results.begin(); p != results.end(); ++p)
+        {
+            intf->end_record(*p);
+        }
+        test(intf->getRecords().size() == 24);
+    }
+    cout << "ok" << endl;
+
+    return intf;
+}
@@ -0,0 +1,75 @@
+// **********************************************************************
+//
+// Copyright (c) 2003-2011 ZeroC, Inc. All rights reserved.
+//
+// This copy of Ice is licensed to you under the terms described in the
+// ICE_LICENSE file included in this distribution.
+//
+// **********************************************************************
+
+#include <Ice/Ice.h>
+#include <TestI.h>
+
+using namespace std;
+
+int
+run(int argc, char* argv[], const Ice::CommunicatorPtr& communicator)
+{
+    communicator->getProperties()->setProperty("TestAdapter.Endpoints", "default -p 12010");
+    Ice::ObjectAdapterPtr adapter = communicator->createObjectAdapter("TestAdapter");
+    adapter->add(new TestIntfI, communicator->stringToIdentity("test"));
+    adapter->activate();
+    communicator->waitForShutdown();
+    return EXIT_SUCCESS;
+}
+
+int
+main(int argc, char* argv[])
+{
+    int status;
+    Ice::CommunicatorPtr communicator;
+
+    try
+    {
+        Ice::InitializationData initData;
+        initData.properties = Ice::createProperties(argc, argv);
+
+        //
+        // Requests of level 0 have a reserved thread, the requests of
+        // levels 1 and 2 are dispatched by a single thread. At most 20
+        // requests of these levels are queued.
+        //
+        initData.properties->setProperty("TestAdapter.ThreadPool.Size", "2");
+        initData.properties->setProperty("TestAdapter.DispatchPriority.Weights", "1 3 1");
+        initData.properties->setProperty("TestAdapter.DispatchPriority.Default", "1");
+        initData.properties->setProperty("TestAdapter.DispatchPriority.Reserved", "1");
+        initData.properties->setProperty("TestAdapter.DispatchPriority.MaxQueued", "20");
+        initData.properties->setProperty("TestAdapter.DispatchPriority.Operation.waitForHold", "0");
+        initData.properties->setProperty("TestAdapter.DispatchPriority.Operation.release", "0");
+        initData.properties->setProperty("TestAdapter.DispatchPriority.Operation.op", "0");
+        initData.properties->setProperty("TestAdapter.DispatchPriority.Operation.getRecords", "0");
+
+        communicator = Ice::initialize(argc, argv, initData);
+        status = run(argc, argv, communicator);
+    }
+    catch(const Ice::Exception& ex)
+    {
+        cerr << ex << endl;
+        status = EXIT_FAILURE;
+    }
+
+    if(communicator)
+    {
+        try
+        {
+            communicator->destroy();
+        }
+        catch(const Ice::Exception& ex)
+        {
+            cerr << ex << endl;
+            status = EXIT_FAILURE;
+        }
+    }
+
+    return status;
+}
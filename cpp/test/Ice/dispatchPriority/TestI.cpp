@@ -0,0 +1,75 @@
+// **********************************************************************
+//
+// Copyright (c) 2003-2011 ZeroC, Inc. All rights reserved.
+//
+// This copy of Ice is licensed to you under the terms described in the
+// ICE_LICENSE file included in this distribution.
+//
+// **********************************************************************
+
+#include <Ice/Ice.h>
+#include <TestI.h>
+
+using namespace std;
+
+TestIntfI::TestIntfI() :
+    _holding(false)
+{
+}
+
+void
+TestIntfI::hold(const Ice::Current&)
+{
+    Lock sync(*this);
+    _holding = true;
+    notifyAll();
+    while(_holding)
+    {
+        wait();
+    }
+}
+
+void
+TestIntfI::waitForHold(const Ice::Current&)
+{
+    Lock sync(*this);
+    while(!_holding)
+    {
+        wait();
+    }
+}
+
+void
+TestIntfI::release(const Ice::Current&)
+{
+    Lock sync(*this);
+    _holding = false;
+    notifyAll();
+}
+
+void
+TestIntfI::op(const Ice::Current&)
+{
+}
+
+void
+TestIntfI::record(Ice::Int id, const Ice::Current&)
+{
+    Lock sync(*this);
+    _records.push_back(id);
+}
+
+Ice::IntSeq
+TestIntfI::getRecords(const Ice::Current&)
+{
+    Lock sync(*this);
+    Ice::IntSeq records;
+    records.swap(_records);
+    return records;
+}
+
+void
+TestIntfI::shutdown(const Ice::Current& current)
+{
+    current.adapter->getCommunicator()->shutdown();
+}
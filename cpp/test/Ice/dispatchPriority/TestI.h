@@ -0,0 +1,36 @@
+// **********************************************************************
+//
+// Copyright (c) 2003-2011 ZeroC, Inc. All rights reserved.
+//
+// This copy of Ice is licensed to you under the terms described in the
+// ICE_LICENSE file included in this distribution.
+//
+// **********************************************************************
+
+#ifndef TEST_I_H
+#define TEST_I_H
+
+#include <IceUtil/Monitor.h>
+#include <Test.h>
+
+class TestIntfI : virtual public Test::TestIntf, public IceUtil::Monitor<IceUtil::Mutex>
+{
+public:
+
+    TestIntfI();
+
+    virtual void hold(const Ice::Current&);
+    virtual void waitForHold(const Ice::Current&);
+    virtual void release(const Ice::Current&);
+    virtual void op(const Ice::Current&);
+    virtual void record(Ice::Int, const Ice::Current&);
+    virtual Ice::IntSeq getRecords(const Ice::Current&);
+    virtual void shutdown(const Ice::Current&);
+
+private:
+
+    bool _holding;
+    Ice::IntSeq _records;
+};
+
+#endif
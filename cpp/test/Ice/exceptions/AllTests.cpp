@@ -1359,6 +1359,36 @@ allTests(const Ice::CommunicatorPtr& communicator, bool collocated)
         test(false);
     }
 
+    try
+    {
+        WrongOperationPrx thrower2 = WrongOperationPrx::uncheckedCast(thrower);
+        thrower2->throwCasD();
+        test(false);
+    }
+    catch(const Ice::OperationNotExistException& ex)
+    {
+        test(ex.operation == "throwCasD");
+    }
+    catch(...)
+    {
+        test(false);
+    }
+
+    try
+    {
+        WrongOperationPrx thrower2 = WrongOperationPrx::uncheckedCast(thrower);
+        thrower2->thrawCasC();
+        test(false);
+    }
+    catch(const Ice::OperationNotExistException& ex)
+    {
+        test(ex.operation == "thrawCasC");
+    }
+    catch(...)
+    {
+        test(false);
+    }
+
     cout << "ok" << endl;
 
     cout << "catching unknown local exception... " << flush;
@@ -637,7 +637,65 @@ MyApplication::run(int argc, char* argv[])
     test(getNum() == 0);
 
     cout << "ok" << endl;
-    
+
+    cout << "testing incremental collection... " << flush;
+
+    {
+        //
+        // Many small cycles, which the collector examines over several
+        // slices, and a single large cycle, which is examined in one slice.
+        //
+        NNPtr live = new NN;
+        live->n = live;
+        for(int i = 0; i < 20000; ++i)
+        {
+            NNPtr nn1 = new NN;
+            NNPtr nn2 = new NN;
+            nn1->n = nn2;
+            nn2->n = nn1;
+            nn1->l = new NL;
+        }
+
+        const int ringSize = 100001;
+        {
+            NNPtr first = new NN;
+            NNPtr last = first;
+            for(int i = 1; i < ringSize; ++i)
+            {
+                NNPtr nn = new NN;
+                last->n = nn;
+                last = nn;
+            }
+            last->n = first;
+        }
+        test(getNum() == 1 + 3 * 20000 + ringSize);
+        Ice::collectGarbage();
+        test(getNum() == 1);
+
+        //
+        // Instances that are still referenced are never collected, no matter
+        // how many times the collector examines them.
+        //
+        vector<NNPtr> nodes;
+        for(int i = 0; i < 1000; ++i)
+        {
+            NNPtr nn = new NN;
+            nn->n = live;
+            nodes.push_back(nn);
+        }
+        nodes.clear();
+        test(getNum() == 1);
+        Ice::collectGarbage();
+        Ice::collectGarbage();
+        test(getNum() == 1);
+        live->n = 0;
+    }
+    test(getNum() == 0);
+    Ice::collectGarbage();
+    test(getNum() == 0);
+
+    cout << "ok" << endl;
+
     cout << "testing for race conditions... " << flush;
     string seedfile = argv[1];
     ofstream file(seedfile.c_str());
@@ -0,0 +1,354 @@
+// **********************************************************************
+//
+// Copyright (c) 2003-2011 ZeroC, Inc. All rights reserved.
+//
+// This copy of Ice is licensed to you under the terms described in the
+// ICE_LICENSE file included in this distribution.
+//
+// **********************************************************************
+
+#include <Ice/Ice.h>
+#include <IceUtil/Thread.h>
+#include <TestCommon.h>
+#include <Test.h>
+
+using namespace std;
+using namespace Test;
+
+namespace
+{
+
+//
+// Returns the metrics of the given operation, checking that the
+// histogram is consistent with the other counters.
+//
+Ice::OperationMetrics
+getOperation(const Ice::OperationMetricsSeq& metrics, const string& operation)
+{
+    for(Ice::OperationMetricsSeq::const_iterator p = metrics.begin(); p != metrics.end(); ++p)
+    {
+        if(p->operation == operation)
+        {
+            test(p->latencyHistogram.size() == 32);
+            Ice::Long count = 0;
+            for(Ice::LongSeq::const_iterator q = p->latencyHistogram.begin(); q != p->latencyHistogram.end(); ++q)
+            {
+                count += *q;
+            }
+            test(count == p->count);
+            test(p->failures <= p->count);
+            test(p->maxLatency <= p->totalLatency);
+            return *p;
+        }
+    }
+
+    Ice::OperationMetrics m;
+    m.count = 0;
+    m.failures = 0;
+    return m;
+}
+
+Ice::ThreadPoolMetrics
+getThreadPool(const Ice::ThreadPoolMetricsSeq& metrics, const string& name)
+{
+    for(Ice::ThreadPoolMetricsSeq::const_iterator p = metrics.begin(); p != metrics.end(); ++p)
+    {
+        if(p->name == name)
+        {
+            return *p;
+        }
+    }
+
+    Ice::ThreadPoolMetrics m;
+    m.threads = 0;
+    return m;
+}
+
+void
+sendRequests(const TestIntfPrx& intf)
+{
+    for(int i = 0; i < 10; ++i)
+    {
+        intf->op();
+    }
+
+    ByteSeq seq(1000);
+    for(int i = 0; i < 5; ++i)
+    {
+        test(intf->opBytes(seq).size() == seq.size());
+    }
+
+    intf->opSleep(50);
+
+    for(int i = 0; i < 3; ++i)
+    {
+        try
+        {
+            intf->opException();
+            test(false);
+        }
+        catch(const TestException&)
+        {
+        }
+    }
+
+    for(int i = 0; i < 4; ++i)
+    {
+        intf->opAMD();
+    }
+
+    vector<Ice::AsyncResultPtr> results;
+    for(int i = 0; i < 5; ++i)
+    {
+        results.push_back(intf->begin_op());
+    }
+    for(vector<Ice::AsyncResultPtr>::const_iterator p = results.begin(); p != results.end(); ++p)
+    {
+        intf->end_op(*p);
+    }
+
+    try
+    {
+        intf->end_opException(intf->begin_opException());
+        test(false);
+    }
+    catch(const TestException&)
+    {
+    }
+
+    TestIntfPrx oneway = intf->ice_oneway();
+    for(int i = 0; i < 5; ++i)
+    {
+        oneway->op();
+    }
+
+    //
+    // Wait for the oneway requests to be dispatched.
+    //
+    intf->ice_ping();
+}
+
+}
+
+TestIntfPrx
+allTests(const Ice::CommunicatorPtr& communicator)
+{
+    string ref = "test:default -p 12010";
+    TestIntfPrx intf = TestIntfPrx::checkedCast(communicator->stringToProxy(ref));
+    test(intf);
+
+    cout << "testing metrics facet... " << flush;
+    Ice::ObjectPrx admin = communicator->stringToProxy("server/admin:tcp -h 127.0.0.1 -p 12011");
+    Ice::MetricsAdminPrx serverMetrics = Ice::MetricsAdminPrx::checkedCast(admin, "Metrics");
+    test(serverMetrics);
+    Ice::MetricsAdminPrx clientMetrics = Ice::MetricsAdminPrx::checkedCast(communicator->getAdmin(), "Metrics");
+    test(clientMetrics);
+    {
+        //
+        // The metrics are disabled if Ice.Metrics is set to 0.
+        //
+        Ice::InitializationData initData;
+        initData.properties = communicator->getProperties()->clone();
+        initData.properties->setProperty("Ice.Admin.InstanceName", "nometrics");
+        initData.properties->setProperty("Ice.Metrics", "0");
+        Ice::CommunicatorPtr com = Ice::initialize(initData);
+        test(com->getAdmin());
+        test(!Ice::MetricsAdminPrx::checkedCast(com->getAdmin(), "Metrics"));
+        com->destroy();
+    }
+    cout << "ok" << endl;
+
+    serverMetrics->reset();
+    clientMetrics->reset();
+    sendRequests(intf);
+
+    cout << "testing dispatch metrics... " << flush;
+    {
+        Ice::OperationMetricsSeq metrics = serverMetrics->getDispatchMetrics();
+
+        Ice::OperationMetrics m = getOperation(metrics, "op");
+        test(m.count == 20 && m.failures == 0);
+
+        m = getOperation(metrics, "opBytes");
+        test(m.count == 5 && m.failures == 0);
+        test(m.bytesIn >= 5000 && m.bytesOut >= 5000);
+
+        m = getOperation(metrics, "opSleep");
+        test(m.count == 1 && m.failures == 0);
+        test(m.maxLatency >= 50000 && m.totalLatency == m.maxLatency);
+        for(int i = 0; i < 16; ++i)
+        {
+            test(m.latencyHistogram[i] == 0);
+        }
+
+        m = getOperation(metrics, "opException");
+        test(m.count == 4 && m.failures == 4);
+
+        m = getOperation(metrics, "opAMD");
+        test(m.count == 4 && m.failures == 0);
+
+        m = getOperation(metrics, "ice_ping");
+        test(m.count == 1);
+
+        test(getOperation(metrics, "unknown").count == 0);
+    }
+    cout << "ok" << endl;
+
+    cout << "testing invocation metrics... " << flush;
+    {
+        Ice::OperationMetricsSeq metrics = clientMetrics->getInvocationMetrics();
+
+        Ice::OperationMetrics m = getOperation(metrics, "op");
+        test(m.count == 20 && m.failures == 0);
+
+        m = getOperation(metrics, "opBytes");
+        test(m.count == 5 && m.failures == 0);
+        test(m.bytesIn >= 5000 && m.bytesOut >= 5000);
+
+        m = getOperation(metrics, "opSleep");
+        test(m.count == 1 && m.maxLatency >= 50000);
+
+        m = getOperation(metrics, "opException");
+        test(m.count == 4 && m.failures == 4);
+
+        m = getOperation(metrics, "opAMD");
+        test(m.count == 4 && m.failures == 0);
+
+        //
+        // The server doesn't invoke any request.
+        //
+        test(serverMetrics->getInvocationMetrics().empty());
+    }
+    cout << "ok" << endl;
+
+    cout << "testing metrics of unknown operations... " << flush;
+    {
+        //
+        // The dispatches of operations which don't exist are recorded
+        // under a single operation, and the number of operations
+        // recorded by the invoking thread is bounded.
+        //
+        const int count = 600;
+        vector<Ice::Byte> inParams;
+        vector<Ice::Byte> outParams;
+        for(int i = 0; i < count; ++i)
+        {
+            ostringstream os;
+            os << "bogus" << i;
+            try
+            {
+                intf->ice_invoke(os.str(), Ice::Normal, inParams, outParams);
+                test(false);
+            }
+            catch(const Ice::OperationNotExistException&)
+            {
+            }
+        }
+        intf->ice_oneway()->ice_invoke("onewayBogus", Ice::Normal, inParams, outParams);
+        try
+        {
+            communicator->stringToProxy("missing:default -p 12010")->ice_ping();
+            test(false);
+        }
+        catch(const Ice::ObjectNotExistException&)
+        {
+        }
+        intf->ice_ping();
+
+        Ice::OperationMetricsSeq metrics = serverMetrics->getDispatchMetrics();
+        Ice::OperationMetrics m = getOperation(metrics, "<unknown>");
+        test(m.count == count + 2 && m.failures == count + 2);
+        test(getOperation(metrics, "bogus0").count == 0);
+        test(getOperation(metrics, "onewayBogus").count == 0);
+        test(getOperation(metrics, "op").count == 20);
+
+        metrics = clientMetrics->getInvocationMetrics();
+        int recorded = 0;
+        for(Ice::OperationMetricsSeq::const_iterator p = metrics.begin(); p != metrics.end(); ++p)
+        {
+            if(p->operation.find("bogus") == 0)
+            {
+                test(p->count == 1 && p->failures == 1);
+                ++recorded;
+            }
+        }
+        test(recorded > 0 && recorded < count);
+        test(getOperation(metrics, "onewayBogus").count == 0);
+        m = getOperation(metrics, "<unknown>");
+        test(m.count == count - recorded + 1 && m.failures == count - recorded);
+    }
+    cout << "ok" << endl;
+
+    cout << "testing connection metrics... " << flush;
+    {
+        Ice::ConnectionMetrics m = serverMetrics->getConnectionMetrics();
+        test(m.current >= 2); // The test and admin connections.
+        test(m.messagesReceived >= 35 && m.bytesReceived > 5000);
+        test(m.messagesSent >= 30 && m.bytesSent > 5000);
+        test(m.queuedMessages >= 0);
+
+        m = clientMetrics->getConnectionMetrics();
+        test(m.current >= 2);
+        test(m.messagesSent >= 35 && m.messagesReceived >= 30);
+
+        //
+        // Closing the test connection is eventually reflected by the
+        // server metrics.
+        //
+        Ice::Long current = serverMetrics->getConnectionMetrics().current;
+        intf->ice_getConnection()->close(false);
+        int i;
+        for(i = 0; i < 100; ++i)
+        {
+            if(serverMetrics->getConnectionMetrics().current == current - 1)
+            {
+                break;
+            }
+            IceUtil::ThreadControl::sleep(IceUtil::Time::milliSeconds(50));
+        }
+        test(i < 100);
+
+        intf->ice_ping();
+        m = serverMetrics->getConnectionMetrics();
+        test(m.current == current && m.total >= 1);
+    }
+    cout << "ok" << endl;
+
+    cout << "testing thread pool metrics... " << flush;
+    {
+        Ice::ThreadPoolMetricsSeq metrics = serverMetrics->getThreadPoolMetrics();
+
+        //
+        // The server thread pool dispatches this request.
+        //
+        Ice::ThreadPoolMetrics m = getThreadPool(metrics, "Ice.ThreadPool.Server");
+        test(m.threads >= 1 && m.inUse >= 1 && m.sizeMax >= m.threads);
+
+        m = getThreadPool(metrics, "TestAdapter.ThreadPool");
+        test(m.threads == 2 && m.sizeMax == 2 && m.queued >= 0);
+
+        test(getThreadPool(clientMetrics->getThreadPoolMetrics(), "Ice.ThreadPool.Client").threads >= 1);
+    }
+    cout << "ok" << endl;
+
+    cout << "testing buffer pool metrics... " << flush;
+    {
+        Ice::BufferPoolMetrics m = serverMetrics->getBufferPoolMetrics();
+        test(m.allocations > 0 && m.hits <= m.allocations && m.cachedBytes >= 0);
+    }
+    cout << "ok" << endl;
+
+    cout << "testing metrics reset... " << flush;
+    {
+        serverMetrics->reset();
+        test(getOperation(serverMetrics->getDispatchMetrics(), "op").count == 0);
+        intf->op();
+        test(getOperation(serverMetrics->getDispatchMetrics(), "op").count == 1);
+
+        Ice::ConnectionMetrics m = serverMetrics->getConnectionMetrics();
+        test(m.current >= 2 && m.total == 0);
+    }
+    cout << "ok" << endl;
+
+    return intf;
+}
@@ -0,0 +1,50 @@
+// **********************************************************************
+//
+// Copyright (c) 2003-2011 ZeroC, Inc. All rights reserved.
+//
+// This copy of Ice is licensed to you under the terms described in the
+// ICE_LICENSE file included in this distribution.
+//
+// **********************************************************************
+
+#include <Ice/Ice.h>
+#include <IceUtil/Thread.h>
+#include <TestI.h>
+
+using namespace std;
+using namespace Test;
+
+void
+TestIntfI::op(const Ice::Current&)
+{
+}
+
+ByteSeq
+TestIntfI::opBytes(const ByteSeq& seq, const Ice::Current&)
+{
+    return seq;
+}
+
+void
+TestIntfI::opSleep(Ice::Int ms, const Ice::Current&)
+{
+    IceUtil::ThreadControl::sleep(IceUtil::Time::milliSeconds(ms));
+}
+
+void
+TestIntfI::opException(const Ice::Current&)
+{
+    throw TestException();
+}
+
+void
+TestIntfI::opAMD_async(const AMD_TestIntf_opAMDPtr& cb, const Ice::Current&)
+{
+    cb->ice_response();
+}
+
+void
+TestIntfI::shutdown(const Ice::Current& current)
+{
+    current.adapter->getCommunicator()->shutdown();
+}
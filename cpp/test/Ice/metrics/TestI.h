@@ -0,0 +1,27 @@
+// **********************************************************************
+//
+// Copyright (c) 2003-2011 ZeroC, Inc. All rights reserved.
+//
+// This copy of Ice is licensed to you under the terms described in the
+// ICE_LICENSE file included in this distribution.
+//
+// **********************************************************************
+
+#ifndef TEST_I_H
+#define TEST_I_H
+
+#include <Test.h>
+
+class TestIntfI : virtual public Test::TestIntf
+{
+public:
+
+    virtual void op(const Ice::Current&);
+    virtual Test::ByteSeq opBytes(const Test::ByteSeq&, const Ice::Current&);
+    virtual void opSleep(Ice::Int, const Ice::Current&);
+    virtual void opException(const Ice::Current&);
+    virtual void opAMD_async(const Test::AMD_TestIntf_opAMDPtr&, const Ice::Current&);
+    virtual void shutdown(const Ice::Current&);
+};
+
+#endif
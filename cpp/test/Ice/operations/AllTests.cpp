@@ -34,30 +34,30 @@ allTests(const Ice::CommunicatorPtr& communicator, bool collocated)
     oneways(communicator, cl);
     cout << "ok" << endl;
 
-    if(!collocated)
-    {
-        cout << "testing twoway operations with AMI... " << flush;
-        void twowaysAMI(const Ice::CommunicatorPtr&, const Test::MyClassPrx&);
-        twowaysAMI(communicator, cl);
-        twowaysAMI(communicator, derived);
-        cout << "ok" << endl;
+    cout << "testing twoway operations with AMI... " << flush;
+    void twowaysAMI(const Ice::CommunicatorPtr&, const Test::MyClassPrx&);
+    twowaysAMI(communicator, cl);
+    twowaysAMI(communicator, derived);
+    cout << "ok" << endl;
 
-        cout << "testing twoway operations with new AMI mapping... " << flush;
-        void twowaysNewAMI(const Ice::CommunicatorPtr&, const Test::MyClassPrx&);
-        twowaysNewAMI(communicator, cl);
-        twowaysNewAMI(communicator, derived);
-        cout << "ok" << endl;
+    cout << "testing twoway operations with new AMI mapping... " << flush;
+    void twowaysNewAMI(const Ice::CommunicatorPtr&, const Test::MyClassPrx&);
+    twowaysNewAMI(communicator, cl);
+    twowaysNewAMI(communicator, derived);
+    cout << "ok" << endl;
 
-        cout << "testing oneway operations with AMI... " << flush;
-        void onewaysAMI(const Ice::CommunicatorPtr&, const Test::MyClassPrx&);
-        onewaysAMI(communicator, cl);
-        cout << "ok" << endl;
+    cout << "testing oneway operations with AMI... " << flush;
+    void onewaysAMI(const Ice::CommunicatorPtr&, const Test::MyClassPrx&);
+    onewaysAMI(communicator, cl);
+    cout << "ok" << endl;
 
-        cout << "testing oneway operations with new AMI mapping... " << flush;
-        void onewaysNewAMI(const Ice::CommunicatorPtr&, const Test::MyClassPrx&);
-        onewaysNewAMI(communicator, cl);
-        cout << "ok" << endl;
+    cout << "testing oneway operations with new AMI mapping... " << flush;
+    void onewaysNewAMI(const Ice::CommunicatorPtr&, const Test::MyClassPrx&);
+    onewaysNewAMI(communicator, cl);
+    cout << "ok" << endl;
 
+    if(!collocated)
+    {
         cout << "testing batch oneway operations... " << flush;
         void batchOneways(const Test::MyClassPrx&);
         batchOneways(cl);
@@ -64,7 +64,12 @@ batchOneways(const Test::MyClassPrx& p)
     
     batch->ice_getConnection()->flushBatchRequests();
 
-    Test::MyClassPrx batch2 = Test::MyClassPrx::uncheckedCast(p->ice_batchOneway());
+    //
+    // Derive the second batch proxy from another proxy, as the proxy
+    // returned by p->ice_batchOneway() is cached.
+    //
+    Test::MyClassPrx batch2 = Test::MyClassPrx::uncheckedCast(p->ice_oneway()->ice_batchOneway());
+    test(batch2.get() != batch.get());
 
     batch->ice_ping();
     batch2->ice_ping();
@@ -61,6 +61,10 @@ twoways(const Ice::CommunicatorPtr& communicator, const Test::MyClassPrx& p)
 
     {
         test(p->ice_isA(Test::MyClass::ice_staticId()));
+        test(p->ice_isA("::Ice::Object"));
+        test(!p->ice_isA("::Test::MyClasz"));
+        test(!p->ice_isA("::Test::MyDerived"));
+        test(!p->ice_isA(""));
     }
 
     {
@@ -24,6 +24,13 @@ print "tests with regular server."
 TestUtil.clientServerTest(additionalClientOptions = "--Ice.Warn.AMICallback=0")
 print "tests with AMD server."
 TestUtil.clientServerTest(additionalClientOptions = "--Ice.Warn.AMICallback=0", server = "serveramd")
+print "tests with reactor thread pools."
+TestUtil.clientServerTest(additionalServerOptions = "--Ice.ThreadPool.Server.Model=Reactor --Ice.ThreadPool.Server.Size=4",
+                          additionalClientOptions = "--Ice.Warn.AMICallback=0 --Ice.ThreadPool.Client.Model=Reactor " +
+                                                    "--Ice.ThreadPool.Client.Size=2")
+print "tests with edge-triggered thread pools."
+TestUtil.clientServerTest(additionalServerOptions = "--Ice.ThreadPool.Server.EdgeTriggered=1",
+                          additionalClientOptions = "--Ice.Warn.AMICallback=0 --Ice.ThreadPool.Client.EdgeTriggered=1")
 print "tests with collocated server."
 TestUtil.collocatedTest()
 
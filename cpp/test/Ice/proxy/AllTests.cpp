@@ -403,6 +403,51 @@ allTests(const Ice::CommunicatorPtr& communicator)
     test(!base->ice_preferSecure(false)->ice_isPreferSecure());
     cout << "ok" << endl;
 
+    cout << "testing cached proxy variants... " << flush;
+    test(base->ice_oneway().get() == base->ice_oneway().get());
+    test(base->ice_batchOneway().get() == base->ice_batchOneway().get());
+    test(base->ice_datagram().get() == base->ice_datagram().get());
+    test(base->ice_batchDatagram().get() == base->ice_batchDatagram().get());
+    test(base->ice_oneway()->ice_twoway() == base);
+    test(base->ice_secure(true).get() == base->ice_secure(true).get());
+    test(base->ice_timeout(10).get() == base->ice_timeout(10).get());
+    test(base->ice_timeout(10) != base->ice_timeout(20));
+    {
+        Ice::Context ctx;
+        ctx["one"] = "hello";
+        Ice::Context ctx2;
+        ctx2["two"] = "world";
+        test(base->ice_context(ctx).get() == base->ice_context(ctx).get());
+        test(base->ice_context(ctx2)->ice_getContext() == ctx2);
+        test(base->ice_context(ctx)->ice_getContext() == ctx);
+    }
+    test(base->ice_oneway()->ice_timeout(10)->ice_isOneway());
+    test(base->ice_oneway()->ice_timeout(10) == base->ice_timeout(10)->ice_oneway());
+    {
+        //
+        // A variant remains cached once it's been used, including when
+        // the server is collocated and the variant has no connection.
+        //
+        Ice::ObjectPrx derived = base->ice_timeout(1000);
+        derived->ice_ping();
+        test(base->ice_timeout(1000).get() == derived.get());
+    }
+    {
+        Ice::ObjectPrx unreachable = communicator->stringToProxy("test:default -p 12011");
+        Ice::ObjectPrx derived = unreachable->ice_timeout(500);
+        try
+        {
+            derived->ice_ping();
+            test(false);
+        }
+        catch(const Ice::LocalException&)
+        {
+        }
+        test(unreachable->ice_timeout(500).get() != derived.get());
+        test(unreachable->ice_timeout(500).get() == unreachable->ice_timeout(500).get());
+    }
+    cout << "ok" << endl;
+
     cout << "testing proxy comparison... " << flush;
 
     test(communicator->stringToProxy("foo") == communicator->stringToProxy("foo"));
@@ -0,0 +1,332 @@
+// **********************************************************************
+//
+// Copyright (c) 2003-2011 ZeroC, Inc. All rights reserved.
+//
+// This copy of Ice is licensed to you under the terms described in the
+// ICE_LICENSE file included in this distribution.
+//
+// **********************************************************************
+
+#include <IceUtil/IceUtil.h>
+#include <Ice/Ice.h>
+#include <Ice/RequestTable.h>
+#include <Ice/Network.h>
+#include <TestCommon.h>
+#include <map>
+
+using namespace std;
+using namespace IceInternal;
+
+namespace
+{
+
+void
+writeAll(SOCKET fd, const Ice::Byte* p, size_t sz)
+{
+    while(sz > 0)
+    {
+        ssize_t n = ::send(fd, reinterpret_cast<const char*>(p), static_cast<int>(sz), 0);
+        test(n > 0);
+        p += n;
+        sz -= static_cast<size_t>(n);
+    }
+}
+
+bool
+readAll(SOCKET fd, Ice::Byte* p, size_t sz)
+{
+    while(sz > 0)
+    {
+        ssize_t n = ::recv(fd, reinterpret_cast<char*>(p), static_cast<int>(sz), 0);
+        if(n <= 0)
+        {
+            return false;
+        }
+        p += n;
+        sz -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+//
+// A server which validates the connection and answers the first
+// request with a reply carrying the given request id.
+//
+class ReplyThread : public IceUtil::Thread
+{
+public:
+
+    ReplyThread(SOCKET fd, Ice::Int requestId) :
+        _fd(fd),
+        _requestId(requestId)
+    {
+    }
+
+    virtual void
+    run()
+    {
+        SOCKET fd = IceInternal::doAccept(_fd);
+        IceInternal::setBlock(fd, true);
+
+        Ice::Byte header[14] = { 'I', 'c', 'e', 'P', 1, 0, 1, 0, 0, 0, 14, 0, 0, 0 };
+        header[8] = 3; // Validate connection message.
+        writeAll(fd, header, sizeof(header));
+
+        Ice::Byte request[14];
+        test(readAll(fd, request, sizeof(request)));
+        Ice::Int size = request[10] | (request[11] << 8) | (request[12] << 16) | (request[13] << 24);
+        vector<Ice::Byte> body(static_cast<size_t>(size) - sizeof(request));
+        test(readAll(fd, &body[0], body.size()));
+
+        //
+        // Reply message with an empty encapsulation.
+        //
+        Ice::Byte reply[25] = { 'I', 'c', 'e', 'P', 1, 0, 1, 0, 2, 0, 25, 0, 0, 0 };
+        for(int i = 0; i < 4; ++i)
+        {
+            reply[14 + i] = static_cast<Ice::Byte>(_requestId >> (8 * i));
+        }
+        reply[18] = 0; // Success.
+        reply[19] = 6; // Encapsulation size.
+        reply[23] = 1; // Encoding.
+        writeAll(fd, reply, sizeof(reply));
+
+        //
+        // Wait for the client to close the connection.
+        //
+        Ice::Byte b;
+        while(readAll(fd, &b, 1))
+        {
+        }
+        IceInternal::closeSocket(fd);
+    }
+
+private:
+
+    const SOCKET _fd;
+    const Ice::Int _requestId;
+};
+
+//
+// Simulates a connection with the given number of pipelined requests:
+// each reply completes the oldest outstanding request and a new
+// request is sent, until the given number of requests is sent. The
+// map version uses the "hint" iterator of the previous ConnectionI
+// implementation.
+//
+Ice::Long
+benchMap(int outstanding, int requests)
+{
+    map<Ice::Int, Ice::Long> table;
+    map<Ice::Int, Ice::Long>::iterator hint = table.end();
+    Ice::Long total = 0;
+    Ice::Int nextRequestId = 1;
+    Ice::Int nextReplyId = 1;
+    while(nextRequestId <= requests)
+    {
+        while(nextRequestId - nextReplyId < outstanding && nextRequestId <= requests)
+        {
+            hint = table.insert(table.end(), pair<const Ice::Int, Ice::Long>(nextRequestId, nextRequestId));
+            ++nextRequestId;
+        }
+
+        map<Ice::Int, Ice::Long>::iterator p = table.end();
+        if(hint != table.end() && hint->first == nextReplyId)
+        {
+            p = hint;
+        }
+        else
+        {
+            p = table.find(nextReplyId);
+        }
+        test(p != table.end());
+        total += p->second;
+        if(p == hint)
+        {
+            table.erase(p++);
+            hint = p;
+        }
+        else
+        {
+            table.erase(p);
+        }
+        ++nextReplyId;
+    }
+    return total;
+}
+
+Ice::Long
+benchRequestTable(int outstanding, int requests)
+{
+    RequestTable<Ice::Long> table;
+    Ice::Long total = 0;
+    Ice::Int nextRequestId = 1;
+    Ice::Int nextReplyId = 1;
+    while(nextRequestId <= requests)
+    {
+        while(nextRequestId - nextReplyId < outstanding && nextRequestId <= requests)
+        {
+            table.insert(nextRequestId, nextRequestId);
+            ++nextRequestId;
+        }
+
+        RequestTable<Ice::Long>::iterator p = table.find(nextReplyId);
+        test(p != table.end());
+        total += p->second;
+        table.erase(p);
+        ++nextReplyId;
+    }
+    return total;
+}
+
+}
+
+int
+main(int, char**)
+{
+    cout << "testing request table... " << flush;
+    {
+        RequestTable<int> table;
+        test(table.empty());
+        test(table.begin() == table.end());
+        test(table.find(1) == table.end());
+        test(!table.erase(1));
+
+        for(int i = 1; i <= 100; ++i)
+        {
+            table.insert(i, i * 2);
+        }
+        test(table.size() == 100);
+        for(int i = 1; i <= 100; ++i)
+        {
+            RequestTable<int>::iterator p = table.find(i);
+            test(p != table.end() && p->first == i && p->second == i * 2);
+        }
+        test(table.find(101) == table.end());
+
+        int count = 0;
+        for(RequestTable<int>::iterator p = table.begin(); p != table.end(); ++p)
+        {
+            test(p->second == p->first * 2);
+            ++count;
+        }
+        test(count == 100);
+
+        table.clear();
+        test(table.empty());
+        test(table.begin() == table.end());
+    }
+
+    {
+        //
+        // Compare against a map with random inserts and erases,
+        // including ids with a regular pattern which fill the same
+        // low bits.
+        //
+        RequestTable<int> table;
+        map<int, int> reference;
+        srand(1);
+        for(int i = 0; i < 100000; ++i)
+        {
+            Ice::Int id = rand() % 4 == 0 ? (rand() % 16) * 64 + 63 : rand() % 1000 + 1;
+            if(reference.find(id) == reference.end())
+            {
+                test(table.find(id) == table.end());
+                table.insert(id, i);
+                reference[id] = i;
+            }
+            else
+            {
+                RequestTable<int>::iterator p = table.find(id);
+                test(p != table.end() && p->second == reference[id]);
+                table.erase(p);
+                reference.erase(id);
+            }
+            test(table.size() == reference.size());
+        }
+
+        for(map<int, int>::const_iterator p = reference.begin(); p != reference.end(); ++p)
+        {
+            RequestTable<int>::iterator q = table.find(p->first);
+            test(q != table.end() && q->second == p->second);
+        }
+    }
+    cout << "ok" << endl;
+
+    cout << "testing invalid request ids... " << flush;
+    {
+        //
+        // Ids which aren't positive are never found, neither in an
+        // empty table nor in a table with erased slots.
+        //
+        RequestTable<int> table;
+        test(table.find(0) == table.end());
+        test(table.find(-1) == table.end());
+        table.insert(15, 1);
+        table.insert(31, 2);
+        test(table.erase(15));
+        test(table.find(0) == table.end());
+        test(table.find(-1) == table.end());
+        test(!table.erase(0));
+        test(!table.erase(-1));
+        test(table.find(31) != table.end());
+    }
+
+    {
+        //
+        // A reply with an invalid request id closes the connection.
+        //
+        Ice::InitializationData initData;
+        initData.properties = Ice::createProperties();
+        initData.properties->setProperty("Ice.RetryIntervals", "-1");
+        initData.properties->setProperty("Ice.Warn.Connections", "0");
+        Ice::CommunicatorPtr communicator = Ice::initialize(initData);
+
+        const Ice::Int requestIds[] = { 0, -1, 2 };
+        for(unsigned int i = 0; i < sizeof(requestIds) / sizeof(Ice::Int); ++i)
+        {
+            struct sockaddr_storage addr = IceInternal::getAddressForServer("127.0.0.1", 0, IceInternal::EnableIPv4);
+            SOCKET fd = IceInternal::createSocket(false, addr.ss_family);
+            IceInternal::setBlock(fd, true);
+            addr = IceInternal::doBind(fd, addr);
+            IceInternal::doListen(fd, 1);
+
+            IceUtil::ThreadPtr thread = new ReplyThread(fd, requestIds[i]);
+            IceUtil::ThreadControl control = thread->start();
+
+            ostringstream os;
+            os << "test:tcp -h 127.0.0.1 -p " << IceInternal::getPort(addr);
+            try
+            {
+                communicator->stringToProxy(os.str())->ice_ping();
+                test(false);
+            }
+            catch(const Ice::UnknownRequestIdException&)
+            {
+            }
+            control.join();
+            IceInternal::closeSocket(fd);
+        }
+        communicator->destroy();
+    }
+    cout << "ok" << endl;
+
+    cout << "benchmarking pipelined requests:" << endl;
+    const int requests = 1000000;
+    const int outstanding[] = { 1, 10, 100, 1000, 10000 };
+    for(unsigned int i = 0; i < sizeof(outstanding) / sizeof(int); ++i)
+    {
+        IceUtil::Time start = IceUtil::Time::now(IceUtil::Time::Monotonic);
+        Ice::Long total = benchMap(outstanding[i], requests);
+        IceUtil::Time mapTime = IceUtil::Time::now(IceUtil::Time::Monotonic) - start;
+
+        start = IceUtil::Time::now(IceUtil::Time::Monotonic);
+        test(benchRequestTable(outstanding[i], requests) == total);
+        IceUtil::Time tableTime = IceUtil::Time::now(IceUtil::Time::Monotonic) - start;
+
+        cout << "  " << outstanding[i] << " outstanding: map " << mapTime.toMilliSecondsDouble() << "ms, "
+             << "request table " << tableTime.toMilliSecondsDouble() << "ms" << endl;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1 @@
+Client$(OBJEXT): Client.cpp "$(includedir)/IceUtil/IceUtil.h" "$(includedir)/IceUtil/CountDownLatch.h" "$(includedir)/Ice/Ice.h" "../../../src/Ice/ObjectAdapterI.h" "../../../src/Ice/ServantManager.h" ../../include/TestCommon.h
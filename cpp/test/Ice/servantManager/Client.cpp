@@ -0,0 +1,411 @@
+// **********************************************************************
+//
+// Copyright (c) 2003-2011 ZeroC, Inc. All rights reserved.
+//
+// This copy of Ice is licensed to you under the terms described in the
+// ICE_LICENSE file included in this distribution.
+//
+// **********************************************************************
+
+#include <IceUtil/IceUtil.h>
+#include <IceUtil/CountDownLatch.h>
+#include <Ice/Ice.h>
+#include <Ice/ObjectAdapterI.h>
+#include <Ice/ServantManager.h>
+#include <TestCommon.h>
+
+using namespace std;
+using namespace Ice;
+
+namespace
+{
+
+class ServantI : public Blobject
+{
+public:
+
+    virtual bool
+    ice_invoke(const vector<Byte>&, vector<Byte>&, const Current&)
+    {
+        return true;
+    }
+};
+
+Identity
+makeIdentity(int i, const string& category = "")
+{
+    ostringstream os;
+    os << "servant-" << i;
+    Identity ident;
+    ident.name = os.str();
+    ident.category = category;
+    return ident;
+}
+
+//
+// The servant manager as it was before the servants were striped: a
+// single map of identities and the default servants protected by one
+// mutex.
+//
+class GlobalLockTable : public IceUtil::Mutex
+{
+public:
+
+    void
+    add(const ObjectPtr& servant, const Identity& ident)
+    {
+        Lock sync(*this);
+        _servants[ident][""] = servant;
+    }
+
+    void
+    addDefault(const ObjectPtr& servant, const string& category)
+    {
+        Lock sync(*this);
+        _defaultServants[category] = servant;
+    }
+
+    ObjectPtr
+    find(const Identity& ident, const string& facet) const
+    {
+        Lock sync(*this);
+        map<Identity, FacetMap>::const_iterator p = _servants.find(ident);
+        if(p != _servants.end())
+        {
+            FacetMap::const_iterator q = p->second.find(facet);
+            if(q != p->second.end())
+            {
+                return q->second;
+            }
+        }
+
+        map<string, ObjectPtr>::const_iterator q = _defaultServants.find(ident.category);
+        if(q == _defaultServants.end())
+        {
+            q = _defaultServants.find("");
+            if(q == _defaultServants.end())
+            {
+                return 0;
+            }
+        }
+        return q->second;
+    }
+
+private:
+
+    map<Identity, FacetMap> _servants;
+    map<string, ObjectPtr> _defaultServants;
+};
+
+//
+// Checks that the servants of stable identities are always found
+// while other threads add and remove servants.
+//
+class StressThread : public IceUtil::Thread
+{
+public:
+
+    StressThread(const ObjectAdapterPtr& adapter, int id, int stable) :
+        _adapter(adapter),
+        _id(id),
+        _stable(stable)
+    {
+    }
+
+    virtual void
+    run()
+    {
+        for(int i = 0; i < 2000; ++i)
+        {
+            Identity ident = makeIdentity(i, "stress");
+            ostringstream os;
+            os << _id;
+            ident.category += os.str();
+            ObjectPtr servant = new ServantI;
+            _adapter->add(servant, ident);
+            test(_adapter->find(ident) == servant);
+            test(_adapter->find(makeIdentity(i % _stable)));
+            test(_adapter->remove(ident) == servant);
+            test(!_adapter->find(ident));
+        }
+    }
+
+private:
+
+    const ObjectAdapterPtr _adapter;
+    const int _id;
+    const int _stable;
+};
+
+template<typename T> class LookupThread : public IceUtil::Thread
+{
+public:
+
+    LookupThread(const T& table, const vector<Identity>& identities, int lookups, IceUtilInternal::CountDownLatch& start) :
+        _table(table),
+        _identities(identities),
+        _lookups(lookups),
+        _start(start)
+    {
+    }
+
+    virtual void
+    run()
+    {
+        _start.await();
+        size_t n = static_cast<size_t>(rand());
+        for(int i = 0; i < _lookups; ++i)
+        {
+            n = (n * 1103515245 + 12345) & 0x7fffffff;
+            test(_table->find(_identities[n % _identities.size()], ""));
+        }
+    }
+
+private:
+
+    const T _table;
+    const vector<Identity>& _identities;
+    const int _lookups;
+    IceUtilInternal::CountDownLatch& _start;
+};
+
+//
+// Adapts the servant manager to the interface of GlobalLockTable.
+//
+class StripedTable : public IceUtil::Shared
+{
+public:
+
+    StripedTable(const IceInternal::ServantManagerPtr& servantManager) :
+        _servantManager(servantManager)
+    {
+    }
+
+    ObjectPtr
+    find(const Identity& ident, const string& facet) const
+    {
+        return _servantManager->findServant(ident, facet);
+    }
+
+private:
+
+    const IceInternal::ServantManagerPtr _servantManager;
+};
+typedef IceUtil::Handle<StripedTable> StripedTablePtr;
+
+template<typename T> double
+measure(const T& table, const vector<Identity>& identities, int threads)
+{
+    const int lookups = 400000 / threads;
+    IceUtilInternal::CountDownLatch start(1);
+    vector<IceUtil::ThreadControl> controls;
+    for(int i = 0; i < threads; ++i)
+    {
+        IceUtil::ThreadPtr thread = new LookupThread<T>(table, identities, lookups, start);
+        controls.push_back(thread->start());
+    }
+
+    IceUtil::Time begin = IceUtil::Time::now(IceUtil::Time::Monotonic);
+    start.countDown();
+    for(vector<IceUtil::ThreadControl>::iterator p = controls.begin(); p != controls.end(); ++p)
+    {
+        p->join();
+    }
+    IceUtil::Time elapsed = IceUtil::Time::now(IceUtil::Time::Monotonic) - begin;
+    return static_cast<double>(lookups) * threads / elapsed.toSecondsDouble() / 1000000;
+}
+
+}
+
+int
+main(int argc, char* argv[])
+{
+    CommunicatorPtr communicator = initialize(argc, argv);
+    communicator->getProperties()->setProperty("TestAdapter.Endpoints", "default");
+    ObjectAdapterPtr adapter = communicator->createObjectAdapter("TestAdapter");
+
+    cout << "testing servant registration... " << flush;
+    {
+        const int count = 10000;
+        map<Identity, FacetMap> servants;
+        for(int i = 0; i < count; ++i)
+        {
+            Identity ident = makeIdentity(i, i % 3 == 0 ? "" : "category");
+            ObjectPtr servant = new ServantI;
+            adapter->add(servant, ident);
+            servants[ident][""] = servant;
+            if(i % 5 == 0)
+            {
+                servant = new ServantI;
+                adapter->addFacet(servant, ident, "facet");
+                servants[ident]["facet"] = servant;
+            }
+        }
+
+        for(map<Identity, FacetMap>::const_iterator p = servants.begin(); p != servants.end(); ++p)
+        {
+            test(adapter->findAllFacets(p->first) == p->second);
+            for(FacetMap::const_iterator q = p->second.begin(); q != p->second.end(); ++q)
+            {
+                test(adapter->findFacet(p->first, q->first) == q->second);
+            }
+            test(!adapter->findFacet(p->first, "unknown"));
+        }
+        test(!adapter->find(makeIdentity(count)));
+        test(adapter->findAllFacets(makeIdentity(count)).empty());
+
+        try
+        {
+            adapter->add(new ServantI, makeIdentity(0));
+            test(false);
+        }
+        catch(const AlreadyRegisteredException&)
+        {
+        }
+
+        try
+        {
+            adapter->remove(makeIdentity(count));
+            test(false);
+        }
+        catch(const NotRegisteredException&)
+        {
+        }
+
+        try
+        {
+            adapter->removeFacet(makeIdentity(1, "category"), "facet");
+            test(false);
+        }
+        catch(const NotRegisteredException&)
+        {
+        }
+
+        //
+        // Removing the last facet of an identity removes the identity.
+        //
+        for(int i = 0; i < count; i += 2)
+        {
+            Identity ident = makeIdentity(i, i % 3 == 0 ? "" : "category");
+            if(i % 4 == 0)
+            {
+                test(adapter->removeAllFacets(ident) == servants[ident]);
+            }
+            else
+            {
+                FacetMap& facets = servants[ident];
+                for(FacetMap::const_iterator q = facets.begin(); q != facets.end(); ++q)
+                {
+                    test(adapter->removeFacet(ident, q->first) == q->second);
+                }
+            }
+            servants.erase(ident);
+            test(!adapter->find(ident));
+            test(adapter->findAllFacets(ident).empty());
+        }
+
+        for(map<Identity, FacetMap>::const_iterator p = servants.begin(); p != servants.end(); ++p)
+        {
+            test(adapter->findAllFacets(p->first) == p->second);
+        }
+
+        for(map<Identity, FacetMap>::const_iterator p = servants.begin(); p != servants.end(); ++p)
+        {
+            adapter->removeAllFacets(p->first);
+        }
+    }
+    cout << "ok" << endl;
+
+    cout << "testing default servants... " << flush;
+    {
+        ObjectPtr servant = new ServantI;
+        ObjectPtr defaultServant = new ServantI;
+        ObjectPtr categoryServant = new ServantI;
+        adapter->add(servant, makeIdentity(0, "category"));
+        test(!adapter->find(makeIdentity(1, "category")));
+
+        adapter->addDefaultServant(defaultServant, "");
+        test(adapter->find(makeIdentity(0, "category")) == servant);
+        test(adapter->find(makeIdentity(1, "category")) == defaultServant);
+        test(adapter->findFacet(makeIdentity(0, "category"), "facet") == defaultServant);
+
+        adapter->addDefaultServant(categoryServant, "category");
+        test(adapter->find(makeIdentity(1, "category")) == categoryServant);
+        test(adapter->find(makeIdentity(1, "other")) == defaultServant);
+        test(adapter->findDefaultServant("category") == categoryServant);
+
+        test(adapter->removeDefaultServant("category") == categoryServant);
+        test(adapter->removeDefaultServant("") == defaultServant);
+        test(!adapter->find(makeIdentity(1, "category")));
+        adapter->remove(makeIdentity(0, "category"));
+    }
+    cout << "ok" << endl;
+
+    const int stable = 100000;
+    vector<Identity> identities;
+    for(int i = 0; i < stable; ++i)
+    {
+        identities.push_back(makeIdentity(i));
+        adapter->add(new ServantI, identities.back());
+    }
+
+    cout << "testing concurrent registration... " << flush;
+    {
+        vector<IceUtil::ThreadControl> controls;
+        for(int i = 0; i < 8; ++i)
+        {
+            IceUtil::ThreadPtr thread = new StressThread(adapter, i, stable);
+            controls.push_back(thread->start());
+        }
+        for(vector<IceUtil::ThreadControl>::iterator p = controls.begin(); p != controls.end(); ++p)
+        {
+            p->join();
+        }
+    }
+    cout << "ok" << endl;
+
+    cout << "measuring lookups with " << stable << " servants (millions per second):" << endl;
+    {
+        GlobalLockTable* globalLockTable = new GlobalLockTable;
+        for(vector<Identity>::const_iterator p = identities.begin(); p != identities.end(); ++p)
+        {
+            globalLockTable->add(adapter->find(*p), *p);
+        }
+        IceInternal::ServantManagerPtr servantManager =
+            ObjectAdapterIPtr::dynamicCast(adapter)->getServantManager();
+        StripedTablePtr stripedTable = new StripedTable(servantManager);
+
+        const int threads[] = { 1, 4, 16, 32 };
+        for(unsigned int i = 0; i < sizeof(threads) / sizeof(int); ++i)
+        {
+            cout << "  " << threads[i] << " thread(s): global lock " << measure(globalLockTable, identities, threads[i])
+                 << ", striped " << measure(stripedTable, identities, threads[i]) << endl;
+        }
+
+        //
+        // The identities of the default servant category are not
+        // registered, each lookup misses the servant table.
+        //
+        vector<Identity> defaultIdentities;
+        for(int i = 0; i < 1000; ++i)
+        {
+            defaultIdentities.push_back(makeIdentity(i, "default"));
+        }
+        ObjectPtr defaultServant = new ServantI;
+        adapter->addDefaultServant(defaultServant, "default");
+        globalLockTable->addDefault(defaultServant, "default");
+
+        cout << "measuring default servant lookups (millions per second):" << endl;
+        for(unsigned int i = 0; i < sizeof(threads) / sizeof(int); ++i)
+        {
+            cout << "  " << threads[i] << " thread(s): global lock "
+                 << measure(globalLockTable, defaultIdentities, threads[i])
+                 << ", striped " << measure(stripedTable, defaultIdentities, threads[i]) << endl;
+        }
+        adapter->removeDefaultServant("default");
+        delete globalLockTable;
+    }
+
+    communicator->destroy();
+    return EXIT_SUCCESS;
+}
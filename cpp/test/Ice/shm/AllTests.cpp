@@ -0,0 +1,278 @@
+// **********************************************************************
+//
+// Copyright (c) 2003-2011 ZeroC, Inc. All rights reserved.
+//
+// This copy of Ice is licensed to you under the terms described in the
+// ICE_LICENSE file included in this distribution.
+//
+// **********************************************************************
+
+#include <Ice/Ice.h>
+#include <IceUtil/Time.h>
+#include <TestCommon.h>
+#include <Test.h>
+
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+using namespace std;
+using namespace Test;
+
+namespace
+{
+
+ByteSeq
+makeSeq(size_t size, int seed)
+{
+    ByteSeq seq(size);
+    for(size_t i = 0; i < size; ++i)
+    {
+        seq[i] = static_cast<Ice::Byte>(i * 7 + seed);
+    }
+    return seq;
+}
+
+void
+testEcho(const TestIntfPrx& prx)
+{
+    const size_t sizes[] = { 0, 1, 100, 4000, 4096, 4097, 10000, 65536, 100000, 500000, 1000000 };
+    for(size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i)
+    {
+        ByteSeq seq = makeSeq(sizes[i], static_cast<int>(i));
+        test(prx->echo(seq) == seq);
+    }
+}
+
+void
+testConcurrentEcho(const TestIntfPrx& prx)
+{
+    //
+    // Many outstanding requests of varying sizes keep both rings busy
+    // and mix the ring and inline paths of the transport.
+    //
+    vector<Ice::AsyncResultPtr> results;
+    vector<ByteSeq> seqs;
+    for(int i = 0; i < 200; ++i)
+    {
+        seqs.push_back(makeSeq((i % 10) * 1500 + (i % 3) * 40000, i));
+        results.push_back(prx->begin_echo(seqs.back()));
+    }
+    for(size_t i = 0; i < results.size(); ++i)
+    {
+        test(prx->end_echo(results[i]) == seqs[i]);
+    }
+}
+
+#if defined(MFD_ALLOW_SEALING) && defined(F_ADD_SEALS)
+
+//
+// Connects to the shm endpoint with a raw socket and passes it a
+// segment with a valid header, sealed or not. Returns whether the
+// server accepted the segment, that is whether it sent the first
+// wakeup byte instead of closing the connection.
+//
+bool
+handshake(const string& path, bool sealed)
+{
+    const Ice::Int size = 4096;
+    const size_t headerSize = 64; // SegmentHeader
+    const size_t ringSize = 128; // ShmTransceiver::Ring
+    int fd = memfd_create("ice-shm-test", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    test(fd != -1);
+    test(ftruncate(fd, static_cast<off_t>(headerSize + 2 * ringSize + 2 * size)) == 0);
+    if(sealed)
+    {
+        test(fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW) == 0);
+    }
+
+    Ice::Byte header[12] = { 'I', 'c', 'e', 'M' };
+    Ice::Int version = 1;
+    memcpy(header + 4, &version, sizeof(version));
+    memcpy(header + 8, &size, sizeof(size));
+    test(pwrite(fd, header, sizeof(header), 0) == static_cast<ssize_t>(sizeof(header)));
+
+    int s = socket(AF_UNIX, SOCK_STREAM, 0);
+    test(s != -1);
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+    test(connect(s, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) == 0);
+
+    char b = 'H';
+    struct iovec iov;
+    iov.iov_base = &b;
+    iov.iov_len = 1;
+    char control[CMSG_SPACE(sizeof(int))];
+    memset(control, 0, sizeof(control));
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+    struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+    memcpy(CMSG_DATA(cmsg), &fd, sizeof(int));
+    test(sendmsg(s, &msg, 0) == 1);
+
+    ssize_t ret = recv(s, &b, 1, 0);
+    close(s);
+    close(fd);
+    return ret == 1;
+}
+
+#endif
+
+double
+latency(const TestIntfPrx& prx, int count)
+{
+    prx->ice_ping(); // Establish the connection.
+    IceUtil::Time start = IceUtil::Time::now(IceUtil::Time::Monotonic);
+    for(int i = 0; i < count; ++i)
+    {
+        prx->ice_ping();
+    }
+    return (IceUtil::Time::now(IceUtil::Time::Monotonic) - start).toMicroSecondsDouble() / count;
+}
+
+}
+
+TestIntfPrx
+allTests(const Ice::CommunicatorPtr& communicator)
+{
+    string path = communicator->getProperties()->getProperty("Test.Path");
+    test(!path.empty());
+
+    cout << "testing shm endpoint parsing... " << flush;
+    {
+        Ice::ObjectPrx base = communicator->stringToProxy("test:shm -p /tmp/foo -t 1000 -z");
+        test(communicator->proxyToString(base) == "test -t:shm -p /tmp/foo -t 1000 -z");
+
+        Ice::EndpointSeq endpoints = base->ice_getEndpoints();
+        test(endpoints.size() == 1);
+        Ice::ShmEndpointInfoPtr info = Ice::ShmEndpointInfoPtr::dynamicCast(endpoints[0]->getInfo());
+        test(info);
+        test(info->path == "/tmp/foo");
+        test(info->timeout == 1000);
+        test(info->compress);
+        test(info->type() == Ice::ShmEndpointType);
+        test(!info->datagram());
+        test(!info->secure());
+
+        try
+        {
+            communicator->stringToProxy("test:shm -t 1000");
+            test(false);
+        }
+        catch(const Ice::EndpointParseException&)
+        {
+        }
+
+        try
+        {
+            communicator->stringToProxy("test:shm -p /tmp/foo -h localhost");
+            test(false);
+        }
+        catch(const Ice::EndpointParseException&)
+        {
+        }
+    }
+    cout << "ok" << endl;
+
+    TestIntfPrx shmPrx = TestIntfPrx::checkedCast(communicator->stringToProxy("test:shm -p " + path));
+    test(shmPrx);
+
+    cout << "testing shm connection info... " << flush;
+    {
+        Ice::ConnectionPtr connection = shmPrx->ice_getConnection();
+        Ice::ShmConnectionInfoPtr info = Ice::ShmConnectionInfoPtr::dynamicCast(connection->getInfo());
+        test(info);
+        test(info->path == path);
+        test(!info->incoming);
+        test(info->size == 1024 * 1024);
+        test(info->peerUid == static_cast<int>(getuid()));
+        test(connection->type() == "shm");
+
+        //
+        // The size of the rings is chosen by the connecting side.
+        //
+        test(shmPrx->getRingSize() == info->size);
+        test(TestIntfPrx::uncheckedCast(communicator->stringToProxy("test:default -p 12010"))->getRingSize() == -1);
+    }
+    cout << "ok" << endl;
+
+    cout << "testing shm requests... " << flush;
+    {
+        testEcho(shmPrx);
+        testConcurrentEcho(shmPrx);
+    }
+    cout << "ok" << endl;
+
+    cout << "testing shm requests with small rings... " << flush;
+    {
+        //
+        // With rings smaller than most of the messages, the data which
+        // doesn't fit is sent over the socket.
+        //
+        Ice::InitializationData initData;
+        initData.properties = communicator->getProperties()->clone();
+        initData.properties->setProperty("Ice.SHM.Size", "5000");
+        Ice::CommunicatorPtr comm = Ice::initialize(initData);
+        TestIntfPrx prx = TestIntfPrx::uncheckedCast(comm->stringToProxy("test:shm -p " + path));
+        test(prx->getRingSize() == 8192);
+        Ice::ShmConnectionInfoPtr info = Ice::ShmConnectionInfoPtr::dynamicCast(prx->ice_getConnection()->getInfo());
+        test(info && info->size == 8192);
+        testEcho(prx);
+        testConcurrentEcho(prx);
+        comm->destroy();
+    }
+    cout << "ok" << endl;
+
+    cout << "testing shm connection closure... " << flush;
+    {
+        Ice::ConnectionPtr connection = shmPrx->ice_getConnection();
+        connection->close(false);
+        testEcho(shmPrx);
+        test(shmPrx->ice_getConnection() != connection);
+
+        try
+        {
+            communicator->stringToProxy("test:shm -p " + path + ".missing")->ice_ping();
+            test(false);
+        }
+        catch(const Ice::ConnectionRefusedException&)
+        {
+        }
+    }
+    cout << "ok" << endl;
+
+#if defined(MFD_ALLOW_SEALING) && defined(F_ADD_SEALS)
+    cout << "testing shm segment seals... " << flush;
+    {
+        test(handshake(path, true));
+        test(!handshake(path, false));
+        testEcho(shmPrx);
+    }
+    cout << "ok" << endl;
+#endif
+
+    cout << "comparing tcp, unix and shm latency... " << flush;
+    {
+        TestIntfPrx tcpPrx = TestIntfPrx::uncheckedCast(communicator->stringToProxy("test:default -p 12010"));
+        TestIntfPrx unixPrx = TestIntfPrx::uncheckedCast(communicator->stringToProxy("test:unix -p " + path + ".unix"));
+        const int count = 2000;
+        double tcpLatency = latency(tcpPrx, count);
+        double unixLatency = latency(unixPrx, count);
+        double shmLatency = latency(shmPrx, count);
+        cout << "tcp " << tcpLatency << "us, unix " << unixLatency << "us, shm " << shmLatency << "us... " << flush;
+    }
+    cout << "ok" << endl;
+
+    return shmPrx;
+}
@@ -0,0 +1,32 @@
+// **********************************************************************
+//
+// Copyright (c) 2003-2011 ZeroC, Inc. All rights reserved.
+//
+// This copy of Ice is licensed to you under the terms described in the
+// ICE_LICENSE file included in this distribution.
+//
+// **********************************************************************
+
+#include <Ice/Ice.h>
+#include <TestI.h>
+
+using namespace std;
+
+Test::ByteSeq
+TestIntfI::echo(const Test::ByteSeq& seq, const Ice::Current&)
+{
+    return seq;
+}
+
+Ice::Int
+TestIntfI::getRingSize(const Ice::Current& current)
+{
+    Ice::ShmConnectionInfoPtr info = Ice::ShmConnectionInfoPtr::dynamicCast(current.con->getInfo());
+    return info ? info->size : -1;
+}
+
+void
+TestIntfI::shutdown(const Ice::Current& current)
+{
+    current.adapter->getCommunicator()->shutdown();
+}
@@ -0,0 +1,36 @@
+#!/usr/bin/env python
+# **********************************************************************
+#
+# Copyright (c) 2003-2011 ZeroC, Inc. All rights reserved.
+#
+# This copy of Ice is licensed to you under the terms described in the
+# ICE_LICENSE file included in this distribution.
+#
+# **********************************************************************
+
+import os, sys
+
+path = [ ".", "..", "../..", "../../..", "../../../.." ]
+head = os.path.dirname(sys.argv[0])
+if len(head) > 0:
+    path = [os.path.join(head, p) for p in path]
+path = [os.path.abspath(p) for p in path if os.path.exists(os.path.join(p, "scripts", "TestUtil.py")) ]
+if len(path) == 0:
+    raise "can't find toplevel directory!"
+sys.path.append(os.path.join(path[0]))
+from scripts import *
+
+#
+# The socket path must be short enough to fit in a sockaddr_un.
+#
+socketPath = "/tmp/icetest-shm-%d" % os.getpid()
+for p in [socketPath, socketPath + ".unix"]:
+    if os.path.exists(p):
+        os.remove(p)
+options = "--Test.Path=%s" % socketPath
+TestUtil.clientServerTest(options, options)
+for p in [socketPath, socketPath + ".unix"]:
+    if os.path.exists(p):
+        print "socket file %s was not removed by the server" % p
+        sys.exit(1)
+
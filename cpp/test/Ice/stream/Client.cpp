@@ -1087,6 +1087,62 @@ run(int argc, char** argv, const Ice::CommunicatorPtr& communicator)
 
     cout << "ok" << endl;
 
+    cout << "testing encoded sizes... " << flush;
+
+    {
+        //
+        // The strings and sequences are long enough for some of their
+        // sizes to be encoded on 5 bytes.
+        //
+        Test::VariableStruct s;
+        s.str = "str";
+        s.seq.push_back("");
+        s.seq.push_back(string(300, 'a'));
+        s.seqSeq.push_back(s.seq);
+        s.seqSeq.push_back(Ice::StringSeq());
+        s.d["key"] = "value";
+        s.d[string(255, 'k')] = string(1000, 'v');
+        for(Ice::Short i = 0; i < 300; ++i)
+        {
+            s.fixedD[i] = i;
+        }
+        s.e.push_back(Test::enum3);
+
+        out = Ice::createOutputStream(communicator);
+        out->write(s);
+        out->finished(data);
+        test(data.size() == s.__encodedSize());
+
+        Test::VariableStruct empty;
+        out = Ice::createOutputStream(communicator);
+        out->write(empty);
+        out->finished(data);
+        test(data.size() == empty.__encodedSize());
+
+        Test::StringSS ss(300, s.seq);
+        out = Ice::createOutputStream(communicator);
+        out->write(ss);
+        out->finished(data);
+        test(data.size() == Test::__encodedSizeStringSS(ss));
+
+        Test::VariableStructS seq(255, s);
+        seq.push_back(empty);
+        out = Ice::createOutputStream(communicator);
+        out->write(seq);
+        out->finished(data);
+        test(data.size() == Test::__encodedSizeVariableStructS(seq));
+
+        Test::StringVariableStructD dict;
+        dict[""] = s;
+        dict["empty"] = empty;
+        out = Ice::createOutputStream(communicator);
+        out->write(dict);
+        out->finished(data);
+        test(data.size() == Test::__encodedSizeStringVariableStructD(dict));
+    }
+
+    cout << "ok" << endl;
+
 #endif
 
     //
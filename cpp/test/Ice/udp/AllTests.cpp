@@ -135,6 +135,32 @@ allTests(const CommunicatorPtr& communicator)
 
     cout << "ok" << endl;
 
+    cout << "testing udp bursts... " << flush;
+    {
+        //
+        // The server receives the datagrams of a burst in batches and
+        // must dispatch each of them.
+        //
+        const int count = 20;
+        nRetry = 5;
+        while(nRetry-- > 0)
+        {
+            replyI->reset();
+            for(int i = 0; i < count; ++i)
+            {
+                obj->ping(reply);
+            }
+            ret = replyI->waitReply(count, IceUtil::Time::seconds(5));
+            if(ret)
+            {
+                break; // Success
+            }
+            replyI = new PingReplyI;
+            reply = PingReplyPrx::uncheckedCast(adapter->addWithUUID(replyI))->ice_datagram();
+        }
+        test(ret);
+    }
+    cout << "ok" << endl;
 
     cout << "testing udp multicast... " << flush;
     string host;
@@ -0,0 +1,190 @@
+// **********************************************************************
+//
+// Copyright (c) 2003-2011 ZeroC, Inc. All rights reserved.
+//
+// This copy of Ice is licensed to you under the terms described in the
+// ICE_LICENSE file included in this distribution.
+//
+// **********************************************************************
+
+#include <Ice/Ice.h>
+#include <IceUtil/Time.h>
+#include <TestCommon.h>
+#include <Test.h>
+
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+using namespace std;
+using namespace Test;
+
+namespace
+{
+
+double
+latency(const TestIntfPrx& prx, int count)
+{
+    prx->ice_ping(); // Establish the connection.
+    IceUtil::Time start = IceUtil::Time::now(IceUtil::Time::Monotonic);
+    for(int i = 0; i < count; ++i)
+    {
+        prx->ice_ping();
+    }
+    return (IceUtil::Time::now(IceUtil::Time::Monotonic) - start).toMicroSecondsDouble() / count;
+}
+
+}
+
+TestIntfPrx
+allTests(const Ice::CommunicatorPtr& communicator)
+{
+    string path = communicator->getProperties()->getProperty("Test.Path");
+    test(!path.empty());
+
+    cout << "testing unix endpoint parsing... " << flush;
+    {
+        Ice::ObjectPrx base = communicator->stringToProxy("test:unix -p /tmp/foo -t 1000 -z");
+        test(communicator->proxyToString(base) == "test -t:unix -p /tmp/foo -t 1000 -z");
+
+        Ice::EndpointSeq endpoints = base->ice_getEndpoints();
+        test(endpoints.size() == 1);
+        Ice::EndpointInfoPtr info = endpoints[0]->getInfo();
+        Ice::UnixEndpointInfoPtr unixInfo = Ice::UnixEndpointInfoPtr::dynamicCast(info);
+        test(unixInfo);
+        test(unixInfo->path == "/tmp/foo");
+        test(unixInfo->timeout == 1000);
+        test(unixInfo->compress);
+        test(unixInfo->type() == Ice::UnixEndpointType);
+        test(!unixInfo->datagram());
+        test(!unixInfo->secure());
+
+        base = communicator->stringToProxy("test:unix -p \"/tmp/foo:bar\"");
+        test(communicator->proxyToString(base) == "test -t:unix -p \"/tmp/foo:bar\"");
+
+        try
+        {
+            communicator->stringToProxy("test:unix -t 1000");
+            test(false);
+        }
+        catch(const Ice::EndpointParseException&)
+        {
+        }
+
+        try
+        {
+            communicator->stringToProxy("test:unix -p /tmp/foo -h localhost");
+            test(false);
+        }
+        catch(const Ice::EndpointParseException&)
+        {
+        }
+
+        try
+        {
+            communicator->stringToProxy("test:unix -p /tmp/" + string(200, 'x'));
+            test(false);
+        }
+        catch(const Ice::EndpointParseException&)
+        {
+        }
+    }
+    cout << "ok" << endl;
+
+    TestIntfPrx tcpPrx = TestIntfPrx::checkedCast(communicator->stringToProxy("test:default -p 12010"));
+    TestIntfPrx unixPrx = TestIntfPrx::checkedCast(communicator->stringToProxy("test:unix -p " + path));
+    test(tcpPrx && unixPrx);
+
+    cout << "testing unix connection info... " << flush;
+    {
+        Ice::ConnectionPtr connection = unixPrx->ice_getConnection();
+        Ice::UnixConnectionInfoPtr info = Ice::UnixConnectionInfoPtr::dynamicCast(connection->getInfo());
+        test(info);
+        test(info->path == path);
+        test(!info->incoming);
+        test(connection->type() == "unix");
+
+        //
+        // The kernel supplies the credentials of the peer on both
+        // sides of the connection.
+        //
+        Credentials server = unixPrx->getCredentials();
+        test(info->peerUid == server.uid);
+        test(info->peerGid == server.gid);
+        test(info->peerPid == -1 || info->peerPid == server.pid);
+
+        Credentials client = unixPrx->getPeerCredentials();
+        test(client.uid == static_cast<int>(getuid()));
+        test(client.gid == static_cast<int>(getgid()));
+        test(client.pid == -1 || client.pid == static_cast<int>(getpid()));
+
+        client = tcpPrx->getPeerCredentials();
+        test(client.pid == -1 && client.uid == -1 && client.gid == -1);
+    }
+    cout << "ok" << endl;
+
+    cout << "testing unix endpoint marshaling... " << flush;
+    {
+        Ice::ObjectPrx prx = communicator->stringToProxy("test:unix -p /tmp/foo -t 1000:default -p 12010");
+        test(unixPrx->echo(prx) == prx);
+        test(unixPrx->echo(unixPrx) == unixPrx);
+    }
+    cout << "ok" << endl;
+
+    cout << "testing unix socket errors... " << flush;
+    {
+        try
+        {
+            communicator->stringToProxy("test:unix -p " + path + ".missing")->ice_ping();
+            test(false);
+        }
+        catch(const Ice::ConnectionRefusedException&)
+        {
+        }
+
+        //
+        // The path is still in use by the server, binding to it must fail.
+        //
+        communicator->getProperties()->setProperty("TestAdapter.Endpoints", "unix -p " + path);
+        try
+        {
+            communicator->createObjectAdapter("TestAdapter");
+            test(false);
+        }
+        catch(const Ice::SocketException&)
+        {
+        }
+
+        //
+        // A socket file left behind by a process that is gone is
+        // removed when binding to its path.
+        //
+        string stale = path + ".stale";
+        int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        test(fd >= 0);
+        struct sockaddr_un addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sun_family = AF_UNIX;
+        strcpy(addr.sun_path, stale.c_str());
+        test(bind(fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) == 0);
+        close(fd);
+        test(access(stale.c_str(), F_OK) == 0);
+
+        communicator->getProperties()->setProperty("StaleAdapter.Endpoints", "unix -p " + stale);
+        Ice::ObjectAdapterPtr adapter = communicator->createObjectAdapter("StaleAdapter");
+        adapter->destroy();
+        test(access(stale.c_str(), F_OK) != 0);
+    }
+    cout << "ok" << endl;
+
+    cout << "comparing tcp and unix latency... " << flush;
+    {
+        const int count = 2000;
+        double tcpLatency = latency(tcpPrx, count);
+        double unixLatency = latency(unixPrx, count);
+        cout << "tcp " << tcpLatency << "us, unix " << unixLatency << "us... " << flush;
+    }
+    cout << "ok" << endl;
+
+    return unixPrx;
+}
@@ -0,0 +1,54 @@
+// **********************************************************************
+//
+// Copyright (c) 2003-2011 ZeroC, Inc. All rights reserved.
+//
+// This copy of Ice is licensed to you under the terms described in the
+// ICE_LICENSE file included in this distribution.
+//
+// **********************************************************************
+
+#include <Ice/Ice.h>
+#include <TestI.h>
+
+#include <unistd.h>
+
+using namespace std;
+
+Test::Credentials
+TestIntfI::getCredentials(const Ice::Current&)
+{
+    Test::Credentials cred;
+    cred.pid = static_cast<int>(getpid());
+    cred.uid = static_cast<int>(getuid());
+    cred.gid = static_cast<int>(getgid());
+    return cred;
+}
+
+Test::Credentials
+TestIntfI::getPeerCredentials(const Ice::Current& current)
+{
+    Test::Credentials cred;
+    cred.pid = -1;
+    cred.uid = -1;
+    cred.gid = -1;
+    Ice::UnixConnectionInfoPtr info = Ice::UnixConnectionInfoPtr::dynamicCast(current.con->getInfo());
+    if(info)
+    {
+        cred.pid = info->peerPid;
+        cred.uid = info->peerUid;
+        cred.gid = info->peerGid;
+    }
+    return cred;
+}
+
+Ice::ObjectPrx
+TestIntfI::echo(const Ice::ObjectPrx& prx, const Ice::Current&)
+{
+    return prx;
+}
+
+void
+TestIntfI::shutdown(const Ice::Current& current)
+{
+    current.adapter->getCommunicator()->shutdown();
+}
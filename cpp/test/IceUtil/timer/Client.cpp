@@ -136,125 +136,280 @@ private:
 };
 typedef IceUtil::Handle<DestroyTask> DestroyTaskPtr;
 
-int main(int argc, char* argv[])
+IceUtil::TimerPtr
+createTimer(bool wheel)
 {
-    cout << "testing timer... " << flush;
+    if(wheel)
     {
-        IceUtil::TimerPtr timer = new IceUtil::Timer();
+        return new IceUtil::Timer(IceUtil::Time::milliSeconds(1));
+    }
+    return new IceUtil::Timer();
+}
 
+void
+testTimer(const IceUtil::TimerPtr& timer)
+{
+    {
+        TestTaskPtr task = new TestTask();
+        timer->schedule(task, IceUtil::Time());
+        task->waitForRun();
+        task->clear();
+
+        //
+        // Verify that the same task cannot be scheduled more than once.
+        //
+        timer->schedule(task, IceUtil::Time::milliSeconds(100));
+        try
         {
-            TestTaskPtr task = new TestTask();
             timer->schedule(task, IceUtil::Time());
-            task->waitForRun();
-            task->clear();
-
-            //
-            // Verify that the same task cannot be scheduled more than once.
-            //
-            timer->schedule(task, IceUtil::Time::milliSeconds(100));
-            try
-            {
-                timer->schedule(task, IceUtil::Time());
-            }
-            catch(const IceUtil::IllegalArgumentException&)
-            {
-                // Expected.
-            }
-            task->waitForRun();
-            task->clear();
         }
-
+        catch(const IceUtil::IllegalArgumentException&)
         {
-            TestTaskPtr task = new TestTask();
-            test(!timer->cancel(task));
-            timer->schedule(task, IceUtil::Time::seconds(1));
-            test(!task->hasRun() && timer->cancel(task) && !task->hasRun());
-            test(!timer->cancel(task));
-            IceUtil::ThreadControl::sleep(IceUtil::Time::milliSeconds(1100));
-            test(!task->hasRun());
+            // Expected.
         }
+        task->waitForRun();
+        task->clear();
+    }
+
+    {
+        TestTaskPtr task = new TestTask();
+        test(!timer->cancel(task));
+        timer->schedule(task, IceUtil::Time::seconds(1));
+        test(!task->hasRun() && timer->cancel(task) && !task->hasRun());
+        test(!timer->cancel(task));
+        IceUtil::ThreadControl::sleep(IceUtil::Time::milliSeconds(1100));
+        test(!task->hasRun());
+    }
 
+    {
+        vector<TestTaskPtr> tasks;
+        IceUtil::Time start = IceUtil::Time::now(IceUtil::Time::Monotonic) + IceUtil::Time::milliSeconds(500);
+        for(int i = 0; i < 20; ++i)
         {
-            vector<TestTaskPtr> tasks;
-            IceUtil::Time start = IceUtil::Time::now(IceUtil::Time::Monotonic) + IceUtil::Time::milliSeconds(500);
-            for(int i = 0; i < 20; ++i)
-            {
-                tasks.push_back(new TestTask(IceUtil::Time::milliSeconds(500 + i * 5)));
-            }
+            tasks.push_back(new TestTask(IceUtil::Time::milliSeconds(500 + i * 5)));
+        }
 
-            random_shuffle(tasks.begin(), tasks.end());
-            vector<TestTaskPtr>::const_iterator p;
-            for(p = tasks.begin(); p != tasks.end(); ++p)
-            {
-                timer->schedule(*p, (*p)->getScheduledTime());
-            }
+        random_shuffle(tasks.begin(), tasks.end());
+        vector<TestTaskPtr>::const_iterator p;
+        for(p = tasks.begin(); p != tasks.end(); ++p)
+        {
+            timer->schedule(*p, (*p)->getScheduledTime());
+        }
 
-            for(p = tasks.begin(); p != tasks.end(); ++p)
-            {
-                (*p)->waitForRun();
-            }
+        for(p = tasks.begin(); p != tasks.end(); ++p)
+        {
+            (*p)->waitForRun();
+        }
 
-            test(IceUtil::Time::now(IceUtil::Time::Monotonic) > start);
+        test(IceUtil::Time::now(IceUtil::Time::Monotonic) > start);
 
-            sort(tasks.begin(), tasks.end());
-            for(p = tasks.begin(); p + 1 != tasks.end(); ++p)
+        sort(tasks.begin(), tasks.end());
+        for(p = tasks.begin(); p + 1 != tasks.end(); ++p)
+        {
+            if((*p)->getRunTime() > (*(p + 1))->getRunTime())
             {
-                if((*p)->getRunTime() > (*(p + 1))->getRunTime())
-                {
-                    test(false);
-                }
+                test(false);
             }
         }
+    }
+
+    {
+        TestTaskPtr task = new TestTask();
+        timer->scheduleRepeated(task, IceUtil::Time::milliSeconds(20));
+        IceUtil::ThreadControl::sleep(IceUtil::Time::milliSeconds(500));
+        test(task->hasRun());
+        test(task->getCount() > 1);
+        test(task->getCount() < 26);
+        test(timer->cancel(task));
+        int count = task->getCount();
+        IceUtil::ThreadControl::sleep(IceUtil::Time::milliSeconds(100));
+        test(count == task->getCount() || count + 1 == task->getCount());
+    }
+}
 
+void
+testDestroy(bool wheel)
+{
+    {
+        IceUtil::TimerPtr timer = createTimer(wheel);
+        DestroyTaskPtr destroyTask = new DestroyTask(timer);
+        timer->schedule(destroyTask, IceUtil::Time());
+        destroyTask->waitForRun();
+        try
+        {
+            timer->schedule(destroyTask, IceUtil::Time());
+        }
+        catch(const IceUtil::IllegalArgumentException&)
+        {
+            // Expected;
+        }
+    }
+    {
+        IceUtil::TimerPtr timer = createTimer(wheel);
+        TestTaskPtr testTask = new TestTask();
+        timer->schedule(testTask, IceUtil::Time());
+        timer->destroy();
+        try
+        {
+            timer->schedule(testTask, IceUtil::Time());
+        }
+        catch(const IceUtil::IllegalArgumentException&)
         {
-            TestTaskPtr task = new TestTask();
-            timer->scheduleRepeated(task, IceUtil::Time::milliSeconds(20));
-            IceUtil::ThreadControl::sleep(IceUtil::Time::milliSeconds(500));
-            test(task->hasRun());
-            test(task->getCount() > 1);
-            test(task->getCount() < 26);
-            test(timer->cancel(task));
-            int count = task->getCount();
-            IceUtil::ThreadControl::sleep(IceUtil::Time::milliSeconds(100));
-            test(count == task->getCount() || count + 1 == task->getCount());
+            // Expected;
         }
+    }
+}
+
+//
+// Checks that tasks due beyond the first levels of the wheel are
+// redistributed and run on time.
+//
+void
+testWheel()
+{
+    IceUtil::TimerPtr timer = new IceUtil::Timer(IceUtil::Time::microSeconds(10));
 
+    vector<TestTaskPtr> tasks;
+    IceUtil::Time start = IceUtil::Time::now(IceUtil::Time::Monotonic);
+    for(int i = 0; i < 50; ++i)
+    {
+        tasks.push_back(new TestTask(IceUtil::Time::milliSeconds(rand() % 200 * 10)));
+        timer->schedule(tasks.back(), tasks.back()->getScheduledTime());
+    }
+
+    vector<TestTaskPtr> cancelled;
+    for(int i = 0; i < 50; ++i)
+    {
+        cancelled.push_back(new TestTask());
+        timer->schedule(cancelled.back(), IceUtil::Time::milliSeconds(rand() % 200 * 10));
+        test(timer->cancel(cancelled.back()));
+    }
+
+    for(vector<TestTaskPtr>::const_iterator p = tasks.begin(); p != tasks.end(); ++p)
+    {
+        (*p)->waitForRun();
+        test((*p)->getRunTime() - start >= (*p)->getScheduledTime());
+        test((*p)->getRunTime() - start < (*p)->getScheduledTime() + IceUtil::Time::milliSeconds(500));
+        test((*p)->getCount() == 1);
+    }
+    for(vector<TestTaskPtr>::const_iterator p = cancelled.begin(); p != cancelled.end(); ++p)
+    {
+        test(!(*p)->hasRun());
+    }
+
+    timer->destroy();
+
+    try
+    {
+        new IceUtil::Timer(IceUtil::Time());
+        test(false);
+    }
+    catch(const IceUtil::IllegalArgumentException&)
+    {
+    }
+}
+
+//
+// Checks that tasks scheduled after the wheel stayed idle for a while
+// run on time. The wheel doesn't move while it's empty and must not go
+// through all the ticks since then, one at a time, with the timer
+// locked.
+//
+void
+testIdleWheel()
+{
+    IceUtil::TimerPtr timer = new IceUtil::Timer(IceUtil::Time::microSeconds(1));
+
+    TestTaskPtr task = new TestTask();
+    timer->schedule(task, IceUtil::Time());
+    task->waitForRun();
+
+    for(int i = 0; i < 3; ++i)
+    {
+        IceUtil::ThreadControl::sleep(IceUtil::Time::seconds(1));
+
+        task = new TestTask(IceUtil::Time::milliSeconds(10));
+        IceUtil::Time start = IceUtil::Time::now(IceUtil::Time::Monotonic);
+        timer->schedule(task, task->getScheduledTime());
+
+        TestTaskPtr other = new TestTask();
+        timer->schedule(other, IceUtil::Time::seconds(60));
+        test(timer->cancel(other));
+        test(IceUtil::Time::now(IceUtil::Time::Monotonic) - start < IceUtil::Time::milliSeconds(50));
+
+        task->waitForRun();
+        test(task->getRunTime() - start >= task->getScheduledTime());
+        test(task->getRunTime() - start < task->getScheduledTime() + IceUtil::Time::milliSeconds(50));
+    }
+
+    timer->destroy();
+}
+
+//
+// Measures scheduling and cancelling a task with a long delay for
+// many tasks at once, as done by connection timeouts.
+//
+void
+benchmark(bool wheel, int count)
+{
+    IceUtil::TimerPtr timer = wheel ? new IceUtil::Timer(IceUtil::Time::milliSeconds(10)) : new IceUtil::Timer();
+
+    vector<IceUtil::TimerTaskPtr> tasks;
+    for(int i = 0; i < count; ++i)
+    {
+        tasks.push_back(new TestTask());
+        timer->schedule(tasks.back(), IceUtil::Time::seconds(60 + i % 60));
+    }
+
+    const int iterations = 200000;
+    IceUtil::Time start = IceUtil::Time::now(IceUtil::Time::Monotonic);
+    for(int i = 0; i < iterations; ++i)
+    {
+        const IceUtil::TimerTaskPtr& task = tasks[rand() % count];
+        test(timer->cancel(task));
+        timer->schedule(task, IceUtil::Time::seconds(60));
+    }
+    IceUtil::Time elapsed = IceUtil::Time::now(IceUtil::Time::Monotonic) - start;
+    timer->destroy();
+
+    cout << "  " << (wheel ? "timing wheel" : "ordered set") << ", " << count << " tasks: "
+         << elapsed.toMicroSecondsDouble() * 1000 / iterations << "ns per cancel and schedule" << endl;
+}
+
+int main(int argc, char* argv[])
+{
+    cout << "testing timer... " << flush;
+    {
+        IceUtil::TimerPtr timer = createTimer(false);
+        testTimer(timer);
         timer->destroy();
     }
     cout << "ok" << endl;
 
     cout << "testing timer destroy... " << flush;
+    testDestroy(false);
+    cout << "ok" << endl;
+
+    cout << "testing timing wheel timer... " << flush;
     {
+        IceUtil::TimerPtr timer = createTimer(true);
+        testTimer(timer);
+        timer->destroy();
+    }
+    testDestroy(true);
+    testWheel();
+    testIdleWheel();
+    cout << "ok" << endl;
+
+    cout << "benchmarking timers:" << endl;
+    {
+        const int counts[] = { 100, 100000 };
+        for(unsigned int i = 0; i < sizeof(counts) / sizeof(int); ++i)
         {
-            IceUtil::TimerPtr timer = new IceUtil::Timer();
-            DestroyTaskPtr destroyTask = new DestroyTask(timer);
-            timer->schedule(destroyTask, IceUtil::Time());
-            destroyTask->waitForRun();
-            try
-            {
-                timer->schedule(destroyTask, IceUtil::Time());
-            }
-            catch(const IceUtil::IllegalArgumentException&)
-            {
-                // Expected;
-            }
-        }
-        {
-            IceUtil::TimerPtr timer = new IceUtil::Timer();
-            TestTaskPtr testTask = new TestTask();
-            timer->schedule(testTask, IceUtil::Time());
-            timer->destroy();
-            try
-            {
-                timer->schedule(testTask, IceUtil::Time());
-            }
-            catch(const IceUtil::IllegalArgumentException&)
-            {
-                // Expected;
-            }
+            benchmark(false, counts[i]);
+            benchmark(true, counts[i]);
         }
     }
-    cout << "ok" << endl;
 
     return EXIT_SUCCESS;
 }
@@ -18,6 +18,58 @@
 using namespace IceUtil;
 using namespace std;
 
+namespace
+{
+
+//
+// Appends a character to its UTF-8 and wide string representations.
+//
+void
+append(string& s, wstring& ws, unsigned int c)
+{
+    if(c < 0x80)
+    {
+        s += static_cast<char>(c);
+    }
+    else if(c < 0x800)
+    {
+        s += static_cast<char>(0xC0 | (c >> 6));
+        s += static_cast<char>(0x80 | (c & 0x3F));
+    }
+    else if(c < 0x10000)
+    {
+        s += static_cast<char>(0xE0 | (c >> 12));
+        s += static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+        s += static_cast<char>(0x80 | (c & 0x3F));
+    }
+    else
+    {
+        s += static_cast<char>(0xF0 | (c >> 18));
+        s += static_cast<char>(0x80 | ((c >> 12) & 0x3F));
+        s += static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+        s += static_cast<char>(0x80 | (c & 0x3F));
+    }
+
+    if(sizeof(wchar_t) == 2 && c >= 0x10000)
+    {
+        ws += static_cast<wchar_t>(0xD800 + ((c - 0x10000) >> 10));
+        ws += static_cast<wchar_t>(0xDC00 + ((c - 0x10000) & 0x3FF));
+    }
+    else
+    {
+        ws += static_cast<wchar_t>(c);
+    }
+}
+
+bool
+isLegal(const string& s)
+{
+    return isLegalUTF8Sequence(reinterpret_cast<const Byte*>(s.data()),
+                               reinterpret_cast<const Byte*>(s.data() + s.size()));
+}
+
+}
+
 //
 // Note that each file starts with a BOM; stringToWstring and wstringToString
 // converts these BOMs back and forth.
@@ -179,6 +231,111 @@ main(int argc, char* argv[])
 
         cout << "ok" << endl;
     }
+
+    {
+        cout << "testing conversion of ASCII runs... ";
+
+        //
+        // Runs of ASCII characters of various lengths separated by
+        // non-ASCII characters of each UTF-8 length.
+        //
+        const unsigned int nonASCII[] = { 0xE9, 0x20AC, 0x1D11E };
+        for(int run = 0; run < 40; ++run)
+        {
+            for(int k = 0; k < 3; ++k)
+            {
+                string s;
+                wstring ws;
+                for(int i = 0; i < 3; ++i)
+                {
+                    for(int j = 0; j < run; ++j)
+                    {
+                        append(s, ws, 'a' + (i * run + j) % 26);
+                    }
+                    append(s, ws, nonASCII[k]);
+                }
+                string suffix;
+                wstring wsuffix;
+                for(int j = 0; j < run; ++j)
+                {
+                    append(suffix, wsuffix, '0' + j % 10);
+                }
+                string prefix = s;
+                wstring wprefix = ws;
+                s += suffix;
+                ws += wsuffix;
+
+                test(isLegal(s));
+                test(stringToWstring(s) == ws);
+                test(wstringToString(ws) == s);
+
+                //
+                // The last non-ASCII character is incomplete at the
+                // end of the string and illegal when followed by ASCII
+                // characters.
+                //
+                string truncated = prefix.substr(0, prefix.size() - 1);
+                test(!isLegal(truncated));
+                try
+                {
+                    stringToWstring(truncated);
+                    test(false);
+                }
+                catch(const UTFConversionException& ex)
+                {
+                    test(ex.conversionError() == partialCharacter);
+                }
+                if(run > 0)
+                {
+                    truncated += suffix;
+                    test(!isLegal(truncated));
+                    try
+                    {
+                        stringToWstring(truncated);
+                        test(false);
+                    }
+                    catch(const UTFConversionException& ex)
+                    {
+                        test(ex.conversionError() == badEncoding);
+                    }
+                }
+
+                //
+                // A lone surrogate between ASCII characters is only
+                // converted in lenient mode.
+                //
+                wstring surrogate = wprefix + static_cast<wchar_t>(0xDC00) + wsuffix;
+                test(wstringToString(surrogate) == prefix + "\xED\xB0\x80" + suffix);
+                try
+                {
+                    wstringToString(surrogate, strictConversion);
+                    test(false);
+                }
+                catch(const UTFConversionException& ex)
+                {
+                    test(ex.conversionError() == badEncoding);
+                }
+            }
+        }
+
+        //
+        // Long strings without ASCII characters.
+        //
+        for(int k = 0; k < 3; ++k)
+        {
+            string s;
+            wstring ws;
+            for(int i = 0; i < 1000; ++i)
+            {
+                append(s, ws, nonASCII[k] + i % 2);
+            }
+            test(isLegal(s));
+            test(stringToWstring(s) == ws);
+            test(wstringToString(ws) == s);
+        }
+
+        cout << "ok" << endl;
+    }
 #ifndef __BCPLUSPLUS__
     {
         cout << "testing UTF-8 filename... ";
@@ -8,7 +8,7 @@
 // **********************************************************************
 
 //
-// Generated by makeprops.py from file ..\config\PropertyNames.xml, Mon May 09 07:39:43 2011
+// Generated by makeprops.py from file ../config/PropertyNames.xml, Sat Oct 17 23:18:59 2026
 
 // IMPORTANT: Do not edit this file -- any edits made here will be lost!
 
@@ -22,6 +22,11 @@ namespace IceInternal
              new Property(@"^Ice\.ACM\.Server$", false, null),
              new Property(@"^Ice\.Admin\.ACM$", false, null),
              new Property(@"^Ice\.Admin\.AdapterId$", false, null),
+             new Property(@"^Ice\.Admin\.DispatchPriority\.Context$", false, null),
+             new Property(@"^Ice\.Admin\.DispatchPriority\.Default$", false, null),
+             new Property(@"^Ice\.Admin\.DispatchPriority\.Operation\.[^\s]+$", false, null),
+             new Property(@"^Ice\.Admin\.DispatchPriority\.Reserved$", false, null),
+             new Property(@"^Ice\.Admin\.DispatchPriority\.Weights$", false, null),
              new Property(@"^Ice\.Admin\.Endpoints$", false, null),
              new Property(@"^Ice\.Admin\.Locator$", false, null),
              new Property(@"^Ice\.Admin\.PublishedEndpoints$", false, null),
@@ -29,6 +34,8 @@ namespace IceInternal
              new Property(@"^Ice\.Admin\.ReplicaGroupId$", false, null),
              new Property(@"^Ice\.Admin\.Router$", false, null),
              new Property(@"^Ice\.Admin\.ProxyOptions$", false, null),
+             new Property(@"^Ice\.Admin\.ThreadPool\.EdgeTriggered$", false, null),
+             new Property(@"^Ice\.Admin\.ThreadPool\.Model$", false, null),
              new Property(@"^Ice\.Admin\.ThreadPool\.Size$", false, null),
              new Property(@"^Ice\.Admin\.ThreadPool\.SizeMax$", false, null),
              new Property(@"^Ice\.Admin\.ThreadPool\.SizeWarn$", false, null),
@@ -42,9 +49,14 @@ namespace IceInternal
              new Property(@"^Ice\.Admin\.ServerId$", false, null),
              new Property(@"^Ice\.BackgroundLocatorCacheUpdates$", false, null),
              new Property(@"^Ice\.BatchAutoFlush$", false, null),
+             new Property(@"^Ice\.BufferPool\.HighWater$", false, null),
+             new Property(@"^Ice\.BufferPool\.MaxSize$", false, null),
              new Property(@"^Ice\.ChangeUser$", false, null),
+             new Property(@"^Ice\.Compression\.Codec$", false, null),
              new Property(@"^Ice\.Compression\.Level$", false, null),
+             new Property(@"^Ice\.Compression\.MinSize$", false, null),
              new Property(@"^Ice\.Config$", false, null),
+             new Property(@"^Ice\.ConnectionPool\.Size$", false, null),
              new Property(@"^Ice\.ConsoleListener$", false, null),
              new Property(@"^Ice\.Default\.CollocationOptimization$", true, @"Ice.Default.CollocationOptimized"),
              new Property(@"^Ice\.Default\.CollocationOptimized$", false, null),
@@ -77,10 +89,12 @@ namespace IceInternal
              new Property(@"^Ice\.EventLog\.Source$", false, null),
              new Property(@"^Ice\.FactoryAssemblies$", false, null),
              new Property(@"^Ice\.GC\.Interval$", false, null),
+             new Property(@"^Ice\.GC\.MaxPause$", false, null),
              new Property(@"^Ice\.ImplicitContext$", false, null),
              new Property(@"^Ice\.InitPlugins$", false, null),
              new Property(@"^Ice\.LogFile$", false, null),
              new Property(@"^Ice\.MessageSizeMax$", false, null),
+             new Property(@"^Ice\.Metrics$", false, null),
              new Property(@"^Ice\.MonitorConnections$", false, null),
              new Property(@"^Ice\.Nohup$", false, null),
              new Property(@"^Ice\.NullHandleAbort$", false, null),
@@ -99,9 +113,12 @@ namespace IceInternal
              new Property(@"^Ice\.RetryIntervals$", false, null),
              new Property(@"^Ice\.ServerId$", true, null),
              new Property(@"^Ice\.ServerIdleTime$", false, null),
+             new Property(@"^Ice\.SHM\.Size$", false, null),
              new Property(@"^Ice\.StdErr$", false, null),
              new Property(@"^Ice\.StdOut$", false, null),
              new Property(@"^Ice\.SyslogFacility$", false, null),
+             new Property(@"^Ice\.ThreadPool\.Client\.EdgeTriggered$", false, null),
+             new Property(@"^Ice\.ThreadPool\.Client\.Model$", false, null),
              new Property(@"^Ice\.ThreadPool\.Client\.Size$", false, null),
              new Property(@"^Ice\.ThreadPool\.Client\.SizeMax$", false, null),
              new Property(@"^Ice\.ThreadPool\.Client\.SizeWarn$", false, null),
@@ -109,6 +126,8 @@ namespace IceInternal
              new Property(@"^Ice\.ThreadPool\.Client\.Serialize$", false, null),
              new Property(@"^Ice\.ThreadPool\.Client\.ThreadIdleTime$", false, null),
              new Property(@"^Ice\.ThreadPool\.Client\.ThreadPriority$", false, null),
+             new Property(@"^Ice\.ThreadPool\.Server\.EdgeTriggered$", false, null),
+             new Property(@"^Ice\.ThreadPool\.Server\.Model$", false, null),
              new Property(@"^Ice\.ThreadPool\.Server\.Size$", false, null),
              new Property(@"^Ice\.ThreadPool\.Server\.SizeMax$", false, null),
              new Property(@"^Ice\.ThreadPool\.Server\.SizeWarn$", false, null),
@@ -117,6 +136,7 @@ namespace IceInternal
              new Property(@"^Ice\.ThreadPool\.Server\.ThreadIdleTime$", false, null),
              new Property(@"^Ice\.ThreadPool\.Server\.ThreadPriority$", false, null),
              new Property(@"^Ice\.ThreadPriority$", false, null),
+             new Property(@"^Ice\.Timer\.Tick$", false, null),
              new Property(@"^Ice\.Trace\.GC$", false, null),
              new Property(@"^Ice\.Trace\.Location$", true, @"Ice.Trace.Locator"),
              new Property(@"^Ice\.Trace\.Locator$", false, null),
@@ -125,6 +145,7 @@ namespace IceInternal
              new Property(@"^Ice\.Trace\.Retry$", false, null),
              new Property(@"^Ice\.Trace\.Slicing$", false, null),
              new Property(@"^Ice\.Trace\.ThreadPool$", false, null),
+             new Property(@"^Ice\.UDP\.RcvBatchSize$", false, null),
              new Property(@"^Ice\.UDP\.RcvSize$", false, null),
              new Property(@"^Ice\.UDP\.SndSize$", false, null),
              new Property(@"^Ice\.TCP\.Backlog$", false, null),
@@ -151,6 +172,11 @@ namespace IceInternal
              new Property(@"^IceBox\.Service\.[^\s]+$", false, null),
              new Property(@"^IceBox\.ServiceManager\.ACM$", false, null),
              new Property(@"^IceBox\.ServiceManager\.AdapterId$", false, null),
+             new Property(@"^IceBox\.ServiceManager\.DispatchPriority\.Context$", false, null),
+             new Property(@"^IceBox\.ServiceManager\.DispatchPriority\.Default$", false, null),
+             new Property(@"^IceBox\.ServiceManager\.DispatchPriority\.Operation\.[^\s]+$", false, null),
+             new Property(@"^IceBox\.ServiceManager\.DispatchPriority\.Reserved$", false, null),
+             new Property(@"^IceBox\.ServiceManager\.DispatchPriority\.Weights$", false, null),
              new Property(@"^IceBox\.ServiceManager\.Endpoints$", false, null),
              new Property(@"^IceBox\.ServiceManager\.Locator$", false, null),
              new Property(@"^IceBox\.ServiceManager\.PublishedEndpoints$", false, null),
@@ -158,6 +184,8 @@ namespace IceInternal
              new Property(@"^IceBox\.ServiceManager\.ReplicaGroupId$", false, null),
              new Property(@"^IceBox\.ServiceManager\.Router$", false, null),
              new Property(@"^IceBox\.ServiceManager\.ProxyOptions$", false, null),
+             new Property(@"^IceBox\.ServiceManager\.ThreadPool\.EdgeTriggered$", false, null),
+             new Property(@"^IceBox\.ServiceManager\.ThreadPool\.Model$", false, null),
              new Property(@"^IceBox\.ServiceManager\.ThreadPool\.Size$", false, null),
              new Property(@"^IceBox\.ServiceManager\.ThreadPool\.SizeMax$", false, null),
              new Property(@"^IceBox\.ServiceManager\.ThreadPool\.SizeWarn$", false, null),
@@ -200,6 +228,11 @@ namespace IceInternal
              new Property(@"^IceGrid\.InstanceName$", false, null),
              new Property(@"^IceGrid\.Node\.ACM$", false, null),
              new Property(@"^IceGrid\.Node\.AdapterId$", false, null),
+             new Property(@"^IceGrid\.Node\.DispatchPriority\.Context$", false, null),
+             new Property(@"^IceGrid\.Node\.DispatchPriority\.Default$", false, null),
+             new Property(@"^IceGrid\.Node\.DispatchPriority\.Operation\.[^\s]+$", false, null),
+             new Property(@"^IceGrid\.Node\.DispatchPriority\.Reserved$", false, null),
+             new Property(@"^IceGrid\.Node\.DispatchPriority\.Weights$", false, null),
              new Property(@"^IceGrid\.Node\.Endpoints$", false, null),
              new Property(@"^IceGrid\.Node\.Locator$", false, null),
              new Property(@"^IceGrid\.Node\.PublishedEndpoints$", false, null),
@@ -207,6 +240,8 @@ namespace IceInternal
              new Property(@"^IceGrid\.Node\.ReplicaGroupId$", false, null),
              new Property(@"^IceGrid\.Node\.Router$", false, null),
              new Property(@"^IceGrid\.Node\.ProxyOptions$", false, null),
+             new Property(@"^IceGrid\.Node\.ThreadPool\.EdgeTriggered$", false, null),
+             new Property(@"^IceGrid\.Node\.ThreadPool\.Model$", false, null),
              new Property(@"^IceGrid\.Node\.ThreadPool\.Size$", false, null),
              new Property(@"^IceGrid\.Node\.ThreadPool\.SizeMax$", false, null),
              new Property(@"^IceGrid\.Node\.ThreadPool\.SizeWarn$", false, null),
@@ -254,6 +289,11 @@ namespace IceInternal
              new Property(@"^IceGrid\.Registry\.AdminSessionFilters$", false, null),
              new Property(@"^IceGrid\.Registry\.AdminSessionManager\.ACM$", false, null),
              new Property(@"^IceGrid\.Registry\.AdminSessionManager\.AdapterId$", false, null),
+             new Property(@"^IceGrid\.Registry\.AdminSessionManager\.DispatchPriority\.Context$", false, null),
+             new Property(@"^IceGrid\.Registry\.AdminSessionManager\.DispatchPriority\.Default$", false, null),
+             new Property(@"^IceGrid\.Registry\.AdminSessionManager\.DispatchPriority\.Operation\.[^\s]+$", false, null),
+             new Property(@"^IceGrid\.Registry\.AdminSessionManager\.DispatchPriority\.Reserved$", false, null),
+             new Property(@"^IceGrid\.Registry\.AdminSessionManager\.DispatchPriority\.Weights$", false, null),
              new Property(@"^IceGrid\.Registry\.AdminSessionManager\.Endpoints$", false, null),
              new Property(@"^IceGrid\.Registry\.AdminSessionManager\.Locator$", false, null),
              new Property(@"^IceGrid\.Registry\.AdminSessionManager\.PublishedEndpoints$", false, null),
@@ -261,6 +301,8 @@ namespace IceInternal
              new Property(@"^IceGrid\.Registry\.AdminSessionManager\.ReplicaGroupId$", false, null),
              new Property(@"^IceGrid\.Registry\.AdminSessionManager\.Router$", false, null),
              new Property(@"^IceGrid\.Registry\.AdminSessionManager\.ProxyOptions$", false, null),
+             new Property(@"^IceGrid\.Registry\.AdminSessionManager\.ThreadPool\.EdgeTriggered$", false, null),
+             new Property(@"^IceGrid\.Registry\.AdminSessionManager\.ThreadPool\.Model$", false, null),
              new Property(@"^IceGrid\.Registry\.AdminSessionManager\.ThreadPool\.Size$", false, null),
              new Property(@"^IceGrid\.Registry\.AdminSessionManager\.ThreadPool\.SizeMax$", false, null),
              new Property(@"^IceGrid\.Registry\.AdminSessionManager\.ThreadPool\.SizeWarn$", false, null),
@@ -279,6 +321,11 @@ namespace IceInternal
              new Property(@"^IceGrid\.Registry\.AdminSSLPermissionsVerifier$", false, null),
              new Property(@"^IceGrid\.Registry\.Client\.ACM$", false, null),
              new Property(@"^IceGrid\.Registry\.Client\.AdapterId$", false, null),
+             new Property(@"^IceGrid\.Registry\.Client\.DispatchPriority\.Context$", false, null),
+             new Property(@"^IceGrid\.Registry\.Client\.DispatchPriority\.Default$", false, null),
+             new Property(@"^IceGrid\.Registry\.Client\.DispatchPriority\.Operation\.[^\s]+$", false, null),
+             new Property(@"^IceGrid\.Registry\.Client\.DispatchPriority\.Reserved$", false, null),
+             new Property(@"^IceGrid\.Registry\.Client\.DispatchPriority\.Weights$", false, null),
              new Property(@"^IceGrid\.Registry\.Client\.Endpoints$", false, null),
              new Property(@"^IceGrid\.Registry\.Client\.Locator$", false, null),
              new Property(@"^IceGrid\.Registry\.Client\.PublishedEndpoints$", false, null),
@@ -286,6 +333,8 @@ namespace IceInternal
              new Property(@"^IceGrid\.Registry\.Client\.ReplicaGroupId$", false, null),
              new Property(@"^IceGrid\.Registry\.Client\.Router$", false, null),
              new Property(@"^IceGrid\.Registry\.Client\.ProxyOptions$", false, null),
+             new Property(@"^IceGrid\.Registry\.Client\.ThreadPool\.EdgeTriggered$", false, null),
+             new Property(@"^IceGrid\.Registry\.Client\.ThreadPool\.Model$", false, null),
              new Property(@"^IceGrid\.Registry\.Client\.ThreadPool\.Size$", false, null),
              new Property(@"^IceGrid\.Registry\.Client\.ThreadPool\.SizeMax$", false, null),
              new Property(@"^IceGrid\.Registry\.Client\.ThreadPool\.SizeWarn$", false, null),
@@ -299,6 +348,11 @@ namespace IceInternal
              new Property(@"^IceGrid\.Registry\.DynamicRegistration$", false, null),
              new Property(@"^IceGrid\.Registry\.Internal\.ACM$", false, null),
              new Property(@"^IceGrid\.Registry\.Internal\.AdapterId$", false, null),
+             new Property(@"^IceGrid\.Registry\.Internal\.DispatchPriority\.Context$", false, null),
+             new Property(@"^IceGrid\.Registry\.Internal\.DispatchPriority\.Default$", false, null),
+             new Property(@"^IceGrid\.Registry\.Internal\.DispatchPriority\.Operation\.[^\s]+$", false, null),
+             new Property(@"^IceGrid\.Registry\.Internal\.DispatchPriority\.Reserved$", false, null),
+             new Property(@"^IceGrid\.Registry\.Internal\.DispatchPriority\.Weights$", false, null),
              new Property(@"^IceGrid\.Registry\.Internal\.Endpoints$", false, null),
              new Property(@"^IceGrid\.Registry\.Internal\.Locator$", false, null),
              new Property(@"^IceGrid\.Registry\.Internal\.PublishedEndpoints$", false, null),
@@ -306,6 +360,8 @@ namespace IceInternal
              new Property(@"^IceGrid\.Registry\.Internal\.ReplicaGroupId$", false, null),
              new Property(@"^IceGrid\.Registry\.Internal\.Router$", false, null),
              new Property(@"^IceGrid\.Registry\.Internal\.ProxyOptions$", false, null),
+             new Property(@"^IceGrid\.Registry\.Internal\.ThreadPool\.EdgeTriggered$", false, null),
+             new Property(@"^IceGrid\.Registry\.Internal\.ThreadPool\.Model$", false, null),
              new Property(@"^IceGrid\.Registry\.Internal\.ThreadPool\.Size$", false, null),
              new Property(@"^IceGrid\.Registry\.Internal\.ThreadPool\.SizeMax$", false, null),
              new Property(@"^IceGrid\.Registry\.Internal\.ThreadPool\.SizeWarn$", false, null),
@@ -327,6 +383,11 @@ namespace IceInternal
              new Property(@"^IceGrid\.Registry\.ReplicaSessionTimeout$", false, null),
              new Property(@"^IceGrid\.Registry\.Server\.ACM$", false, null),
              new Property(@"^IceGrid\.Registry\.Server\.AdapterId$", false, null),
+             new Property(@"^IceGrid\.Registry\.Server\.DispatchPriority\.Context$", false, null),
+             new Property(@"^IceGrid\.Registry\.Server\.DispatchPriority\.Default$", false, null),
+             new Property(@"^IceGrid\.Registry\.Server\.DispatchPriority\.Operation\.[^\s]+$", false, null),
+             new Property(@"^IceGrid\.Registry\.Server\.DispatchPriority\.Reserved$", false, null),
+             new Property(@"^IceGrid\.Registry\.Server\.DispatchPriority\.Weights$", false, null),
              new Property(@"^IceGrid\.Registry\.Server\.Endpoints$", false, null),
              new Property(@"^IceGrid\.Registry\.Server\.Locator$", false, null),
              new Property(@"^IceGrid\.Registry\.Server\.PublishedEndpoints$", false, null),
@@ -334,6 +395,8 @@ namespace IceInternal
              new Property(@"^IceGrid\.Registry\.Server\.ReplicaGroupId$", false, null),
              new Property(@"^IceGrid\.Registry\.Server\.Router$", false, null),
              new Property(@"^IceGrid\.Registry\.Server\.ProxyOptions$", false, null),
+             new Property(@"^IceGrid\.Registry\.Server\.ThreadPool\.EdgeTriggered$", false, null),
+             new Property(@"^IceGrid\.Registry\.Server\.ThreadPool\.Model$", false, null),
              new Property(@"^IceGrid\.Registry\.Server\.ThreadPool\.Size$", false, null),
              new Property(@"^IceGrid\.Registry\.Server\.ThreadPool\.SizeMax$", false, null),
              new Property(@"^IceGrid\.Registry\.Server\.ThreadPool\.SizeWarn$", false, null),
@@ -344,6 +407,11 @@ namespace IceInternal
              new Property(@"^IceGrid\.Registry\.SessionFilters$", false, null),
              new Property(@"^IceGrid\.Registry\.SessionManager\.ACM$", false, null),
              new Property(@"^IceGrid\.Registry\.SessionManager\.AdapterId$", false, null),
+             new Property(@"^IceGrid\.Registry\.SessionManager\.DispatchPriority\.Context$", false, null),
+             new Property(@"^IceGrid\.Registry\.SessionManager\.DispatchPriority\.Default$", false, null),
+             new Property(@"^IceGrid\.Registry\.SessionManager\.DispatchPriority\.Operation\.[^\s]+$", false, null),
+             new Property(@"^IceGrid\.Registry\.SessionManager\.DispatchPriority\.Reserved$", false, null),
+             new Property(@"^IceGrid\.Registry\.SessionManager\.DispatchPriority\.Weights$", false, null),
              new Property(@"^IceGrid\.Registry\.SessionManager\.Endpoints$", false, null),
              new Property(@"^IceGrid\.Registry\.SessionManager\.Locator$", false, null),
              new Property(@"^IceGrid\.Registry\.SessionManager\.PublishedEndpoints$", false, null),
@@ -351,6 +419,8 @@ namespace IceInternal
              new Property(@"^IceGrid\.Registry\.SessionManager\.ReplicaGroupId$", false, null),
              new Property(@"^IceGrid\.Registry\.SessionManager\.Router$", false, null),
              new Property(@"^IceGrid\.Registry\.SessionManager\.ProxyOptions$", false, null),
+             new Property(@"^IceGrid\.Registry\.SessionManager\.ThreadPool\.EdgeTriggered$", false, null),
+             new Property(@"^IceGrid\.Registry\.SessionManager\.ThreadPool\.Model$", false, null),
              new Property(@"^IceGrid\.Registry\.SessionManager\.ThreadPool\.Size$", false, null),
              new Property(@"^IceGrid\.Registry\.SessionManager\.ThreadPool\.SizeMax$", false, null),
              new Property(@"^IceGrid\.Registry\.SessionManager\.ThreadPool\.SizeWarn$", false, null),
@@ -394,6 +464,11 @@ namespace IceInternal
         {
              new Property(@"^IcePatch2\.ACM$", false, null),
              new Property(@"^IcePatch2\.AdapterId$", false, null),
+             new Property(@"^IcePatch2\.DispatchPriority\.Context$", false, null),
+             new Property(@"^IcePatch2\.DispatchPriority\.Default$", false, null),
+             new Property(@"^IcePatch2\.DispatchPriority\.Operation\.[^\s]+$", false, null),
+             new Property(@"^IcePatch2\.DispatchPriority\.Reserved$", false, null),
+             new Property(@"^IcePatch2\.DispatchPriority\.Weights$", false, null),
              new Property(@"^IcePatch2\.Endpoints$", false, null),
              new Property(@"^IcePatch2\.Locator$", false, null),
              new Property(@"^IcePatch2\.PublishedEndpoints$", false, null),
@@ -401,6 +476,8 @@ namespace IceInternal
              new Property(@"^IcePatch2\.ReplicaGroupId$", false, null),
              new Property(@"^IcePatch2\.Router$", false, null),
              new Property(@"^IcePatch2\.ProxyOptions$", false, null),
+             new Property(@"^IcePatch2\.ThreadPool\.EdgeTriggered$", false, null),
+             new Property(@"^IcePatch2\.ThreadPool\.Model$", false, null),
              new Property(@"^IcePatch2\.ThreadPool\.Size$", false, null),
              new Property(@"^IcePatch2\.ThreadPool\.SizeMax$", false, null),
              new Property(@"^IcePatch2\.ThreadPool\.SizeWarn$", false, null),
@@ -493,6 +570,11 @@ namespace IceInternal
              new Property(@"^Glacier2\.Admin\.ThreadPool\.StackSize$", true, null),
              new Property(@"^Glacier2\.Client\.ACM$", false, null),
              new Property(@"^Glacier2\.Client\.AdapterId$", false, null),
+             new Property(@"^Glacier2\.Client\.DispatchPriority\.Context$", false, null),
+             new Property(@"^Glacier2\.Client\.DispatchPriority\.Default$", false, null),
+             new Property(@"^Glacier2\.Client\.DispatchPriority\.Operation\.[^\s]+$", false, null),
+             new Property(@"^Glacier2\.Client\.DispatchPriority\.Reserved$", false, null),
+             new Property(@"^Glacier2\.Client\.DispatchPriority\.Weights$", false, null),
              new Property(@"^Glacier2\.Client\.Endpoints$", false, null),
              new Property(@"^Glacier2\.Client\.Locator$", false, null),
              new Property(@"^Glacier2\.Client\.PublishedEndpoints$", false, null),
@@ -500,6 +582,8 @@ namespace IceInternal
              new Property(@"^Glacier2\.Client\.ReplicaGroupId$", false, null),
              new Property(@"^Glacier2\.Client\.Router$", false, null),
              new Property(@"^Glacier2\.Client\.ProxyOptions$", false, null),
+             new Property(@"^Glacier2\.Client\.ThreadPool\.EdgeTriggered$", false, null),
+             new Property(@"^Glacier2\.Client\.ThreadPool\.Model$", false, null),
              new Property(@"^Glacier2\.Client\.ThreadPool\.Size$", false, null),
              new Property(@"^Glacier2\.Client\.ThreadPool\.SizeMax$", false, null),
              new Property(@"^Glacier2\.Client\.ThreadPool\.SizeWarn$", false, null),
@@ -545,6 +629,11 @@ namespace IceInternal
              new Property(@"^Glacier2\.RoutingTable\.MaxSize$", false, null),
              new Property(@"^Glacier2\.Server\.ACM$", false, null),
              new Property(@"^Glacier2\.Server\.AdapterId$", false, null),
+             new Property(@"^Glacier2\.Server\.DispatchPriority\.Context$", false, null),
+             new Property(@"^Glacier2\.Server\.DispatchPriority\.Default$", false, null),
+             new Property(@"^Glacier2\.Server\.DispatchPriority\.Operation\.[^\s]+$", false, null),
+             new Property(@"^Glacier2\.Server\.DispatchPriority\.Reserved$", false, null),
+             new Property(@"^Glacier2\.Server\.DispatchPriority\.Weights$", false, null),
              new Property(@"^Glacier2\.Server\.Endpoints$", false, null),
              new Property(@"^Glacier2\.Server\.Locator$", false, null),
              new Property(@"^Glacier2\.Server\.PublishedEndpoints$", false, null),
@@ -552,6 +641,8 @@ namespace IceInternal
              new Property(@"^Glacier2\.Server\.ReplicaGroupId$", false, null),
              new Property(@"^Glacier2\.Server\.Router$", false, null),
              new Property(@"^Glacier2\.Server\.ProxyOptions$", false, null),
+             new Property(@"^Glacier2\.Server\.ThreadPool\.EdgeTriggered$", false, null),
+             new Property(@"^Glacier2\.Server\.ThreadPool\.Model$", false, null),
              new Property(@"^Glacier2\.Server\.ThreadPool\.Size$", false, null),
              new Property(@"^Glacier2\.Server\.ThreadPool\.SizeMax$", false, null),
              new Property(@"^Glacier2\.Server\.ThreadPool\.SizeWarn$", false, null),
@@ -1595,6 +1595,10 @@ def runTests(start, expanded, num = 0, script = False):
                 print "%s*** test only supported under Win32%s" % (prefix, suffix)
                 continue
 
+            if isWin32() and "nowin32" in config:
+                print "%s*** test not supported under Win32%s" % (prefix, suffix)
+                continue
+
             if isBCC2010() and "nobcc" in config:
                 print "%s*** test not supported with C++Builder%s" % (prefix, suffix)
                 continue